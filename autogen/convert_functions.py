@@ -94,8 +94,8 @@ override_allowed_functions = {
 override_disallowed_functions = {
     "src/audio/external.h":                     [ " func_" ],
     "src/engine/math_util.h":                   [ "atan2f", "vec3s_sub" ],
-    "src/engine/surface_load.h":                [ "alloc_surface_pools", "clear_dynamic_surfaces" ],
-    "src/engine/surface_collision.h":           [ " debug_", "f32_find_wall_collision" ],
+    "src/engine/surface_load.h":                [ "alloc_surface_pools", "clear_dynamic_surfaces", "mark_static_surfaces_modified", "refresh_static_surfaces" ],
+    "src/engine/surface_collision.h":           [ " debug_", "f32_find_wall_collision", "_bench" ],
     "src/game/mario_actions_airborne.c":        [ "^[us]32 act_.*" ],
     "src/game/mario_actions_automatic.c":       [ "^[us]32 act_.*" ],
     "src/game/mario_actions_cutscene.c":        [ "^[us]32 act_.*", " geo_", "spawn_obj", "print_displaying_credits_entry" ],
@@ -110,7 +110,7 @@ override_disallowed_functions = {
     "src/game/interaction.h":                   [ "process_interaction", "_handle_" ],
     "src/game/sound_init.h":                    [ "_loop_", "thread4_", "set_sound_mode" ],
     "src/pc/network/network_utils.h":           [ "network_get_player_text_color[^_]" ],
-    "src/pc/network/network_player.h":          [ "_init", "_connected[^_]", "_shutdown", "_disconnected", "_update", "construct_player_popup", "network_player_name_valid" ],
+    "src/pc/network/network_player.h":          [ "_init", "_connected[^_]", "_shutdown", "_disconnected", "_update", "construct_player_popup", "network_player_name_valid", "_bench" ],
     "src/game/object_helpers.c":                [ "spawn_obj", "^bhv_", "abs[fi]", "^bit_shift", "_debug$", "^stub_", "_set_model", "cur_obj_set_direction_table", "cur_obj_progress_direction_table" ],
     "src/game/obj_behaviors.c":                 [ "debug_" ],
     "src/game/obj_behaviors_2.c":               [ "wiggler_jumped_on_attack_handler", "huge_goomba_weakly_attacked" ],
@@ -125,8 +125,8 @@ override_disallowed_functions = {
     "src/pc/lua/utils/smlua_anim_utils.h":      [ "smlua_anim_util_reset", "smlua_anim_util_register_animation" ],
     "src/pc/network/lag_compensation.h":        [ "lag_compensation_clear" ],
     "src/game/first_person_cam.h":              [ "first_person_update" ],
-    "src/pc/lua/utils/smlua_collision_utils.h": [ "collision_find_surface_on_ray" ],
-    "src/engine/behavior_script.h":             [ "stub_behavior_script_2", "cur_obj_update" ],
+    "src/pc/lua/utils/smlua_collision_utils.h": [ "collision_find_surface_on_ray", "smlua_collision_util_reset" ],
+    "src/engine/behavior_script.h":             [ "stub_behavior_script_2", "cur_obj_update", "behavior_ext_cache_clear" ],
     "src/pc/utils/misc.h":                      [ "str_.*", "file_get_line", "delta_interpolate_(normal|rgba|mtx)", "detect_and_skip_mtx_interpolation" ],
     "src/engine/lighting_engine.h":             [ "le_calculate_vertex_lighting", "le_clear", "le_shutdown" ]
 }
@@ -216,6 +216,8 @@ manual_index_documentation = """
    - [cast_graph_node](#cast_graph_node)
    - [get_uncolored_string](#get_uncolored_string)
    - [gfx_set_command](#gfx_set_command)
+   - [vec3f_new](#vec3f_new)
+   - [vec3s_new](#vec3s_new)
 
 <br />
 
@@ -780,6 +782,60 @@ N/A
 
 <br />
 
+## [vec3f_new](#vec3f_new)
+
+Creates a native `Vec3f`. Missing components default to `0`. Native vectors can be passed anywhere a `Vec3f` table is accepted without being converted field by field, and support `+`, `-`, `*`, `/`, and unary `-`.
+
+### Lua Example
+```lua
+local v = vec3f_new(1, 2, 3)
+local w = v * 2 + vec3f_new(0, 1, 0) -- { x = 2, y = 5, z = 6 }
+vec3f_add(v, w) -- in place
+```
+
+### Parameters
+| Field | Type |
+| ----- | ---- |
+| x (optional) | `number` |
+| y (optional) | `number` |
+| z (optional) | `number` |
+
+### Returns
+- [Vec3f](structs.md#Vec3f)
+
+### C Prototype
+N/A
+
+[:arrow_up_small:](#)
+
+<br />
+
+## [vec3s_new](#vec3s_new)
+
+Creates a native `Vec3s`. Missing components default to `0`. Behaves like [vec3f_new](#vec3f_new) with integer components.
+
+### Lua Example
+```lua
+local angle = vec3s_new(0, 0x4000, 0)
+```
+
+### Parameters
+| Field | Type |
+| ----- | ---- |
+| x (optional) | `integer` |
+| y (optional) | `integer` |
+| z (optional) | `integer` |
+
+### Returns
+- [Vec3s](structs.md#Vec3s)
+
+### C Prototype
+N/A
+
+[:arrow_up_small:](#)
+
+<br />
+
 """
 
 ############################################################################
@@ -821,12 +877,21 @@ def build_vec_types():
 
         # Get
         s += "static void smlua_get_%s(%s dest, int index) {\n" % (type_name.lower(), type_name)
+        s += "    void *src = smlua_to_vec(gLuaState, index, LOT_%s);\n" % type_name.upper()
+        s += "    if (src != NULL) {\n"
+        s += "        memcpy(dest, src, sizeof(%s));\n" % type_name
+        s += "        gSmLuaConvertSuccess = true;\n"
+        s += "        return;\n"
+        s += "    }\n"
         for lua_field, c_field in vec_type["fields_mapping"].items():
             s += "    dest%s = smlua_get_%s_field(index, \"%s\");\n" % (c_field, vec_type["field_lua_type"], lua_field)
         s += "}\n\n"
 
         # Push
         s += "static void smlua_push_%s(%s src, int index) {\n" % (type_name.lower(), type_name)
+        s += "    if (smlua_write_vec(gLuaState, index, LOT_%s, src, sizeof(%s))) {\n" % (type_name.upper(), type_name)
+        s += "        return;\n"
+        s += "    }\n"
         for lua_field, c_field in vec_type["fields_mapping"].items():
             s += "    smlua_push_%s_field(index, \"%s\", src%s);\n" % (vec_type["field_lua_type"], lua_field, c_field)
         for lua_field, c_field in vec_type.get('optional_fields_mapping', {}).items():
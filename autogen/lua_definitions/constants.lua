@@ -11836,13 +11836,13 @@ SPTASK_STATE_FINISHED_DP = 4 --- @type SpTaskState
 MAX_VERSION_LENGTH = 128
 
 --- @type integer
-MINOR_VERSION_NUMBER = 0
+MINOR_VERSION_NUMBER = 2
 
 --- @type string
 SM64COOPDX_VERSION = "v1.3"
 
 --- @type integer
-VERSION_NUMBER = 40
+VERSION_NUMBER = 41
 
 --- @type string
 VERSION_TEXT = "v"
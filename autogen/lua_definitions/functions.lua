@@ -9380,6 +9380,16 @@ function collision_find_ceil(x, y, z)
     -- ...
 end
 
+--- @param x number
+--- @param y number
+--- @param z number
+--- @param radius number
+--- @return Surface
+--- Finds the surface closest to the given `x`, `y`, and `z` values within `radius`
+function collision_find_closest_surface(x, y, z, radius)
+    -- ...
+end
+
 --- @param x number
 --- @param y number
 --- @param z number
@@ -9389,12 +9399,24 @@ function collision_find_floor(x, y, z)
     -- ...
 end
 
+--- @return boolean
+--- Gets whether raycasts and sphere queries use the level's surface BVH
+function collision_get_bvh_enabled()
+    -- ...
+end
+
 --- @return WallCollisionData
 --- Returns a temporary wall collision data pointer
 function collision_get_temp_wall_collision_data()
     -- ...
 end
 
+--- @param enabled boolean
+--- Sets whether raycasts and sphere queries use the level's surface BVH instead of walking the collision grid
+function collision_set_bvh_enabled(enabled)
+    -- ...
+end
+
 --- @param wcd WallCollisionData
 --- @param index integer
 --- @return Surface
@@ -10957,6 +10979,15 @@ function find_ceil_height(x, y, z)
     -- ...
 end
 
+--- @param pos Vec3f
+--- @param radius number
+--- @param closestPos Vec3f
+--- @return Surface
+--- Finds the surface closest to `pos` within `radius`, and writes the closest point on it to `closestPos`. Returns nil if no surface is that close
+function find_closest_surface_in_sphere(pos, radius, closestPos)
+    -- ...
+end
+
 --- @param x number
 --- @param y number
 --- @param z number
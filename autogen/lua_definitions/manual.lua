@@ -456,3 +456,21 @@ end
 function gfx_set_command(gfx, command, ...)
     -- ...
 end
+
+--- @param x? number
+--- @param y? number
+--- @param z? number
+--- @return Vec3f
+--- Creates a native Vec3f that supports arithmetic operators and is passed to functions without field-by-field conversion
+function vec3f_new(x, y, z)
+    -- ...
+end
+
+--- @param x? integer
+--- @param y? integer
+--- @param z? integer
+--- @return Vec3s
+--- Creates a native Vec3s that supports arithmetic operators and is passed to functions without field-by-field conversion
+function vec3s_new(x, y, z)
+    -- ...
+end
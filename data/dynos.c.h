@@ -12,7 +12,8 @@ void *dynos_swap_cmd(void *cmd);
 // -- built in -- //
 void *dynos_update_cmd(void *cmd);
 void  dynos_update_gfx();
-s32   dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi, void **hashmap, void *pool, s32 *poolpos, s32 poolsize);
+s32   dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi);
+s32   dynos_tex_resolve(const void **key, void *ptr);
 void  dynos_gfx_swap_animations(void *ptr);
 
 // -- warps -- //
@@ -86,6 +87,7 @@ void dynos_model_clear_pool(enum ModelPool aModelPool);
 
 // -- other -- //
 void dynos_mod_shutdown(void);
+void dynos_tex_decode_shutdown(void);
 void dynos_add_scroll_target(u32 index, const char *name, u32 offset, u32 size);
 
 #endif
@@ -16,6 +16,7 @@ extern "C" {
 #define POINTER_CODE    (u32) 0x52544E50
 #define LUA_VAR_CODE    (u32) 0x5641554C
 #define TEX_REF_CODE    (u32) 0x52584554
+#define TEX_RAW_CODE    (u32) 0x57415254
 
 #define MOD_PACK_INDEX 99
 
@@ -51,6 +52,12 @@ enum {
     DATA_TYPE_LIGHT_0,
 };
 
+enum {
+    TEX_DECODE_NONE,   // mRawData is ready to use (or there is nothing to decode)
+    TEX_DECODE_QUEUED, // waiting in the decode pool
+    TEX_DECODE_BUSY,   // being decoded right now
+};
+
 enum {
     DOPT_NONE = 0,
 
@@ -502,6 +509,9 @@ struct TexData : NoCopy {
     s32 mRawFormat = -1;
     s32 mRawSize   = -1;
     bool mUploaded = false;
+    std::atomic<u8> mDecodeState { TEX_DECODE_NONE }; // Written under the decode pool mutex
+    TexData *mDecodeSource = NULL; // Set on a duplicate loaded while its original was still decoding, the pixels are copied from it
+    ~TexData();
 };
 
 struct AnimData : NoCopy {
@@ -907,8 +917,12 @@ void DynOS_Anim_Swap(void *aPtr);
 void DynOS_Tex_Valid(GfxData* aGfxData);
 void DynOS_Tex_Invalid(GfxData* aGfxData);
 void DynOS_Tex_Update();
+void DynOS_Tex_Decode_Queue(TexData* aData);
+bool DynOS_Tex_Decode_Ensure(TexData* aData);
+void DynOS_Tex_Decode_Shutdown();
 u8 *DynOS_Tex_ConvertToRGBA32(const u8 *aData, u64 aLength, s32 aFormat, s32 aSize, const u8 *aPalette);
-bool DynOS_Tex_Import(void **aOutput, void *aPtr, s32 aTile, void *aGfxRApi, void **aHashMap, void *aPool, u32 *aPoolPos, u32 aPoolSize);
+bool DynOS_Tex_Import(void **aOutput, void *aPtr, s32 aTile, void *aGfxRApi);
+bool DynOS_Tex_Resolve(const void **aKey, void *aPtr);
 void DynOS_Tex_Activate(DataNode<TexData>* aNode, bool aCustomTexture);
 void DynOS_Tex_Deactivate(DataNode<TexData>* aNode);
 void DynOS_Tex_AddCustom(const SysPath &aFilename, const char *aTexName);
@@ -15,6 +15,7 @@
 #endif
 #ifdef __cplusplus
 #include <new>
+#include <atomic>
 #include <utility>
 #include <string>
 extern "C" {
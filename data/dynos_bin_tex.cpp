@@ -181,6 +181,22 @@ void DynOS_Tex_Write(BinFile* aFile, GfxData* aGfxData, DataNode<TexData> *aNode
                 return;
             }
         }
+
+        // Store the decoded pixels instead, loading them is then a plain copy
+        // Only done when the .bin files get compressed, raw pixels are several times larger than the png
+        if (configPackRawTextures && configCompressOnStartup) {
+            s32 _Width = 0, _Height = 0;
+            u8 *_RawData = stbi_load_from_memory(aNode->mData->mPngData.begin(), aNode->mData->mPngData.Count(), &_Width, &_Height, NULL, 4);
+            if (_RawData) {
+                aFile->Write<u32>(TEX_RAW_CODE);
+                aFile->Write<s32>(_Width);
+                aFile->Write<s32>(_Height);
+                aFile->Write<s32>(_Width * _Height * 4);
+                aFile->Write<u8>(_RawData, _Width * _Height * 4);
+                free(_RawData);
+                return;
+            }
+        }
     }
     aNode->mData->mPngData.Write(aFile);
 }
@@ -246,33 +262,43 @@ DataNode<TexData>* DynOS_Tex_Load(BinFile *aFile, GfxData *aGfxData) {
     _Node->mData = New<TexData>();
     _Node->mData->mUploaded = false;
 
-    // Check for the texture ref magic
+    // Check for the texture ref and raw magics
     s32 _FileOffset = aFile->Offset();
-    u32 _TexRefCode = aFile->Read<u32>();
-    if (_TexRefCode == TEX_REF_CODE) {
+    u32 _TexCode = aFile->Read<u32>();
+    if (_TexCode == TEX_REF_CODE) {
 
         // That's a duplicate, find the original node and copy its content
+        // If the original is still waiting to be decoded, the copy shares that decode
         String _NodeName; _NodeName.Read(aFile);
         for (const auto& _LoadedNode : aGfxData->mTextures) {
             if (_LoadedNode->mName == _NodeName) {
                 _Node->mData->mPngData   = _LoadedNode->mData->mPngData;
-                _Node->mData->mRawData   = _LoadedNode->mData->mRawData;
-                _Node->mData->mRawWidth  = _LoadedNode->mData->mRawWidth;
-                _Node->mData->mRawHeight = _LoadedNode->mData->mRawHeight;
-                _Node->mData->mRawFormat = _LoadedNode->mData->mRawFormat;
-                _Node->mData->mRawSize   = _LoadedNode->mData->mRawSize;
+                if (_LoadedNode->mData->mDecodeState == TEX_DECODE_NONE) {
+                    _Node->mData->mRawData   = _LoadedNode->mData->mRawData;
+                    _Node->mData->mRawWidth  = _LoadedNode->mData->mRawWidth;
+                    _Node->mData->mRawHeight = _LoadedNode->mData->mRawHeight;
+                    _Node->mData->mRawFormat = _LoadedNode->mData->mRawFormat;
+                    _Node->mData->mRawSize   = _LoadedNode->mData->mRawSize;
+                } else {
+                    _Node->mData->mDecodeSource = _LoadedNode->mData;
+                }
                 break;
             }
         }
+    } else if (_TexCode == TEX_RAW_CODE) {
+
+        // Already decoded RGBA32 pixels
+        _Node->mData->mRawWidth  = aFile->Read<s32>();
+        _Node->mData->mRawHeight = aFile->Read<s32>();
+        _Node->mData->mRawFormat = G_IM_FMT_RGBA;
+        _Node->mData->mRawSize   = G_IM_SIZ_32b;
+        _Node->mData->mRawData.Read(aFile);
     } else {
         aFile->SetOffset(_FileOffset);
         _Node->mData->mPngData.Read(aFile);
         if (!_Node->mData->mPngData.Empty()) {
-            u8 *_RawData = stbi_load_from_memory(_Node->mData->mPngData.begin(), _Node->mData->mPngData.Count(), &_Node->mData->mRawWidth, &_Node->mData->mRawHeight, NULL, 4);
-            _Node->mData->mRawFormat = G_IM_FMT_RGBA;
-            _Node->mData->mRawSize   = G_IM_SIZ_32b;
-            _Node->mData->mRawData   = Array<u8>(_RawData, _RawData + (_Node->mData->mRawWidth * _Node->mData->mRawHeight * 4));
-            free(_RawData);
+            // Decoded in the background, see DynOS_Tex_Decode_Ensure
+            DynOS_Tex_Decode_Queue(_Node->mData);
         } else { // Probably a palette
             _Node->mData->mRawData   = Array<u8>();
             _Node->mData->mRawWidth  = 0;
@@ -17,8 +17,12 @@ void dynos_update_gfx() {
     return DynOS_UpdateGfx();
 }
 
-s32 dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi, void **hashmap, void *pool, s32 *poolpos, s32 poolsize) {
-    return DynOS_Tex_Import(output, ptr, tile, grapi, hashmap, pool, (u32 *) poolpos, (u32) poolsize);
+s32 dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi) {
+    return DynOS_Tex_Import(output, ptr, tile, grapi);
+}
+
+s32 dynos_tex_resolve(const void **key, void *ptr) {
+    return DynOS_Tex_Resolve(key, ptr);
 }
 
 void dynos_gfx_swap_animations(void *ptr) {
@@ -280,6 +284,10 @@ void dynos_mod_shutdown(void) {
     DynOS_Mod_Shutdown();
 }
 
+void dynos_tex_decode_shutdown(void) {
+    DynOS_Tex_Decode_Shutdown();
+}
+
 void dynos_add_scroll_target(u32 index, const char *name, u32 offset, u32 size) {
     DynOS_Add_Scroll_Target(index, name, offset, size);
 }
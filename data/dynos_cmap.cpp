@@ -1,5 +1,6 @@
 #include <map>
-#include <unordered_map>
+#include <algorithm>
+#include <vector>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -12,31 +13,149 @@ enum class MapType {
 // Ordered maps can be iterated by key order
 // Unordered maps have the fastest lookup times (also called a hash map)
 
+// Open addressing hash map with linear probing.
+// Entries live in a dense array that iteration walks in insertion order,
+// the slot table only holds keys and entry indices so a lookup is usually a single probe.
+// Deletion shifts the following probe run back instead of leaving tombstones.
+class FlatMap {
+public:
+    void* get(int64_t key) const {
+        if (mSlots.empty()) { return nullptr; }
+        size_t mask = mSlots.size() - 1;
+        for (size_t i = Hash(key) & mask;; i = (i + 1) & mask) {
+            const Slot& slot = mSlots[i];
+            if (slot.entry == 0) { return nullptr; }
+            if (slot.key == key) { return mEntries[slot.entry - 1].value; }
+        }
+    }
+
+    void put(int64_t key, void* value) {
+        if ((mEntries.size() + 1) * 4 > mSlots.size() * 3) {
+            Rehash(mSlots.empty() ? 16 : mSlots.size() * 2);
+        }
+        size_t mask = mSlots.size() - 1;
+        size_t i = Hash(key) & mask;
+        for (; mSlots[i].entry != 0; i = (i + 1) & mask) {
+            if (mSlots[i].key == key) {
+                mEntries[mSlots[i].entry - 1].value = value;
+                return;
+            }
+        }
+        mEntries.push_back({ key, value, (uint32_t)i });
+        mSlots[i] = { key, (uint32_t)mEntries.size() };
+    }
+
+    void erase(int64_t key) {
+        if (mSlots.empty()) { return; }
+        size_t mask = mSlots.size() - 1;
+        size_t i = Hash(key) & mask;
+        for (;; i = (i + 1) & mask) {
+            if (mSlots[i].entry == 0) { return; }
+            if (mSlots[i].key == key) { break; }
+        }
+
+        // remove the entry, keeping any iteration in progress on track
+        size_t index = mSlots[i].entry - 1;
+        size_t last = mEntries.size() - 1;
+        if (mIterator < mEntries.size() && index <= mIterator) {
+            // fill the hole with the current entry and the current entry's place with the last one
+            MoveEntry(mIterator, index);
+            MoveEntry(last, mIterator);
+            mIterator--;
+        } else {
+            MoveEntry(last, index);
+        }
+        mEntries.pop_back();
+
+        // shift the rest of the probe run back over the hole
+        size_t hole = i;
+        for (size_t j = (i + 1) & mask; mSlots[j].entry != 0; j = (j + 1) & mask) {
+            size_t home = Hash(mSlots[j].key) & mask;
+            if (((j - home) & mask) < ((j - hole) & mask)) { continue; }
+            mSlots[hole] = mSlots[j];
+            mEntries[mSlots[hole].entry - 1].slot = (uint32_t)hole;
+            hole = j;
+        }
+        mSlots[hole] = { 0, 0 };
+    }
+
+    void clear() {
+        mEntries.clear();
+        std::fill(mSlots.begin(), mSlots.end(), Slot{ 0, 0 });
+        mIterator = SIZE_MAX;
+    }
+
+    size_t size() const {
+        return mEntries.size();
+    }
+
+    void* begin() {
+        mIterator = 0;
+        if (mEntries.empty()) { return nullptr; }
+        return mEntries[0].value;
+    }
+
+    void* next() {
+        if (++mIterator >= mEntries.size()) { return nullptr; }
+        return mEntries[mIterator].value;
+    }
+
+private:
+    struct Slot {
+        int64_t key;
+        uint32_t entry; // index into mEntries plus one, zero when empty
+    };
+
+    struct Entry {
+        int64_t key;
+        void* value;
+        uint32_t slot;
+    };
+
+    std::vector<Slot> mSlots;
+    std::vector<Entry> mEntries;
+    size_t mIterator = SIZE_MAX;
+
+    static size_t Hash(int64_t key) {
+        // fibonacci hashing, keys are mostly small sequential ids
+        uint64_t hash = (uint64_t)key * 0x9E3779B97F4A7C15ull;
+        return (size_t)(hash ^ (hash >> 32));
+    }
+
+    void MoveEntry(size_t from, size_t to) {
+        if (from == to) { return; }
+        mEntries[to] = mEntries[from];
+        mSlots[mEntries[to].slot].entry = (uint32_t)(to + 1);
+    }
+
+    void Rehash(size_t capacity) {
+        mSlots.assign(capacity, Slot{ 0, 0 });
+        size_t mask = capacity - 1;
+        for (size_t e = 0; e < mEntries.size(); e++) {
+            size_t i = Hash(mEntries[e].key) & mask;
+            while (mSlots[i].entry != 0) { i = (i + 1) & mask; }
+            mSlots[i] = { mEntries[e].key, (uint32_t)(e + 1) };
+            mEntries[e].slot = (uint32_t)i;
+        }
+    }
+};
+
 class HMap {
 public:
     HMap(MapType type = MapType::Ordered) : mMapType(type) {
-        switch (mMapType) {
-            case MapType::Ordered:
-                mOrderedMap = std::make_unique<std::map<int64_t, void*>>();
-                break;
-            case MapType::Unordered:
-                mUnorderedMap = std::make_unique<std::unordered_map<int64_t, void*>>();
-                break;
+        if (mMapType == MapType::Ordered) {
+            mOrderedMap = std::make_unique<std::map<int64_t, void*>>();
         }
     }
 
     void* get(int64_t key) {
         switch (mMapType) {
-            case MapType::Ordered:
-                if (mOrderedMap->count(key)) {
-                    return mOrderedMap->at(key);
-                }
-                break;
+            case MapType::Ordered: {
+                auto it = mOrderedMap->find(key);
+                return (it != mOrderedMap->end()) ? it->second : nullptr;
+            }
             case MapType::Unordered:
-                if (mUnorderedMap->count(key)) {
-                    return mUnorderedMap->at(key);
-                }
-                break;
+                return mFlatMap.get(key);
         }
         return nullptr;
     }
@@ -47,7 +166,7 @@ public:
                 mOrderedMap->insert_or_assign(key, value);
                 break;
             case MapType::Unordered:
-                mUnorderedMap->insert_or_assign(key, value);
+                mFlatMap.put(key, value);
                 break;
         }
     }
@@ -58,7 +177,7 @@ public:
                 mOrderedMap->erase(key);
                 break;
             case MapType::Unordered:
-                mUnorderedMap->erase(key);
+                mFlatMap.erase(key);
                 break;
         }
     }
@@ -69,7 +188,7 @@ public:
                 mOrderedMap->clear();
                 break;
             case MapType::Unordered:
-                mUnorderedMap->clear();
+                mFlatMap.clear();
                 break;
         }
     }
@@ -79,7 +198,7 @@ public:
             case MapType::Ordered:
                 return mOrderedMap->size();
             case MapType::Unordered:
-                return mUnorderedMap->size();
+                return mFlatMap.size();
         }
         return 0;
     }
@@ -92,12 +211,8 @@ public:
                 mOrderedIterator = mOrderedMap->begin();
                 return mOrderedIterator->second;
             }
-            case MapType::Unordered: {
-                auto& unorderedMap = *mUnorderedMap;
-                if (unorderedMap.empty()) { return nullptr; }
-                mUnorderedIterator = mUnorderedMap->begin();
-                return mUnorderedIterator->second;
-            }
+            case MapType::Unordered:
+                return mFlatMap.begin();
         }
         return nullptr;
     }
@@ -110,12 +225,8 @@ public:
                 }
                 break;
             }
-            case MapType::Unordered: {
-                if (++mUnorderedIterator != mUnorderedMap->end()) {
-                    return mUnorderedIterator->second;
-                }
-                break;
-            }
+            case MapType::Unordered:
+                return mFlatMap.next();
         }
         return nullptr;
     }
@@ -126,13 +237,12 @@ private:
     std::unique_ptr<std::map<int64_t, void*>> mOrderedMap;
     typename std::map<int64_t, void*>::iterator mOrderedIterator;
 
-    std::unique_ptr<std::unordered_map<int64_t, void*>> mUnorderedMap;
-    typename std::unordered_map<int64_t, void*>::iterator mUnorderedIterator;
+    FlatMap mFlatMap;
 };
 
 extern "C" {
-void* hmap_create(MapType type) {
-    return new HMap(type);
+void* hmap_create(bool useUnordered) {
+    return new HMap(useUnordered ? MapType::Unordered : MapType::Ordered);
 }
 
 void* hmap_get(void* map, int64_t key) {
@@ -182,3 +292,106 @@ void* hmap_next(void* map) {
     return hmap->next();
 }
 }
+
+#ifdef DEVELOPMENT
+
+#include <unordered_map>
+
+extern "C" {
+#include "types.h"
+#include "pc/utils/misc.h"
+#include "pc/dev/bench.h"
+}
+
+#define HMAP_BENCH_KEYS 1024
+#define HMAP_BENCH_ITERATIONS 200
+
+// the old backends paid for count() followed by at() on every lookup
+template <typename Map>
+static void* hmap_bench_legacy_get(Map& map, int64_t key) {
+    if (map.count(key)) {
+        return map.at(key);
+    }
+    return nullptr;
+}
+
+template <typename Map>
+static f64 hmap_bench_legacy(const std::vector<int64_t>& keys, uintptr_t& sum) {
+    Map map;
+    for (size_t i = 0; i < keys.size(); i++) {
+        map.insert_or_assign(keys[i], (void*)(uintptr_t)(i + 1));
+    }
+    f64 start = clock_elapsed_f64();
+    for (u32 iter = 0; iter < HMAP_BENCH_ITERATIONS; iter++) {
+        for (const auto& key : keys) {
+            sum += (uintptr_t)hmap_bench_legacy_get(map, key);
+            sum += (uintptr_t)hmap_bench_legacy_get(map, key + 1);
+        }
+        for (const auto& entry : map) {
+            sum += (uintptr_t)entry.second;
+        }
+    }
+    return clock_elapsed_f64() - start;
+}
+
+static f64 hmap_bench_current(const std::vector<int64_t>& keys, bool useUnordered, uintptr_t& sum) {
+    void* map = hmap_create(useUnordered);
+    for (size_t i = 0; i < keys.size(); i++) {
+        hmap_put(map, keys[i], (void*)(uintptr_t)(i + 1));
+    }
+    f64 start = clock_elapsed_f64();
+    for (u32 iter = 0; iter < HMAP_BENCH_ITERATIONS; iter++) {
+        for (const auto& key : keys) {
+            sum += (uintptr_t)hmap_get(map, key);
+            sum += (uintptr_t)hmap_get(map, key + 1);
+        }
+        for (void* value = hmap_begin(map); value != NULL; value = hmap_next(map)) {
+            sum += (uintptr_t)value;
+        }
+    }
+    f64 end = clock_elapsed_f64();
+    hmap_destroy(map);
+    return end - start;
+}
+
+static void hmap_bench_one(const char* name, const std::vector<int64_t>& keys) {
+    uintptr_t sum = 0;
+    f64 legacyOrdered = hmap_bench_legacy<std::map<int64_t, void*>>(keys, sum);
+    f64 legacyUnordered = hmap_bench_legacy<std::unordered_map<int64_t, void*>>(keys, sum);
+    f64 ordered = hmap_bench_current(keys, false, sum);
+    f64 flat = hmap_bench_current(keys, true, sum);
+
+    // each iteration does two lookups per key and one walk
+    f64 scale = 1000000000.0 / ((f64)HMAP_BENCH_ITERATIONS * keys.size() * 3);
+    dev_bench_report("%s: old map %.1fns, old unordered %.1fns, ordered %.1fns, flat %.1fns (%x)",
+        name, legacyOrdered * scale, legacyUnordered * scale, ordered * scale, flat * scale, (u32)(sum & 0xFF));
+}
+
+extern "C" {
+void hmap_bench(void) {
+    std::vector<int64_t> keys;
+    u32 seed = 1;
+
+    // light ids, handed out sequentially
+    for (int64_t i = 1; i <= HMAP_BENCH_KEYS; i++) { keys.push_back(i); }
+    hmap_bench_one("sequential ids", keys);
+
+    // sync ids, scattered over the player blocks
+    keys.clear();
+    for (u32 i = 0; i < HMAP_BENCH_KEYS; i++) {
+        seed = seed * 1103515245 + 12345;
+        keys.push_back(((seed >> 8) % (MAX_PLAYERS + 1)) * 4096 + (i % 4096));
+    }
+    hmap_bench_one("sync ids", keys);
+
+    // utf8 glyph keys, packed bytes of multi-byte characters
+    keys.clear();
+    for (u32 i = 0; i < HMAP_BENCH_KEYS; i++) {
+        seed = seed * 1103515245 + 12345;
+        keys.push_back(0xE00000 | ((seed >> 8) & 0x0FFFFF));
+    }
+    hmap_bench_one("glyph keys", keys);
+}
+}
+
+#endif
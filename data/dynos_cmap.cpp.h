@@ -13,5 +13,9 @@ size_t hmap_len(void* map);
 void* hmap_begin(void* map);
 void* hmap_next(void* map);
 
+#ifdef DEVELOPMENT
+void hmap_bench(void);
+#endif
+
 #endif
 #endif
\ No newline at end of file
@@ -2,7 +2,11 @@
 #include <set>
 #include "dynos.cpp.h"
 extern "C" {
+#include "pc/thread.h"
 #include "pc/gfx/gfx_rendering_api.h"
+#include "pc/gfx/gfx_pc.h"
+#include "pc/debug_context.h"
+#include "pc/utils/misc.h"
 }
 
 struct OverrideTexture {
@@ -213,6 +217,195 @@ u8 *DynOS_Tex_ConvertToRGBA32(const u8 *aData, u64 aLength, s32 aFormat, s32 aSi
     return NULL;
 }
 
+//
+// Decode
+//
+
+// PNG textures are decoded by a small pool as soon as they are loaded or activated,
+// so a pack appearing on screen for the first time doesn't have to decode them mid-frame
+#define DYNOS_TEX_DECODE_WORKERS 2
+
+static pthread_mutex_t sDynosDecodeMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t sDynosDecodeQueued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t sDynosDecodeDone = PTHREAD_COND_INITIALIZER;
+static struct ThreadHandle sDynosDecodeThreads[DYNOS_TEX_DECODE_WORKERS];
+static s32 sDynosDecodeWorkers = 0;
+static bool sDynosDecodeStarted = false;
+static bool sDynosDecodeExit = false;
+
+static Array<TexData *>& DynosDecodeQueue() {
+    static Array<TexData *> sDynosDecodeQueue;
+    return sDynosDecodeQueue;
+}
+
+static bool DynOS_Tex_Decode_Pending(TexData *aData) {
+    return !aData->mPngData.Empty() && aData->mRawData.Empty() && aData->mRawWidth == -1;
+}
+
+// Only called by whoever moved the texture to the busy state, nothing else touches it meanwhile
+static void DynOS_Tex_Decode(TexData *aData) {
+    s32 _Width = 0, _Height = 0;
+    u8 *_RawData = stbi_load_from_memory(aData->mPngData.begin(), aData->mPngData.Count(), &_Width, &_Height, NULL, 4);
+    aData->mRawFormat = G_IM_FMT_RGBA;
+    aData->mRawSize   = G_IM_SIZ_32b;
+
+    // Corrupted data, leave it empty so it isn't decoded again
+    if (_RawData == NULL) {
+        aData->mRawWidth  = 0;
+        aData->mRawHeight = 0;
+        return;
+    }
+
+    aData->mRawWidth  = _Width;
+    aData->mRawHeight = _Height;
+    aData->mRawData   = Array<u8>(_RawData, _RawData + (_Width * _Height * 4));
+    free(_RawData);
+}
+
+static void *DynOS_Tex_Decode_Worker(void *) {
+    auto& _Queue = DynosDecodeQueue();
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    while (true) {
+        while (_Queue.Empty() && !sDynosDecodeExit) {
+            pthread_cond_wait(&sDynosDecodeQueued, &sDynosDecodeMutex);
+        }
+        if (sDynosDecodeExit) { break; }
+        TexData *_Data = _Queue[0];
+        _Queue.Remove(0);
+        _Data->mDecodeState = TEX_DECODE_BUSY;
+        pthread_mutex_unlock(&sDynosDecodeMutex);
+
+        DynOS_Tex_Decode(_Data);
+
+        pthread_mutex_lock(&sDynosDecodeMutex);
+        _Data->mDecodeState = TEX_DECODE_NONE;
+        pthread_cond_broadcast(&sDynosDecodeDone);
+    }
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+    return NULL;
+}
+
+void DynOS_Tex_Decode_Queue(TexData *aData) {
+    if (!aData) { return; }
+
+    // A duplicate is decoded through its original
+    if (aData->mDecodeSource && DynOS_Tex_Decode_Pending(aData)) {
+        aData = aData->mDecodeSource;
+    }
+
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    if (aData->mDecodeState == TEX_DECODE_NONE && DynOS_Tex_Decode_Pending(aData)) {
+
+        // Start the workers on first use, if none can be started textures are decoded when needed
+        if (!sDynosDecodeStarted) {
+            sDynosDecodeStarted = true;
+            sDynosDecodeExit = false;
+            for (s32 i = 0; i < DYNOS_TEX_DECODE_WORKERS; ++i) {
+                if (init_thread(&sDynosDecodeThreads[i], DynOS_Tex_Decode_Worker, NULL, NULL, 0) != 0) {
+                    sDynosDecodeThreads[i].state = INVALID;
+                    break;
+                }
+                sDynosDecodeWorkers++;
+            }
+        }
+
+        if (sDynosDecodeWorkers > 0) {
+            aData->mDecodeState = TEX_DECODE_QUEUED;
+            DynosDecodeQueue().Add(aData);
+            pthread_cond_signal(&sDynosDecodeQueued);
+        }
+    }
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+}
+
+// Stops the workers, whatever they didn't get to is decoded when needed
+void DynOS_Tex_Decode_Shutdown() {
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    sDynosDecodeExit = true;
+    pthread_cond_broadcast(&sDynosDecodeQueued);
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+
+    for (s32 i = 0; i < sDynosDecodeWorkers; ++i) {
+        join_thread(&sDynosDecodeThreads[i]);
+    }
+
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    auto& _Queue = DynosDecodeQueue();
+    for (auto& _Data : _Queue) {
+        _Data->mDecodeState = TEX_DECODE_NONE;
+    }
+    _Queue.Clear();
+    sDynosDecodeWorkers = 0;
+    sDynosDecodeStarted = false;
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+}
+
+// Makes sure mRawData is ready, returns false if the texture has no pixels
+bool DynOS_Tex_Decode_Ensure(TexData *aData) {
+    if (!aData) { return false; }
+    if (aData->mDecodeState == TEX_DECODE_NONE && !DynOS_Tex_Decode_Pending(aData)) {
+        return !aData->mRawData.Empty();
+    }
+
+    // A duplicate takes the pixels of its original once that one is decoded
+    if (aData->mDecodeSource) {
+        TexData *_Source = aData->mDecodeSource;
+        DynOS_Tex_Decode_Ensure(_Source);
+        aData->mRawData   = _Source->mRawData;
+        aData->mRawWidth  = _Source->mRawWidth;
+        aData->mRawHeight = _Source->mRawHeight;
+        aData->mRawFormat = _Source->mRawFormat;
+        aData->mRawSize   = _Source->mRawSize;
+        return !aData->mRawData.Empty();
+    }
+
+    // Needed before the pool got to it: take it over or wait for the worker decoding it, this is a hitch
+    f64 _Start = clock_elapsed_f64();
+    bool _Decode = false;
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    if (aData->mDecodeState == TEX_DECODE_QUEUED) {
+        auto& _Queue = DynosDecodeQueue();
+        _Queue.Remove(_Queue.Find(aData));
+        _Decode = true;
+    } else if (aData->mDecodeState == TEX_DECODE_NONE) {
+        _Decode = DynOS_Tex_Decode_Pending(aData);
+    }
+    if (_Decode) {
+        aData->mDecodeState = TEX_DECODE_BUSY;
+    }
+    while (!_Decode && aData->mDecodeState == TEX_DECODE_BUSY) {
+        pthread_cond_wait(&sDynosDecodeDone, &sDynosDecodeMutex);
+    }
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+
+    if (_Decode) {
+        DynOS_Tex_Decode(aData);
+        pthread_mutex_lock(&sDynosDecodeMutex);
+        aData->mDecodeState = TEX_DECODE_NONE;
+        pthread_cond_broadcast(&sDynosDecodeDone);
+        pthread_mutex_unlock(&sDynosDecodeMutex);
+    }
+
+    CTR_ADD(CTR_DYNOS_TEX_STALL, 1);
+    CTR_ADD(CTR_DYNOS_TEX_STALL_US, (s64)((clock_elapsed_f64() - _Start) * 1000000.0));
+    return !aData->mRawData.Empty();
+}
+
+// A texture can't be freed while the pool still holds it
+TexData::~TexData() {
+    if (mDecodeState == TEX_DECODE_NONE) { return; }
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    if (mDecodeState == TEX_DECODE_QUEUED) {
+        auto& _Queue = DynosDecodeQueue();
+        _Queue.Remove(_Queue.Find(this));
+        mDecodeState = TEX_DECODE_NONE;
+    }
+    while (mDecodeState == TEX_DECODE_BUSY) {
+        pthread_cond_wait(&sDynosDecodeDone, &sDynosDecodeMutex);
+    }
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+}
+
 //
 // Upload
 //
@@ -222,12 +415,14 @@ static void DynOS_Tex_Upload(DataNode<TexData> *aNode, GRAPI *aGfxRApi, s32 aTil
     aGfxRApi->select_texture(aTile, aTexId);
     aGfxRApi->upload_texture(aNode->mData->mRawData.begin(), aNode->mData->mRawWidth, aNode->mData->mRawHeight);
     aNode->mData->mUploaded = true;
+    CTR_ADD(CTR_TEX_UPLOAD_BYTES, aNode->mData->mRawWidth * aNode->mData->mRawHeight * 4);
 }
 
 //
 // Cache
 //
 
+// Mirrors the start of TextureHashmapNode in gfx_pc.c
 struct THN {
     struct THN *mNext;
     const void *mAddr; // Contains the pointer to the DataNode<TexData> struct, NOT the actual texture data
@@ -237,44 +432,27 @@ struct THN {
     bool mLInf;
 };
 
-static bool DynOS_Tex_Cache(THN **aOutput, DataNode<TexData> *aNode, s32 aTile, GRAPI *aGfxRApi, THN **aHashMap, THN *aPool, u32 *aPoolPos, u32 aPoolSize) {
-
-    // Find texture in cache
-    uintptr_t _Hash = ((uintptr_t) aNode) & ((aPoolSize * 2) - 1);
-    THN **_Node = &(aHashMap[_Hash]);
-    while ((*_Node) != NULL && ((*_Node) - aPool) < (*aPoolPos)) {
-        if ((*_Node)->mAddr == (const void *) aNode) {
-            aGfxRApi->select_texture(aTile, (*_Node)->mTexId);
-            if (!aNode->mData->mUploaded) {
-                DynOS_Tex_Upload(aNode, aGfxRApi, aTile, (*_Node)->mTexId);
-            }
-            (*aOutput) = (*_Node);
-            return true;
-        }
-        _Node = &(*_Node)->mNext;
-    }
-
-    // If cache is full, clear cache
-    if ((*aPoolPos) == aPoolSize) {
-        (*aPoolPos) = 0;
-        _Node = &aHashMap[_Hash];
-    }
-
-    // Add new texture to cache
-    (*_Node) = &aPool[(*aPoolPos)++];
-    if (!(*_Node)->mAddr) {
-        (*_Node)->mTexId = aGfxRApi->new_texture();
-    }
-    aGfxRApi->select_texture(aTile, (*_Node)->mTexId);
-    aGfxRApi->set_sampler_parameters(aTile, false, 0, 0);
-    (*_Node)->mCms  = 0;
-    (*_Node)->mCmt  = 0;
-    (*_Node)->mLInf = false;
-    (*_Node)->mNext = NULL;
-    (*_Node)->mAddr = aNode;
-    (*_Node)->mFmt  = G_IM_FMT_RGBA;
-    (*_Node)->mSiz  = G_IM_SIZ_32b;
-    (*aOutput)      = (*_Node);
+static bool DynOS_Tex_Cache(THN **aOutput, DataNode<TexData> *aNode, s32 aTile) {
+
+    // The node may have been reloaded since its last upload, drop whatever was cached under it
+    if (!aNode->mData->mUploaded) {
+        gfx_texture_cache_invalidate(aNode);
+    }
+
+    // Find texture in cache, or share the upload of an identical one
+    if (gfx_texture_cache_lookup(
+        aTile,
+        (struct TextureHashmapNode **) aOutput,
+        aNode,
+        G_IM_FMT_RGBA,
+        G_IM_SIZ_32b,
+        aNode->mData->mRawData.begin(),
+        aNode->mData->mRawData.Count(),
+        aNode->mData->mRawWidth * 4
+    )) {
+        aNode->mData->mUploaded = true;
+        return true;
+    }
     return false;
 }
 
@@ -285,6 +463,7 @@ static bool DynOS_Tex_Cache(THN **aOutput, DataNode<TexData> *aNode, s32 aTile,
 void DynOS_Tex_Valid(GfxData* aGfxData) {
     for (auto &_Texture : aGfxData->mTextures) {
         DynosValidTextures().insert(_Texture);
+        DynOS_Tex_Decode_Queue(_Texture->mData);
     }
 }
 
@@ -296,6 +475,10 @@ void DynOS_Tex_Invalid(GfxData* aGfxData) {
 }
 
 void DynOS_Tex_Update() {
+    pthread_mutex_lock(&sDynosDecodeMutex);
+    CTR_SET(CTR_DYNOS_TEX_PENDING, DynosDecodeQueue().Count());
+    pthread_mutex_unlock(&sDynosDecodeMutex);
+
     auto& schedule = DynosScheduledInvalidTextures();
     if (schedule.Count() == 0) { return; }
     for (auto &_Texture : schedule) {
@@ -332,10 +515,11 @@ static DataNode<TexData> *DynOS_Tex_RetrieveNode(void *aPtr) {
     return NULL;
 }
 
-static bool DynOS_Tex_Import_Typed(THN **aOutput, void *aPtr, s32 aTile, GRAPI *aGfxRApi, THN **aHashMap, THN *aPool, u32 *aPoolPos, u32 aPoolSize) {
+static bool DynOS_Tex_Import_Typed(THN **aOutput, void *aPtr, s32 aTile, GRAPI *aGfxRApi) {
     DataNode<TexData> *_Node = DynOS_Tex_RetrieveNode(aPtr);
     if (_Node) {
-        if (!DynOS_Tex_Cache(aOutput, _Node, aTile, aGfxRApi, aHashMap, aPool, aPoolPos, aPoolSize)) {
+        DynOS_Tex_Decode_Ensure(_Node->mData);
+        if (!DynOS_Tex_Cache(aOutput, _Node, aTile) && *aOutput) {
             DynOS_Tex_Upload(_Node, aGfxRApi, aTile, (*aOutput)->mTexId);
         }
         return true;
@@ -343,19 +527,23 @@ static bool DynOS_Tex_Import_Typed(THN **aOutput, void *aPtr, s32 aTile, GRAPI *
     return false;
 }
 
-bool DynOS_Tex_Import(void **aOutput, void *aPtr, s32 aTile, void *aGfxRApi, void **aHashMap, void *aPool, u32 *aPoolPos, u32 aPoolSize) {
+bool DynOS_Tex_Import(void **aOutput, void *aPtr, s32 aTile, void *aGfxRApi) {
     return DynOS_Tex_Import_Typed(
         (THN **)  aOutput,
         (void *)  aPtr,
         (s32)     aTile,
-        (GRAPI *) aGfxRApi,
-        (THN **)  aHashMap,
-        (THN *)   aPool,
-        (u32 *)   aPoolPos,
-        (u32)     aPoolSize
+        (GRAPI *) aGfxRApi
     );
 }
 
+// Tells whether DynOS handles this texture, and which node it is cached under if it is already uploaded
+bool DynOS_Tex_Resolve(const void **aKey, void *aPtr) {
+    DataNode<TexData> *_Node = DynOS_Tex_RetrieveNode(aPtr);
+    if (!_Node) { return false; }
+    *aKey = (_Node->mData->mUploaded && _Node->mData->mDecodeState == TEX_DECODE_NONE) ? _Node : NULL;
+    return true;
+}
+
   /////////////////////
  // Custom Textures //
 /////////////////////
@@ -397,6 +585,7 @@ void DynOS_Tex_Activate(DataNode<TexData>* aNode, bool aCustomTexture) {
 
     // Add to valid
     DynosValidTextures().insert(aNode);
+    DynOS_Tex_Decode_Queue(aNode->mData);
 }
 
 void DynOS_Tex_Deactivate(DataNode<TexData>* aNode) {
@@ -473,18 +662,11 @@ bool DynOS_Tex_Get(const char* aTexName, struct TextureInfo* aOutTexInfo) {
         if (!strcmp(_DynosCustomTexs[i].first, aTexName)) {
             auto& _Data = _DynosCustomTexs[i].second->mData;
 
-            // load the texture if it hasn't been yet
-            if (_Data->mRawData.begin() == NULL) {
-                u8 *_RawData = stbi_load_from_memory(_Data->mPngData.begin(), _Data->mPngData.Count(), &_Data->mRawWidth, &_Data->mRawHeight, NULL, 4);
+            // load the texture if the pool hasn't yet
+            if (!DynOS_Tex_Decode_Ensure(_Data)) {
                 // texture data is corrupted
-                if (_RawData == NULL) {
-                    PrintError("Attempted to load corrupted tex file: %s", aTexName);
-                    return false;
-                }
-                _Data->mRawFormat = G_IM_FMT_RGBA;
-                _Data->mRawSize   = G_IM_SIZ_32b;
-                _Data->mRawData   = Array<u8>(_RawData, _RawData + (_Data->mRawWidth * _Data->mRawHeight * 4));
-                free(_RawData);
+                PrintError("Attempted to load corrupted tex file: %s", aTexName);
+                return false;
             }
 
             CONVERT_TEXINFO();
@@ -498,6 +680,7 @@ bool DynOS_Tex_Get(const char* aTexName, struct TextureInfo* aOutTexInfo) {
         for (DataNode<TexData>* _Node : DynosValidTextures()) { // check valid textures
             if (_Node->mName == aTexName) {
                 auto& _Data = _Node->mData;
+                DynOS_Tex_Decode_Ensure(_Data);
                 CONVERT_TEXINFO();
                 return true;
             }
@@ -456,7 +456,13 @@ struct TextureInfo
 #define PLAY_MODE_CHANGE_LEVEL 4
 #define PLAY_MODE_FRAME_ADVANCE 5
 
+// can be raised at build time with MAX_PLAYERS=N, up to 64
+#ifndef MAX_PLAYERS
 #define MAX_PLAYERS 16
+#endif
+
+// one bit per local player index
+typedef u64 NetworkPlayerMask;
 
 #define COOP_OBJ_FLAG_NETWORK     (1 << 0)
 #define COOP_OBJ_FLAG_LUA         (1 << 1)
@@ -71,6 +71,47 @@ struct SequenceQueueItem {
     u8 priority;
 }; // size = 0x2
 
+// Game-side requests that change the audio state, marshalled to whichever thread runs synthesis
+enum AudioCommandType {
+    AUDIO_COMMAND_PLAY_SOUND,
+    AUDIO_COMMAND_STOP_SOUND,
+    AUDIO_COMMAND_STOP_SOUNDS_FROM_SOURCE,
+    AUDIO_COMMAND_STOP_SOUNDS_IN_CONTINUOUS_BANKS,
+    AUDIO_COMMAND_SOUND_BANKS_DISABLE,
+    AUDIO_COMMAND_SOUND_BANKS_ENABLE,
+    AUDIO_COMMAND_SEQ_PLAYER_FADE_OUT,
+    AUDIO_COMMAND_FADE_VOLUME_SCALE,
+    AUDIO_COMMAND_SEQ_PLAYER_LOWER_VOLUME,
+    AUDIO_COMMAND_SEQ_PLAYER_UNLOWER_VOLUME,
+    AUDIO_COMMAND_SET_AUDIO_MUTED,
+    AUDIO_COMMAND_PLAY_MUSIC,
+    AUDIO_COMMAND_STOP_BACKGROUND_MUSIC,
+    AUDIO_COMMAND_FADEOUT_BACKGROUND_MUSIC,
+    AUDIO_COMMAND_DROP_QUEUED_BACKGROUND_MUSIC,
+    AUDIO_COMMAND_PLAY_SECONDARY_MUSIC,
+    AUDIO_COMMAND_STOP_SECONDARY_MUSIC,
+    AUDIO_COMMAND_SET_AUDIO_FADEOUT,
+    AUDIO_COMMAND_PLAY_SEQUENCE,
+    AUDIO_COMMAND_PLAY_JINGLE,
+    AUDIO_COMMAND_SET_SOUND_MOVING_SPEED,
+    AUDIO_COMMAND_SET_SOUND_MODE,
+    AUDIO_COMMAND_SET_BACKGROUND_MUSIC_DEFAULT_VOLUME,
+    AUDIO_COMMAND_RESET_BACKGROUND_MUSIC_DEFAULT_VOLUME,
+    AUDIO_COMMAND_SOUND_RESET,
+};
+
+struct AudioCommand {
+    u8 type;
+    u8 u8Args[3];
+    u16 u16Args[2];
+    u32 bits;
+    f32 *pos;
+    f32 scale;
+};
+
+// must be a power of two
+#define AUDIO_COMMAND_RING_SIZE 1024
+
 // data
 #if defined(VERSION_EU) || defined(VERSION_SH)
 // moved to bss in data.c
@@ -490,6 +531,10 @@ static void fade_channel_volume_scale(u8 player, u8 channelId, u8 targetScale, u
 void process_level_music_dynamics(void);
 static u8 begin_background_music_fade(u16 fadeDuration);
 void fade_in_env_music(void);
+static void sound_banks_enable_internal(u16 bankMask);
+static void stop_background_music_internal(u16 seqId);
+static void audio_command_submit(struct AudioCommand *cmd);
+static void audio_command_process(void);
 
 static s16 get_level_dynamics(s16 levelNum, s16 index) {
     if (levelNum < 0 || levelNum >= LEVEL_COUNT) {
@@ -790,6 +835,8 @@ extern void func_sh_802F64C8(void);
  * Called from threads: thread5_game_loop
  */
 void maybe_tick_game_sound(void) {
+    // the game loop drives sound here, so it consumes its own commands
+    audio_command_flush();
     if (sGameLoopTicked != 0) {
         update_game_sound();
         sGameLoopTicked = 0;
@@ -817,6 +864,7 @@ struct SPTask *create_next_audio_frame_task(void) {
 }
 
 void create_next_audio_buffer(s16 *samples, u32 num_samples) {
+    audio_command_process();
     gAudioFrameCount++;
     if (sGameLoopTicked != 0) {
         update_game_sound();
@@ -835,29 +883,24 @@ void create_next_audio_buffer(s16 *samples, u32 num_samples) {
 extern f32 *smlua_get_vec3f_for_play_sound(f32 *pos);
 
 void play_sound(s32 soundBits, f32 *pos) {
-    MUTEX_LOCK(gAudioThread);
-    
-    pos = smlua_get_vec3f_for_play_sound(pos);
-    smlua_call_event_hooks_on_play_sound(HOOK_ON_PLAY_SOUND, soundBits, pos, &soundBits);
-    sSoundRequests[sSoundRequestCount].soundBits = soundBits;
-    sSoundRequests[sSoundRequestCount].position = pos;
-    sSoundRequests[sSoundRequestCount].customFreqScale = 0;
-    sSoundRequestCount++;
-    
-    MUTEX_UNLOCK(gAudioThread);
+    play_sound_with_freq_scale(soundBits, pos, 0);
 }
 
 void play_sound_with_freq_scale(s32 soundBits, f32* pos, f32 freqScale) {
-    MUTEX_LOCK(gAudioThread);
-    
     pos = smlua_get_vec3f_for_play_sound(pos);
     smlua_call_event_hooks_on_play_sound(HOOK_ON_PLAY_SOUND, soundBits, pos, &soundBits);
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_PLAY_SOUND, .bits = soundBits, .pos = pos, .scale = freqScale };
+    audio_command_submit(&cmd);
+}
+
+/**
+ * Called from threads: thread4_sound
+ */
+static void play_sound_internal(u32 soundBits, f32 *pos, f32 freqScale) {
     sSoundRequests[sSoundRequestCount].soundBits = soundBits;
     sSoundRequests[sSoundRequestCount].position = pos;
     sSoundRequests[sSoundRequestCount].customFreqScale = freqScale;
     sSoundRequestCount++;
-    
-    MUTEX_UNLOCK(gAudioThread);
 }
 
 /**
@@ -994,9 +1037,9 @@ static void delete_sound_from_bank(u8 bank, u8 soundIndex) {
  * Called from threads: thread3_main, thread4_sound, thread5_game_loop
  */
 static void update_background_music_after_sound(u8 bank, u8 soundIndex) {
+    if (bank >= SOUND_BANK_COUNT || soundIndex >= SOUND_INDEX_COUNT) { return; }
     MUTEX_LOCK(gAudioThread);
     
-    if (bank >= SOUND_BANK_COUNT || soundIndex >= SOUND_INDEX_COUNT) { return; }
     if (sSoundBanks[bank][soundIndex].soundBits & SOUND_LOWER_BACKGROUND_MUSIC) {
         sSoundBanksThatLowerBackgroundMusic &= (1 << bank) ^ 0xffff;
         begin_background_music_fade(50);
@@ -1773,9 +1816,9 @@ static void update_game_sound(void) {
  * Called from threads: thread4_sound, thread5_game_loop
  */
 static void seq_player_play_sequence(u8 player, u8 seqId, u16 arg2) {
+    if (player >= SEQUENCE_PLAYERS) { return; }
     MUTEX_LOCK(gAudioThread);
     
-    if (player >= SEQUENCE_PLAYERS) { return; }
     u8 targetVolume;
     u8 i;
 
@@ -1822,9 +1865,7 @@ static void seq_player_play_sequence(u8 player, u8 seqId, u16 arg2) {
 /**
  * Called from threads: thread5_game_loop
  */
-void seq_player_fade_out(u8 player, u16 fadeDuration) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void seq_player_fade_out_internal(u8 player, u16 fadeDuration) {
     if (player >= SEQUENCE_PLAYERS) { return; }
 #if defined(VERSION_EU) || defined(VERSION_SH)
 #ifdef VERSION_EU
@@ -1842,29 +1883,36 @@ void seq_player_fade_out(u8 player, u16 fadeDuration) {
     }
     seq_player_fade_to_zero_volume(player, fadeDuration);
 #endif
+}
 
-    MUTEX_UNLOCK(gAudioThread);
+void seq_player_fade_out(u8 player, u16 fadeDuration) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SEQ_PLAYER_FADE_OUT, .u8Args = { player }, .u16Args = { fadeDuration } };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void fade_volume_scale(u8 player, u8 targetScale, u16 fadeDuration) {
+static void fade_volume_scale_internal(u8 player, u8 targetScale, u16 fadeDuration) {
     u8 i;
     for (i = 0; i < CHANNELS_MAX; i++) {
         fade_channel_volume_scale(player, i, targetScale, fadeDuration);
     }
 }
 
+void fade_volume_scale(u8 player, u8 targetScale, u16 fadeDuration) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_FADE_VOLUME_SCALE, .u8Args = { player, targetScale }, .u16Args = { fadeDuration } };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread3_main, thread4_sound, thread5_game_loop
  */
 static void fade_channel_volume_scale(u8 player, u8 channelIndex, u8 targetScale, u16 fadeDuration) {
-    MUTEX_LOCK(gAudioThread);
-    
     struct ChannelVolumeScaleFade *temp;
     if (player >= SEQUENCE_PLAYERS) { return; }
     if (channelIndex >= CHANNELS_MAX) { return; }
+    MUTEX_LOCK(gAudioThread);
 
     if (gSequencePlayers[player].channels[channelIndex] != &gSequenceChannelNone) {
         temp = &sVolumeScaleFades[player][channelIndex];
@@ -2082,9 +2130,7 @@ void unused_8031FED0(u8 player, u32 bits, s8 arg2) {
  *
  * Called from threads: thread5_game_loop
  */
-void seq_player_lower_volume(u8 player, u16 fadeDuration, u8 percentage) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void seq_player_lower_volume_internal(u8 player, u16 fadeDuration, u8 percentage) {
     if (player >= SEQUENCE_PLAYERS) { return; }
     if (player == SEQ_PLAYER_LEVEL) {
         sLowerBackgroundMusicVolume = TRUE;
@@ -2092,8 +2138,11 @@ void seq_player_lower_volume(u8 player, u16 fadeDuration, u8 percentage) {
     } else if (gSequencePlayers[player].enabled == TRUE) {
         seq_player_fade_to_percentage_of_volume(player, fadeDuration, percentage);
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void seq_player_lower_volume(u8 player, u16 fadeDuration, u8 percentage) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SEQ_PLAYER_LOWER_VOLUME, .u8Args = { player, percentage }, .u16Args = { fadeDuration } };
+    audio_command_submit(&cmd);
 }
 
 /**
@@ -2104,9 +2153,7 @@ void seq_player_lower_volume(u8 player, u16 fadeDuration, u8 percentage) {
  *
  * Called from threads: thread5_game_loop
  */
-void seq_player_unlower_volume(u8 player, u16 fadeDuration) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void seq_player_unlower_volume_internal(u8 player, u16 fadeDuration) {
     if (player >= SEQUENCE_PLAYERS) { return; }
     sLowerBackgroundMusicVolume = FALSE;
     if (player == SEQ_PLAYER_LEVEL) {
@@ -2118,8 +2165,11 @@ void seq_player_unlower_volume(u8 player, u16 fadeDuration) {
             seq_player_fade_to_normal_volume(player, fadeDuration);
         }
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void seq_player_unlower_volume(u8 player, u16 fadeDuration) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SEQ_PLAYER_UNLOWER_VOLUME, .u8Args = { player }, .u16Args = { fadeDuration } };
+    audio_command_submit(&cmd);
 }
 
 /**
@@ -2184,9 +2234,7 @@ static u8 begin_background_music_fade(u16 fadeDuration) {
 /**
  * Called from threads: thread5_game_loop
  */
-void set_audio_muted(u8 muted) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void set_audio_muted_internal(u8 muted) {
     u8 i;
 
     for (i = 0; i < SEQUENCE_PLAYERS; i++) {
@@ -2199,8 +2247,11 @@ void set_audio_muted(u8 muted) {
         gSequencePlayers[i].muted = muted;
 #endif
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void set_audio_muted(u8 muted) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SET_AUDIO_MUTED, .u8Args = { muted } };
+    audio_command_submit(&cmd);
 }
 
 /**
@@ -2252,7 +2303,7 @@ void sound_init(void) {
         sBackgroundMusicQueue[i].priority = 0;
     }
 
-    sound_banks_enable(SEQ_PLAYER_SFX, SOUND_BANKS_ALL_BITS);
+    sound_banks_enable_internal(SOUND_BANKS_ALL_BITS);
 
     sUnused80332118 = 0;
     sBackgroundMusicTargetVolume = TARGET_VOLUME_UNSET;
@@ -2296,10 +2347,7 @@ void get_currently_playing_sound(u8 bank, u8 *numPlayingSounds, u8 *numSoundsInB
 /**
  * Called from threads: thread5_game_loop
  */
-void stop_sound(u32 soundBits, f32 *pos) {
-    MUTEX_LOCK(gAudioThread);
-    
-    pos = smlua_get_vec3f_for_play_sound(pos);
+static void stop_sound_internal(u32 soundBits, f32 *pos) {
     u8 bank = (soundBits & SOUNDARGS_MASK_BANK) >> SOUNDARGS_SHIFT_BANK;
     if (bank >= SOUND_BANK_COUNT) { return; }
     u8 soundIndex = sSoundBanks[bank][0].next;
@@ -2321,17 +2369,17 @@ void stop_sound(u32 soundBits, f32 *pos) {
             soundIndex = sSoundBanks[bank][soundIndex].next;
         }
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void stop_sound(u32 soundBits, f32 *pos) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_STOP_SOUND, .bits = soundBits, .pos = smlua_get_vec3f_for_play_sound(pos) };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void stop_sounds_from_source(f32 *pos) {
-    MUTEX_LOCK(gAudioThread);
-    
-    pos = smlua_get_vec3f_for_play_sound(pos);
+static void stop_sounds_from_source_internal(f32 *pos) {
     u8 bank;
     u8 soundIndex;
 
@@ -2345,17 +2393,20 @@ void stop_sounds_from_source(f32 *pos) {
             soundIndex = sSoundBanks[bank][soundIndex].next;
         }
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void stop_sounds_from_source(f32 *pos) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_STOP_SOUNDS_FROM_SOURCE, .pos = smlua_get_vec3f_for_play_sound(pos) };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread3_main, thread5_game_loop
  */
 static void stop_sounds_in_bank(u8 bank) {
+    if (bank >= SOUND_BANK_COUNT) { return; }
     MUTEX_LOCK(gAudioThread);
     
-    if (bank >= SOUND_BANK_COUNT) { return; }
     u8 soundIndex = sSoundBanks[bank][0].next;
 
     while (soundIndex != 0xff) {
@@ -2374,18 +2425,21 @@ static void stop_sounds_in_bank(u8 bank) {
  *
  * Called from threads: thread3_main, thread5_game_loop
  */
-void stop_sounds_in_continuous_banks(void) {
+static void stop_sounds_in_continuous_banks_internal(void) {
     stop_sounds_in_bank(SOUND_BANK_MOVING);
     stop_sounds_in_bank(SOUND_BANK_ENV);
     stop_sounds_in_bank(SOUND_BANK_AIR);
 }
 
+void stop_sounds_in_continuous_banks(void) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_STOP_SOUNDS_IN_CONTINUOUS_BANKS };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread3_main, thread5_game_loop
  */
-void sound_banks_disable(UNUSED u8 player, u16 bankMask) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void sound_banks_disable_internal(u16 bankMask) {
     u8 i;
 
     for (i = 0; i < SOUND_BANK_COUNT; i++) {
@@ -2394,8 +2448,11 @@ void sound_banks_disable(UNUSED u8 player, u16 bankMask) {
         }
         bankMask = bankMask >> 1;
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void sound_banks_disable(UNUSED u8 player, u16 bankMask) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SOUND_BANKS_DISABLE, .u16Args = { bankMask } };
+    audio_command_submit(&cmd);
 }
 
 /**
@@ -2416,9 +2473,7 @@ static void disable_all_sequence_players(void) {
 /**
  * Called from threads: thread5_game_loop
  */
-void sound_banks_enable(UNUSED u8 player, u16 bankMask) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void sound_banks_enable_internal(u16 bankMask) {
     u8 i;
 
     for (i = 0; i < SOUND_BANK_COUNT; i++) {
@@ -2427,8 +2482,11 @@ void sound_banks_enable(UNUSED u8 player, u16 bankMask) {
         }
         bankMask = bankMask >> 1;
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void sound_banks_enable(UNUSED u8 player, u16 bankMask) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SOUND_BANKS_ENABLE, .u16Args = { bankMask } };
+    audio_command_submit(&cmd);
 }
 
 u8 unused_803209D8(u8 player, u8 channelIndex, u8 arg2) {
@@ -2447,11 +2505,16 @@ u8 unused_803209D8(u8 player, u8 channelIndex, u8 arg2) {
  *
  * Called from threads: thread5_game_loop
  */
-void set_sound_moving_speed(u8 bank, u8 speed) {
+static void set_sound_moving_speed_internal(u8 bank, u8 speed) {
     if (bank >= SOUND_BANK_COUNT) { return; }
     sSoundMovingSpeed[bank] = speed;
 }
 
+void set_sound_moving_speed(u8 bank, u8 speed) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SET_SOUND_MOVING_SPEED, .u8Args = { bank, speed } };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread5_game_loop
  */
@@ -2470,7 +2533,8 @@ void play_dialog_sound(u8 dialogID) {
         // Play music during bowser message that appears when first entering the
         // castle or when trying to enter a door without enough stars
         if (speaker == DS_BOWS1) {
-            seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_KOOPA_MESSAGE, 0);
+            struct AudioCommand cmd = { .type = AUDIO_COMMAND_PLAY_SEQUENCE, .u8Args = { SEQ_PLAYER_ENV, SEQ_EVENT_KOOPA_MESSAGE } };
+            audio_command_submit(&cmd);
         }
     }
 
@@ -2504,9 +2568,7 @@ void set_sequence_player_volume(s32 player, f32 volume) {
 /**
  * Called from threads: thread5_game_loop
  */
-void play_music(u8 player, u16 seqArgs, u16 fadeTimer) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void play_music_internal(u8 player, u16 seqArgs, u16 fadeTimer) {
     if (player >= SEQUENCE_PLAYERS) { return; }
     u8 seqId = seqArgs & 0xff;
     u8 priority = seqArgs >> 8;
@@ -2536,7 +2598,7 @@ void play_music(u8 player, u16 seqArgs, u16 fadeTimer) {
             if (i == 0) {
                 seq_player_play_sequence(SEQ_PLAYER_LEVEL, seqId, fadeTimer);
             } else if (!gSequencePlayers[SEQ_PLAYER_LEVEL].enabled) {
-                stop_background_music(sBackgroundMusicQueue[0].seqId);
+                stop_background_music_internal(sBackgroundMusicQueue[0].seqId);
             }
             //LOG_DEBUG("Sequence 0x%X is already in the background music queue!", seqId);
             return;
@@ -2569,16 +2631,17 @@ void play_music(u8 player, u16 seqArgs, u16 fadeTimer) {
     // Insert item into queue.
     sBackgroundMusicQueue[foundIndex].priority = priority;
     sBackgroundMusicQueue[foundIndex].seqId = seqId;
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void play_music(u8 player, u16 seqArgs, u16 fadeTimer) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_PLAY_MUSIC, .u8Args = { player }, .u16Args = { seqArgs, fadeTimer } };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void stop_background_music(u16 seqId) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void stop_background_music_internal(u16 seqId) {
     u8 foundIndex;
     u8 i;
 
@@ -2617,7 +2680,7 @@ void stop_background_music(u16 seqId) {
                 if (sBackgroundMusicQueueSize != 0) {
                     seq_player_play_sequence(SEQ_PLAYER_LEVEL, sBackgroundMusicQueue[1].seqId, 0);
                 } else {
-                    seq_player_fade_out(SEQ_PLAYER_LEVEL, 20);
+                    seq_player_fade_out_internal(SEQ_PLAYER_LEVEL, 20);
                 }
             }
             foundIndex = i;
@@ -2634,28 +2697,41 @@ void stop_background_music(u16 seqId) {
     // @bug? If the sequence queue is full and we attempt to stop a sequence
     // that isn't in the queue, this writes out of bounds. Can that happen?
     sBackgroundMusicQueue[i].priority = 0;
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void stop_background_music(u16 seqId) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_STOP_BACKGROUND_MUSIC, .u16Args = { seqId } };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void fadeout_background_music(u16 seqId, u16 fadeOut) {
+static void fadeout_background_music_internal(u16 seqId, u16 fadeOut) {
     if (sBackgroundMusicQueueSize != 0 && sBackgroundMusicQueue[0].seqId == (u8)(seqId & 0xff)) {
-        seq_player_fade_out(SEQ_PLAYER_LEVEL, fadeOut);
+        seq_player_fade_out_internal(SEQ_PLAYER_LEVEL, fadeOut);
     }
 }
 
+void fadeout_background_music(u16 seqId, u16 fadeOut) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_FADEOUT_BACKGROUND_MUSIC, .u16Args = { seqId, fadeOut } };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread5_game_loop
  */
-void drop_queued_background_music(void) {
+static void drop_queued_background_music_internal(void) {
     if (sBackgroundMusicQueueSize != 0) {
         sBackgroundMusicQueueSize = 1;
     }
 }
 
+void drop_queued_background_music(void) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_DROP_QUEUED_BACKGROUND_MUSIC };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread5_game_loop
  */
@@ -2718,9 +2794,7 @@ void fade_in_env_music(void) {
 /**
  * Called from threads: thread5_game_loop
  */
-void play_secondary_music(u8 seqId, u8 bgMusicVolume, u8 volume, u16 fadeTimer) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void play_secondary_music_internal(u8 seqId, u8 bgMusicVolume, u8 volume, u16 fadeTimer) {
     UNUSED u32 dummy;
 
     sUnused80332118 = 0;
@@ -2743,29 +2817,35 @@ void play_secondary_music(u8 seqId, u8 bgMusicVolume, u8 volume, u16 fadeTimer)
         seq_player_fade_to_target_volume(SEQ_PLAYER_ENV, fadeTimer, volume);
         sCurrentSecondaryMusicVolume = volume;
     }
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void play_secondary_music(u8 seqId, u8 bgMusicVolume, u8 volume, u16 fadeTimer) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_PLAY_SECONDARY_MUSIC, .u8Args = { seqId, bgMusicVolume, volume }, .u16Args = { fadeTimer } };
+    audio_command_submit(&cmd);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void stop_secondary_music(u16 fadeTimer) {
+static void stop_secondary_music_internal(u16 fadeTimer) {
     if (sBackgroundMusicTargetVolume != TARGET_VOLUME_UNSET) {
         sBackgroundMusicTargetVolume = TARGET_VOLUME_UNSET;
         sCurrentSecondaryMusicSeqId = 0;
         sCurrentSecondaryMusicVolume = 0;
         begin_background_music_fade(fadeTimer);
-        seq_player_fade_out(SEQ_PLAYER_ENV, fadeTimer);
+        seq_player_fade_out_internal(SEQ_PLAYER_ENV, fadeTimer);
     }
 }
 
+void stop_secondary_music(u16 fadeTimer) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_STOP_SECONDARY_MUSIC, .u16Args = { fadeTimer } };
+    audio_command_submit(&cmd);
+}
+
 /**
  * Called from threads: thread3_main, thread5_game_loop
  */
-void set_audio_fadeout(u16 fadeDuration) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void set_audio_fadeout_internal(u16 fadeDuration) {
     if (sHasStartedFadeOut) {
         return;
     }
@@ -2793,32 +2873,47 @@ void set_audio_fadeout(u16 fadeDuration) {
     }
 
     sHasStartedFadeOut = TRUE;
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void set_audio_fadeout(u16 fadeDuration) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SET_AUDIO_FADEOUT, .u16Args = { fadeDuration } };
+    audio_command_submit(&cmd);
 }
 
 /**
- * Called from threads: thread5_game_loop
+ * Plays a jingle on the env player and ducks the background music under it.
+ *
+ * Called from threads: thread4_sound, thread5_game_loop
  */
-void play_course_clear(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_CUTSCENE_COLLECT_STAR, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 0;
+static void play_jingle_internal(u8 seqId, u8 maxTargetVolume, u8 keepBackgroundMusic) {
+    if (!keepBackgroundMusic) {
+        sBackgroundMusicTargetVolume = 0;
+    }
+    seq_player_play_sequence(SEQ_PLAYER_ENV, seqId, 0);
+    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | maxTargetVolume;
 #if defined(VERSION_EU) || defined(VERSION_SH)
     sRemainingEnvFadeInSkips = 2;
 #endif
     begin_background_music_fade(50);
 }
 
+static void play_jingle(u8 seqId, u8 maxTargetVolume, u8 keepBackgroundMusic) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_PLAY_JINGLE, .u8Args = { seqId, maxTargetVolume, keepBackgroundMusic } };
+    audio_command_submit(&cmd);
+}
+
+/**
+ * Called from threads: thread5_game_loop
+ */
+void play_course_clear(void) {
+    play_jingle(SEQ_EVENT_CUTSCENE_COLLECT_STAR, 0, TRUE);
+}
+
 /**
  * Called from threads: thread5_game_loop
  */
 void play_peachs_jingle(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_PEACH_MESSAGE, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 0;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_PEACH_MESSAGE, 0, TRUE);
 }
 
 /**
@@ -2829,71 +2924,41 @@ void play_peachs_jingle(void) {
  * Called from threads: thread5_game_loop
  */
 void play_puzzle_jingle(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_SOLVE_PUZZLE, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 20;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_SOLVE_PUZZLE, 20, TRUE);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
 void play_star_fanfare(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_HIGH_SCORE, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 20;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_HIGH_SCORE, 20, TRUE);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
 void play_power_star_jingle(u8 keepBackgroundMusic) {
-    if (!keepBackgroundMusic) {
-        sBackgroundMusicTargetVolume = 0;
-    }
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_CUTSCENE_STAR_SPAWN, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 20;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_CUTSCENE_STAR_SPAWN, 20, keepBackgroundMusic);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
 void play_race_fanfare(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_RACE, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 20;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_RACE, 20, TRUE);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
 void play_toads_jingle(void) {
-    seq_player_play_sequence(SEQ_PLAYER_ENV, SEQ_EVENT_TOAD_MESSAGE, 0);
-    sBackgroundMusicMaxTargetVolume = TARGET_VOLUME_IS_PRESENT_FLAG | 20;
-#if defined(VERSION_EU) || defined(VERSION_SH)
-    sRemainingEnvFadeInSkips = 2;
-#endif
-    begin_background_music_fade(50);
+    play_jingle(SEQ_EVENT_TOAD_MESSAGE, 20, TRUE);
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void sound_reset(u8 presetId) {
-    MUTEX_LOCK(gAudioThread);
-    
+static void sound_reset_internal(u8 presetId) {
 #ifndef VERSION_JP
     if (presetId >= 8) {
         presetId = 0;
@@ -2921,18 +2986,29 @@ void sound_reset(u8 presetId) {
     D_80332108 = (D_80332108 & 0xf0) + presetId;
     gSoundMode = D_80332108 >> 4;
     sHasStartedFadeOut = FALSE;
-    
-    MUTEX_UNLOCK(gAudioThread);
+}
+
+void sound_reset(u8 presetId) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SOUND_RESET, .u8Args = { presetId } };
+    audio_command_submit(&cmd);
+
+    // the game loads and plays sequences right after a reset, so wait for it
+    audio_command_flush();
 }
 
 /**
  * Called from threads: thread5_game_loop
  */
-void audio_set_sound_mode(u8 soundMode) {
+static void audio_set_sound_mode_internal(u8 soundMode) {
     D_80332108 = (D_80332108 & 0xf) + (soundMode << 4);
     gSoundMode = soundMode;
 }
 
+void audio_set_sound_mode(u8 soundMode) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SET_SOUND_MODE, .u8Args = { soundMode } };
+    audio_command_submit(&cmd);
+}
+
 #if defined(VERSION_JP) || defined(VERSION_US)
 void unused_80321460(UNUSED s32 arg0, UNUSED s32 arg1, UNUSED s32 arg2, UNUSED s32 arg3) {
 }
@@ -2940,7 +3016,7 @@ void unused_80321460(UNUSED s32 arg0, UNUSED s32 arg1, UNUSED s32 arg2, UNUSED s
 void unused_80321474(UNUSED s32 arg0) {
 }
 
-void sound_reset_background_music_default_volume(u8 seqId) {
+static void sound_reset_background_music_default_volume_internal(u8 seqId) {
     if (seqId >= sizeof(sBackgroundMusicDefaultVolume) / sizeof(sBackgroundMusicDefaultVolume[0])) { return; }
     if (seqId >= SEQ_EVENT_CUTSCENE_LAKITU) {
         sBackgroundMusicDefaultVolume[seqId] = 75;
@@ -2949,11 +3025,21 @@ void sound_reset_background_music_default_volume(u8 seqId) {
     sBackgroundMusicDefaultVolume[seqId] = sBackgroundMusicDefaultVolumeDefault[seqId];
 }
 
-void sound_set_background_music_default_volume(u8 seqId, u8 volume) {
+void sound_reset_background_music_default_volume(u8 seqId) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_RESET_BACKGROUND_MUSIC_DEFAULT_VOLUME, .u8Args = { seqId } };
+    audio_command_submit(&cmd);
+}
+
+static void sound_set_background_music_default_volume_internal(u8 seqId, u8 volume) {
     if (seqId >= MAX_AUDIO_OVERRIDE) { return; }
     sBackgroundMusicDefaultVolume[seqId] = volume;
 }
 
+void sound_set_background_music_default_volume(u8 seqId, u8 volume) {
+    struct AudioCommand cmd = { .type = AUDIO_COMMAND_SET_BACKGROUND_MUSIC_DEFAULT_VOLUME, .u8Args = { seqId, volume } };
+    audio_command_submit(&cmd);
+}
+
 #endif
 
 f32 sound_get_level_intensity(f32 distance) {
@@ -2972,3 +3058,100 @@ f32 sound_get_level_intensity(f32 distance) {
 
     return volumeRange * intensity * intensity + 1.0f - volumeRange;
 }
+
+  ///////////////////
+ // audio command //
+///////////////////
+
+// Single producer (the game thread), single consumer (whoever holds gAudioThread's mutex).
+// The game thread only ever consumes while holding the mutex, so consumers never overlap.
+static struct AudioCommand sAudioCommands[AUDIO_COMMAND_RING_SIZE];
+static u32 sAudioCommandHead = 0;
+static u32 sAudioCommandTail = 0;
+static bool sAudioCommandFlushing = false;
+
+static void audio_command_execute(struct AudioCommand *cmd) {
+    switch (cmd->type) {
+        case AUDIO_COMMAND_PLAY_SOUND: play_sound_internal(cmd->bits, cmd->pos, cmd->scale); break;
+        case AUDIO_COMMAND_STOP_SOUND: stop_sound_internal(cmd->bits, cmd->pos); break;
+        case AUDIO_COMMAND_STOP_SOUNDS_FROM_SOURCE: stop_sounds_from_source_internal(cmd->pos); break;
+        case AUDIO_COMMAND_STOP_SOUNDS_IN_CONTINUOUS_BANKS: stop_sounds_in_continuous_banks_internal(); break;
+        case AUDIO_COMMAND_SOUND_BANKS_DISABLE: sound_banks_disable_internal(cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_SOUND_BANKS_ENABLE: sound_banks_enable_internal(cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_SEQ_PLAYER_FADE_OUT: seq_player_fade_out_internal(cmd->u8Args[0], cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_FADE_VOLUME_SCALE: fade_volume_scale_internal(cmd->u8Args[0], cmd->u8Args[1], cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_SEQ_PLAYER_LOWER_VOLUME: seq_player_lower_volume_internal(cmd->u8Args[0], cmd->u16Args[0], cmd->u8Args[1]); break;
+        case AUDIO_COMMAND_SEQ_PLAYER_UNLOWER_VOLUME: seq_player_unlower_volume_internal(cmd->u8Args[0], cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_SET_AUDIO_MUTED: set_audio_muted_internal(cmd->u8Args[0]); break;
+        case AUDIO_COMMAND_PLAY_MUSIC: play_music_internal(cmd->u8Args[0], cmd->u16Args[0], cmd->u16Args[1]); break;
+        case AUDIO_COMMAND_STOP_BACKGROUND_MUSIC: stop_background_music_internal(cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_FADEOUT_BACKGROUND_MUSIC: fadeout_background_music_internal(cmd->u16Args[0], cmd->u16Args[1]); break;
+        case AUDIO_COMMAND_DROP_QUEUED_BACKGROUND_MUSIC: drop_queued_background_music_internal(); break;
+        case AUDIO_COMMAND_PLAY_SECONDARY_MUSIC: play_secondary_music_internal(cmd->u8Args[0], cmd->u8Args[1], cmd->u8Args[2], cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_STOP_SECONDARY_MUSIC: stop_secondary_music_internal(cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_SET_AUDIO_FADEOUT: set_audio_fadeout_internal(cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_PLAY_SEQUENCE: seq_player_play_sequence(cmd->u8Args[0], cmd->u8Args[1], cmd->u16Args[0]); break;
+        case AUDIO_COMMAND_PLAY_JINGLE: play_jingle_internal(cmd->u8Args[0], cmd->u8Args[1], cmd->u8Args[2]); break;
+        case AUDIO_COMMAND_SET_SOUND_MOVING_SPEED: set_sound_moving_speed_internal(cmd->u8Args[0], cmd->u8Args[1]); break;
+        case AUDIO_COMMAND_SET_SOUND_MODE: audio_set_sound_mode_internal(cmd->u8Args[0]); break;
+#if defined(VERSION_JP) || defined(VERSION_US)
+        case AUDIO_COMMAND_SET_BACKGROUND_MUSIC_DEFAULT_VOLUME: sound_set_background_music_default_volume_internal(cmd->u8Args[0], cmd->u8Args[1]); break;
+        case AUDIO_COMMAND_RESET_BACKGROUND_MUSIC_DEFAULT_VOLUME: sound_reset_background_music_default_volume_internal(cmd->u8Args[0]); break;
+#endif
+        case AUDIO_COMMAND_SOUND_RESET: sound_reset_internal(cmd->u8Args[0]); break;
+    }
+}
+
+/**
+ * Runs every pending command in order. The caller must hold gAudioThread's mutex.
+ *
+ * Called from threads: thread4_sound, thread5_game_loop
+ */
+static void audio_command_process(void) {
+    u32 tail = sAudioCommandTail;
+    u32 head = __atomic_load_n(&sAudioCommandHead, __ATOMIC_ACQUIRE);
+    while (tail != head) {
+        audio_command_execute(&sAudioCommands[tail & (AUDIO_COMMAND_RING_SIZE - 1)]);
+        tail++;
+    }
+    __atomic_store_n(&sAudioCommandTail, tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * Drains the ring from the game thread, used when the game needs the audio
+ * state to be caught up before touching it directly.
+ *
+ * Called from threads: thread5_game_loop
+ */
+void audio_command_flush(void) {
+    if (gAudioThread.state != RUNNING) { return; }
+    lock_mutex(&gAudioThread);
+    sAudioCommandFlushing = true;
+    audio_command_process();
+    sAudioCommandFlushing = false;
+    unlock_mutex(&gAudioThread);
+}
+
+/**
+ * Queues the command for the audio thread, or runs it in place when there is
+ * no audio thread or the caller is already updating the audio state.
+ *
+ * Called from threads: thread4_sound, thread5_game_loop
+ */
+static void audio_command_submit(struct AudioCommand *cmd) {
+    if (gAudioThread.state != RUNNING || pthread_equal(pthread_self(), gAudioThread.thread) || sAudioCommandFlushing) {
+        MUTEX_LOCK(gAudioThread);
+        audio_command_execute(cmd);
+        MUTEX_UNLOCK(gAudioThread);
+        return;
+    }
+
+    u32 head = sAudioCommandHead;
+    if (head - __atomic_load_n(&sAudioCommandTail, __ATOMIC_ACQUIRE) >= AUDIO_COMMAND_RING_SIZE) {
+        // the audio thread fell behind, catch it up rather than reorder or drop commands
+        audio_command_flush();
+    }
+
+    sAudioCommands[head & (AUDIO_COMMAND_RING_SIZE - 1)] = *cmd;
+    __atomic_store_n(&sAudioCommandHead, head + 1, __ATOMIC_RELEASE);
+}
@@ -130,6 +130,7 @@ void play_race_fanfare(void);
 void play_toads_jingle(void);
 void sound_reset(u8 presetId);
 void audio_set_sound_mode(u8 arg0);
+void audio_command_flush(void);
 
 void audio_init(void); // in load.c
 
@@ -9,6 +9,11 @@
 
 #include "../pc/mixer.h"
 
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
 #ifndef VERSION_SH
 #define DMEM_ADDR_TEMP 0x0
 #define DMEM_ADDR_RESAMPLED 0x20
@@ -69,8 +74,11 @@ u64 *process_envelope(u64 *cmd, struct NoteSubEu *noteSubEu, struct NoteSynthesi
 u64 *note_apply_headset_pan_effects(u64 *cmd, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *note, s32 bufLen, s32 flags, s32 leftRight);
 #else
 u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd);
-u64 *load_wave_samples(u64 *cmd, struct Note *note, s32 nSamplesToLoad);
-u64 *final_resample(u64 *cmd, struct Note *note, s32 count, u16 pitch, u16 dmemIn, u32 flags);
+// The note load step takes the mixer dmem it runs on and is inlined into its
+// callers, so the serial path's constant NULL compiles down to the shared one
+#define SYNTHESIS_LOAD_INLINE inline __attribute__((always_inline))
+static SYNTHESIS_LOAD_INLINE u64 *load_wave_samples(struct MixerDmem *dmem, u64 *cmd, struct Note *note, s32 nSamplesToLoad);
+static SYNTHESIS_LOAD_INLINE u64 *final_resample(struct MixerDmem *dmem, u64 *cmd, struct Note *note, s32 count, u16 pitch, u16 dmemIn, u32 flags);
 u64 *process_envelope(u64 *cmd, struct Note *note, s32 nSamples, u16 inBuf, s32 headsetPanSettings,
                       u32 flags);
 u64 *process_envelope_inner(u64 *cmd, struct Note *note, s32 nSamples, u16 inBuf,
@@ -759,19 +767,60 @@ u64 *synthesis_do_one_audio_update(s16 *aiBuf, s32 bufLen, u64 *cmd, s32 updateI
 #endif
 
 #ifndef VERSION_SH
+#if defined(VERSION_JP) || defined(VERSION_US)
+// Notes are decoded and resampled on a few workers that each own a private DMEM,
+// then enveloped into the shared mix bus one at a time in note order. The mix
+// saturates, so keeping that last step serial keeps the output bit-identical.
+#define SYNTHESIS_WORKERS 3
+#define SYNTHESIS_PARALLEL_MIN_NOTES 8
+#define SYNTHESIS_MAX_JOBS 128
+
+struct SynthesisJob {
+    struct Note *note;
+    s32 flags;
+    s16 samples[DEFAULT_LEN_1CH / sizeof(s16)];
+};
+
+static struct SynthesisJob sSynthesisJobs[SYNTHESIS_MAX_JOBS];
+static s32 sSynthesisJobCount = 0;
+static s32 sSynthesisNextJob = 0;
+static s32 sSynthesisBufLen = 0;
+static u64 *sSynthesisCmd = NULL;
+
+static struct ThreadPool sSynthesisPool = { 0 };
+static s32 sSynthesisWorkerCount = -1;
+static s32 sSynthesisParallelMinNotes = SYNTHESIS_PARALLEL_MIN_NOTES;
+// one per worker, the first is for the mixing thread so the mix bus is left alone
+static struct MixerDmem *sSynthesisDmem[SYNTHESIS_WORKERS + 1] = { 0 };
+
+// the sample dma cache is shared by every note
+static pthread_mutex_t sSynthesisDmaMutex = PTHREAD_MUTEX_INITIALIZER;
+static bool sSynthesisParallel = false;
+
+static inline void synthesis_lock_dma(void) {
+    if (sSynthesisParallel) { pthread_mutex_lock(&sSynthesisDmaMutex); }
+}
+
+static inline void synthesis_unlock_dma(void) {
+    if (sSynthesisParallel) { pthread_mutex_unlock(&sSynthesisDmaMutex); }
+}
+#endif
+
+#if defined(VERSION_JP) || defined(VERSION_US)
+#undef MIXER_DMEM
+#define MIXER_DMEM dmem
+#endif
+
 #if defined(VERSION_EU)
-// Processes just one note, not all
-u64 *synthesis_process_note(struct Note *note, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *synthesisState, u16 *aiBuf, s32 bufLen, u64 *cmd) {
+static u64 *synthesis_load_note(struct Note *note, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *synthesisState, s32 bufLen, s16 **loadedBook, s32 *envFlags, u64 *cmd) {
     UNUSED s32 pad0[3];
 #else
-u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd) {
-    s32 noteIndex;                           // sp174
-    struct Note *note;                       // s7
+static SYNTHESIS_LOAD_INLINE u64 *synthesis_load_note(struct MixerDmem *dmem, struct Note *note, s32 bufLen, s16 **loadedBook, s32 *envFlags, u64 *cmd) {
     UNUSED u8 pad0[0x08];
 #endif
     struct AudioBankSample *audioBookSample; // sp164, sp138
     struct AdpcmLoop *loopInfo;              // sp160, sp134
-    s16 *curLoadedBook = NULL;               // sp154, sp130
+    s16 *curLoadedBook = *loadedBook;        // sp154, sp130
 #if defined(VERSION_EU)
     UNUSED u8 padEU[0x04];
 #endif
@@ -822,16 +871,12 @@ u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd) {
     s32 nSamplesToProcess;  // sp10c/a0, spE0
 #endif
 
-    s32 leftRight;
     s32 s3;
     s32 s5; //s4
 
     u32 samplesLenFixedPoint;    // v1_1
     s32 nSamplesInThisIteration; // v1_2
     u32 a3;
-#if defined(VERSION_JP) || defined(VERSION_US)
-    s32 t9;
-#endif
     u8 *v0_2;
     s32 nParts;                 // spE8, spBC
     s32 curPart;                // spE4, spB8
@@ -847,412 +892,533 @@ u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd) {
     s32 resampledTempLen;                    // spD8, spAC
     u16 noteSamplesDmemAddrBeforeResampling; // spD6, spAA
 
-
-#if defined(VERSION_JP) || defined(VERSION_US)
-    for (noteIndex = 0; noteIndex < gMaxSimultaneousNotes; noteIndex++) {
-        note = &gNotes[noteIndex];
-#ifdef VERSION_US
-        //! This function requires note->enabled to be volatile, but it breaks other functions like note_enable.
-        //! Casting to a struct with just the volatile bitfield works, but there may be a better way to match.
-        if (((struct vNote *)note)->enabled && IS_BANK_LOAD_COMPLETE(note->bankId) == FALSE) {
-#else
-        if (IS_BANK_LOAD_COMPLETE(note->bankId) == FALSE) {
-#endif
-            gAudioErrorFlags = (note->bankId << 8) + noteIndex + 0x1000000;
-        } else if (((struct vNote *)note)->enabled) {
-#else
-        if (note->noteSubEu.enabled == FALSE) {
-            return cmd;
-        } else {
-#endif
-            flags = 0;
+    flags = 0;
 #if defined(VERSION_EU)
-            tempBufLen = bufLen;
+    tempBufLen = bufLen;
 #endif
 
 #if defined(VERSION_EU)
-            if (noteSubEu->needsInit == TRUE) {
+    if (noteSubEu->needsInit == TRUE) {
 #else
-            if (note->needsInit == TRUE) {
+    if (note->needsInit == TRUE) {
 #endif
-                flags = A_INIT;
+        flags = A_INIT;
 #if defined(VERSION_JP) || defined(VERSION_US)
-                note->samplePosInt = 0;
-                note->samplePosFrac = 0;
+        note->samplePosInt = 0;
+        note->samplePosFrac = 0;
 #else
-                synthesisState->restart = FALSE;
-                synthesisState->samplePosInt = 0;
-                synthesisState->samplePosFrac = 0;
-                synthesisState->curVolLeft = 1;
-                synthesisState->curVolRight = 1;
-                synthesisState->prevHeadsetPanRight = 0;
-                synthesisState->prevHeadsetPanLeft = 0;
+        synthesisState->restart = FALSE;
+        synthesisState->samplePosInt = 0;
+        synthesisState->samplePosFrac = 0;
+        synthesisState->curVolLeft = 1;
+        synthesisState->curVolRight = 1;
+        synthesisState->prevHeadsetPanRight = 0;
+        synthesisState->prevHeadsetPanLeft = 0;
 #endif
-            }
+    }
 
 #if defined(VERSION_JP) || defined(VERSION_US)
-            if (note->frequency < US_FLOAT(2.0)) {
-                nParts = 1;
-                if (note->frequency > US_FLOAT(1.99996)) {
-                    note->frequency = US_FLOAT(1.99996);
-                }
-                resamplingRate = note->frequency;
-            } else {
-                // If frequency is > 2.0, the processing must be split into two parts
-                nParts = 2;
-                if (note->frequency >= US_FLOAT(3.99993)) {
-                    note->frequency = US_FLOAT(3.99993);
-                }
-                resamplingRate = note->frequency * US_FLOAT(.5);
-            }
+    if (note->frequency < US_FLOAT(2.0)) {
+        nParts = 1;
+        if (note->frequency > US_FLOAT(1.99996)) {
+            note->frequency = US_FLOAT(1.99996);
+        }
+        resamplingRate = note->frequency;
+    } else {
+        // If frequency is > 2.0, the processing must be split into two parts
+        nParts = 2;
+        if (note->frequency >= US_FLOAT(3.99993)) {
+            note->frequency = US_FLOAT(3.99993);
+        }
+        resamplingRate = note->frequency * US_FLOAT(.5);
+    }
 
-            resamplingRateFixedPoint = (u16)(s32)(resamplingRate * 32768.0f);
-            samplesLenFixedPoint = note->samplePosFrac + (resamplingRateFixedPoint * bufLen) * 2;
-            note->samplePosFrac = samplesLenFixedPoint & 0xFFFF; // 16-bit store, can't reuse
+    resamplingRateFixedPoint = (u16)(s32)(resamplingRate * 32768.0f);
+    samplesLenFixedPoint = note->samplePosFrac + (resamplingRateFixedPoint * bufLen) * 2;
+    note->samplePosFrac = samplesLenFixedPoint & 0xFFFF; // 16-bit store, can't reuse
 #else
-            resamplingRateFixedPoint = noteSubEu->resamplingRateFixedPoint;
-            nParts = noteSubEu->hasTwoAdpcmParts + 1;
-            samplesLenFixedPoint = (resamplingRateFixedPoint * tempBufLen * 2) + synthesisState->samplePosFrac;
-            synthesisState->samplePosFrac = samplesLenFixedPoint & 0xFFFF;
+    resamplingRateFixedPoint = noteSubEu->resamplingRateFixedPoint;
+    nParts = noteSubEu->hasTwoAdpcmParts + 1;
+    samplesLenFixedPoint = (resamplingRateFixedPoint * tempBufLen * 2) + synthesisState->samplePosFrac;
+    synthesisState->samplePosFrac = samplesLenFixedPoint & 0xFFFF;
 #endif
 
 #if defined(VERSION_EU)
-            if (noteSubEu->isSyntheticWave) {
-                cmd = load_wave_samples(cmd, noteSubEu, synthesisState, samplesLenFixedPoint >> 0x10);
-                noteSamplesDmemAddrBeforeResampling = (synthesisState->samplePosInt * 2) + DMEM_ADDR_UNCOMPRESSED_NOTE;
-                synthesisState->samplePosInt += samplesLenFixedPoint >> 0x10;
-            }
+    if (noteSubEu->isSyntheticWave) {
+        cmd = load_wave_samples(cmd, noteSubEu, synthesisState, samplesLenFixedPoint >> 0x10);
+        noteSamplesDmemAddrBeforeResampling = (synthesisState->samplePosInt * 2) + DMEM_ADDR_UNCOMPRESSED_NOTE;
+        synthesisState->samplePosInt += samplesLenFixedPoint >> 0x10;
+    }
 #else
-            if (note->sound == NULL) {
-                // A wave synthesis note (not ADPCM)
+    if (note->sound == NULL) {
+        // A wave synthesis note (not ADPCM)
 
-                cmd = load_wave_samples(cmd, note, samplesLenFixedPoint >> 0x10);
-                noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_UNCOMPRESSED_NOTE + note->samplePosInt * 2;
-                note->samplePosInt += (samplesLenFixedPoint >> 0x10);
-                flags = 0;
-            }
+        cmd = load_wave_samples(dmem, cmd, note, samplesLenFixedPoint >> 0x10);
+        noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_UNCOMPRESSED_NOTE + note->samplePosInt * 2;
+        note->samplePosInt += (samplesLenFixedPoint >> 0x10);
+        flags = 0;
+    }
 #endif
-            else {
-                // ADPCM note
+    else {
+        // ADPCM note
 
 #if defined(VERSION_EU)
-                audioBookSample = noteSubEu->sound.audioBankSound->sample;
+        audioBookSample = noteSubEu->sound.audioBankSound->sample;
 #else
-                audioBookSample = note->sound->sample;
+        audioBookSample = note->sound->sample;
 #endif
 
-                loopInfo = audioBookSample->loop;
-                endPos = loopInfo->end;
-                sampleAddr = audioBookSample->sampleAddr;
-                resampledTempLen = 0;
-                for (curPart = 0; curPart < nParts; curPart++) {
-                    nAdpcmSamplesProcessed = 0; // s8
-                    s5 = 0;                     // s4
+        loopInfo = audioBookSample->loop;
+        endPos = loopInfo->end;
+        sampleAddr = audioBookSample->sampleAddr;
+        resampledTempLen = 0;
+        for (curPart = 0; curPart < nParts; curPart++) {
+            nAdpcmSamplesProcessed = 0; // s8
+            s5 = 0;                     // s4
 
-                    if (nParts == 1) {
-                        samplesLenAdjusted = samplesLenFixedPoint >> 0x10;
-                    } else if ((samplesLenFixedPoint >> 0x10) & 1) {
-                        samplesLenAdjusted = ((samplesLenFixedPoint >> 0x10) & ~1) + (curPart * 2);
-                    }
-                    else {
-                        samplesLenAdjusted = (samplesLenFixedPoint >> 0x10);
-                    }
+            if (nParts == 1) {
+                samplesLenAdjusted = samplesLenFixedPoint >> 0x10;
+            } else if ((samplesLenFixedPoint >> 0x10) & 1) {
+                samplesLenAdjusted = ((samplesLenFixedPoint >> 0x10) & ~1) + (curPart * 2);
+            }
+            else {
+                samplesLenAdjusted = (samplesLenFixedPoint >> 0x10);
+            }
 
-                    if (curLoadedBook != audioBookSample->book->book) {
-                        u32 nEntries; // v1
-                        curLoadedBook = audioBookSample->book->book;
+            if (curLoadedBook != audioBookSample->book->book) {
+                u32 nEntries; // v1
+                curLoadedBook = audioBookSample->book->book;
 #if defined(VERSION_EU)
-                        nEntries = 16 * audioBookSample->book->order * audioBookSample->book->npredictors;
-                        aLoadADPCM(cmd++, nEntries, VIRTUAL_TO_PHYSICAL2(curLoadedBook + noteSubEu->bookOffset));
+                nEntries = 16 * audioBookSample->book->order * audioBookSample->book->npredictors;
+                aLoadADPCM(cmd++, nEntries, VIRTUAL_TO_PHYSICAL2(curLoadedBook + noteSubEu->bookOffset));
 #else
-                        nEntries = audioBookSample->book->order * audioBookSample->book->npredictors;
-                        aLoadADPCM(cmd++, nEntries * 16, VIRTUAL_TO_PHYSICAL2(curLoadedBook));
+                nEntries = audioBookSample->book->order * audioBookSample->book->npredictors;
+                aLoadADPCM(cmd++, nEntries * 16, VIRTUAL_TO_PHYSICAL2(curLoadedBook));
 #endif
-                    }
+            }
 
 #if defined(VERSION_EU)
-                    if (noteSubEu->bookOffset) {
-                        curLoadedBook = euUnknownData_80301950; // what's this? never read
-                    }
+            if (noteSubEu->bookOffset) {
+                curLoadedBook = euUnknownData_80301950; // what's this? never read
+            }
 #endif
 
-                    while (nAdpcmSamplesProcessed != samplesLenAdjusted) {
-                        s32 samplesRemaining; // v1
-                        s32 s0;
+            while (nAdpcmSamplesProcessed != samplesLenAdjusted) {
+                s32 samplesRemaining; // v1
+                s32 s0;
 
-                        noteFinished = FALSE;
-                        restart = FALSE;
-                        nSamplesToProcess = samplesLenAdjusted - nAdpcmSamplesProcessed;
+                noteFinished = FALSE;
+                restart = FALSE;
+                nSamplesToProcess = samplesLenAdjusted - nAdpcmSamplesProcessed;
 #if defined(VERSION_EU)
-                        s2 = synthesisState->samplePosInt & 0xf;
-                        samplesRemaining = endPos - synthesisState->samplePosInt;
+                s2 = synthesisState->samplePosInt & 0xf;
+                samplesRemaining = endPos - synthesisState->samplePosInt;
 #else
-                        s2 = note->samplePosInt & 0xf;
-                        samplesRemaining = endPos - note->samplePosInt;
+                s2 = note->samplePosInt & 0xf;
+                samplesRemaining = endPos - note->samplePosInt;
 #endif
 
 #if defined(VERSION_EU)
-                        if (s2 == 0 && synthesisState->restart == FALSE) {
-                            s2 = 16;
-                        }
+                if (s2 == 0 && synthesisState->restart == FALSE) {
+                    s2 = 16;
+                }
 #else
-                        if (s2 == 0 && note->restart == FALSE) {
-                            s2 = 16;
-                        }
+                if (s2 == 0 && note->restart == FALSE) {
+                    s2 = 16;
+                }
 #endif
-                        s6 = 16 - s2; // a1
+                s6 = 16 - s2; // a1
 
-                        if (nSamplesToProcess < samplesRemaining) {
-                            t0 = (nSamplesToProcess - s6 + 0xf) / 16;
-                            s0 = t0 * 16;
-                            s3 = s6 + s0 - nSamplesToProcess;
-                        } else {
+                if (nSamplesToProcess < samplesRemaining) {
+                    t0 = (nSamplesToProcess - s6 + 0xf) / 16;
+                    s0 = t0 * 16;
+                    s3 = s6 + s0 - nSamplesToProcess;
+                } else {
 #if defined(VERSION_JP) || defined(VERSION_US)
-                            s0 = samplesRemaining + s2 - 0x10;
+                    s0 = samplesRemaining + s2 - 0x10;
 #else
-                            s0 = samplesRemaining - s6;
+                    s0 = samplesRemaining - s6;
 #endif
-                            s3 = 0;
-                            if (s0 <= 0) {
-                                s0 = 0;
-                                s6 = samplesRemaining;
-                            }
-                            t0 = (s0 + 0xf) / 16;
-                            if (loopInfo->count != 0) {
-                                // Loop around and restart
-                                restart = 1;
-                            } else {
-                                noteFinished = 1;
-                            }
-                        }
+                    s3 = 0;
+                    if (s0 <= 0) {
+                        s0 = 0;
+                        s6 = samplesRemaining;
+                    }
+                    t0 = (s0 + 0xf) / 16;
+                    if (loopInfo->count != 0) {
+                        // Loop around and restart
+                        restart = 1;
+                    } else {
+                        noteFinished = 1;
+                    }
+                }
 
-                        if (t0 != 0) {
+                if (t0 != 0) {
 #if defined(VERSION_EU)
-                            temp = (synthesisState->samplePosInt - s2 + 0x10) / 16;
-                            if (audioBookSample->loaded == 0x81) {
-                                v0_2 = sampleAddr + temp * 9;
-                            } else {
-                                v0_2 = dma_sample_data(
-                                    (uintptr_t) (sampleAddr + temp * 9),
-                                    t0 * 9, flags, &synthesisState->sampleDmaIndex);
-                            }
+                    temp = (synthesisState->samplePosInt - s2 + 0x10) / 16;
+                    if (audioBookSample->loaded == 0x81) {
+                        v0_2 = sampleAddr + temp * 9;
+                    } else {
+                        v0_2 = dma_sample_data(
+                            (uintptr_t) (sampleAddr + temp * 9),
+                            t0 * 9, flags, &synthesisState->sampleDmaIndex);
+                    }
 #else
-                            temp = (note->samplePosInt - s2 + 0x10) / 16;
-                            v0_2 = dma_sample_data(
-                                (uintptr_t) (sampleAddr + temp * 9),
-                                t0 * 9, flags, &note->sampleDmaIndex);
+                    temp = (note->samplePosInt - s2 + 0x10) / 16;
+                    synthesis_lock_dma();
+                    v0_2 = dma_sample_data(
+                        (uintptr_t) (sampleAddr + temp * 9),
+                        t0 * 9, flags, &note->sampleDmaIndex);
+#endif
+                    a3 = (u32)((uintptr_t) v0_2 & 0xf);
+                    aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA, 0, t0 * 9 + a3);
+                    aLoadBuffer(cmd++, VIRTUAL_TO_PHYSICAL2(v0_2 - a3));
+#if defined(VERSION_JP) || defined(VERSION_US)
+                    synthesis_unlock_dma();
 #endif
-                            a3 = (u32)((uintptr_t) v0_2 & 0xf);
-                            aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA, 0, t0 * 9 + a3);
-                            aLoadBuffer(cmd++, VIRTUAL_TO_PHYSICAL2(v0_2 - a3));
-                        } else {
-                            s0 = 0;
-                            a3 = 0;
-                        }
+                } else {
+                    s0 = 0;
+                    a3 = 0;
+                }
 
 #if defined(VERSION_EU)
-                        if (synthesisState->restart != FALSE) {
-                            aSetLoop(cmd++, VIRTUAL_TO_PHYSICAL2(audioBookSample->loop->state));
-                            flags = A_LOOP; // = 2
-                            synthesisState->restart = FALSE;
-                        }
+                if (synthesisState->restart != FALSE) {
+                    aSetLoop(cmd++, VIRTUAL_TO_PHYSICAL2(audioBookSample->loop->state));
+                    flags = A_LOOP; // = 2
+                    synthesisState->restart = FALSE;
+                }
 #else
-                        if (note->restart != FALSE) {
-                            aSetLoop(cmd++, VIRTUAL_TO_PHYSICAL2(audioBookSample->loop->state));
-                            flags = A_LOOP; // = 2
-                            note->restart = FALSE;
-                        }
+                if (note->restart != FALSE) {
+                    aSetLoop(cmd++, VIRTUAL_TO_PHYSICAL2(audioBookSample->loop->state));
+                    flags = A_LOOP; // = 2
+                    note->restart = FALSE;
+                }
 #endif
 
-                        nSamplesInThisIteration = s0 + s6 - s3;
+                nSamplesInThisIteration = s0 + s6 - s3;
 #if defined(VERSION_EU)
-                        if (nAdpcmSamplesProcessed == 0) {
-                            aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3,
-                                       DMEM_ADDR_UNCOMPRESSED_NOTE, s0 * 2);
-                            aADPCMdec(cmd++, flags,
-                                      VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->adpcmdecState));
-                            sp130 = s2 * 2;
-                        } else {
-                            s5Aligned = ALIGN(s5, 5);
-                            aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3,
-                                       DMEM_ADDR_UNCOMPRESSED_NOTE + s5Aligned, s0 * 2);
-                            aADPCMdec(cmd++, flags,
-                                      VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->adpcmdecState));
-                            aDMEMMove(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + s5Aligned + (s2 * 2),
-                                      DMEM_ADDR_UNCOMPRESSED_NOTE + s5, (nSamplesInThisIteration) * 2);
-                        }
+                if (nAdpcmSamplesProcessed == 0) {
+                    aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3,
+                               DMEM_ADDR_UNCOMPRESSED_NOTE, s0 * 2);
+                    aADPCMdec(cmd++, flags,
+                              VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->adpcmdecState));
+                    sp130 = s2 * 2;
+                } else {
+                    s5Aligned = ALIGN(s5, 5);
+                    aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3,
+                               DMEM_ADDR_UNCOMPRESSED_NOTE + s5Aligned, s0 * 2);
+                    aADPCMdec(cmd++, flags,
+                              VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->adpcmdecState));
+                    aDMEMMove(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + s5Aligned + (s2 * 2),
+                              DMEM_ADDR_UNCOMPRESSED_NOTE + s5, (nSamplesInThisIteration) * 2);
+                }
 #else
-                        if (nAdpcmSamplesProcessed == 0) {
-                            aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3, DMEM_ADDR_UNCOMPRESSED_NOTE, s0 * 2);
-                            aADPCMdec(cmd++, flags, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->adpcmdecState));
-                            sp130 = s2 * 2;
-                        } else {
-                            aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3, DMEM_ADDR_UNCOMPRESSED_NOTE + ALIGN(s5, 5), s0 * 2);
-                            aADPCMdec(cmd++, flags, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->adpcmdecState));
-                            aDMEMMove(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + ALIGN(s5, 5) + (s2 * 2), DMEM_ADDR_UNCOMPRESSED_NOTE + s5, (nSamplesInThisIteration) * 2);
-                        }
+                if (nAdpcmSamplesProcessed == 0) {
+                    aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3, DMEM_ADDR_UNCOMPRESSED_NOTE, s0 * 2);
+                    aADPCMdec(cmd++, flags, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->adpcmdecState));
+                    sp130 = s2 * 2;
+                } else {
+                    aSetBuffer(cmd++, 0, DMEM_ADDR_COMPRESSED_ADPCM_DATA + a3, DMEM_ADDR_UNCOMPRESSED_NOTE + ALIGN(s5, 5), s0 * 2);
+                    aADPCMdec(cmd++, flags, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->adpcmdecState));
+                    aDMEMMove(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + ALIGN(s5, 5) + (s2 * 2), DMEM_ADDR_UNCOMPRESSED_NOTE + s5, (nSamplesInThisIteration) * 2);
+                }
 #endif
 
-                        nAdpcmSamplesProcessed += nSamplesInThisIteration;
+                nAdpcmSamplesProcessed += nSamplesInThisIteration;
 
-                        switch (flags) {
-                            case A_INIT: // = 1
-                                sp130 = 0;
-                                s5 = s0 * 2 + s5;
-                                break;
+                switch (flags) {
+                    case A_INIT: // = 1
+                        sp130 = 0;
+                        s5 = s0 * 2 + s5;
+                        break;
 
-                            case A_LOOP: // = 2
-                                s5 = nSamplesInThisIteration * 2 + s5;
-                                break;
+                    case A_LOOP: // = 2
+                        s5 = nSamplesInThisIteration * 2 + s5;
+                        break;
 
-                            default:
-                                if (s5 != 0) {
-                                    s5 = nSamplesInThisIteration * 2 + s5;
-                                } else {
-                                    s5 = (s2 + nSamplesInThisIteration) * 2;
-                                }
-                                break;
+                    default:
+                        if (s5 != 0) {
+                            s5 = nSamplesInThisIteration * 2 + s5;
+                        } else {
+                            s5 = (s2 + nSamplesInThisIteration) * 2;
                         }
-                        flags = 0;
+                        break;
+                }
+                flags = 0;
 
-                        if (noteFinished) {
-                            aClearBuffer(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + s5,
-                                         (samplesLenAdjusted - nAdpcmSamplesProcessed) * 2);
+                if (noteFinished) {
+                    aClearBuffer(cmd++, DMEM_ADDR_UNCOMPRESSED_NOTE + s5,
+                                 (samplesLenAdjusted - nAdpcmSamplesProcessed) * 2);
 #if defined(VERSION_EU)
-                            noteSubEu->finished = 1;
-                            note->noteSubEu.finished = 1;
-                            note->noteSubEu.enabled = 0;
+                    noteSubEu->finished = 1;
+                    note->noteSubEu.finished = 1;
+                    note->noteSubEu.enabled = 0;
 #else
-                            note->samplePosInt = 0;
-                            note->finished = 1;
-                            ((struct vNote *)note)->enabled = 0;
+                    note->samplePosInt = 0;
+                    note->finished = 1;
+                    ((struct vNote *)note)->enabled = 0;
 #endif
-                            break;
-                        }
+                    break;
+                }
 #if defined(VERSION_EU)
-                        if (restart) {
-                            synthesisState->restart = TRUE;
-                            synthesisState->samplePosInt = loopInfo->start;
-                        } else {
-                            synthesisState->samplePosInt += nSamplesToProcess;
-                        }
+                if (restart) {
+                    synthesisState->restart = TRUE;
+                    synthesisState->samplePosInt = loopInfo->start;
+                } else {
+                    synthesisState->samplePosInt += nSamplesToProcess;
+                }
 #else
-                        if (restart) {
-                            note->restart = TRUE;
-                            note->samplePosInt = loopInfo->start;
-                        } else {
-                            note->samplePosInt += nSamplesToProcess;
-                        }
+                if (restart) {
+                    note->restart = TRUE;
+                    note->samplePosInt = loopInfo->start;
+                } else {
+                    note->samplePosInt += nSamplesToProcess;
+                }
 #endif
-                    }
+            }
 
-                    switch (nParts) {
-                        case 1:
-                            noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_UNCOMPRESSED_NOTE + sp130;
-                            break;
+            switch (nParts) {
+                case 1:
+                    noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_UNCOMPRESSED_NOTE + sp130;
+                    break;
 
-                        case 2:
-                            switch (curPart) {
-                                case 0:
-                                    aSetBuffer(cmd++, 0, DMEM_ADDR_UNCOMPRESSED_NOTE + sp130, DMEM_ADDR_RESAMPLED, samplesLenAdjusted + 4);
+                case 2:
+                    switch (curPart) {
+                        case 0:
+                            aSetBuffer(cmd++, 0, DMEM_ADDR_UNCOMPRESSED_NOTE + sp130, DMEM_ADDR_RESAMPLED, samplesLenAdjusted + 4);
 #if defined(VERSION_EU)
-                                    aResample(cmd++, A_INIT, 0xff60, VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->dummyResampleState));
+                            aResample(cmd++, A_INIT, 0xff60, VIRTUAL_TO_PHYSICAL2(synthesisState->synthesisBuffers->dummyResampleState));
 #else
-                                    aResample(cmd++, A_INIT, 0xff60, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->dummyResampleState));
+                            aResample(cmd++, A_INIT, 0xff60, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->dummyResampleState));
 #endif
-                                    resampledTempLen = samplesLenAdjusted + 4;
-                                    noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_RESAMPLED + 4;
+                            resampledTempLen = samplesLenAdjusted + 4;
+                            noteSamplesDmemAddrBeforeResampling = DMEM_ADDR_RESAMPLED + 4;
 #if defined(VERSION_EU)
-                                    if (noteSubEu->finished != FALSE) {
+                            if (noteSubEu->finished != FALSE) {
 #else
-                                    if (note->finished != FALSE) {
+                            if (note->finished != FALSE) {
 #endif
-                                        aClearBuffer(cmd++, DMEM_ADDR_RESAMPLED + resampledTempLen, samplesLenAdjusted + 0x10);
-                                    }
-                                    break;
+                                aClearBuffer(cmd++, DMEM_ADDR_RESAMPLED + resampledTempLen, samplesLenAdjusted + 0x10);
+                            }
+                            break;
 
-                                case 1:
-                                    aSetBuffer(cmd++, 0, DMEM_ADDR_UNCOMPRESSED_NOTE + sp130,
-                                               DMEM_ADDR_RESAMPLED2,
-                                               samplesLenAdjusted + 8);
+                        case 1:
+                            aSetBuffer(cmd++, 0, DMEM_ADDR_UNCOMPRESSED_NOTE + sp130,
+                                       DMEM_ADDR_RESAMPLED2,
+                                       samplesLenAdjusted + 8);
 #if defined(VERSION_EU)
-                                    aResample(cmd++, A_INIT, 0xff60,
-                                              VIRTUAL_TO_PHYSICAL2(
-                                                  synthesisState->synthesisBuffers->dummyResampleState));
-#else
-                                    aResample(cmd++, A_INIT, 0xff60,
-                                              VIRTUAL_TO_PHYSICAL2(
-                                                  note->synthesisBuffers->dummyResampleState));
-#endif
-                                    aDMEMMove(cmd++, DMEM_ADDR_RESAMPLED2 + 4,
-                                              DMEM_ADDR_RESAMPLED + resampledTempLen,
-                                              samplesLenAdjusted + 4);
-                                    break;
-                            }
+                            aResample(cmd++, A_INIT, 0xff60,
+                                      VIRTUAL_TO_PHYSICAL2(
+                                          synthesisState->synthesisBuffers->dummyResampleState));
+#else
+                            aResample(cmd++, A_INIT, 0xff60,
+                                      VIRTUAL_TO_PHYSICAL2(
+                                          note->synthesisBuffers->dummyResampleState));
+#endif
+                            aDMEMMove(cmd++, DMEM_ADDR_RESAMPLED2 + 4,
+                                      DMEM_ADDR_RESAMPLED + resampledTempLen,
+                                      samplesLenAdjusted + 4);
+                            break;
                     }
+            }
 
 #if defined(VERSION_EU)
-                    if (noteSubEu->finished != FALSE) {
+            if (noteSubEu->finished != FALSE) {
 #else
-                    if (note->finished != FALSE) {
+            if (note->finished != FALSE) {
 #endif
-                        break;
-                    }
-                }
+                break;
             }
+        }
+    }
 
-            flags = 0;
+    flags = 0;
 
 #if defined(VERSION_EU)
-            if (noteSubEu->needsInit == TRUE) {
-                flags = A_INIT;
-                noteSubEu->needsInit = FALSE;
-            }
+    if (noteSubEu->needsInit == TRUE) {
+        flags = A_INIT;
+        noteSubEu->needsInit = FALSE;
+    }
 
-            cmd = final_resample(cmd, synthesisState, bufLen * 2, resamplingRateFixedPoint,
-                                 noteSamplesDmemAddrBeforeResampling, flags);
+    cmd = final_resample(cmd, synthesisState, bufLen * 2, resamplingRateFixedPoint,
+                         noteSamplesDmemAddrBeforeResampling, flags);
 #else
-            if (note->needsInit == TRUE) {
-                flags = A_INIT;
-                note->needsInit = FALSE;
-            }
+    if (note->needsInit == TRUE) {
+        flags = A_INIT;
+        note->needsInit = FALSE;
+    }
 
-            cmd = final_resample(cmd, note, bufLen * 2, resamplingRateFixedPoint,
-                                 noteSamplesDmemAddrBeforeResampling, flags);
+    cmd = final_resample(dmem, cmd, note, bufLen * 2, resamplingRateFixedPoint,
+                         noteSamplesDmemAddrBeforeResampling, flags);
 #endif
 
+    *loadedBook = curLoadedBook;
+    *envFlags = flags;
+    return cmd;
+}
+
+#if defined(VERSION_EU)
+static u64 *synthesis_mix_note(UNUSED struct Note *note, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *synthesisState, s32 bufLen, s32 flags, u64 *cmd) {
+#else
+static u64 *synthesis_mix_note(struct Note *note, s32 bufLen, s32 flags, u64 *cmd) {
+#endif
+    s32 leftRight;
+
 #if defined(VERSION_JP) || defined(VERSION_US)
-            if (note->headsetPanRight != 0 || note->prevHeadsetPanRight != 0) {
-                leftRight = 1;
-            } else if (note->headsetPanLeft != 0 || note->prevHeadsetPanLeft != 0) {
-                leftRight = 2;
+    if (note->headsetPanRight != 0 || note->prevHeadsetPanRight != 0) {
+        leftRight = 1;
+    } else if (note->headsetPanLeft != 0 || note->prevHeadsetPanLeft != 0) {
+        leftRight = 2;
 #else
-            if (noteSubEu->headsetPanRight != 0 || synthesisState->prevHeadsetPanRight != 0) {
-                leftRight = 1;
-            } else if (noteSubEu->headsetPanLeft != 0 || synthesisState->prevHeadsetPanLeft != 0) {
-                leftRight = 2;
+    if (noteSubEu->headsetPanRight != 0 || synthesisState->prevHeadsetPanRight != 0) {
+        leftRight = 1;
+    } else if (noteSubEu->headsetPanLeft != 0 || synthesisState->prevHeadsetPanLeft != 0) {
+        leftRight = 2;
 #endif
-            } else {
-                leftRight = 0;
-            }
+    } else {
+        leftRight = 0;
+    }
 
 #if defined(VERSION_EU)
-            cmd = process_envelope(cmd, noteSubEu, synthesisState, bufLen, 0, leftRight, flags);
+    cmd = process_envelope(cmd, noteSubEu, synthesisState, bufLen, 0, leftRight, flags);
 #else
-            cmd = process_envelope(cmd, note, bufLen, 0, leftRight, flags);
+    cmd = process_envelope(cmd, note, bufLen, 0, leftRight, flags);
 #endif
 
 #if defined(VERSION_EU)
-            if (noteSubEu->usesHeadsetPanEffects) {
-                cmd = note_apply_headset_pan_effects(cmd, noteSubEu, synthesisState, bufLen * 2, flags, leftRight);
-            }
+    if (noteSubEu->usesHeadsetPanEffects) {
+        cmd = note_apply_headset_pan_effects(cmd, noteSubEu, synthesisState, bufLen * 2, flags, leftRight);
+    }
 #else
-            if (note->usesHeadsetPanEffects) {
-                cmd = note_apply_headset_pan_effects(cmd, note, bufLen * 2, flags, leftRight);
-            }
+    if (note->usesHeadsetPanEffects) {
+        cmd = note_apply_headset_pan_effects(cmd, note, bufLen * 2, flags, leftRight);
+    }
 #endif
+    return cmd;
+}
+
+#if defined(VERSION_EU)
+// Processes just one note, not all
+u64 *synthesis_process_note(struct Note *note, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *synthesisState, UNUSED u16 *aiBuf, s32 bufLen, u64 *cmd) {
+    s16 *curLoadedBook = NULL;
+    s32 flags;
+
+    if (note->noteSubEu.enabled == FALSE) {
+        return cmd;
+    }
+
+    cmd = synthesis_load_note(note, noteSubEu, synthesisState, bufLen, &curLoadedBook, &flags, cmd);
+    return synthesis_mix_note(note, noteSubEu, synthesisState, bufLen, flags, cmd);
+}
+#else
+static void synthesis_run_jobs(struct MixerDmem *dmem) {
+    s16 *curLoadedBook = NULL;
+    s32 jobIndex;
+
+    while ((jobIndex = __atomic_fetch_add(&sSynthesisNextJob, 1, __ATOMIC_RELAXED)) < sSynthesisJobCount) {
+        struct SynthesisJob *job = &sSynthesisJobs[jobIndex];
+        UNUSED u64 *cmd = synthesis_load_note(dmem, job->note, sSynthesisBufLen, &curLoadedBook, &job->flags, sSynthesisCmd);
+        aSetBuffer(cmd++, 0, 0, DMEM_ADDR_TEMP, sSynthesisBufLen * 2);
+        aSaveBuffer(cmd++, job->samples);
+    }
+}
+
+#undef MIXER_DMEM
+#define MIXER_DMEM NULL
+
+static void synthesis_job(UNUSED void *arg, s32 worker) {
+    synthesis_run_jobs(sSynthesisDmem[worker]);
+}
+
+static void synthesis_stop_workers(void) {
+    shutdown_thread_pool(&sSynthesisPool);
+    for (s32 i = 0; i <= SYNTHESIS_WORKERS; i++) {
+        free(sSynthesisDmem[i]);
+        sSynthesisDmem[i] = NULL;
+    }
+    sSynthesisWorkerCount = -1;
+}
+
+static bool synthesis_start_workers(void) {
+    if (sSynthesisWorkerCount >= 0) { return sSynthesisWorkerCount > 0; }
+
+    // on a single core the workers only take turns with the mixing thread
+    sSynthesisWorkerCount = 0;
+    s32 workers = 0;
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 1) { workers = MIN(cores - 1, SYNTHESIS_WORKERS); }
+#endif
+    if (workers == 0) { return false; }
+
+    for (s32 i = 0; i <= workers; i++) {
+        sSynthesisDmem[i] = mixer_dmem_create();
+        if (sSynthesisDmem[i] == NULL) {
+            synthesis_stop_workers();
+            sSynthesisWorkerCount = 0;
+            return false;
+        }
+    }
+
+    sSynthesisWorkerCount = init_thread_pool(&sSynthesisPool, workers);
+    return sSynthesisWorkerCount > 0;
+}
+
+static void synthesis_decode_parallel(s32 bufLen, u64 *cmd) {
+    sSynthesisBufLen = bufLen;
+    sSynthesisCmd = cmd;
+    sSynthesisNextJob = 0;
+    sSynthesisParallel = true;
+
+    // the mixing thread helps out as worker 0
+    run_thread_pool(&sSynthesisPool, synthesis_job, NULL);
+
+    sSynthesisParallel = false;
+}
+
+u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd) {
+    s16 *curLoadedBook = NULL;
+    s32 noteIndex;
+    s32 jobIndex;
+    s32 flags;
+    s32 t9;
+
+    sSynthesisJobCount = 0;
+    for (noteIndex = 0; noteIndex < gMaxSimultaneousNotes; noteIndex++) {
+        struct Note *note = &gNotes[noteIndex];
+#ifdef VERSION_US
+        //! This function requires note->enabled to be volatile, but it breaks other functions like note_enable.
+        //! Casting to a struct with just the volatile bitfield works, but there may be a better way to match.
+        if (((struct vNote *)note)->enabled && IS_BANK_LOAD_COMPLETE(note->bankId) == FALSE) {
+#else
+        if (IS_BANK_LOAD_COMPLETE(note->bankId) == FALSE) {
+#endif
+            gAudioErrorFlags = (note->bankId << 8) + noteIndex + 0x1000000;
+        } else if (((struct vNote *)note)->enabled && sSynthesisJobCount < SYNTHESIS_MAX_JOBS) {
+            sSynthesisJobs[sSynthesisJobCount++].note = note;
+        } else if (((struct vNote *)note)->enabled) {
+            // out of job slots, the serial path below handles every note
+            sSynthesisJobCount = SYNTHESIS_MAX_JOBS + 1;
+        }
+    }
+
+    if (sSynthesisJobCount <= SYNTHESIS_MAX_JOBS && sSynthesisJobCount >= sSynthesisParallelMinNotes
+        && bufLen * (s32) sizeof(s16) <= (s32) sizeof(sSynthesisJobs[0].samples) && synthesis_start_workers()) {
+        synthesis_decode_parallel(bufLen, cmd);
+        for (jobIndex = 0; jobIndex < sSynthesisJobCount; jobIndex++) {
+            struct SynthesisJob *job = &sSynthesisJobs[jobIndex];
+            aSetBuffer(cmd++, 0, DMEM_ADDR_TEMP, 0, bufLen * 2);
+            aLoadBuffer(cmd++, job->samples);
+            cmd = synthesis_mix_note(job->note, bufLen, job->flags, cmd);
+        }
+    } else {
+        for (noteIndex = 0; noteIndex < gMaxSimultaneousNotes; noteIndex++) {
+            struct Note *note = &gNotes[noteIndex];
+            if (((struct vNote *)note)->enabled && IS_BANK_LOAD_COMPLETE(note->bankId) == TRUE) {
+                cmd = synthesis_load_note(NULL, note, bufLen, &curLoadedBook, &flags, cmd);
+                cmd = synthesis_mix_note(note, bufLen, flags, cmd);
+            }
         }
-#if defined(VERSION_JP) || defined(VERSION_US)
     }
 
     t9 = bufLen * 2;
@@ -1261,10 +1427,10 @@ u64 *synthesis_process_notes(s16 *aiBuf, s32 bufLen, u64 *cmd) {
     t9 *= 2;
     aSetBuffer(cmd++, 0, 0, DMEM_ADDR_TEMP, t9);
     aSaveBuffer(cmd++, VIRTUAL_TO_PHYSICAL2(aiBuf));
-#endif
 
     return cmd;
 }
+#endif
 #else // VERSION_SH
 u64 *synthesis_process_note(s32 noteIndex, struct NoteSubEu *noteSubEu, struct NoteSynthesisState *synthesisState, UNUSED u16 *aiBuf, s32 bufLen, u64 *cmd, s32 updateIndex) {
     UNUSED s32 pad0[3];
@@ -1652,7 +1818,10 @@ u64 *load_wave_samples(u64 *cmd, struct NoteSubEu *noteSubEu, struct NoteSynthes
     return cmd;
 }
 #else
-u64 *load_wave_samples(u64 *cmd, struct Note *note, s32 nSamplesToLoad) {
+#undef MIXER_DMEM
+#define MIXER_DMEM dmem
+
+static SYNTHESIS_LOAD_INLINE u64 *load_wave_samples(struct MixerDmem *dmem, u64 *cmd, struct Note *note, s32 nSamplesToLoad) {
     s32 a3;
     s32 i;
     aSetBuffer(cmd++, /*flags*/ 0, /*dmemin*/ DMEM_ADDR_UNCOMPRESSED_NOTE, /*dmemout*/ 0,
@@ -1684,11 +1853,14 @@ u64 *final_resample(u64 *cmd, struct NoteSynthesisState *synthesisState, s32 cou
     return cmd;
 }
 #else
-u64 *final_resample(u64 *cmd, struct Note *note, s32 count, u16 pitch, u16 dmemIn, u32 flags) {
+static SYNTHESIS_LOAD_INLINE u64 *final_resample(struct MixerDmem *dmem, u64 *cmd, struct Note *note, s32 count, u16 pitch, u16 dmemIn, u32 flags) {
     aSetBuffer(cmd++, /*flags*/ 0, dmemIn, /*dmemout*/ DMEM_ADDR_TEMP, count);
     aResample(cmd++, flags, pitch, VIRTUAL_TO_PHYSICAL2(note->synthesisBuffers->finalResampleState));
     return cmd;
 }
+
+#undef MIXER_DMEM
+#define MIXER_DMEM NULL
 #endif
 
 #ifndef VERSION_SH
@@ -2222,3 +2394,110 @@ void note_disable(struct Note *note) {
     note->prevParentLayer = NO_LAYER;
 }
 #endif
+
+void synthesis_shutdown(void) {
+#if defined(VERSION_JP) || defined(VERSION_US)
+    synthesis_stop_workers();
+#endif
+}
+
+#ifdef DEVELOPMENT
+  ///////////
+ // bench //
+///////////
+
+#include "pc/dev/bench.h"
+#include "pc/utils/misc.h"
+
+#define SYNTHESIS_BENCH_LEN (DEFAULT_LEN_1CH / sizeof(s16) / 2)
+#define SYNTHESIS_BENCH_ITERATIONS 64
+
+#if defined(VERSION_JP) || defined(VERSION_US)
+static struct Note *sBenchNotes = NULL;
+static struct NoteSynthesisBuffers *sBenchBuffers = NULL;
+static struct MixerDmem *sBenchDmem = NULL;
+static s32 sBenchErrorFlags = 0;
+
+static void synthesis_bench_save(void) {
+    for (s32 i = 0; i < gMaxSimultaneousNotes; i++) {
+        sBenchNotes[i] = gNotes[i];
+        sBenchBuffers[i] = *gNotes[i].synthesisBuffers;
+    }
+    mixer_dmem_copy(sBenchDmem, NULL);
+    sBenchErrorFlags = gAudioErrorFlags;
+}
+
+static void synthesis_bench_restore(void) {
+    for (s32 i = 0; i < gMaxSimultaneousNotes; i++) {
+        gNotes[i] = sBenchNotes[i];
+        *gNotes[i].synthesisBuffers = sBenchBuffers[i];
+    }
+    mixer_dmem_copy(NULL, sBenchDmem);
+    gAudioErrorFlags = sBenchErrorFlags;
+}
+
+// Runs the playing notes through one path and keeps the first output as the golden one
+static f64 synthesis_bench_one(s32 minNotes, s16 *aiBuf) {
+    static u64 sBenchCmds[4];
+    s16 scratch[SYNTHESIS_BENCH_LEN * 2];
+    f64 elapsed = 0;
+
+    sSynthesisParallelMinNotes = minNotes;
+    for (s32 iter = 0; iter < SYNTHESIS_BENCH_ITERATIONS; iter++) {
+        synthesis_bench_restore();
+        f64 start = clock_elapsed_f64();
+        synthesis_process_notes(iter == 0 ? aiBuf : scratch, SYNTHESIS_BENCH_LEN, sBenchCmds);
+        elapsed += clock_elapsed_f64() - start;
+    }
+    sSynthesisParallelMinNotes = SYNTHESIS_PARALLEL_MIN_NOTES;
+
+    return elapsed * 1000000.0 / SYNTHESIS_BENCH_ITERATIONS;
+}
+#endif
+
+void synthesis_bench(void) {
+#if defined(VERSION_JP) || defined(VERSION_US)
+    s16 serial[SYNTHESIS_BENCH_LEN * 2];
+    s16 parallel[SYNTHESIS_BENCH_LEN * 2];
+
+    if (gNotes == NULL || !synthesis_start_workers()) {
+        dev_bench_report("Parallel synthesis is unavailable");
+        return;
+    }
+
+    sBenchNotes = malloc(sizeof(struct Note) * gMaxSimultaneousNotes);
+    sBenchBuffers = malloc(sizeof(struct NoteSynthesisBuffers) * gMaxSimultaneousNotes);
+    sBenchDmem = mixer_dmem_create();
+    if (sBenchNotes == NULL || sBenchBuffers == NULL || sBenchDmem == NULL) {
+        dev_bench_report("Out of memory");
+    } else {
+        // hold the audio thread so the notes stay put while they're replayed
+        MUTEX_LOCK(gAudioThread);
+        synthesis_bench_save();
+
+        s32 playing = 0;
+        for (s32 i = 0; i < gMaxSimultaneousNotes; i++) {
+            if (gNotes[i].enabled) { playing++; }
+        }
+
+        f64 serialTime = synthesis_bench_one(INT32_MAX, serial);
+        f64 parallelTime = synthesis_bench_one(1, parallel);
+        synthesis_bench_restore();
+        MUTEX_UNLOCK(gAudioThread);
+
+        dev_bench_report("%d notes: serial %.3fus, parallel %.3fus, output %s",
+            playing, serialTime, parallelTime,
+            memcmp(serial, parallel, sizeof(serial)) == 0 ? "identical" : "DIFFERS");
+    }
+
+    free(sBenchNotes);
+    free(sBenchBuffers);
+    free(sBenchDmem);
+    sBenchNotes = NULL;
+    sBenchBuffers = NULL;
+    sBenchDmem = NULL;
+#else
+    dev_bench_report("Only the US and JP mixers synthesize notes in parallel");
+#endif
+}
+#endif
@@ -96,4 +96,10 @@ void note_enable(struct Note *note);
 void note_disable(struct Note *note);
 #endif
 
+void synthesis_shutdown(void);
+
+#ifdef DEVELOPMENT
+void synthesis_bench(void);
+#endif
+
 #endif // AUDIO_SYNTHESIS_H
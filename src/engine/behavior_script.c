@@ -22,6 +22,7 @@
 #include "game/rng_position.h"
 #include "game/interaction.h"
 #include "game/hardcoded.h"
+#include "data/dynos_cmap.cpp.h"
 
 // Macros for retrieving arguments from behavior scripts.
 #define BHV_CMD_GET_1ST_U8(index)  (u8)((gCurBhvCommand[index] >> 24) & 0xFF) // unused
@@ -906,20 +907,65 @@ static s32 bhv_cmd_id(void) {
     return BHV_PROC_CONTINUE;
 }
 
-// Command 0x3A: Jumps to a new behavior command and stores the return address in the object's behavior stack.
-// Usage: CALL_EXT(addr)
-static s32 bhv_cmd_call_ext(void) {
-    gCurBhvCommand++;
+  ///////////////////////
+ // ext command cache //
+///////////////////////
 
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
+// What an *_EXT command's token resolved to. Keyed by the address of the command,
+// so the token and Lua lookups only happen the first time a command runs.
+struct BhvExtResolution {
+    const char *token;
+    s32 modIndex;
+    enum BehaviorId behId;
+    LuaFunction funcRef;
+};
+
+static void *sBhvExtCache = NULL;
 
+void behavior_ext_cache_clear(void) {
+    if (sBhvExtCache == NULL) { return; }
+    for (struct BhvExtResolution *res = hmap_begin(sBhvExtCache); res != NULL; res = hmap_next(sBhvExtCache)) {
+        free(res);
+    }
+    hmap_clear(sBhvExtCache);
+}
+
+static struct BhvExtResolution *bhv_ext_cache_put(const BehaviorScript *cmd, const char *token, s32 modIndex, enum BehaviorId behId, LuaFunction funcRef) {
+    if (sBhvExtCache == NULL) { sBhvExtCache = hmap_create(true); }
+    struct BhvExtResolution *res = malloc(sizeof(struct BhvExtResolution));
+    if (res == NULL) { return NULL; }
+    res->token = token;
+    res->modIndex = modIndex;
+    res->behId = behId;
+    res->funcRef = funcRef;
+    hmap_put(sBhvExtCache, (int64_t)(intptr_t)cmd, res);
+    return res;
+}
+
+static s32 bhv_ext_get_mod_index(BehaviorScript *behavior) {
     s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
     if (modIndex == -1) {
         LOG_ERROR("Could not find behavior script mod index.");
-        return BHV_PROC_CONTINUE;
+    }
+    return modIndex;
+}
+
+// Resolves the behavior named by the token at <tokenOffset> of the current command.
+// Sets <token> to the name, which is NULL when the behavior's mod could not be found.
+static struct BhvExtResolution *bhv_ext_resolve_behavior(u32 tokenOffset, const char **token) {
+    struct BhvExtResolution *res = hmap_get(sBhvExtCache, (int64_t)(intptr_t)gCurBhvCommand);
+    if (res != NULL) {
+        *token = res->token;
+        return res;
     }
 
-    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(0));
+    *token = NULL;
+    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
+    s32 modIndex = bhv_ext_get_mod_index(behavior);
+    if (modIndex == -1) { return NULL; }
+
+    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(tokenOffset));
+    *token = behStr;
 
     gSmLuaConvertSuccess = true;
     enum BehaviorId behId = smlua_get_integer_mod_variable(modIndex, behStr);
@@ -929,86 +975,95 @@ static s32 bhv_cmd_call_ext(void) {
         behId = smlua_get_any_integer_mod_variable(behStr);
     }
 
-    if (!gSmLuaConvertSuccess) {
-        LOG_LUA("Failed to call address, could not find behavior '%s'", behStr);
-        return BHV_PROC_CONTINUE;
-    }
-
-    cur_obj_bhv_stack_push(BHV_CMD_GET_ADDR_OF_CMD(1)); // Store address of the next bhv command in the stack.
-    const BehaviorScript *jumpAddress = (BehaviorScript *)get_behavior_from_id(behId);
-    gCurBhvCommand = jumpAddress; // Jump to the new address.
+    if (!gSmLuaConvertSuccess) { return NULL; }
 
-    return BHV_PROC_CONTINUE;
+    return bhv_ext_cache_put(gCurBhvCommand, behStr, modIndex, behId, 0);
 }
 
-// Command 0x3B: Jumps to a new behavior script without saving anything.
-// Usage: GOTO_EXT(addr)
-static s32 bhv_cmd_goto_ext(void) {
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
-
-    s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
-    if (modIndex == -1) {
-        LOG_ERROR("Could not find behavior script mod index.");
-        return BHV_PROC_CONTINUE;
+// Resolves the Lua function named by the token at <tokenOffset> of the current command.
+// Sets <token> to the name, which is NULL when the behavior's mod could not be found.
+static struct BhvExtResolution *bhv_ext_resolve_function(u32 tokenOffset, const char **token) {
+    struct BhvExtResolution *res = hmap_get(sBhvExtCache, (int64_t)(intptr_t)gCurBhvCommand);
+    if (res != NULL) {
+        *token = res->token;
+        return res;
     }
 
-    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(0));
+    *token = NULL;
+    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
+    s32 modIndex = bhv_ext_get_mod_index(behavior);
+    if (modIndex == -1) { return NULL; }
+
+    const char *funcStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(tokenOffset));
+    *token = funcStr;
 
     gSmLuaConvertSuccess = true;
-    enum BehaviorId behId = smlua_get_integer_mod_variable(modIndex, behStr);
+    LuaFunction funcRef = smlua_get_function_mod_variable(modIndex, funcStr);
 
     if (!gSmLuaConvertSuccess) {
         gSmLuaConvertSuccess = true;
-        behId = smlua_get_any_integer_mod_variable(behStr);
+        funcRef = smlua_get_any_function_mod_variable(funcStr);
     }
 
-    if (!gSmLuaConvertSuccess) {
-        LOG_LUA("Failed to jump to address, could not find behavior '%s'", behStr);
-        return BHV_PROC_CONTINUE;
-    }
+    if (!gSmLuaConvertSuccess || funcRef == 0) { return NULL; }
 
-    gCurBhvCommand = (BehaviorScript *)get_behavior_from_id(behId); // Jump directly to address
-    return BHV_PROC_CONTINUE;
+    return bhv_ext_cache_put(gCurBhvCommand, funcStr, modIndex, 0, funcRef);
 }
 
-// Command 0x3C: Executes a lua function. Function must not take or return any values.
-// Usage: CALL_NATIVE_EXT(func)
-static s32 bhv_cmd_call_native_ext(void) {
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
+// Command 0x3A: Jumps to a new behavior command and stores the return address in the object's behavior stack.
+// Usage: CALL_EXT(addr)
+static s32 bhv_cmd_call_ext(void) {
+    gCurBhvCommand++;
 
-    s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
-    if (modIndex == -1) {
-        LOG_ERROR("Could not find behavior script mod index.");
-        gCurBhvCommand += 2;
+    const char *behStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_behavior(0, &behStr);
+    if (res == NULL) {
+        if (behStr) { LOG_LUA("Failed to call address, could not find behavior '%s'", behStr); }
         return BHV_PROC_CONTINUE;
     }
 
-    const char *funcStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(1));
+    cur_obj_bhv_stack_push(BHV_CMD_GET_ADDR_OF_CMD(1)); // Store address of the next bhv command in the stack.
+    const BehaviorScript *jumpAddress = (BehaviorScript *)get_behavior_from_id(res->behId);
+    gCurBhvCommand = jumpAddress; // Jump to the new address.
 
-    gSmLuaConvertSuccess = true;
-    LuaFunction funcRef = smlua_get_function_mod_variable(modIndex, funcStr);
+    return BHV_PROC_CONTINUE;
+}
 
-    if (!gSmLuaConvertSuccess) {
-        gSmLuaConvertSuccess = true;
-        funcRef = smlua_get_any_function_mod_variable(funcStr);
+// Command 0x3B: Jumps to a new behavior script without saving anything.
+// Usage: GOTO_EXT(addr)
+static s32 bhv_cmd_goto_ext(void) {
+    const char *behStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_behavior(0, &behStr);
+    if (res == NULL) {
+        if (behStr) { LOG_LUA("Failed to jump to address, could not find behavior '%s'", behStr); }
+        return BHV_PROC_CONTINUE;
     }
 
-    if (!gSmLuaConvertSuccess || funcRef == 0) {
-        LOG_LUA("Failed to call lua function, could not find lua function '%s'", funcStr);
+    gCurBhvCommand = (BehaviorScript *)get_behavior_from_id(res->behId); // Jump directly to address
+    return BHV_PROC_CONTINUE;
+}
+
+// Command 0x3C: Executes a lua function. Function must not take or return any values.
+// Usage: CALL_NATIVE_EXT(func)
+static s32 bhv_cmd_call_native_ext(void) {
+    const char *funcStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_function(1, &funcStr);
+    if (res == NULL) {
+        if (funcStr) { LOG_LUA("Failed to call lua function, could not find lua function '%s'", funcStr); }
         gCurBhvCommand += 2;
         return BHV_PROC_CONTINUE;
     }
 
     // Get our mod.
-    if (modIndex >= gActiveMods.entryCount) {
+    if (res->modIndex >= gActiveMods.entryCount) {
         LOG_LUA("Failed to call lua function, could not find mod");
         gCurBhvCommand += 2;
         return BHV_PROC_CONTINUE;
     }
-    struct Mod *mod = gActiveMods.entries[modIndex];
+    struct Mod *mod = gActiveMods.entries[res->modIndex];
 
     // Push the callback onto the stack
-    lua_rawgeti(gLuaState, LUA_REGISTRYINDEX, funcRef);
+    lua_rawgeti(gLuaState, LUA_REGISTRYINDEX, res->funcRef);
 
     // Push object
     smlua_push_object(gLuaState, LOT_OBJECT, gCurrentObject, NULL);
@@ -1027,30 +1082,14 @@ static s32 bhv_cmd_call_native_ext(void) {
 static s32 bhv_cmd_spawn_child_ext(void) {
     u32 model = BHV_CMD_GET_U32(1);
 
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
-
-    s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
-    if (modIndex == -1) {
-        LOG_ERROR("Could not find behavior script mod index.");
-        gCurBhvCommand += 3;
-        return BHV_PROC_CONTINUE;
-    }
-
-    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(2));
-
-    gSmLuaConvertSuccess = true;
-    enum BehaviorId behId = smlua_get_integer_mod_variable(modIndex, behStr);
-
-    if (!gSmLuaConvertSuccess) {
-        gSmLuaConvertSuccess = true;
-        behId = smlua_get_any_integer_mod_variable(behStr);
-    }
-
-    if (!gSmLuaConvertSuccess) {
-        LOG_LUA("Failed to spawn custom child, could not find behavior '%s'", behStr);
+    const char *behStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_behavior(2, &behStr);
+    if (res == NULL) {
+        if (behStr) { LOG_LUA("Failed to spawn custom child, could not find behavior '%s'", behStr); }
         gCurBhvCommand += 3;
         return BHV_PROC_CONTINUE;
     }
+    enum BehaviorId behId = res->behId;
 
     BehaviorScript *childBhvScript = (BehaviorScript *)get_behavior_from_id(behId);
     if (childBhvScript == NULL) {
@@ -1074,30 +1113,14 @@ static s32 bhv_cmd_spawn_child_with_param_ext(void) {
     u32 bhvParam = BHV_CMD_GET_2ND_S16(0);
     u32 modelID = BHV_CMD_GET_U32(1);
 
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
-
-    s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
-    if (modIndex == -1) {
-        LOG_ERROR("Could not find behavior script mod index.");
-        gCurBhvCommand += 3;
-        return BHV_PROC_CONTINUE;
-    }
-
-    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(2));
-
-    gSmLuaConvertSuccess = true;
-    enum BehaviorId behId = smlua_get_integer_mod_variable(modIndex, behStr);
-
-    if (!gSmLuaConvertSuccess) {
-        gSmLuaConvertSuccess = true;
-        behId = smlua_get_any_integer_mod_variable(behStr);
-    }
-
-    if (!gSmLuaConvertSuccess) {
-        LOG_LUA("Failed to spawn custom child with params, could not find behavior '%s'", behStr);
+    const char *behStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_behavior(2, &behStr);
+    if (res == NULL) {
+        if (behStr) { LOG_LUA("Failed to spawn custom child with params, could not find behavior '%s'", behStr); }
         gCurBhvCommand += 3;
         return BHV_PROC_CONTINUE;
     }
+    enum BehaviorId behId = res->behId;
 
     BehaviorScript *childBhvScript = (BehaviorScript *)get_behavior_from_id(behId);
     if (childBhvScript == NULL) {
@@ -1121,30 +1144,14 @@ static s32 bhv_cmd_spawn_child_with_param_ext(void) {
 static s32 bhv_cmd_spawn_obj_ext(void) {
     u32 modelID = BHV_CMD_GET_U32(1);
 
-    BehaviorScript *behavior = (BehaviorScript *)gCurrentObject->behavior;
-
-    s32 modIndex = dynos_behavior_get_active_mod_index(behavior);
-    if (modIndex == -1) {
-        LOG_ERROR("Could not find behavior script mod index.");
-        gCurBhvCommand += 3;
-        return BHV_PROC_CONTINUE;
-    }
-
-    const char *behStr = dynos_behavior_get_token(behavior, BHV_CMD_GET_U32(2));
-
-    gSmLuaConvertSuccess = true;
-    enum BehaviorId behId = smlua_get_integer_mod_variable(modIndex, behStr);
-
-    if (!gSmLuaConvertSuccess) {
-        gSmLuaConvertSuccess = true;
-        behId = smlua_get_any_integer_mod_variable(behStr);
-    }
-
-    if (!gSmLuaConvertSuccess) {
-        LOG_LUA("Failed to spawn custom object, could not find behavior '%s'", behStr);
+    const char *behStr = NULL;
+    struct BhvExtResolution *res = bhv_ext_resolve_behavior(2, &behStr);
+    if (res == NULL) {
+        if (behStr) { LOG_LUA("Failed to spawn custom object, could not find behavior '%s'", behStr); }
         gCurBhvCommand += 3;
         return BHV_PROC_CONTINUE;
     }
+    enum BehaviorId behId = res->behId;
 
     BehaviorScript *objBhvScript = (BehaviorScript *)get_behavior_from_id(behId);
     if (objBhvScript == NULL) {
@@ -29,6 +29,7 @@ s32 random_sign(void);
 void stub_behavior_script_2(void);
 
 void cur_obj_update(void);
+void behavior_ext_cache_clear(void);
 
 /* |description|Updates an object's graphical position and angle|descriptionEnd| */
 void obj_update_gfx_pos_and_angle(struct Object *obj);
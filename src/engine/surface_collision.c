@@ -1,4 +1,7 @@
 #include <PR/ultratypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "sm64.h"
 #include "game/debug.h"
@@ -12,10 +15,16 @@
 #include "game/hardcoded.h"
 #include "pc/utils/misc.h"
 #include "pc/network/network.h"
+#include "pc/thread.h"
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 Vec3f gFindWallDirection = { 0 };
 u8 gFindWallDirectionActive = false;
 u8 gFindWallDirectionAirborne = false;
+u8 gInterpolatingSurfaces;
 
 #define CLAMP(_val, _min, _max) MAX(MIN((_val), _max), _min)
 
@@ -104,209 +113,379 @@ static void closest_point_to_triangle(struct Surface* surf, Vec3f src, Vec3f out
     out[2] = v1[2] + s * edge0[2] + t * edge1[2];
 }
 
+/**
+ * Returns TRUE if the surface should be ignored by the current query, either
+ * because of the camera flags or because the current object can pass through
+ * vanish cap surfaces.
+ */
+static s32 surface_is_ignored(struct Surface *surf, s32 checkVanishCap) {
+    // Determine if checking for the camera or not.
+    if (gCheckingSurfaceCollisionsForCamera != 0) {
+        return (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION) != 0;
+    }
+
+    // Ignore camera only surfaces.
+    if (surf->type == SURFACE_CAMERA_BOUNDARY || surf->type == SURFACE_RAYCAST) {
+        return TRUE;
+    }
+
+    // If an object can pass through a vanish cap surface, pass through.
+    if (checkVanishCap && surf->type == SURFACE_VANISH_CAP_WALLS) {
+        if (gCurrentObject != NULL
+            && (gCurrentObject->activeFlags & ACTIVE_FLAG_MOVE_THROUGH_GRATE)) {
+            return TRUE;
+        }
+
+        // If Mario has a vanish cap, pass through the vanish cap surface.
+        for (s32 i = 0; i < MAX_PLAYERS; i++) {
+            if (gCurrentObject != NULL && gCurrentObject == gMarioStates[i].marioObj
+                && (gMarioStates[i].flags & MARIO_VANISH_CAP)) {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+/**************************************************
+ *                 PACKED SURFACES                *
+ **************************************************/
+
+/**
+ * The static partition is also baked into gStaticPackedSurfaces. The packed
+ * walks test four triangles at a time and only touch the Surface of the ones
+ * that pass, then apply the same filters in the same order as the list walks.
+ * Interpolated and per-object queries still walk the lists.
+ */
+static u8 use_packed_surfaces(void) {
+    if (gStaticSurfacesModified) { refresh_static_surfaces(); }
+    return gStaticPackedSurfaces.count != 0
+        && !gInterpolatingSurfaces
+        && gCheckingSurfaceCollisionsForObject == NULL;
+}
+
+/**
+ * Bitmask of the lanes of a packed group that belong to the list.
+ */
+static u32 packed_lane_mask(u32 remaining) {
+    return (remaining >= PACKED_SURFACE_ALIGN) ? 0xF : ((1 << remaining) - 1);
+}
+
+/**
+ * Bitmask of the floors in a packed group that (x, z) lies over. Matches the
+ * edge tests of find_floor_from_list exactly.
+ */
+static u32 packed_floor_mask(struct PackedSurfaces *packed, u32 base, f32 x, f32 z) {
+#ifdef __SSE__
+    __m128 px = _mm_set1_ps(x);
+    __m128 pz = _mm_set1_ps(z);
+    __m128 x1 = _mm_loadu_ps(&packed->x1[base]);
+    __m128 z1 = _mm_loadu_ps(&packed->z1[base]);
+    __m128 x2 = _mm_loadu_ps(&packed->x2[base]);
+    __m128 z2 = _mm_loadu_ps(&packed->z2[base]);
+    __m128 x3 = _mm_loadu_ps(&packed->x3[base]);
+    __m128 z3 = _mm_loadu_ps(&packed->z3[base]);
+    __m128 zero = _mm_setzero_ps();
+
+    __m128 e1 = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(z1, pz), _mm_sub_ps(x2, x1)), _mm_mul_ps(_mm_sub_ps(x1, px), _mm_sub_ps(z2, z1)));
+    __m128 e2 = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(z2, pz), _mm_sub_ps(x3, x2)), _mm_mul_ps(_mm_sub_ps(x2, px), _mm_sub_ps(z3, z2)));
+    __m128 e3 = _mm_sub_ps(_mm_mul_ps(_mm_sub_ps(z3, pz), _mm_sub_ps(x1, x3)), _mm_mul_ps(_mm_sub_ps(x3, px), _mm_sub_ps(z1, z3)));
+
+    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpnlt_ps(e1, zero), _mm_cmpnlt_ps(e2, zero)), _mm_cmpnlt_ps(e3, zero));
+    return (u32) _mm_movemask_ps(inside);
+#else
+    u32 mask = 0;
+    for (u32 lane = 0; lane < PACKED_SURFACE_ALIGN; lane++) {
+        u32 i = base + lane;
+        f32 x1 = packed->x1[i], z1 = packed->z1[i];
+        f32 x2 = packed->x2[i], z2 = packed->z2[i];
+        f32 x3 = packed->x3[i], z3 = packed->z3[i];
+        if ((z1 - z) * (x2 - x1) - (x1 - x) * (z2 - z1) < 0) { continue; }
+        if ((z2 - z) * (x3 - x2) - (x2 - x) * (z3 - z2) < 0) { continue; }
+        if ((z3 - z) * (x1 - x3) - (x3 - x) * (z1 - z3) < 0) { continue; }
+        mask |= (1 << lane);
+    }
+    return mask;
+#endif
+}
+
+/**
+ * Bitmask of the walls in a packed group whose height range contains y.
+ */
+static u32 packed_wall_mask(struct PackedSurfaces *packed, u32 base, f32 y) {
+#ifdef __SSE__
+    __m128 py = _mm_set1_ps(y);
+    __m128 lowerY = _mm_loadu_ps(&packed->lowerY[base]);
+    __m128 upperY = _mm_loadu_ps(&packed->upperY[base]);
+    __m128 inside = _mm_and_ps(_mm_cmpnlt_ps(py, lowerY), _mm_cmpngt_ps(py, upperY));
+    return (u32) _mm_movemask_ps(inside);
+#else
+    u32 mask = 0;
+    for (u32 lane = 0; lane < PACKED_SURFACE_ALIGN; lane++) {
+        u32 i = base + lane;
+        if (y < packed->lowerY[i] || y > packed->upperY[i]) { continue; }
+        mask |= (1 << lane);
+    }
+    return mask;
+#endif
+}
+
+#ifdef DEVELOPMENT
+/**
+ * Recent floor, ceiling and wall queries, kept so the collision bench can
+ * replay real movement against the loaded level.
+ */
+enum CollisionQueryType {
+    COLLISION_QUERY_FLOOR,
+    COLLISION_QUERY_CEIL,
+    COLLISION_QUERY_WALL,
+    COLLISION_QUERY_MAX,
+};
+
+struct CollisionQuery {
+    u8 type;
+    u8 camera;
+    f32 x, y, z;
+    f32 offsetY, radius;
+};
+
+#define COLLISION_QUERY_LOG_SIZE 8192
+static struct CollisionQuery sCollisionQueryLog[COLLISION_QUERY_LOG_SIZE];
+static u32 sCollisionQueryLogCount = 0;
+
+static void collision_query_record(u8 type, f32 x, f32 y, f32 z, f32 offsetY, f32 radius) {
+    struct CollisionQuery *query = &sCollisionQueryLog[sCollisionQueryLogCount++ % COLLISION_QUERY_LOG_SIZE];
+    query->type = type;
+    query->camera = (gCheckingSurfaceCollisionsForCamera != 0);
+    query->x = x;
+    query->y = y;
+    query->z = z;
+    query->offsetY = offsetY;
+    query->radius = radius;
+}
+#else
+#define collision_query_record(...)
+#endif
+
 /**************************************************
  *                      WALLS                     *
  **************************************************/
 
 /**
- * Iterate through the list of walls until all walls are checked and
- * have given their wall push.
+ * Test a single wall against the query and give its wall push. `xPtr` and
+ * `zPtr` hold the position the query is checked at, which rounded corners
+ * move along with the push.
  */
-static s32 find_wall_collisions_from_list(struct SurfaceNode *surfaceNode,
-                                          struct WallCollisionData *data) {
-    register struct Surface *surf;
+static s32 find_wall_collision_with_surface(struct Surface *surf, struct WallCollisionData *data,
+                                            f32 radius, f32 y, f32 *xPtr, f32 *zPtr) {
     register f32 offset = 0;
-    register f32 radius = data->radius;
-    register f32 x = data->x;
-    register f32 y = data->y + data->offsetY;
-    register f32 z = data->z;
+    register f32 x = *xPtr;
+    register f32 z = *zPtr;
     register f32 px, pz;
     register f32 w1, w2, w3;
     register f32 y1, y2, y3;
-    s32 numCols = 0;
 
     Vec3f cPos = { 0 };
     Vec3f cNorm = { 0 };
 
-    // Max collision radius = 200
-    if (radius > 200.0f) {
-        radius = 200.0f;
-    }
-
-    // Stay in this loop until out of walls.
-    while (surfaceNode != NULL) {
-        surf = surfaceNode->surface;
-        surfaceNode = surfaceNode->next;
-
-        // Exclude a large number of walls immediately to optimize.
-        if (y < surf->lowerY || y > surf->upperY) {
-            continue;
+    if (gLevelValues.fixCollisionBugs && gLevelValues.fixCollisionBugsRoundedCorners && !gFindWallDirectionAirborne) {
+        // Check AABB to exclude walls before doing expensive triangle check
+        f32 minX = MIN(MIN(surf->vertex1[0], surf->vertex2[0]), surf->vertex3[0]) - radius;
+        f32 minZ = MIN(MIN(surf->vertex1[2], surf->vertex2[2]), surf->vertex3[2]) - radius;
+        f32 maxX = MAX(MAX(surf->vertex1[0], surf->vertex2[0]), surf->vertex3[0]) + radius;
+        f32 maxZ = MAX(MAX(surf->vertex1[2], surf->vertex2[2]), surf->vertex3[2]) + radius;
+        if (x < minX || x > maxX) { return FALSE; }
+        if (z < minZ || z > maxZ) { return FALSE; }
+
+        // Exclude triangles from wrong movement side
+        Vec3f norm = { surf->normal.x, surf->normal.y, surf->normal.z };
+        if (gFindWallDirectionActive) {
+            if (vec3f_dot(norm, gFindWallDirection) > 0) {
+                return FALSE;
+            }
         }
 
-        if (gLevelValues.fixCollisionBugs && gLevelValues.fixCollisionBugsRoundedCorners && !gFindWallDirectionAirborne) {
-            // Check AABB to exclude walls before doing expensive triangle check
-            f32 minX = MIN(MIN(surf->vertex1[0], surf->vertex2[0]), surf->vertex3[0]) - radius;
-            f32 minZ = MIN(MIN(surf->vertex1[2], surf->vertex2[2]), surf->vertex3[2]) - radius;
-            f32 maxX = MAX(MAX(surf->vertex1[0], surf->vertex2[0]), surf->vertex3[0]) + radius;
-            f32 maxZ = MAX(MAX(surf->vertex1[2], surf->vertex2[2]), surf->vertex3[2]) + radius;
-            if (x < minX || x > maxX) { continue; }
-            if (z < minZ || z > maxZ) { continue; }
-
-            // Exclude triangles from wrong movement side
-            Vec3f norm = { surf->normal.x, surf->normal.y, surf->normal.z };
-            if (gFindWallDirectionActive) {
-                if (vec3f_dot(norm, gFindWallDirection) > 0) {
-                    continue;
-                }
-            }
+        // Find closest point to triangle
+        Vec3f src = { x, y, z };
+        closest_point_to_triangle(surf, src, cPos);
 
-            // Find closest point to triangle
-            Vec3f src = { x, y, z };
-            closest_point_to_triangle(surf, src, cPos);
+        // Exclude triangles where y isn't inside of it
+        if (fabs(cPos[1] - y) > 1) { return FALSE; }
 
-            // Exclude triangles where y isn't inside of it
-            if (fabs(cPos[1] - y) > 1) { continue; }
+        // Figure out normal
+        f32 dX = src[0] - cPos[0];
+        f32 dZ = src[2] - cPos[2];
+        f32 dist = sqrtf(dX * dX + dZ * dZ);
+        if (dist > radius) { return FALSE; }
 
-            // Figure out normal
-            f32 dX = src[0] - cPos[0];
-            f32 dZ = src[2] - cPos[2];
-            f32 dist = sqrtf(dX * dX + dZ * dZ);
-            if (dist > radius) { continue; }
+        if (dist < __FLT_EPSILON__) {
+            dist = __FLT_EPSILON__;
+        }
 
-            if (dist < __FLT_EPSILON__) {
-                dist = __FLT_EPSILON__;
-            }
+        cNorm[0] = dX / dist;
+        cNorm[1] = 0;
+        cNorm[2] = dZ / dist;
 
-            cNorm[0] = dX / dist;
-            cNorm[1] = 0;
-            cNorm[2] = dZ / dist;
+        // Exclude triangles that are colliding from the wrong side
+        if (!gFindWallDirectionActive && vec3f_dot(norm, cNorm) < 0) { return FALSE; }
 
-            // Exclude triangles that are colliding from the wrong side
-            if (!gFindWallDirectionActive && vec3f_dot(norm, cNorm) < 0) { continue; }
+    } else {
 
-        } else {
+        offset = surf->normal.x * x + surf->normal.y * y + surf->normal.z * z + surf->originOffset;
 
-            offset = surf->normal.x * x + surf->normal.y * y + surf->normal.z * z + surf->originOffset;
+        if (offset < -radius || offset > radius) {
+            return FALSE;
+        }
 
-            if (offset < -radius || offset > radius) {
-                continue;
-            }
+        px = x;
+        pz = z;
 
-            px = x;
-            pz = z;
-
-            //! (Quantum Tunneling) Due to issues with the vertices walls choose and
-            //  the fact they are floating point, certain floating point positions
-            //  along the seam of two walls may collide with neither wall or both walls.
-            if (surf->flags & SURFACE_FLAG_X_PROJECTION) {
-                w1 = -surf->vertex1[2]; w2 = -surf->vertex2[2]; w3 = -surf->vertex3[2];
-                y1 = surf->vertex1[1];  y2 = surf->vertex2[1];  y3 = surf->vertex3[1];
-
-                if (surf->normal.x > 0.0f) {
-                    if ((y1 - y) * (w2 - w1) - (w1 - -pz) * (y2 - y1) > 0.0f) {
-                        continue;
-                    }
-                    if ((y2 - y) * (w3 - w2) - (w2 - -pz) * (y3 - y2) > 0.0f) {
-                        continue;
-                    }
-                    if ((y3 - y) * (w1 - w3) - (w3 - -pz) * (y1 - y3) > 0.0f) {
-                        continue;
-                    }
-                } else {
-                    if ((y1 - y) * (w2 - w1) - (w1 - -pz) * (y2 - y1) < 0.0f) {
-                        continue;
-                    }
-                    if ((y2 - y) * (w3 - w2) - (w2 - -pz) * (y3 - y2) < 0.0f) {
-                        continue;
-                    }
-                    if ((y3 - y) * (w1 - w3) - (w3 - -pz) * (y1 - y3) < 0.0f) {
-                        continue;
-                    }
+        //! (Quantum Tunneling) Due to issues with the vertices walls choose and
+        //  the fact they are floating point, certain floating point positions
+        //  along the seam of two walls may collide with neither wall or both walls.
+        if (surf->flags & SURFACE_FLAG_X_PROJECTION) {
+            w1 = -surf->vertex1[2]; w2 = -surf->vertex2[2]; w3 = -surf->vertex3[2];
+            y1 = surf->vertex1[1];  y2 = surf->vertex2[1];  y3 = surf->vertex3[1];
+
+            if (surf->normal.x > 0.0f) {
+                if ((y1 - y) * (w2 - w1) - (w1 - -pz) * (y2 - y1) > 0.0f) {
+                    return FALSE;
+                }
+                if ((y2 - y) * (w3 - w2) - (w2 - -pz) * (y3 - y2) > 0.0f) {
+                    return FALSE;
+                }
+                if ((y3 - y) * (w1 - w3) - (w3 - -pz) * (y1 - y3) > 0.0f) {
+                    return FALSE;
                 }
             } else {
-                w1 = surf->vertex1[0]; w2 = surf->vertex2[0]; w3 = surf->vertex3[0];
-                y1 = surf->vertex1[1]; y2 = surf->vertex2[1]; y3 = surf->vertex3[1];
-
-                if (surf->normal.z > 0.0f) {
-                    if ((y1 - y) * (w2 - w1) - (w1 - px) * (y2 - y1) > 0.0f) {
-                        continue;
-                    }
-                    if ((y2 - y) * (w3 - w2) - (w2 - px) * (y3 - y2) > 0.0f) {
-                        continue;
-                    }
-                    if ((y3 - y) * (w1 - w3) - (w3 - px) * (y1 - y3) > 0.0f) {
-                        continue;
-                    }
-                } else {
-                    if ((y1 - y) * (w2 - w1) - (w1 - px) * (y2 - y1) < 0.0f) {
-                        continue;
-                    }
-                    if ((y2 - y) * (w3 - w2) - (w2 - px) * (y3 - y2) < 0.0f) {
-                        continue;
-                    }
-                    if ((y3 - y) * (w1 - w3) - (w3 - px) * (y1 - y3) < 0.0f) {
-                        continue;
-                    }
+                if ((y1 - y) * (w2 - w1) - (w1 - -pz) * (y2 - y1) < 0.0f) {
+                    return FALSE;
+                }
+                if ((y2 - y) * (w3 - w2) - (w2 - -pz) * (y3 - y2) < 0.0f) {
+                    return FALSE;
+                }
+                if ((y3 - y) * (w1 - w3) - (w3 - -pz) * (y1 - y3) < 0.0f) {
+                    return FALSE;
                 }
-            }
-        }
-
-        // Determine if checking for the camera or not.
-        if (gCheckingSurfaceCollisionsForCamera) {
-            if (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION) {
-                continue;
             }
         } else {
-            // Ignore camera only surfaces.
-            if (surf->type == SURFACE_CAMERA_BOUNDARY || surf->type == SURFACE_RAYCAST) {
-                continue;
-            }
+            w1 = surf->vertex1[0]; w2 = surf->vertex2[0]; w3 = surf->vertex3[0];
+            y1 = surf->vertex1[1]; y2 = surf->vertex2[1]; y3 = surf->vertex3[1];
 
-            // If an object can pass through a vanish cap wall, pass through.
-            if (surf->type == SURFACE_VANISH_CAP_WALLS) {
-                // If an object can pass through a vanish cap wall, pass through.
-                if (gCurrentObject != NULL
-                    && (gCurrentObject->activeFlags & ACTIVE_FLAG_MOVE_THROUGH_GRATE)) {
-                    continue;
+            if (surf->normal.z > 0.0f) {
+                if ((y1 - y) * (w2 - w1) - (w1 - px) * (y2 - y1) > 0.0f) {
+                    return FALSE;
                 }
-
-                // If Mario has a vanish cap, pass through the vanish cap wall.
-                u8 passThroughWall = FALSE;
-                for (s32 i = 0; i < MAX_PLAYERS; i++) {
-                    if (gCurrentObject != NULL && gCurrentObject == gMarioStates[i].marioObj
-                        && (gMarioStates[i].flags & MARIO_VANISH_CAP)) {
-                        passThroughWall = TRUE;
-                        break;
-                    }
+                if ((y2 - y) * (w3 - w2) - (w2 - px) * (y3 - y2) > 0.0f) {
+                    return FALSE;
+                }
+                if ((y3 - y) * (w1 - w3) - (w3 - px) * (y1 - y3) > 0.0f) {
+                    return FALSE;
+                }
+            } else {
+                if ((y1 - y) * (w2 - w1) - (w1 - px) * (y2 - y1) < 0.0f) {
+                    return FALSE;
+                }
+                if ((y2 - y) * (w3 - w2) - (w2 - px) * (y3 - y2) < 0.0f) {
+                    return FALSE;
+                }
+                if ((y3 - y) * (w1 - w3) - (w3 - px) * (y1 - y3) < 0.0f) {
+                    return FALSE;
                 }
-                if (passThroughWall) { continue; }
             }
         }
+    }
 
-        //! (Wall Overlaps) Because this doesn't update the x and z local variables,
-        //  multiple walls can push mario more than is required.
-        //  <Fixed when gLevelValues.fixCollisionBugs != 0>
-        if (gLevelValues.fixCollisionBugs && gLevelValues.fixCollisionBugsRoundedCorners && !gFindWallDirectionAirborne) {
-            data->x = cPos[0] + cNorm[0] * radius;
-            data->z = cPos[2] + cNorm[2] * radius;
-            x = data->x;
-            z = data->z;
-            data->normalAddition[0] += cNorm[0];
-            data->normalAddition[2] += cNorm[2];
-            data->normalCount++;
-        } else {
-            data->x += surf->normal.x * (radius - offset);
-            data->z += surf->normal.z * (radius - offset);
-        }
+    if (surface_is_ignored(surf, TRUE)) {
+        return FALSE;
+    }
+
+    //! (Wall Overlaps) Because this doesn't update the x and z local variables,
+    //  multiple walls can push mario more than is required.
+    //  <Fixed when gLevelValues.fixCollisionBugs != 0>
+    if (gLevelValues.fixCollisionBugs && gLevelValues.fixCollisionBugsRoundedCorners && !gFindWallDirectionAirborne) {
+        data->x = cPos[0] + cNorm[0] * radius;
+        data->z = cPos[2] + cNorm[2] * radius;
+        *xPtr = data->x;
+        *zPtr = data->z;
+        data->normalAddition[0] += cNorm[0];
+        data->normalAddition[2] += cNorm[2];
+        data->normalCount++;
+    } else {
+        data->x += surf->normal.x * (radius - offset);
+        data->z += surf->normal.z * (radius - offset);
+    }
+
+    //! (Unreferenced Walls) Since this only returns the first four walls,
+    //  this can lead to wall interaction being missed. Typically unreferenced walls
+    //  come from only using one wall, however.
+    if (data->numWalls < 4) {
+        data->walls[data->numWalls++] = surf;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Iterate through the list of walls until all walls are checked and
+ * have given their wall push.
+ */
+static s32 find_wall_collisions_from_list(struct SurfaceNode *surfaceNode,
+                                          struct WallCollisionData *data) {
+    register struct Surface *surf;
+    register f32 radius = data->radius;
+    f32 x = data->x;
+    register f32 y = data->y + data->offsetY;
+    f32 z = data->z;
+    s32 numCols = 0;
+
+    // Max collision radius = 200
+    if (radius > 200.0f) {
+        radius = 200.0f;
+    }
+
+    // Stay in this loop until out of walls.
+    while (surfaceNode != NULL) {
+        surf = surfaceNode->surface;
+        surfaceNode = surfaceNode->next;
 
-        //! (Unreferenced Walls) Since this only returns the first four walls,
-        //  this can lead to wall interaction being missed. Typically unreferenced walls
-        //  come from only using one wall, however.
-        if (data->numWalls < 4) {
-            data->walls[data->numWalls++] = surf;
+        // Exclude a large number of walls immediately to optimize.
+        if (y < surf->lowerY || y > surf->upperY) {
+            continue;
         }
 
-        numCols++;
+        numCols += find_wall_collision_with_surface(surf, data, radius, y, &x, &z);
+    }
+
+    return numCols;
+}
+
+/**
+ * Packed version of find_wall_collisions_from_list for the static partition.
+ */
+static s32 find_wall_collisions_from_packed(struct PackedSurfaceList *list,
+                                            struct WallCollisionData *data) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    f32 radius = data->radius;
+    f32 x = data->x;
+    f32 y = data->y + data->offsetY;
+    f32 z = data->z;
+    s32 numCols = 0;
+    u32 end = list->offset + list->count;
+
+    // Max collision radius = 200
+    if (radius > 200.0f) {
+        radius = 200.0f;
+    }
+
+    for (u32 base = list->offset; base < end; base += PACKED_SURFACE_ALIGN) {
+        u32 mask = packed_wall_mask(packed, base, y) & packed_lane_mask(end - base);
+        while (mask != 0) {
+            u32 i = base + __builtin_ctz(mask);
+            mask &= mask - 1;
+            numCols += find_wall_collision_with_surface(packed->surface[i], data, radius, y, &x, &z);
+        }
     }
 
     return numCols;
@@ -337,11 +516,32 @@ s32 f32_find_wall_collision(f32 *xPtr, f32 *yPtr, f32 *zPtr, f32 offsetY, f32 ra
     return numCollisions;
 }
 
+/**
+ * Find the wall collisions in a cell and receive their push.
+ */
+static s32 find_wall_collisions_in_cell(s16 cellX, s16 cellZ, struct WallCollisionData *colData) {
+    struct SurfaceNode *node;
+    s32 numCollisions = 0;
+
+    // Check for surfaces belonging to objects.
+    node = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next;
+    numCollisions += find_wall_collisions_from_list(node, colData);
+
+    // Check for surfaces that are a part of level geometry.
+    if (use_packed_surfaces()) {
+        numCollisions += find_wall_collisions_from_packed(&gStaticPackedSurfaces.lists[cellZ][cellX][SPATIAL_PARTITION_WALLS], colData);
+    } else {
+        node = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next;
+        numCollisions += find_wall_collisions_from_list(node, colData);
+    }
+
+    return numCollisions;
+}
+
 /**
  * Find wall collisions and receive their push.
  */
 s32 find_wall_collisions(struct WallCollisionData *colData) {
-    struct SurfaceNode *node;
     s16 cellX, cellZ;
     s32 numCollisions = 0;
     s16 x = colData->x;
@@ -363,13 +563,9 @@ s32 find_wall_collisions(struct WallCollisionData *colData) {
     cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
     cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
 
-    // Check for surfaces belonging to objects.
-    node = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next;
-    numCollisions += find_wall_collisions_from_list(node, colData);
+    collision_query_record(COLLISION_QUERY_WALL, colData->x, colData->y, colData->z, colData->offsetY, colData->radius);
 
-    // Check for surfaces that are a part of level geometry.
-    node = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next;
-    numCollisions += find_wall_collisions_from_list(node, colData);
+    numCollisions = find_wall_collisions_in_cell(cellX, cellZ, colData);
 
     // Increment the debug tracker.
     gNumCalls.wall += 1;
@@ -421,36 +617,8 @@ static struct Surface *find_ceil_from_list(struct SurfaceNode *surfaceNode, s32
             continue;
         }
 
-        // Determine if checking for the camera or not.
-        if (gCheckingSurfaceCollisionsForCamera != 0) {
-            if (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION) {
-                continue;
-            }
-        }
-        else {
-            // Ignore camera only surfaces.
-            if (surf->type == SURFACE_CAMERA_BOUNDARY || surf->type == SURFACE_RAYCAST) {
-                continue;
-            }
-
-            // If an object can pass through a vanish cap surface, pass through.
-            if (gLevelValues.fixVanishFloors && surf->type == SURFACE_VANISH_CAP_WALLS) {
-                if (gCurrentObject != NULL
-                    && (gCurrentObject->activeFlags & ACTIVE_FLAG_MOVE_THROUGH_GRATE)) {
-                    continue;
-                }
-
-                // If Mario has a vanish cap, pass through the vanish cap surface.
-                u8 passThrough = FALSE;
-                for (s32 i = 0; i < MAX_PLAYERS; i++) {
-                    if (gCurrentObject != NULL && gCurrentObject == gMarioStates[i].marioObj
-                        && (gMarioStates[i].flags & MARIO_VANISH_CAP)) {
-                        passThrough = TRUE;
-                        break;
-                    }
-                }
-                if (passThrough) { continue; }
-            }
+        if (surface_is_ignored(surf, gLevelValues.fixVanishFloors)) {
+            continue;
         }
 
         {
@@ -496,14 +664,96 @@ static struct Surface *find_ceil_from_list(struct SurfaceNode *surfaceNode, s32
 }
 
 /**
- * Find the lowest ceiling above a given position and return the height.
+ * Packed version of find_ceil_from_list for the static partition. The edge
+ * tests stay in integer math like the list walk, so they aren't vectorized.
  */
-f32 find_ceil(f32 posX, f32 posY, f32 posZ, struct Surface **pceil) {
-    s16 cellZ, cellX;
+static struct Surface *find_ceil_from_packed(struct PackedSurfaceList *list, s32 x, s32 y, s32 z, f32 *pheight) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    struct Surface *ceil = NULL;
+    u32 end = list->offset + list->count;
+
+    // set pheight to highest value
+    if (gLevelValues.fixCollisionBugs) {
+        *pheight = gLevelValues.cellHeightLimit;
+    }
+
+    for (u32 i = list->offset; i < end; i++) {
+        s32 x1 = packed->x1[i];
+        s32 z1 = packed->z1[i];
+        s32 x2 = packed->x2[i];
+        s32 z2 = packed->z2[i];
+        s32 x3 = packed->x3[i];
+        s32 z3 = packed->z3[i];
+
+        // Checking if point is in bounds of the triangle laterally.
+        if ((z1 - z) * (x2 - x1) - (x1 - x) * (z2 - z1) > 0) { continue; }
+        if ((z2 - z) * (x3 - x2) - (x2 - x) * (z3 - z2) > 0) { continue; }
+        if ((z3 - z) * (x1 - x3) - (x3 - x) * (z1 - z3) > 0) { continue; }
+
+        struct Surface *surf = packed->surface[i];
+        if (surface_is_ignored(surf, gLevelValues.fixVanishFloors)) {
+            continue;
+        }
+
+        f32 ny = packed->normalY[i];
+        if (ny == 0.0f) { continue; }
+
+        f32 height = -(x * packed->normalX[i] + packed->normalZ[i] * z + surf->originOffset) / ny;
+        if (gLevelValues.fixCollisionBugs && (height > *pheight)) { continue; }
+        if (y - (height - -78.0f) > 0.0f) { continue; }
+
+        *pheight = height;
+        ceil = surf;
+
+        if (!gLevelValues.fixCollisionBugs) {
+            break;
+        }
+    }
+
+    return ceil;
+}
+
+/**
+ * Find the ceiling of the level geometry in a cell.
+ */
+static struct Surface *find_static_ceil(s16 cellX, s16 cellZ, s32 x, s32 y, s32 z, f32 *pheight) {
+    if (use_packed_surfaces()) {
+        return find_ceil_from_packed(&gStaticPackedSurfaces.lists[cellZ][cellX][SPATIAL_PARTITION_CEILS], x, y, z, pheight);
+    }
+    return find_ceil_from_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next, x, y, z, pheight);
+}
+
+/**
+ * Find the lowest ceiling above a position in a cell and return the height.
+ */
+static f32 find_ceil_in_cell(s16 cellX, s16 cellZ, s32 x, s32 y, s32 z, struct Surface **pceil) {
     struct Surface *ceil, *dynamicCeil;
     struct SurfaceNode *surfaceList;
     f32 height = gLevelValues.cellHeightLimit;
     f32 dynamicHeight = gLevelValues.cellHeightLimit;
+
+    // Check for surfaces belonging to objects.
+    surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next;
+    dynamicCeil = find_ceil_from_list(surfaceList, x, y, z, &dynamicHeight);
+
+    // Check for surfaces that are a part of level geometry.
+    ceil = find_static_ceil(cellX, cellZ, x, y, z, &height);
+
+    if (dynamicHeight < height) {
+        ceil = dynamicCeil;
+        height = dynamicHeight;
+    }
+
+    *pceil = ceil;
+    return height;
+}
+
+/**
+ * Find the lowest ceiling above a given position and return the height.
+ */
+f32 find_ceil(f32 posX, f32 posY, f32 posZ, struct Surface **pceil) {
+    s16 cellZ, cellX;
+    f32 height = gLevelValues.cellHeightLimit;
     s16 x, y, z;
 
     //! (Parallel Universes) Because position is casted to an s16, reaching higher
@@ -527,20 +777,9 @@ f32 find_ceil(f32 posX, f32 posY, f32 posZ, struct Surface **pceil) {
     cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
     cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
 
-    // Check for surfaces belonging to objects.
-    surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next;
-    dynamicCeil = find_ceil_from_list(surfaceList, x, y, z, &dynamicHeight);
-
-    // Check for surfaces that are a part of level geometry.
-    surfaceList = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next;
-    ceil = find_ceil_from_list(surfaceList, x, y, z, &height);
-
-    if (dynamicHeight < height) {
-        ceil = dynamicCeil;
-        height = dynamicHeight;
-    }
+    collision_query_record(COLLISION_QUERY_CEIL, posX, posY, posZ, 0, 0);
 
-    *pceil = ceil;
+    height = find_ceil_in_cell(cellX, cellZ, x, y, z, pceil);
 
     // Increment the debug tracker.
     gNumCalls.ceil += 1;
@@ -599,7 +838,6 @@ f32 find_floor_height_and_data(f32 xPos, f32 yPos, f32 zPos, struct FloorGeometr
 }
 
 extern f32 gRenderingDelta;
-u8 gInterpolatingSurfaces;
 
 /**
  * Iterate through the list of floors and find the first floor under a given point.
@@ -670,36 +908,8 @@ static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32
             continue;
         }
 
-        // Determine if we are checking for the camera or not.
-        if (gCheckingSurfaceCollisionsForCamera != 0) {
-            if (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION) {
-                continue;
-            }
-        }
-        else {
-            // If we are not checking for the camera, ignore camera only floors.
-            if (surf->type == SURFACE_CAMERA_BOUNDARY || surf->type == SURFACE_RAYCAST) {
-                continue;
-            }
-
-            // If an object can pass through a vanish cap surface, pass through.
-            if (gLevelValues.fixVanishFloors && surf->type == SURFACE_VANISH_CAP_WALLS) {
-                if (gCurrentObject != NULL
-                    && (gCurrentObject->activeFlags & ACTIVE_FLAG_MOVE_THROUGH_GRATE)) {
-                    continue;
-                }
-
-                // If Mario has a vanish cap, pass through the vanish cap surface.
-                u8 passThrough = FALSE;
-                for (s32 i = 0; i < MAX_PLAYERS; i++) {
-                    if (gCurrentObject != NULL && gCurrentObject == gMarioStates[i].marioObj
-                        && (gMarioStates[i].flags & MARIO_VANISH_CAP)) {
-                        passThrough = TRUE;
-                        break;
-                    }
-                }
-                if (passThrough) { continue; }
-            }
+        if (surface_is_ignored(surf, gLevelValues.fixVanishFloors)) {
+            continue;
         }
 
         if (interpolate) {
@@ -772,6 +982,59 @@ static struct Surface *find_floor_from_list(struct SurfaceNode *surfaceNode, s32
     return floor;
 }
 
+/**
+ * Packed version of find_floor_from_list for the static partition.
+ */
+static struct Surface *find_floor_from_packed(struct PackedSurfaceList *list, s32 x, s32 y, s32 z, f32 *pheight) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    struct Surface *floor = NULL;
+    u32 end = list->offset + list->count;
+
+    // set pheight to lowest value
+    if (gLevelValues.fixCollisionBugs) {
+        *pheight = gLevelValues.floorLowerLimit;
+    }
+
+    for (u32 base = list->offset; base < end; base += PACKED_SURFACE_ALIGN) {
+        u32 mask = packed_floor_mask(packed, base, x, z) & packed_lane_mask(end - base);
+        while (mask != 0) {
+            u32 i = base + __builtin_ctz(mask);
+            mask &= mask - 1;
+
+            struct Surface *surf = packed->surface[i];
+            if (surface_is_ignored(surf, gLevelValues.fixVanishFloors)) {
+                continue;
+            }
+
+            f32 ny = packed->normalY[i];
+            if (ny == 0.0f) { continue; }
+
+            f32 height = -(x * packed->normalX[i] + packed->normalZ[i] * z + surf->originOffset) / ny;
+            if (gLevelValues.fixCollisionBugs && (height < *pheight)) { continue; }
+            if (y - (height + -78.0f) < 0.0f) { continue; }
+
+            *pheight = height;
+            floor = surf;
+
+            if (!gLevelValues.fixCollisionBugs) {
+                return floor;
+            }
+        }
+    }
+
+    return floor;
+}
+
+/**
+ * Find the floor of the level geometry in a cell.
+ */
+static struct Surface *find_static_floor(s16 cellX, s16 cellZ, s32 x, s32 y, s32 z, f32 *pheight) {
+    if (use_packed_surfaces()) {
+        return find_floor_from_packed(&gStaticPackedSurfaces.lists[cellZ][cellX][SPATIAL_PARTITION_FLOORS], x, y, z, pheight);
+    }
+    return find_floor_from_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next, x, y, z, pheight);
+}
+
 /**
  * Find the height of the highest floor below a point.
  */
@@ -810,66 +1073,40 @@ f32 unused_find_dynamic_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfl
 }
 
 /**
- * Find the highest floor under a given position and return the height.
+ * Find the highest floor under a position in a cell and return the height.
+ * @param includeIntangible Whether SURFACE_INTANGIBLE floors are returned
+ * @param misses Incremented if no level geometry floor was found
  */
-f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
-    s16 cellZ, cellX;
-
+static f32 find_floor_in_cell(s16 cellX, s16 cellZ, s32 x, s32 y, s32 z, u8 includeIntangible, struct Surface **pfloor, s32 *misses) {
     struct Surface *floor, *dynamicFloor;
     struct SurfaceNode *surfaceList;
 
     f32 height = gLevelValues.floorLowerLimit;
     f32 dynamicHeight = gLevelValues.floorLowerLimit;
 
-    //! (Parallel Universes) Because position is casted to an s16, reaching higher
-    // float locations  can return floors despite them not existing there.
-    //(Dynamic floors will unload due to the range.)
-    s16 x = (s16) xPos;
-    s16 y = (s16) yPos;
-    s16 z = (s16) zPos;
-
-    *pfloor = NULL;
-
-#if EXTENDED_BOUNDS_MODE != 3
-    if (x <= -LEVEL_BOUNDARY_MAX || x >= LEVEL_BOUNDARY_MAX) {
-        return height;
-    }
-    if (z <= -LEVEL_BOUNDARY_MAX || z >= LEVEL_BOUNDARY_MAX) {
-        return height;
-    }
-#endif
-
-    // Each level is split into cells to limit load, find the appropriate cell.
-    cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
-    cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
-
     // Check for surfaces belonging to objects.
     surfaceList = gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
     dynamicFloor = find_floor_from_list(surfaceList, x, y, z, &dynamicHeight);
 
     // Check for surfaces that are a part of level geometry.
-    surfaceList = gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next;
-    floor = find_floor_from_list(surfaceList, x, y, z, &height);
+    floor = find_static_floor(cellX, cellZ, x, y, z, &height);
 
     // To prevent the Merry-Go-Round room from loading when Mario passes above the hole that leads
     // there, SURFACE_INTANGIBLE is used. This prevent the wrong room from loading, but can also allow
     // Mario to pass through.
-    if (!gFindFloorIncludeSurfaceIntangible) {
+    if (!includeIntangible) {
         //! (BBH Crash) Most NULL checking is done by checking the height of the floor returned
         //  instead of checking directly for a NULL floor. If this check returns a NULL floor
         //  (happens when there is no floor under the SURFACE_INTANGIBLE floor) but returns the height
         //  of the SURFACE_INTANGIBLE floor instead of the typical -11000 returned for a NULL floor.
         if (floor != NULL && floor->type == SURFACE_INTANGIBLE) {
-            floor = find_floor_from_list(surfaceList, x, (s32)(height - 200.0f), z, &height);
+            floor = find_static_floor(cellX, cellZ, x, (s32)(height - 200.0f), z, &height);
         }
-    } else {
-        // To prevent accidentally leaving the floor tangible, stop checking for it.
-        gFindFloorIncludeSurfaceIntangible = FALSE;
     }
 
     // If a floor was missed, increment the debug counter.
     if (floor == NULL) {
-        gNumFindFloorMisses += 1;
+        *misses += 1;
     }
 
     if (dynamicHeight > height) {
@@ -878,6 +1115,45 @@ f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
     }
 
     *pfloor = floor;
+    return height;
+}
+
+/**
+ * Find the highest floor under a given position and return the height.
+ */
+f32 find_floor(f32 xPos, f32 yPos, f32 zPos, struct Surface **pfloor) {
+    s16 cellZ, cellX;
+
+    f32 height = gLevelValues.floorLowerLimit;
+
+    //! (Parallel Universes) Because position is casted to an s16, reaching higher
+    // float locations  can return floors despite them not existing there.
+    //(Dynamic floors will unload due to the range.)
+    s16 x = (s16) xPos;
+    s16 y = (s16) yPos;
+    s16 z = (s16) zPos;
+
+    *pfloor = NULL;
+
+#if EXTENDED_BOUNDS_MODE != 3
+    if (x <= -LEVEL_BOUNDARY_MAX || x >= LEVEL_BOUNDARY_MAX) {
+        return height;
+    }
+    if (z <= -LEVEL_BOUNDARY_MAX || z >= LEVEL_BOUNDARY_MAX) {
+        return height;
+    }
+#endif
+
+    // Each level is split into cells to limit load, find the appropriate cell.
+    cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+    cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+
+    collision_query_record(COLLISION_QUERY_FLOOR, xPos, yPos, zPos, 0, 0);
+
+    height = find_floor_in_cell(cellX, cellZ, x, y, z, gFindFloorIncludeSurfaceIntangible, pfloor, &gNumFindFloorMisses);
+
+    // To prevent accidentally leaving the floor tangible, stop checking for it.
+    gFindFloorIncludeSurfaceIntangible = FALSE;
 
     // Increment the debug tracker.
     gNumCalls.floor += 1;
@@ -1177,7 +1453,7 @@ void find_surface_on_ray_list(struct SurfaceNode *list, Vec3f orig, Vec3f dir, f
 }
 
 
-void find_surface_on_ray_cell(s16 cellX, s16 cellZ, Vec3f orig, Vec3f normalized_dir, f32 dir_length, struct Surface **hit_surface, Vec3f hit_pos, f32 *max_length)
+void find_surface_on_ray_cell(s16 cellX, s16 cellZ, Vec3f orig, Vec3f normalized_dir, f32 dir_length, struct Surface **hit_surface, Vec3f hit_pos, f32 *max_length, u8 checkStatic)
 {
     // Skip if OOB
     if (cellX >= 0 && cellX < NUM_CELLS && cellZ >= 0 && cellZ < NUM_CELLS)
@@ -1185,19 +1461,106 @@ void find_surface_on_ray_cell(s16 cellX, s16 cellZ, Vec3f orig, Vec3f normalized
         // Iterate through each surface in this partition
         if (normalized_dir[1] > -0.99f)
         {
-            find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
+            if (checkStatic)
+                find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
             find_surface_on_ray_list(gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_CEILS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
         }
         if (normalized_dir[1] < 0.99f)
         {
-            find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
+            if (checkStatic)
+                find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
             find_surface_on_ray_list(gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_FLOORS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
         }
-        find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
+        if (checkStatic)
+            find_surface_on_ray_list(gStaticSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
         find_surface_on_ray_list(gDynamicSurfacePartition[cellZ][cellX][SPATIAL_PARTITION_WALLS].next, orig, normalized_dir, dir_length, hit_surface, hit_pos, max_length);
     }
 }
 
+/**
+ * Returns TRUE if a ray along `dir` can hit a box within `max_length`.
+ */
+static s32 ray_box_intersect(Vec3f orig, Vec3f dir, f32 max_length, Vec3f boxMin, Vec3f boxMax)
+{
+    f32 tMin = 0.0f;
+    f32 tMax = max_length;
+
+    for (s32 i = 0; i < 3; i++)
+    {
+        if (dir[i] == 0.0f)
+        {
+            if (orig[i] < boxMin[i] || orig[i] > boxMax[i])
+                return FALSE;
+            continue;
+        }
+
+        f32 inv = 1.0f / dir[i];
+        f32 t1 = (boxMin[i] - orig[i]) * inv;
+        f32 t2 = (boxMax[i] - orig[i]) * inv;
+        tMin = MAX(tMin, MIN(t1, t2));
+        tMax = MIN(tMax, MAX(t1, t2));
+        if (tMin > tMax)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/**
+ * Finds the closest static surface on a ray through the BVH, with the same
+ * filters find_surface_on_ray_cell applies to the partition lists.
+ */
+static void find_surface_on_ray_bvh(Vec3f orig, Vec3f normalized_dir, f32 dir_length, struct Surface **hit_surface, Vec3f hit_pos, f32 *max_length)
+{
+    struct SurfaceBVH *bvh = &gStaticSurfaceBVH;
+    u32 stack[SURFACE_BVH_STACK_SIZE];
+    u32 depth = 0;
+    Vec3f chk_hit_pos;
+    f32 length;
+
+    stack[depth++] = 0;
+    while (depth > 0)
+    {
+        u32 index = stack[--depth];
+        struct SurfaceBVHNode *node = &bvh->nodes[index];
+        if (!ray_box_intersect(orig, normalized_dir, *max_length, node->min, node->max))
+            continue;
+
+        if (node->count == 0)
+        {
+            stack[depth++] = node->first;
+            stack[depth++] = index + 1;
+            continue;
+        }
+
+        for (u32 i = node->first; i < node->first + node->count; i++)
+        {
+            struct Surface *surf = bvh->surfaces[i];
+
+            // Ceilings can't be hit straight down and floors can't be hit straight up
+            if (surf->normal.y < -0.01f && normalized_dir[1] <= -0.99f)
+                continue;
+            if (surf->normal.y > 0.01f && normalized_dir[1] >= 0.99f)
+                continue;
+
+            // Reject no-cam collision surfaces
+            if (gCheckingSurfaceCollisionsForCamera && (surf->flags & SURFACE_FLAG_NO_CAM_COLLISION))
+                continue;
+
+            if (ray_surface_intersect(orig, normalized_dir, dir_length, surf, chk_hit_pos, &length) && length <= *max_length)
+            {
+                *hit_surface = surf;
+                vec3f_copy(hit_pos, chk_hit_pos);
+                *max_length = length;
+            }
+        }
+    }
+}
+
+static u8 use_surface_bvh(void) {
+    return gSurfaceBVHEnabled && gStaticSurfaceBVH.numNodes > 0;
+}
+
 void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Vec3f hit_pos, f32 precision) {
     f32 max_length;
     s16 cellZ, cellX;
@@ -1223,10 +1586,16 @@ void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Ve
     cellX = (s16)fCellX;
     cellZ = (s16)fCellZ;
 
+    // Static surfaces come from the BVH, only the dynamic ones are found per cell
+    u8 checkStatic = !use_surface_bvh();
+    if (!checkStatic)
+        find_surface_on_ray_bvh(orig, normalized_dir, dir_length, hit_surface, hit_pos, &max_length);
+    struct Surface *static_hit = *hit_surface;
+
     // Don't do DDA if straight down
     if (normalized_dir[1] >= 1.0f || normalized_dir[1] <= -1.0f)
     {
-        find_surface_on_ray_cell(cellX, cellZ, orig, normalized_dir, dir_length, hit_surface, hit_pos, &max_length);
+        find_surface_on_ray_cell(cellX, cellZ, orig, normalized_dir, dir_length, hit_surface, hit_pos, &max_length, checkStatic);
         return;
     }
 
@@ -1239,9 +1608,13 @@ void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Ve
     dx = dir[0] / step / CELL_SIZE;
     dz = dir[2] / step / CELL_SIZE;
 
-    for (i = 0; i < step && *hit_surface == NULL; i++)
+    for (i = 0; i < step && *hit_surface == static_hit; i++)
     {
-        find_surface_on_ray_cell(cellX, cellZ, orig, normalized_dir, dir_length, hit_surface, hit_pos, &max_length);
+        // Cells past the static hit can't have anything closer
+        if (static_hit != NULL && i * dir_length / step > max_length + dir_length / step)
+            break;
+
+        find_surface_on_ray_cell(cellX, cellZ, orig, normalized_dir, dir_length, hit_surface, hit_pos, &max_length, checkStatic);
 
         // Move cell coordinate
         fCellX += dx;
@@ -1250,3 +1623,280 @@ void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Ve
         cellZ = (s16)fCellZ;
     }
 }
+
+/**************************************************
+ *                 SPHERE QUERIES                 *
+ **************************************************/
+
+/**
+ * Keeps `surf` if it is closer to `pos` than the best surface so far.
+ */
+static void find_closest_surface_check(struct Surface *surf, Vec3f pos, f32 *bestDistSq, struct Surface **best, Vec3f closestPos) {
+    Vec3f point;
+    if (surface_is_ignored(surf, FALSE)) { return; }
+
+    Vec3f offset;
+    closest_point_to_triangle(surf, pos, point);
+    vec3f_dif(offset, point, pos);
+    f32 distSq = vec3f_dot(offset, offset);
+    if (distSq <= *bestDistSq) {
+        *bestDistSq = distSq;
+        *best = surf;
+        vec3f_copy(closestPos, point);
+    }
+}
+
+static void find_closest_surface_from_list(struct SurfaceNode *node, Vec3f pos, f32 *bestDistSq, struct Surface **best, Vec3f closestPos) {
+    for (; node != NULL; node = node->next) {
+        find_closest_surface_check(node->surface, pos, bestDistSq, best, closestPos);
+    }
+}
+
+static void find_closest_surface_from_bvh(Vec3f pos, f32 *bestDistSq, struct Surface **best, Vec3f closestPos) {
+    struct SurfaceBVH *bvh = &gStaticSurfaceBVH;
+    u32 stack[SURFACE_BVH_STACK_SIZE];
+    u32 depth = 0;
+
+    stack[depth++] = 0;
+    while (depth > 0) {
+        u32 index = stack[--depth];
+        struct SurfaceBVHNode *node = &bvh->nodes[index];
+
+        // distance from the sphere center to the box
+        f32 distSq = 0;
+        for (s32 i = 0; i < 3; i++) {
+            f32 outside = MAX(node->min[i] - pos[i], pos[i] - node->max[i]);
+            if (outside > 0) { distSq += outside * outside; }
+        }
+        if (distSq > *bestDistSq) { continue; }
+
+        if (node->count == 0) {
+            stack[depth++] = node->first;
+            stack[depth++] = index + 1;
+            continue;
+        }
+
+        for (u32 i = node->first; i < node->first + node->count; i++) {
+            find_closest_surface_check(bvh->surfaces[i], pos, bestDistSq, best, closestPos);
+        }
+    }
+}
+
+struct Surface *find_closest_surface_in_sphere(Vec3f pos, f32 radius, Vec3f closestPos) {
+    struct Surface *best = NULL;
+    f32 bestDistSq = radius * radius;
+    u8 checkStatic = !use_surface_bvh();
+
+    vec3f_copy(closestPos, pos);
+    if (radius < 0) { return NULL; }
+
+    if (!checkStatic) {
+        find_closest_surface_from_bvh(pos, &bestDistSq, &best, closestPos);
+    }
+
+    s32 minCellX = CLAMP((s32)((pos[0] - radius + LEVEL_BOUNDARY_MAX) / CELL_SIZE), 0, NUM_CELLS_INDEX);
+    s32 maxCellX = CLAMP((s32)((pos[0] + radius + LEVEL_BOUNDARY_MAX) / CELL_SIZE), 0, NUM_CELLS_INDEX);
+    s32 minCellZ = CLAMP((s32)((pos[2] - radius + LEVEL_BOUNDARY_MAX) / CELL_SIZE), 0, NUM_CELLS_INDEX);
+    s32 maxCellZ = CLAMP((s32)((pos[2] + radius + LEVEL_BOUNDARY_MAX) / CELL_SIZE), 0, NUM_CELLS_INDEX);
+
+    for (s32 cellZ = minCellZ; cellZ <= maxCellZ; cellZ++) {
+        for (s32 cellX = minCellX; cellX <= maxCellX; cellX++) {
+            for (s32 listIndex = 0; listIndex < 3; listIndex++) {
+                if (checkStatic) {
+                    find_closest_surface_from_list(gStaticSurfacePartition[cellZ][cellX][listIndex].next, pos, &bestDistSq, &best, closestPos);
+                }
+                find_closest_surface_from_list(gDynamicSurfacePartition[cellZ][cellX][listIndex].next, pos, &bestDistSq, &best, closestPos);
+            }
+        }
+    }
+
+    return best;
+}
+
+#ifdef DEVELOPMENT
+
+  ///////////
+ // bench //
+///////////
+
+#include "pc/dev/bench.h"
+
+#define COLLISION_BENCH_ITERATIONS 20
+
+struct CollisionBenchResult {
+    struct Surface *surface;
+    f32 height;
+    f32 x, z;
+    s16 numWalls;
+};
+
+/**
+ * Replay a recorded query against the static partition only, through either
+ * the SurfaceNode lists or the packed arrays.
+ */
+static void collision_bench_replay(struct CollisionQuery *query, u8 packed, struct CollisionBenchResult *result) {
+    s16 x = query->x;
+    s16 y = query->y;
+    s16 z = query->z;
+    s16 cellX = ((x + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+    s16 cellZ = ((z + LEVEL_BOUNDARY_MAX) / CELL_SIZE) & NUM_CELLS_INDEX;
+    struct PackedSurfaceList *list = &gStaticPackedSurfaces.lists[cellZ][cellX][0];
+    SpatialPartitionCell *cell = &gStaticSurfacePartition[cellZ][cellX];
+
+    memset(result, 0, sizeof(struct CollisionBenchResult));
+    gCheckingSurfaceCollisionsForCamera = query->camera;
+
+    switch (query->type) {
+        case COLLISION_QUERY_FLOOR:
+            result->height = gLevelValues.floorLowerLimit;
+            result->surface = packed
+                ? find_floor_from_packed(&list[SPATIAL_PARTITION_FLOORS], x, y, z, &result->height)
+                : find_floor_from_list((*cell)[SPATIAL_PARTITION_FLOORS].next, x, y, z, &result->height);
+            break;
+
+        case COLLISION_QUERY_CEIL:
+            result->height = gLevelValues.cellHeightLimit;
+            result->surface = packed
+                ? find_ceil_from_packed(&list[SPATIAL_PARTITION_CEILS], x, y, z, &result->height)
+                : find_ceil_from_list((*cell)[SPATIAL_PARTITION_CEILS].next, x, y, z, &result->height);
+            break;
+
+        case COLLISION_QUERY_WALL: {
+            struct WallCollisionData data = { 0 };
+            data.x = query->x;
+            data.y = query->y;
+            data.z = query->z;
+            data.offsetY = query->offsetY;
+            data.radius = query->radius;
+            if (packed) {
+                find_wall_collisions_from_packed(&list[SPATIAL_PARTITION_WALLS], &data);
+            } else {
+                find_wall_collisions_from_list((*cell)[SPATIAL_PARTITION_WALLS].next, &data);
+            }
+            result->surface = data.walls[0];
+            result->x = data.x;
+            result->z = data.z;
+            result->numWalls = data.numWalls;
+            break;
+        }
+    }
+}
+
+void surface_collision_bench(void) {
+    u32 count = MIN(sCollisionQueryLogCount, COLLISION_QUERY_LOG_SIZE);
+    if (gStaticSurfacesModified) { refresh_static_surfaces(); }
+    if (count == 0 || gStaticPackedSurfaces.count == 0) {
+        dev_bench_report("No collision queries recorded, move around a level first");
+        return;
+    }
+
+    s16 savedCamera = gCheckingSurfaceCollisionsForCamera;
+    u32 queries[COLLISION_QUERY_MAX] = { 0 };
+    u32 mismatches = 0;
+    struct CollisionBenchResult listResult;
+    struct CollisionBenchResult packedResult;
+
+    // both walks must agree before their timings mean anything
+    for (u32 i = 0; i < count; i++) {
+        struct CollisionQuery *query = &sCollisionQueryLog[i];
+        collision_bench_replay(query, FALSE, &listResult);
+        collision_bench_replay(query, TRUE, &packedResult);
+        if (memcmp(&listResult, &packedResult, sizeof(struct CollisionBenchResult)) != 0) {
+            mismatches++;
+        }
+        queries[query->type]++;
+    }
+
+    f64 start = clock_elapsed_f64();
+    for (u32 iter = 0; iter < COLLISION_BENCH_ITERATIONS; iter++) {
+        for (u32 i = 0; i < count; i++) {
+            collision_bench_replay(&sCollisionQueryLog[i], FALSE, &listResult);
+        }
+    }
+    f64 mid = clock_elapsed_f64();
+    for (u32 iter = 0; iter < COLLISION_BENCH_ITERATIONS; iter++) {
+        for (u32 i = 0; i < count; i++) {
+            collision_bench_replay(&sCollisionQueryLog[i], TRUE, &packedResult);
+        }
+    }
+    f64 end = clock_elapsed_f64();
+
+    gCheckingSurfaceCollisionsForCamera = savedCamera;
+
+    dev_bench_report("%u queries (%u floor, %u ceil, %u wall) over %u static surfaces",
+        count, queries[COLLISION_QUERY_FLOOR], queries[COLLISION_QUERY_CEIL], queries[COLLISION_QUERY_WALL], gNumStaticSurfaces);
+    dev_bench_report("lists %.3fus, packed %.3fus per replay, %u mismatches",
+        (mid - start) * 1000000.0 / COLLISION_BENCH_ITERATIONS,
+        (end - mid) * 1000000.0 / COLLISION_BENCH_ITERATIONS,
+        mismatches);
+}
+
+#define RAYCAST_BENCH_RAYS 2000
+
+void surface_raycast_bench(void) {
+    struct SurfaceBVH *bvh = &gStaticSurfaceBVH;
+    if (bvh->numNodes == 0) {
+        dev_bench_report("No static surfaces loaded, enter a level first");
+        return;
+    }
+
+    static Vec3f sOrigins[RAYCAST_BENCH_RAYS];
+    static Vec3f sDirs[RAYCAST_BENCH_RAYS];
+    u8 savedEnabled = gSurfaceBVHEnabled;
+    u32 seed = 0x12345678;
+    u32 gridHits = 0;
+    u32 bvhHits = 0;
+    u32 mismatches = 0;
+
+    // random rays between points spread over the static geometry
+    struct SurfaceBVHNode *root = &bvh->nodes[0];
+    for (u32 i = 0; i < RAYCAST_BENCH_RAYS; i++) {
+        Vec3f target;
+        for (s32 axis = 0; axis < 3; axis++) {
+            seed = seed * 1664525 + 1013904223;
+            sOrigins[i][axis] = root->min[axis] + (root->max[axis] - root->min[axis]) * ((seed >> 8) / (f32)(1 << 24));
+            seed = seed * 1664525 + 1013904223;
+            target[axis] = root->min[axis] + (root->max[axis] - root->min[axis]) * ((seed >> 8) / (f32)(1 << 24));
+        }
+        vec3f_dif(sDirs[i], target, sOrigins[i]);
+    }
+
+    // the grid walk can step over cells, so only count hits it finds that the BVH doesn't agree with
+    for (u32 i = 0; i < RAYCAST_BENCH_RAYS; i++) {
+        struct Surface *gridSurface;
+        struct Surface *bvhSurface;
+        Vec3f hitPos;
+        gSurfaceBVHEnabled = FALSE;
+        find_surface_on_ray(sOrigins[i], sDirs[i], &gridSurface, hitPos, 3.0f);
+        gSurfaceBVHEnabled = TRUE;
+        find_surface_on_ray(sOrigins[i], sDirs[i], &bvhSurface, hitPos, 3.0f);
+        if (gridSurface != NULL) { gridHits++; }
+        if (bvhSurface != NULL) { bvhHits++; }
+        if (gridSurface != NULL && gridSurface != bvhSurface) { mismatches++; }
+    }
+
+    struct Surface *surface;
+    Vec3f hitPos;
+    gSurfaceBVHEnabled = FALSE;
+    f64 start = clock_elapsed_f64();
+    for (u32 i = 0; i < RAYCAST_BENCH_RAYS; i++) {
+        find_surface_on_ray(sOrigins[i], sDirs[i], &surface, hitPos, 3.0f);
+    }
+    f64 mid = clock_elapsed_f64();
+    gSurfaceBVHEnabled = TRUE;
+    for (u32 i = 0; i < RAYCAST_BENCH_RAYS; i++) {
+        find_surface_on_ray(sOrigins[i], sDirs[i], &surface, hitPos, 3.0f);
+    }
+    f64 end = clock_elapsed_f64();
+
+    gSurfaceBVHEnabled = savedEnabled;
+
+    dev_bench_report("%u rays over %u static surfaces, %u BVH nodes",
+        RAYCAST_BENCH_RAYS, bvh->numSurfaces, bvh->numNodes);
+    dev_bench_report("grid %.3fus (%u hits), bvh %.3fus (%u hits) per ray, %u grid hits differ",
+        (mid - start) * 1000000.0 / RAYCAST_BENCH_RAYS, gridHits,
+        (end - mid) * 1000000.0 / RAYCAST_BENCH_RAYS, bvhHits,
+        mismatches);
+}
+
+#endif
@@ -79,6 +79,17 @@ f32 find_poison_gas_level(f32 x, f32 z);
 void debug_surface_list_info(f32 xPos, f32 zPos);
 void find_surface_on_ray(Vec3f orig, Vec3f dir, struct Surface **hit_surface, Vec3f hit_pos, f32 precision);
 
+/* |description|
+Finds the surface closest to `pos` within `radius`, and writes the closest point on it to `closestPos`.
+Returns nil if no surface is that close
+|descriptionEnd| */
+struct Surface *find_closest_surface_in_sphere(Vec3f pos, f32 radius, Vec3f closestPos);
+
+#ifdef DEVELOPMENT
+void surface_collision_bench(void);
+void surface_raycast_bench(void);
+#endif
+
 /* |description|
 Sets whether collision finding functions should check wall directions.
 |descriptionEnd| */
@@ -1,4 +1,6 @@
 #include <PR/ultratypes.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "prevent_bss_reordering.h"
 
@@ -20,6 +22,8 @@
 #include "game/hardcoded.h"
 #include "pc/network/network.h"
 #include "pc/lua/smlua_hooks.h"
+#include "pc/utils/misc.h"
+#include "pc/debug_context.h"
 
 /**
  * Partitions for course and object surfaces. The arrays represent
@@ -28,12 +32,73 @@
 SpatialPartitionCell gStaticSurfacePartition[NUM_CELLS][NUM_CELLS];
 SpatialPartitionCell gDynamicSurfacePartition[NUM_CELLS][NUM_CELLS];
 
+/**
+ * Flat copy of the static partition that the collision queries walk instead
+ * of the SurfaceNode lists.
+ */
+struct PackedSurfaces gStaticPackedSurfaces = { 0 };
+
+/**
+ * Hierarchy over the static surfaces for ray and sphere queries, which can be
+ * turned off to fall back to the partition.
+ */
+struct SurfaceBVH gStaticSurfaceBVH = { 0 };
+u8 gSurfaceBVHEnabled = TRUE;
+
+/**
+ * Set when Lua writes surface data the packed partition keeps a copy of.
+ */
+u8 gStaticSurfacesModified = FALSE;
+
+#define PACKED_SURFACE_ROUND(_count) (((_count) + PACKED_SURFACE_ALIGN - 1) & ~(PACKED_SURFACE_ALIGN - 1))
+
 /**
  * Pools of data to contain either surface nodes or surfaces.
  */
 static struct GrowingArray *sSurfaceNodePool = NULL;
 static struct GrowingArray *sSurfacePool = NULL;
 
+/**
+ * Nodes of the static partition lists, laid out alongside the packed arrays.
+ */
+static struct SurfaceNode *sStaticSurfaceNodes = NULL;
+
+/**
+ * A node of an object's collision, remembering which dynamic partition list
+ * (flattened cell and list index) it is linked into.
+ */
+struct ObjectCollisionNode {
+    struct SurfaceNode node;
+    u16 list;
+};
+
+/**
+ * Collision an object loaded on an earlier frame. The transformed surfaces
+ * and the cell of every node are kept, so an object that hasn't moved only has
+ * its nodes linked back into the dynamic partition.
+ */
+struct ObjectCollision {
+    const BehaviorScript *behavior;
+    s16 *collisionData;
+    Mat4 transform;
+    struct Surface **surfaces;
+    u32 numSurfaces;
+    u32 surfaceCapacity;
+    struct ObjectCollisionNode *nodes;
+    u32 numNodes;
+    u32 nodeCapacity;
+    u32 linkedFrame;
+    u8 valid;
+    u8 moved;
+};
+
+static struct ObjectCollision sObjectCollisions[OBJECT_POOL_CAPACITY] = { 0 };
+
+/**
+ * Bumped every time the dynamic partition is cleared.
+ */
+static u32 sDynamicSurfaceFrame = 1;
+
 /**
  * Allocate the part of the surface node pool to contain a surface node.
  */
@@ -71,39 +136,48 @@ static void clear_spatial_partition(SpatialPartitionCell *cells) {
  */
 static void clear_static_surfaces(void) {
     clear_spatial_partition(&gStaticSurfacePartition[0][0]);
+
+    // object collision data may be reused for something else in the new area
+    for (u32 i = 0; i < OBJECT_POOL_CAPACITY; i++) {
+        sObjectCollisions[i].valid = FALSE;
+        sObjectCollisions[i].linkedFrame = 0;
+    }
+
+    gStaticPackedSurfaces.count = 0;
+    memset(gStaticPackedSurfaces.lists, 0, sizeof(gStaticPackedSurfaces.lists));
+
+    gStaticSurfaceBVH.numNodes = 0;
+    gStaticSurfaceBVH.numSurfaces = 0;
+    gStaticSurfacesModified = FALSE;
 }
 
 /**
- * Add a surface to the correct cell list of surfaces.
- * @param dynamic Determines whether the surface is static or dynamic
- * @param cellX The X position of the cell in which the surface resides
- * @param cellZ The Z position of the cell in which the surface resides
- * @param surface The surface to add
+ * Sort direction of each cell list: floors go highest to lowest, ceilings
+ * lowest to highest and walls stay in insertion order.
  */
-static void add_surface_to_cell(s16 dynamic, s16 cellX, s16 cellZ, struct Surface *surface) {
-    struct SurfaceNode *newNode = alloc_surface_node();
-    if (newNode == NULL) { return; }
-    struct SurfaceNode *list;
-    s16 surfacePriority;
-    s16 priority;
-    s16 sortDir;
-    s16 listIndex;
+static s16 sSurfaceListSortDir[3] = { 1, -1, 0 };
 
+/**
+ * Returns which cell list a surface belongs in, flagging walls that should be
+ * projected onto the X axis.
+ */
+static s16 surface_list_index(struct Surface *surface) {
     if (surface->normal.y > 0.01) {
-        listIndex = SPATIAL_PARTITION_FLOORS;
-        sortDir = 1; // highest to lowest, then insertion order
+        return SPATIAL_PARTITION_FLOORS;
     } else if (surface->normal.y < -0.01) {
-        listIndex = SPATIAL_PARTITION_CEILS;
-        sortDir = -1; // lowest to highest, then insertion order
-    } else {
-        listIndex = SPATIAL_PARTITION_WALLS;
-        sortDir = 0; // insertion order
+        return SPATIAL_PARTITION_CEILS;
+    }
 
-        if (surface->normal.x < -0.707 || surface->normal.x > 0.707) {
-            surface->flags |= SURFACE_FLAG_X_PROJECTION;
-        }
+    if (surface->normal.x < -0.707 || surface->normal.x > 0.707) {
+        surface->flags |= SURFACE_FLAG_X_PROJECTION;
     }
+    return SPATIAL_PARTITION_WALLS;
+}
 
+/**
+ * Returns the priority a surface is sorted by within its cell list.
+ */
+static s16 surface_sort_priority(struct Surface *surface, s16 sortDir) {
     //! (Surface Cucking) Surfaces are sorted by the height of their first
     //  vertex. Since vertices aren't ordered by height, this causes many
     //  lower triangles to be sorted higher. This worsens surface cucking since
@@ -111,18 +185,21 @@ static void add_surface_to_cell(s16 dynamic, s16 cellX, s16 cellZ, struct Surfac
     //  missing higher surfaces.
     //  upperY would be a better sort method.
     //  <Fixed when gLevelValues.fixCollisionBugs != 0>
+    return gLevelValues.fixCollisionBugs
+         ? (surface->upperY * sortDir)
+         : (surface->vertex1[1] * sortDir);
+}
 
-    surfacePriority = gLevelValues.fixCollisionBugs
-                    ? (surface->upperY * sortDir)
-                    : (surface->vertex1[1] * sortDir);
-
-    newNode->surface = surface;
-
-    if (dynamic) {
-        list = &gDynamicSurfacePartition[cellZ][cellX][listIndex];
-    } else {
-        list = &gStaticSurfacePartition[cellZ][cellX][listIndex];
-    }
+/**
+ * Link a surface node into a cell list, keeping the list in priority order.
+ * @param list The head of the cell list
+ * @param newNode The node to link, pointing to its surface
+ * @param listIndex Which of the cell's lists `list` is
+ */
+static void link_surface_node(struct SurfaceNode *list, struct SurfaceNode *newNode, s16 listIndex) {
+    s16 sortDir = sSurfaceListSortDir[listIndex];
+    s16 surfacePriority = surface_sort_priority(newNode->surface, sortDir);
+    s16 priority;
 
     // Loop until we find the appropriate place for the surface in the list.
     while (list->next != NULL) {
@@ -139,6 +216,27 @@ static void add_surface_to_cell(s16 dynamic, s16 cellX, s16 cellZ, struct Surfac
     list->next = newNode;
 }
 
+/**
+ * Add a surface to the correct cell list of surfaces.
+ * @param dynamic Determines whether the surface is static or dynamic
+ * @param cellX The X position of the cell in which the surface resides
+ * @param cellZ The Z position of the cell in which the surface resides
+ * @param surface The surface to add
+ */
+static void add_surface_to_cell(s16 dynamic, s16 cellX, s16 cellZ, struct Surface *surface) {
+    struct SurfaceNode *newNode = alloc_surface_node();
+    if (newNode == NULL) { return; }
+    s16 listIndex = surface_list_index(surface);
+
+    newNode->surface = surface;
+
+    if (dynamic) {
+        link_surface_node(&gDynamicSurfacePartition[cellZ][cellX][listIndex], newNode, listIndex);
+    } else {
+        link_surface_node(&gStaticSurfacePartition[cellZ][cellX][listIndex], newNode, listIndex);
+    }
+}
+
 /**
  * Returns the lowest of three values.
  */
@@ -247,15 +345,337 @@ static void add_surface(struct Surface *surface, s32 dynamic) {
     }
 }
 
+/**
+ * Make room for `capacity` static partition entries. The packed arrays and the
+ * surface nodes are carved out of a single allocation that is kept between
+ * areas.
+ */
+static bool reserve_static_partition(u32 capacity) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    if (capacity <= packed->capacity) { return true; }
+
+    // round up so the next few areas don't have to reallocate
+    capacity = MAX(capacity, packed->capacity * 2);
+    capacity = PACKED_SURFACE_ROUND(capacity);
+
+    u8 *block = realloc(packed->x1, capacity * (11 * sizeof(f32) + sizeof(struct Surface *) + sizeof(struct SurfaceNode)));
+    if (block == NULL) { return false; }
+
+    f32 *floats = (f32 *) block;
+    packed->x1           = floats; floats += capacity;
+    packed->z1           = floats; floats += capacity;
+    packed->x2           = floats; floats += capacity;
+    packed->z2           = floats; floats += capacity;
+    packed->x3           = floats; floats += capacity;
+    packed->z3           = floats; floats += capacity;
+    packed->normalX      = floats; floats += capacity;
+    packed->normalY      = floats; floats += capacity;
+    packed->normalZ      = floats; floats += capacity;
+    packed->lowerY       = floats; floats += capacity;
+    packed->upperY       = floats; floats += capacity;
+    packed->surface      = (struct Surface **) floats;
+    sStaticSurfaceNodes  = (struct SurfaceNode *) (packed->surface + capacity);
+    packed->capacity     = capacity;
+    return true;
+}
+
+/**
+ * Stable merge sort of a cell list by surface priority. Without
+ * fixCollisionBugs this is exactly the order add_surface_to_cell builds one
+ * insertion at a time; with it the list is fully ordered by upperY, while
+ * insertion compared against the first vertex of the surfaces already there.
+ */
+static void sort_static_surfaces(struct Surface **surfaces, struct Surface **scratch, u32 count, s16 sortDir) {
+    struct Surface **src = surfaces;
+    struct Surface **dst = scratch;
+
+    for (u32 width = 1; width < count; width *= 2) {
+        for (u32 left = 0; left < count; left += 2 * width) {
+            u32 mid = MIN(left + width, count);
+            u32 right = MIN(left + 2 * width, count);
+            u32 i = left, j = mid, k = left;
+            while (i < mid && j < right) {
+                // later surfaces only go first when strictly higher priority
+                if (surface_sort_priority(src[j], sortDir) > surface_sort_priority(src[i], sortDir)) {
+                    dst[k++] = src[j++];
+                } else {
+                    dst[k++] = src[i++];
+                }
+            }
+            while (i < mid) { dst[k++] = src[i++]; }
+            while (j < right) { dst[k++] = src[j++]; }
+        }
+        struct Surface **swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != surfaces) {
+        memcpy(surfaces, src, count * sizeof(struct Surface *));
+    }
+}
+
+/**
+ * Copies what the packed walks test of a surface into entry `i`.
+ */
+static void pack_static_surface(struct PackedSurfaces *packed, u32 i, struct Surface *surf) {
+    packed->x1[i]      = surf->vertex1[0];
+    packed->z1[i]      = surf->vertex1[2];
+    packed->x2[i]      = surf->vertex2[0];
+    packed->z2[i]      = surf->vertex2[2];
+    packed->x3[i]      = surf->vertex3[0];
+    packed->z3[i]      = surf->vertex3[2];
+    packed->normalX[i] = surf->normal.x;
+    packed->normalY[i] = surf->normal.y;
+    packed->normalZ[i] = surf->normal.z;
+    packed->lowerY[i]  = surf->lowerY;
+    packed->upperY[i]  = surf->upperY;
+}
+
+/**
+ * Iterates through the cells a surface is added to.
+ */
+#define FOR_EACH_SURFACE_CELL(_surface, _cellX, _cellZ) \
+    for (s16 _cellZ = lower_cell_index(min_3((_surface)->vertex1[2], (_surface)->vertex2[2], (_surface)->vertex3[2])), \
+             _maxZ_ = upper_cell_index(max_3((_surface)->vertex1[2], (_surface)->vertex2[2], (_surface)->vertex3[2])); _cellZ <= _maxZ_; _cellZ++) \
+    for (s16 _cellX = lower_cell_index(min_3((_surface)->vertex1[0], (_surface)->vertex2[0], (_surface)->vertex3[0])), \
+             _maxX_ = upper_cell_index(max_3((_surface)->vertex1[0], (_surface)->vertex2[0], (_surface)->vertex3[0])); _cellX <= _maxX_; _cellX++)
+
+/**
+ * Builds the static partition from every surface loaded for the area at once:
+ * surfaces are bucketed per cell list, each bucket is sorted once, and the
+ * buckets are laid out back to back in both the packed arrays and the surface
+ * nodes the lists are linked through.
+ */
+static void build_static_partition(u32 firstSurface, u32 numSurfaces) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    struct Surface **surfaces = (struct Surface **) &sSurfacePool->buffer[firstSurface];
+    u32 largestList = 0;
+    u32 total = 0;
+
+    // count the entries of every cell list
+    memset(packed->lists, 0, sizeof(packed->lists));
+    for (u32 i = 0; i < numSurfaces; i++) {
+        struct Surface *surface = surfaces[i];
+        s16 listIndex = surface_list_index(surface);
+        FOR_EACH_SURFACE_CELL(surface, cellX, cellZ) {
+            packed->lists[cellZ][cellX][listIndex].count++;
+        }
+    }
+
+    // give each list its range, padded for the SIMD walks
+    for (s32 cellZ = 0; cellZ < NUM_CELLS; cellZ++) {
+        for (s32 cellX = 0; cellX < NUM_CELLS; cellX++) {
+            for (s32 listIndex = 0; listIndex < 3; listIndex++) {
+                struct PackedSurfaceList *list = &packed->lists[cellZ][cellX][listIndex];
+                list->offset = total;
+                total += PACKED_SURFACE_ROUND(list->count);
+                largestList = MAX(largestList, list->count);
+                list->count = 0;
+            }
+        }
+    }
+
+    struct Surface **scratch = malloc(MAX(largestList, 1) * sizeof(struct Surface *));
+    if (scratch == NULL || !reserve_static_partition(total)) {
+        // fall back to inserting one surface at a time
+        free(scratch);
+        packed->count = 0;
+        memset(packed->lists, 0, sizeof(packed->lists));
+        for (u32 i = 0; i < numSurfaces; i++) {
+            add_surface(surfaces[i], FALSE);
+        }
+        return;
+    }
+
+    // bucket the surfaces in load order
+    for (u32 i = 0; i < numSurfaces; i++) {
+        struct Surface *surface = surfaces[i];
+        s16 listIndex = surface_list_index(surface);
+        FOR_EACH_SURFACE_CELL(surface, cellX, cellZ) {
+            struct PackedSurfaceList *list = &packed->lists[cellZ][cellX][listIndex];
+            packed->surface[list->offset + list->count++] = surface;
+        }
+    }
+
+    // sort each bucket once and lay out the packed data and nodes
+    for (s32 cellZ = 0; cellZ < NUM_CELLS; cellZ++) {
+        for (s32 cellX = 0; cellX < NUM_CELLS; cellX++) {
+            for (s32 listIndex = 0; listIndex < 3; listIndex++) {
+                struct PackedSurfaceList *list = &packed->lists[cellZ][cellX][listIndex];
+                u32 end = list->offset + list->count;
+                u32 i = list->offset;
+
+                if (sSurfaceListSortDir[listIndex] != 0) {
+                    sort_static_surfaces(&packed->surface[i], scratch, list->count, sSurfaceListSortDir[listIndex]);
+                }
+
+                gStaticSurfacePartition[cellZ][cellX][listIndex].next = (list->count > 0) ? &sStaticSurfaceNodes[i] : NULL;
+
+                for (; i < end; i++) {
+                    struct Surface *surf = packed->surface[i];
+                    pack_static_surface(packed, i, surf);
+
+                    sStaticSurfaceNodes[i].surface = surf;
+                    sStaticSurfaceNodes[i].next = (i + 1 < end) ? &sStaticSurfaceNodes[i + 1] : NULL;
+                }
+
+                // padding lanes are never reported by the queries
+                for (; i < list->offset + PACKED_SURFACE_ROUND(list->count); i++) {
+                    packed->x1[i] = packed->z1[i] = packed->x2[i] = packed->z2[i] = packed->x3[i] = packed->z3[i] = 0;
+                    packed->normalX[i] = packed->normalY[i] = packed->normalZ[i] = 0;
+                    packed->lowerY[i] = packed->upperY[i] = 0;
+                    packed->surface[i] = NULL;
+                }
+            }
+        }
+    }
+
+    packed->count = total;
+    free(scratch);
+}
+
+/**
+ * Marks the static surfaces as written to by Lua. The packed partition is
+ * recopied from the surfaces before the next query walks it. Moved vertices
+ * or normals also drop the BVH until the next area load, the ray and sphere
+ * queries then walk the partition lists like they did before the BVH.
+ */
+void mark_static_surfaces_modified(u8 verticesChanged) {
+    gStaticSurfacesModified = TRUE;
+    if (verticesChanged) {
+        gStaticSurfaceBVH.numNodes = 0;
+    }
+}
+
+/**
+ * Recopies every packed entry from its surface. Surfaces stay in the cells
+ * they were loaded into, like they do in the SurfaceNode lists.
+ */
+void refresh_static_surfaces(void) {
+    struct PackedSurfaces *packed = &gStaticPackedSurfaces;
+    for (u32 i = 0; i < packed->count; i++) {
+        if (packed->surface[i] != NULL) {
+            pack_static_surface(packed, i, packed->surface[i]);
+        }
+    }
+    gStaticSurfacesModified = FALSE;
+}
+
+/**
+ * Axis the BVH build is currently splitting along.
+ */
+static s32 sSurfaceBVHSplitAxis = 0;
+
+static int surface_bvh_compare(const void *a, const void *b) {
+    const struct Surface *surfA = *(const struct Surface **) a;
+    const struct Surface *surfB = *(const struct Surface **) b;
+    s32 axis = sSurfaceBVHSplitAxis;
+    s32 centerA = surfA->vertex1[axis] + surfA->vertex2[axis] + surfA->vertex3[axis];
+    s32 centerB = surfB->vertex1[axis] + surfB->vertex2[axis] + surfB->vertex3[axis];
+
+    if (centerA != centerB) { return (centerA < centerB) ? -1 : 1; }
+    // keep the build deterministic
+    return (surfA < surfB) ? -1 : (surfA > surfB);
+}
+
+/**
+ * Builds the subtree over surfaces [first, first + count) by splitting them in
+ * half along the axis their centers are most spread out on.
+ * @return The index of the subtree's root node
+ */
+static u32 build_surface_bvh_node(u32 first, u32 count, u32 depth) {
+    struct SurfaceBVH *bvh = &gStaticSurfaceBVH;
+    u32 index = bvh->numNodes++;
+    bvh->depth = MAX(bvh->depth, depth);
+    struct SurfaceBVHNode *node = &bvh->nodes[index];
+    s32 centerMin[3] = {  0x7FFFFFFF,  0x7FFFFFFF,  0x7FFFFFFF };
+    s32 centerMax[3] = { -0x7FFFFFFF, -0x7FFFFFFF, -0x7FFFFFFF };
+
+    vec3f_set(node->min,  0x7FFF,  0x7FFF,  0x7FFF);
+    vec3f_set(node->max, -0x8000, -0x8000, -0x8000);
+
+    for (u32 i = first; i < first + count; i++) {
+        struct Surface *surf = bvh->surfaces[i];
+        for (s32 axis = 0; axis < 3; axis++) {
+            s16 lo = min_3(surf->vertex1[axis], surf->vertex2[axis], surf->vertex3[axis]);
+            s16 hi = max_3(surf->vertex1[axis], surf->vertex2[axis], surf->vertex3[axis]);
+            s32 center = surf->vertex1[axis] + surf->vertex2[axis] + surf->vertex3[axis];
+            node->min[axis] = MIN(node->min[axis], lo);
+            node->max[axis] = MAX(node->max[axis], hi);
+            centerMin[axis] = MIN(centerMin[axis], center);
+            centerMax[axis] = MAX(centerMax[axis], center);
+        }
+    }
+
+    if (count <= SURFACE_BVH_LEAF_SIZE) {
+        node->first = first;
+        node->count = count;
+        return index;
+    }
+
+    sSurfaceBVHSplitAxis = 0;
+    for (s32 axis = 1; axis < 3; axis++) {
+        if (centerMax[axis] - centerMin[axis] > centerMax[sSurfaceBVHSplitAxis] - centerMin[sSurfaceBVHSplitAxis]) {
+            sSurfaceBVHSplitAxis = axis;
+        }
+    }
+    qsort(&bvh->surfaces[first], count, sizeof(struct Surface *), surface_bvh_compare);
+
+    // the left child always directly follows its parent
+    u32 half = count / 2;
+    build_surface_bvh_node(first, half, depth + 1);
+    u32 right = build_surface_bvh_node(first + half, count - half, depth + 1);
+
+    node = &bvh->nodes[index];
+    node->first = right;
+    node->count = 0;
+    return index;
+}
+
+/**
+ * Builds the BVH over the area's static surfaces. If it can't be allocated the
+ * ray and sphere queries keep using the static partition.
+ */
+static void build_static_bvh(u32 firstSurface, u32 numSurfaces) {
+    struct SurfaceBVH *bvh = &gStaticSurfaceBVH;
+    bvh->numNodes = 0;
+    bvh->numSurfaces = 0;
+    bvh->depth = 0;
+    if (numSurfaces == 0) { return; }
+
+    if (numSurfaces > bvh->capacity) {
+        // a binary tree with at most one surface per leaf has under twice as many nodes as surfaces
+        struct SurfaceBVHNode *nodes = realloc(bvh->nodes, 2 * numSurfaces * sizeof(struct SurfaceBVHNode));
+        if (nodes == NULL) { return; }
+        bvh->nodes = nodes;
+
+        struct Surface **surfaces = realloc(bvh->surfaces, numSurfaces * sizeof(struct Surface *));
+        if (surfaces == NULL) { return; }
+        bvh->surfaces = surfaces;
+
+        bvh->capacity = numSurfaces;
+    }
+
+    memcpy(bvh->surfaces, &sSurfacePool->buffer[firstSurface], numSurfaces * sizeof(struct Surface *));
+    bvh->numSurfaces = numSurfaces;
+    build_surface_bvh_node(0, numSurfaces, 0);
+
+    // the walks keep at most one pending node per level plus the one being split
+    if (bvh->depth + 1 > SURFACE_BVH_STACK_SIZE) {
+        bvh->numNodes = 0;
+    }
+}
+
 /**
  * Initializes a Surface struct using the given vertex data
  * @param vertexData The raw data containing vertex positions
  * @param vertexIndices Helper which tells positions in vertexData to start reading vertices
+ * @param surface The surface to fill in, or NULL to allocate one from the surface pool
  */
-static struct Surface *read_surface_data(s16 *vertexData, s16 **vertexIndices) {
+static struct Surface *read_surface_data(s16 *vertexData, s16 **vertexIndices, struct Surface *surface) {
     if (vertexData == NULL || vertexIndices == NULL || *vertexIndices == NULL) { return NULL; }
 
-    struct Surface *surface;
     register s32 x1, y1, z1;
     register s32 x2, y2, z2;
     register s32 x3, y3, z3;
@@ -312,8 +732,10 @@ static struct Surface *read_surface_data(s16 *vertexData, s16 **vertexIndices) {
     ny *= mag;
     nz *= mag;
 
-    surface = alloc_surface();
-    if (surface == NULL) { return NULL; }
+    if (surface == NULL) {
+        surface = alloc_surface();
+        if (surface == NULL) { return NULL; }
+    }
 
     vec3s_copy(surface->prevVertex1, surface->vertex1);
     vec3s_copy(surface->prevVertex2, surface->vertex2);
@@ -391,7 +813,7 @@ static void load_static_surfaces(s16 **data, s16 *vertexData, s16 surfaceType, s
             *surfaceRooms += 1;
         }
 
-        surface = read_surface_data(vertexData, data);
+        surface = read_surface_data(vertexData, data, NULL);
         if (surface != NULL) {
             surface->room = room;
             surface->type = surfaceType;
@@ -403,7 +825,6 @@ static void load_static_surfaces(s16 **data, s16 *vertexData, s16 surfaceType, s
                 surface->force = 0;
             }
 
-            add_surface(surface, FALSE);
         }
 
         *data += 3;
@@ -537,6 +958,7 @@ u32 get_area_terrain_size(s16 *terrainData) {
 void load_area_terrain(s16 index, s16 *data, s8 *surfaceRooms, s16 *macroObjects) {
     s16 terrainLoadType = 0;
     s16 *vertexData = NULL;
+    f64 loadStart = clock_elapsed_f64();
 
     // Initialize the data for this.
     gEnvironmentRegions = NULL;
@@ -582,8 +1004,14 @@ void load_area_terrain(s16 index, s16 *data, s8 *surfaceRooms, s16 *macroObjects
         }
     }
 
+    build_static_partition(0, gSurfacesAllocated);
+    build_static_bvh(0, gSurfacesAllocated);
+
     gNumStaticSurfaceNodes = gSurfaceNodesAllocated;
     gNumStaticSurfaces = gSurfacesAllocated;
+
+    CTR_SET(CTR_AREA_LOAD_US, (s64)((clock_elapsed_f64() - loadStart) * 1000000.0));
+    CTR_SET(CTR_AREA_SURFACES, gNumStaticSurfaces);
 }
 
 /**
@@ -593,6 +1021,7 @@ void clear_dynamic_surfaces(void) {
     if (!(gTimeStopState & TIME_STOP_ACTIVE)) {
         gSurfacesAllocated = gNumStaticSurfaces;
         gSurfaceNodesAllocated = gNumStaticSurfaceNodes;
+        sDynamicSurfaceFrame++;
 
         clear_spatial_partition(&gDynamicSurfacePartition[0][0]);
 
@@ -605,31 +1034,32 @@ void clear_dynamic_surfaces(void) {
 }
 
 /**
- * Applies an object's transformation to the object's vertices.
+ * Builds the matrix gCurrentObject's collision vertices are transformed by.
  */
-void transform_object_vertices(s16 **data, s16 *vertexData) {
-    if (!gCurrentObject) { return; }
+static void get_object_collision_transform(Mat4 m) {
+    Mat4 *objectTransform = &gCurrentObject->transform;
+
+    if (gCurrentObject->header.gfx.throwMatrix == NULL) {
+        gCurrentObject->header.gfx.throwMatrix = objectTransform;
+        obj_build_transform_from_pos_and_angle(gCurrentObject, O_POS_INDEX, O_FACE_ANGLE_INDEX);
+    }
+
+    obj_apply_scale_to_matrix(gCurrentObject, m, *objectTransform);
+}
+
+/**
+ * Transforms the vertices at `data` by `m` into `vertexData`.
+ */
+static void apply_object_transform(s16 **data, s16 *vertexData, Mat4 m) {
     register s16 *vertices;
     register f32 vx, vy, vz;
     register s32 numVertices;
 
-    Mat4 *objectTransform;
-    Mat4 m;
-
-    objectTransform = &gCurrentObject->transform;
-
     numVertices = *(*data);
     (*data)++;
 
     vertices = *data;
 
-    if (gCurrentObject->header.gfx.throwMatrix == NULL) {
-        gCurrentObject->header.gfx.throwMatrix = objectTransform;
-        obj_build_transform_from_pos_and_angle(gCurrentObject, O_POS_INDEX, O_FACE_ANGLE_INDEX);
-    }
-
-    obj_apply_scale_to_matrix(gCurrentObject, m, *objectTransform);
-
     // Go through all vertices, rotating and translating them to transform the object.
     while (numVertices--) {
         vx = *(vertices++);
@@ -645,6 +1075,17 @@ void transform_object_vertices(s16 **data, s16 *vertexData) {
     *data = vertices;
 }
 
+/**
+ * Applies an object's transformation to the object's vertices.
+ */
+void transform_object_vertices(s16 **data, s16 *vertexData) {
+    if (!gCurrentObject) { return; }
+    Mat4 m;
+
+    get_object_collision_transform(m);
+    apply_object_transform(data, vertexData, m);
+}
+
 /**
  * Load in the surfaces for the gCurrentObject. This includes setting the flags, exertion, and room.
  */
@@ -677,7 +1118,7 @@ void load_object_surfaces(s16** data, s16* vertexData) {
     }
 
     for (i = 0; i < numSurfaces; i++) {
-        struct Surface* surface = read_surface_data(vertexData, data);
+        struct Surface* surface = read_surface_data(vertexData, data, NULL);
 
         if (surface != NULL) {
 
@@ -711,6 +1152,199 @@ void load_object_surfaces(s16** data, s16* vertexData) {
     }
 }
 
+/**
+ * Returns the kept collision of a pool object, or NULL for anything else.
+ */
+static struct ObjectCollision *object_collision_get(struct Object *o) {
+    if (o < gObjectPool || o >= gObjectPool + OBJECT_POOL_CAPACITY) { return NULL; }
+    return &sObjectCollisions[o - gObjectPool];
+}
+
+/**
+ * Counts the surfaces in the surface groups of an object's collision data.
+ */
+static u32 count_object_surfaces(s16 *data) {
+    u32 count = 0;
+
+    while (*data != TERRAIN_LOAD_CONTINUE) {
+        s16 surfaceType = *data++;
+        s32 numSurfaces = *data++;
+        if (numSurfaces <= 0) { continue; }
+        count += numSurfaces;
+        data += numSurfaces * (surface_has_force(surfaceType) ? 4 : 3);
+    }
+
+    return count;
+}
+
+/**
+ * Make room for the surfaces and nodes of an object's collision. Surfaces
+ * are allocated one at a time and never freed, since Mario and objects keep
+ * pointers to surfaces from earlier frames.
+ */
+static bool object_collision_reserve(struct ObjectCollision *col, u32 numSurfaces, u32 numNodes) {
+    if (numSurfaces > col->surfaceCapacity) {
+        struct Surface **surfaces = realloc(col->surfaces, numSurfaces * sizeof(struct Surface *));
+        if (surfaces == NULL) { return false; }
+        col->surfaces = surfaces;
+        for (; col->surfaceCapacity < numSurfaces; col->surfaceCapacity++) {
+            col->surfaces[col->surfaceCapacity] = calloc(1, sizeof(struct Surface));
+            if (col->surfaces[col->surfaceCapacity] == NULL) { return false; }
+        }
+    }
+
+    if (numNodes > col->nodeCapacity) {
+        struct ObjectCollisionNode *nodes = realloc(col->nodes, numNodes * sizeof(struct ObjectCollisionNode));
+        if (nodes == NULL) { return false; }
+        col->nodes = nodes;
+        col->nodeCapacity = numNodes;
+    }
+
+    return true;
+}
+
+/**
+ * Reads gCurrentObject's transformed surfaces into its kept collision and
+ * works out which cells they go in.
+ * @param data The first surface group of the collision data
+ * @param vertexData The transformed vertices
+ */
+static bool object_collision_rebuild(struct ObjectCollision *col, s16 *data, s16 *vertexData) {
+    s16 room;
+
+    col->numSurfaces = 0;
+    col->numNodes = 0;
+    col->moved = TRUE;
+
+    if (!object_collision_reserve(col, count_object_surfaces(data), 0)) {
+        return false;
+    }
+
+    // The DDD warp is initially loaded at the origin and moved to the proper
+    // position in paintings.c and doesn't update its room, so set it here.
+    if (gCurrentObject->behavior == segmented_to_virtual(smlua_override_behavior(bhvDddWarp))) {
+        room = 5;
+    } else {
+        room = 0;
+    }
+
+    while (*data != TERRAIN_LOAD_CONTINUE) {
+        s16 surfaceType = *data++;
+        s32 numSurfaces = *data++;
+        bool hasForce = surface_has_force(surfaceType);
+        s8 flags = surf_has_no_cam_collision(surfaceType) ? SURFACE_FLAG_NO_CAM_COLLISION : 0;
+        flags |= SURFACE_FLAG_DYNAMIC;
+
+        for (s32 i = 0; i < numSurfaces; i++) {
+            // reusing the slot keeps last frame's vertices as prevVertex
+            struct Surface *surface = read_surface_data(vertexData, &data, col->surfaces[col->numSurfaces]);
+            if (surface != NULL) {
+                surface->object = gCurrentObject;
+                surface->type = surfaceType;
+                surface->force = hasForce ? *(data + 3) : 0;
+                surface->flags = flags;
+                surface->room = (s8)room;
+                col->numSurfaces++;
+            }
+
+            data += hasForce ? 4 : 3;
+        }
+    }
+
+    u32 numNodes = 0;
+    for (u32 i = 0; i < col->numSurfaces; i++) {
+        FOR_EACH_SURFACE_CELL(col->surfaces[i], cellX, cellZ) { numNodes++; }
+    }
+
+    if (!object_collision_reserve(col, 0, numNodes)) {
+        return false;
+    }
+
+    // same order add_surface would have linked them in
+    for (u32 i = 0; i < col->numSurfaces; i++) {
+        struct Surface *surface = col->surfaces[i];
+        s16 listIndex = surface_list_index(surface);
+        FOR_EACH_SURFACE_CELL(surface, cellX, cellZ) {
+            struct ObjectCollisionNode *node = &col->nodes[col->numNodes++];
+            node->node.surface = surface;
+            node->node.next = NULL;
+            node->list = (cellZ * NUM_CELLS + cellX) * 3 + listIndex;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Links every node of an object's kept collision into the dynamic partition.
+ */
+static void object_collision_link(struct ObjectCollision *col) {
+    struct SurfaceNode *lists = &gDynamicSurfacePartition[0][0][0];
+
+    for (u32 i = 0; i < col->numNodes; i++) {
+        struct ObjectCollisionNode *node = &col->nodes[i];
+        link_surface_node(&lists[node->list], &node->node, node->list % 3);
+    }
+
+    col->linkedFrame = sDynamicSurfaceFrame;
+}
+
+/**
+ * Loads gCurrentObject's collision into the dynamic partition, only
+ * transforming it again when the object moved or its model changed.
+ * @param data The collision data, past the vertex count
+ */
+static void load_object_collision(s16 *data, s16 *vertexData) {
+    struct ObjectCollision *col = object_collision_get(gCurrentObject);
+
+    // Loaded twice in the same frame (or not a pool object), add another copy like before
+    if (col == NULL || col->linkedFrame == sDynamicSurfaceFrame) {
+        transform_object_vertices(&data, vertexData);
+
+        // TERRAIN_LOAD_CONTINUE acts as an "end" to the terrain data.
+        while (*data != TERRAIN_LOAD_CONTINUE) {
+            load_object_surfaces(&data, vertexData);
+        }
+        return;
+    }
+
+    Mat4 m;
+    get_object_collision_transform(m);
+
+    if (!col->valid
+        || col->collisionData != gCurrentObject->collisionData
+        || col->behavior != gCurrentObject->behavior
+        || memcmp(col->transform, m, sizeof(Mat4)) != 0) {
+        apply_object_transform(&data, vertexData, m);
+
+        col->valid = object_collision_rebuild(col, data, vertexData);
+        if (!col->valid) {
+            LOG_ERROR("Failed to allocate object collision");
+            return;
+        }
+
+        col->collisionData = gCurrentObject->collisionData;
+        col->behavior = gCurrentObject->behavior;
+        mtxf_copy(col->transform, m);
+        CTR_ADD(CTR_COL_REBUILT, col->numSurfaces);
+    } else {
+        // it stood still, so it shouldn't interpolate from where it moved from
+        if (col->moved) {
+            for (u32 i = 0; i < col->numSurfaces; i++) {
+                struct Surface *surface = col->surfaces[i];
+                vec3s_copy(surface->prevVertex1, surface->vertex1);
+                vec3s_copy(surface->prevVertex2, surface->vertex2);
+                vec3s_copy(surface->prevVertex3, surface->vertex3);
+            }
+            col->moved = FALSE;
+        }
+        CTR_ADD(CTR_COL_REUSED, col->numSurfaces);
+    }
+
+    object_collision_link(col);
+    gCurrentObject->numSurfaces = col->numSurfaces;
+}
+
 /**
  * Transform an object's vertices, reload them, and render the object.
  */
@@ -762,13 +1396,7 @@ void load_object_collision_model(void) {
     if (!(gTimeStopState & TIME_STOP_ACTIVE)
         && (anyPlayerInTangibleRange)
         && !(gCurrentObject->activeFlags & ACTIVE_FLAG_IN_DIFFERENT_ROOM)) {
-        collisionData++;
-        transform_object_vertices(&collisionData, sVertexData);
-
-        // TERRAIN_LOAD_CONTINUE acts as an "end" to the terrain data.
-        while (*collisionData != TERRAIN_LOAD_CONTINUE) {
-            load_object_surfaces(&collisionData, sVertexData);
-        }
+        load_object_collision(collisionData + 1, sVertexData);
     }
 
     f32 marioDist = dist_between_objects(gCurrentObject, gMarioStates[0].marioObj);
@@ -780,8 +1408,15 @@ void load_object_collision_model(void) {
 }
 
 struct Surface *obj_get_surface_from_index(struct Object *o, u32 index) {
-    if (!o || o->firstSurface == 0) { return NULL; }
+    if (!o) { return NULL; }
     if (index >= o->numSurfaces) { return NULL; }
-    struct Surface *surf = sSurfacePool->buffer[o->firstSurface + index];
+
+    // kept collision comes first, then any copies loaded again this frame
+    struct ObjectCollision *col = object_collision_get(o);
+    u32 numKept = (col != NULL && col->linkedFrame == sDynamicSurfaceFrame) ? col->numSurfaces : 0;
+    if (index < numKept) { return col->surfaces[index]; }
+
+    if (o->firstSurface == 0) { return NULL; }
+    struct Surface *surf = sSurfacePool->buffer[o->firstSurface + index - numKept];
     return surf;
 }
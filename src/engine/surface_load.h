@@ -27,12 +27,86 @@ typedef struct SurfaceNode SpatialPartitionCell[3];
 extern SpatialPartitionCell gStaticSurfacePartition[NUM_CELLS][NUM_CELLS];
 extern SpatialPartitionCell gDynamicSurfacePartition[NUM_CELLS][NUM_CELLS];
 
+// Packed lists start on a multiple of this so SIMD loads never run past the arrays
+#define PACKED_SURFACE_ALIGN 4
+
+/**
+ * A static partition cell list baked into the packed arrays below. Entries
+ * [offset, offset + count) hold the same surfaces in the same order as the
+ * matching SurfaceNode list.
+ */
+struct PackedSurfaceList
+{
+    u32 offset;
+    u32 count;
+};
+
+/**
+ * Structure-of-arrays copy of the static partition, built once after the area
+ * terrain is loaded so the collision queries can test triangles without
+ * chasing surface pointers. Vertices are stored as floats to match the math
+ * in the list walks. Lua writes to the copied fields are reported through
+ * mark_static_surfaces_modified and the copies refreshed before the next query.
+ */
+struct PackedSurfaces
+{
+    u32 count;
+    u32 capacity;
+    f32 *x1, *z1, *x2, *z2, *x3, *z3;
+    f32 *normalX, *normalY, *normalZ;
+    f32 *lowerY, *upperY;
+    struct Surface **surface;
+    struct PackedSurfaceList lists[NUM_CELLS][NUM_CELLS][3];
+};
+
+extern struct PackedSurfaces gStaticPackedSurfaces;
+extern u8 gStaticSurfacesModified;
+
+// Most surfaces kept in a single leaf of the static surface BVH
+#define SURFACE_BVH_LEAF_SIZE 4
+// Nodes the BVH walks can have pending, a deeper tree isn't used
+#define SURFACE_BVH_STACK_SIZE 64
+
+/**
+ * A node of the static surface BVH. Leaves hold surfaces [first, first + count)
+ * of the BVH's surface array. Inner nodes have a count of 0, their left child
+ * right after them and their right child at index first.
+ */
+struct SurfaceBVHNode
+{
+    Vec3f min;
+    Vec3f max;
+    u32 first;
+    u32 count;
+};
+
+/**
+ * Bounding volume hierarchy over the static surfaces of the current area,
+ * built in load_area_terrain. Ray and sphere queries use it instead of
+ * walking the static partition cell by cell. Node bounds come from the
+ * vertices, so it is dropped once Lua moves a vertex or normal.
+ */
+struct SurfaceBVH
+{
+    struct SurfaceBVHNode *nodes;
+    struct Surface **surfaces;
+    u32 numNodes;
+    u32 numSurfaces;
+    u32 capacity;
+    u32 depth;
+};
+
+extern struct SurfaceBVH gStaticSurfaceBVH;
+extern u8 gSurfaceBVHEnabled;
+
 void alloc_surface_pools(void);
 
 u32 get_area_terrain_size(s16 *data);
 
 void load_area_terrain(s16 index, s16 *data, s8 *surfaceRooms, s16 *macroObjects);
 void clear_dynamic_surfaces(void);
+void mark_static_surfaces_modified(u8 verticesChanged);
+void refresh_static_surfaces(void);
 /* |description|
 Loads the object's collision data into dynamic collision.
 You must run this every frame in your object's behavior loop for it to have collision
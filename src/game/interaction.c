@@ -678,8 +678,9 @@ u32 determine_knockback_action(struct MarioState *m, UNUSED s32 arg) {
         f32 scaler = 1.0f;
         s8 hasBeenPunched = FALSE;
 #define IF_REVAMPED_PVP(is, isNot) (gServerSettings.pvpType == PLAYER_PVP_REVAMPED ? (is) : (isNot));
-        for (s32 i = 0; i < MAX_PLAYERS; i++) {
-            struct MarioState* m2 = &gMarioStates[i];
+        NetworkPlayerMask mask = network_player_present_mask();
+        while (mask) {
+            struct MarioState* m2 = &gMarioStates[network_player_mask_pop(&mask)];
             if (!is_player_active(m2)) { continue; }
             if (m2->marioObj == NULL) { continue; }
             if (m2->marioObj != m->interactObj) { continue; }
@@ -1068,8 +1069,9 @@ u32 display_door_dialog(struct MarioState *m, u32 actionArg) {
 u8 prevent_interact_door(struct MarioState* m, struct Object* o) {
     if (!m) { return FALSE; }
     // prevent multiple star/key unlocks on the same door
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        struct MarioState* m2 = &gMarioStates[i];
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        struct MarioState* m2 = &gMarioStates[network_player_mask_pop(&mask)];
         if (m2 == m) { continue; }
         if (!is_player_active(m2)) { continue; }
         Vec3f diff = { 0 };
@@ -1412,7 +1414,9 @@ u32 interact_player(struct MarioState* m, UNUSED u32 interactType, struct Object
     if (m->action & ACT_FLAG_INTANGIBLE) { return FALSE; }
 
     struct MarioState* m2 = NULL;
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (o == gMarioStates[i].marioObj) {
             if (!is_player_active(&gMarioStates[i])) { return FALSE; }
             m2 = &gMarioStates[i];
@@ -1961,7 +1965,9 @@ u32 interact_koopa_shell(struct MarioState *m, UNUSED u32 interactType, struct O
         return FALSE;
     }
 
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!is_player_active(&gMarioStates[i])) { continue; }
         if (gMarioStates[i].riddenObj == o) { return FALSE; }
     }
@@ -2365,9 +2371,9 @@ void mario_process_interactions(struct MarioState *m) {
     }
 
     if (!(m->action & ACT_FLAG_INTANGIBLE) && is_player_active(m)) {
-        for (s32 i = 0; i < MAX_PLAYERS; i++) {
-            struct NetworkPlayer* np2 = &gNetworkPlayers[i];
-            if (!np2->connected) { continue; }
+        NetworkPlayerMask mask = gNetworkPlayersConnected;
+        while (mask) {
+            u8 i = network_player_mask_pop(&mask);
             if (&gMarioStates[i] == m) { continue; }
             interact_player_pvp(m, &gMarioStates[i]);
         }
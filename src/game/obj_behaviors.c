@@ -527,7 +527,9 @@ void obj_move_xyz_using_fvel_and_yaw(struct Object *obj) {
  * Checks if a point is within distance from Mario's graphical position. Test is exclusive.
  */
 s8 is_point_within_radius_of_mario(f32 x, f32 y, f32 z, s32 dist) {
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!is_player_active(&gMarioStates[i])) { continue; }
         if (!gMarioStates[i].visibleToEnemies) { continue; }
         struct Object* player = gMarioStates[i].marioObj;
@@ -546,7 +548,9 @@ s8 is_point_within_radius_of_mario(f32 x, f32 y, f32 z, s32 dist) {
 }
 
 s8 is_point_within_radius_of_any_player(f32 x, f32 y, f32 z, s32 dist) {
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!is_player_active(&gMarioStates[i])) { continue; }
         struct Object* player = gMarioStates[i].marioObj;
         if (!player) { continue; }
@@ -583,8 +587,9 @@ u8 is_player_active(struct MarioState* m) {
 }
 
 u8 is_other_player_active(void) {
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        struct MarioState *m = &gMarioStates[i];
+    NetworkPlayerMask mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        struct MarioState *m = &gMarioStates[network_player_mask_pop(&mask)];
         if (is_player_active(m)) { return TRUE; }
     }
     return FALSE;
@@ -615,7 +620,9 @@ struct MarioState* nearest_mario_state_to_object(struct Object *obj) {
     if (!obj) { return NULL; }
     struct MarioState* nearest = NULL;
     f32 nearestDist = 0;
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!gMarioStates[i].marioObj) { continue; }
         if (gMarioStates[i].marioObj == obj) { continue; }
         if (!gMarioStates[i].visibleToEnemies) { continue; }
@@ -634,7 +641,9 @@ struct MarioState* nearest_possible_mario_state_to_object(struct Object *obj) {
     if (!obj) { return NULL; }
     struct MarioState* nearest = NULL;
     f32 nearestDist = 0;
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!gMarioStates[i].marioObj) { continue; }
         if (gMarioStates[i].marioObj == obj) { continue; }
         if (!is_player_active(&gMarioStates[i])) { continue; }
@@ -666,7 +675,9 @@ struct MarioState *nearest_interacting_mario_state_to_object(struct Object *obj)
     struct MarioState *nearest = NULL;
     f32 nearestDist = 0;
 
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (!gMarioStates[i].marioObj) { continue; }
         if (gMarioStates[i].marioObj == obj) { continue; }
         if (gMarioStates[i].interactObj != obj) { continue; }
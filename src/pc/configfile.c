@@ -85,6 +85,7 @@ bool         configUncappedFramerate              = true;
 unsigned int configFrameLimit                     = 60;
 unsigned int configInterpolationMode              = 1;
 unsigned int configDrawDistance                   = 4;
+bool         configTextureContentHash             = true;
 // sound settings
 unsigned int configMasterVolume                   = 80; // 0 - MAX_VOLUME
 unsigned int configMusicVolume                    = MAX_VOLUME;
@@ -151,6 +152,7 @@ bool         configCameraInvertY                  = true;
 bool         configCameraToxicGas                 = true;
 // debug
 bool         configLuaProfiler                    = false;
+unsigned int configLuaGcBudget                    = 1000;
 bool         configDebugPrint                     = false;
 bool         configDebugInfo                      = false;
 bool         configDebugError                     = false;
@@ -185,6 +187,9 @@ bool         configDisablePopups                  = false;
 char         configLanguage[MAX_CONFIG_STRING]    = "";
 bool         configDynosLocalPlayerModelOnly      = false;
 unsigned int configPvpType                        = PLAYER_PVP_CLASSIC;
+unsigned int configNetworkCompression             = PACKET_COMPRESSION_BEST;
+unsigned int configNetworkCompressionThreshold    = 64;
+unsigned int configNetworkObjectBudget            = 4096;
 // CoopNet settings
 char         configCoopNetIp[MAX_CONFIG_STRING]   = DEFAULT_COOPNET_IP;
 unsigned int configCoopNetPort                    = DEFAULT_COOPNET_PORT;
@@ -203,6 +208,7 @@ unsigned int configDjuiScale                      = 0;
 unsigned int configRulesVersion                   = 0;
 bool         configCompressOnStartup              = false;
 bool         configSkipPackGeneration             = false;
+bool         configPackRawTextures                = false;
 
 // secrets
 bool configExCoopTheme = false;
@@ -223,6 +229,7 @@ static const struct ConfigOption options[] = {
     {.name = "frame_limit",                    .type = CONFIG_TYPE_UINT, .uintValue = &configFrameLimit},
     {.name = "interpolation_mode",             .type = CONFIG_TYPE_UINT, .uintValue = &configInterpolationMode},
     {.name = "coop_draw_distance",             .type = CONFIG_TYPE_UINT, .uintValue = &configDrawDistance},
+    {.name = "texture_content_hash",           .type = CONFIG_TYPE_BOOL, .boolValue = &configTextureContentHash},
     // sound settings
     {.name = "master_volume",                  .type = CONFIG_TYPE_UINT, .uintValue = &configMasterVolume},
     {.name = "music_volume",                   .type = CONFIG_TYPE_UINT, .uintValue = &configMusicVolume},
@@ -292,6 +299,7 @@ static const struct ConfigOption options[] = {
     {.name = "debug_offset",                   .type = CONFIG_TYPE_U64,  .u64Value    = &gPcDebug.bhvOffset},
     {.name = "debug_tags",                     .type = CONFIG_TYPE_U64,  .u64Value    = gPcDebug.tags},
     {.name = "lua_profiler",                   .type = CONFIG_TYPE_BOOL, .boolValue   = &configLuaProfiler},
+    {.name = "lua_gc_budget_us",               .type = CONFIG_TYPE_UINT, .uintValue   = &configLuaGcBudget},
     {.name = "debug_print",                    .type = CONFIG_TYPE_BOOL, .boolValue   = &configDebugPrint},
     {.name = "debug_info",                     .type = CONFIG_TYPE_BOOL, .boolValue   = &configDebugInfo},
     {.name = "debug_error",                    .type = CONFIG_TYPE_BOOL, .boolValue   = &configDebugError},
@@ -329,6 +337,9 @@ static const struct ConfigOption options[] = {
     {.name = "coop_menu_sound",                .type = CONFIG_TYPE_UINT,   .uintValue   = &configMenuSound},
     {.name = "coop_menu_random",               .type = CONFIG_TYPE_BOOL,   .boolValue   = &configMenuRandom},
     {.name = "player_pvp_mode",                .type = CONFIG_TYPE_UINT,   .uintValue   = &configPvpType},
+    {.name = "coop_net_compression",           .type = CONFIG_TYPE_UINT,   .uintValue   = &configNetworkCompression},
+    {.name = "coop_net_compress_threshold",    .type = CONFIG_TYPE_UINT,   .uintValue   = &configNetworkCompressionThreshold},
+    {.name = "coop_net_object_budget",         .type = CONFIG_TYPE_UINT,   .uintValue   = &configNetworkObjectBudget},
     // {.name = "coop_menu_demos",                .type = CONFIG_TYPE_BOOL,   .boolValue   = &configMenuDemos},
     {.name = "disable_popups",                 .type = CONFIG_TYPE_BOOL,   .boolValue   = &configDisablePopups},
     {.name = "language",                       .type = CONFIG_TYPE_STRING, .stringValue = (char*)&configLanguage, .maxStringLength = MAX_CONFIG_STRING},
@@ -347,6 +358,7 @@ static const struct ConfigOption options[] = {
     {.name = "rules_version",                  .type = CONFIG_TYPE_UINT,   .uintValue   = &configRulesVersion},
     {.name = "compress_on_startup",            .type = CONFIG_TYPE_BOOL,   .boolValue   = &configCompressOnStartup},
     {.name = "skip_pack_generation",           .type = CONFIG_TYPE_BOOL,   .boolValue   = &configSkipPackGeneration},
+    {.name = "pack_raw_textures",              .type = CONFIG_TYPE_BOOL,   .boolValue   = &configPackRawTextures},
 };
 
 struct SecretConfigOption {
@@ -762,6 +774,8 @@ NEXT_OPTION:
     if (configFrameLimit < 30)   { configFrameLimit = 30; }
     if (configFrameLimit > 3000) { configFrameLimit = 3000; }
 
+    if (configLuaGcBudget > 16000) { configLuaGcBudget = 16000; }
+
     if (configPlayerModel >= CT_MAX) { configPlayerModel = 0; }
 
     if (configDjuiTheme >= DJUI_THEME_MAX) { configDjuiTheme = 0; }
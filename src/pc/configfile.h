@@ -37,6 +37,7 @@ extern bool         configUncappedFramerate;
 extern unsigned int configFrameLimit;
 extern unsigned int configInterpolationMode;
 extern unsigned int configDrawDistance;
+extern bool         configTextureContentHash;
 // sound settings
 extern unsigned int configMasterVolume;
 extern unsigned int configMusicVolume;
@@ -102,6 +103,7 @@ extern bool         configCameraInvertY;
 extern bool         configCameraToxicGas;
 // debug
 extern bool         configLuaProfiler;
+extern unsigned int configLuaGcBudget;
 extern bool         configDebugPrint;
 extern bool         configDebugInfo;
 extern bool         configDebugError;
@@ -136,6 +138,9 @@ extern bool         configDisablePopups;
 extern char         configLanguage[MAX_CONFIG_STRING];
 extern bool         configDynosLocalPlayerModelOnly;
 extern unsigned int configPvpType;
+extern unsigned int configNetworkCompression;
+extern unsigned int configNetworkCompressionThreshold;
+extern unsigned int configNetworkObjectBudget;
 // CoopNet settings
 extern char         configCoopNetIp[MAX_CONFIG_STRING];
 extern unsigned int configCoopNetPort;
@@ -150,6 +155,7 @@ extern unsigned int configDjuiScale;
 extern unsigned int configRulesVersion;
 extern bool         configCompressOnStartup;
 extern bool         configSkipPackGeneration;
+extern bool         configPackRawTextures;
 
 // secrets
 extern bool configExCoopTheme;
@@ -14,6 +14,8 @@ static f64 sCtxTime[CTX_MAX] = { 0 };
 static f64 sCtxStartTimeStack[MAX_TIME_STACK] = { 0 };
 static u32 sCtxStackIndex = 0;
 
+static s64 sCtrValue[CTR_MAX] = { 0 };
+
 #endif
 
 void debug_context_begin(enum DebugContext ctx) {
@@ -52,6 +54,12 @@ void debug_context_reset(void) {
 #endif
 
     }
+
+#ifdef DEVELOPMENT
+    for (int i = 0; i < CTR_PERSISTENT_START; i++) {
+        sCtrValue[i] = 0;
+    }
+#endif
 }
 
 bool debug_context_within(enum DebugContext ctx) {
@@ -70,3 +78,26 @@ f64 debug_context_get_time(enum DebugContext ctx) {
     return sCtxTime[ctx];
 }
 #endif
+
+void debug_counter_set(UNUSED enum DebugCounter ctr, UNUSED s64 value) {
+#ifdef DEVELOPMENT
+    if (ctr >= CTR_MAX) { return; }
+    sCtrValue[ctr] = value;
+#endif
+}
+
+void debug_counter_add(UNUSED enum DebugCounter ctr, UNUSED s64 value) {
+#ifdef DEVELOPMENT
+    if (ctr >= CTR_MAX) { return; }
+    sCtrValue[ctr] += value;
+#endif
+}
+
+s64 debug_counter_get(UNUSED enum DebugCounter ctr) {
+#ifdef DEVELOPMENT
+    if (ctr >= CTR_MAX) { return 0; }
+    return sCtrValue[ctr];
+#else
+    return 0;
+#endif
+}
@@ -9,6 +9,9 @@
 #define CTX_TIME(_ctx, time) debug_context_set_time(_ctx, time)
 #define CTX_EXTENT(_ctx, _f) { CTX_BEGIN(_ctx); _f(); CTX_END(_ctx); }
 
+#define CTR_SET(_ctr, _value) debug_counter_set(_ctr, _value)
+#define CTR_ADD(_ctr, _value) debug_counter_add(_ctr, _value)
+
 enum DebugContext {
     CTX_NONE,
     CTX_TOTAL,
@@ -21,13 +24,52 @@ enum DebugContext {
     CTX_LEVEL_SCRIPT,
     CTX_HOOK,
     CTX_LIGHTING,
+    CTX_LUA_GC,
     CTX_MAX,
     // MUST BE KEPT IN SYNC WITH sDebugContextNames
 };
 
+enum DebugCounter {
+    CTR_NET_PLAYER_RAW_BPS,
+    CTR_NET_PLAYER_TX_BPS,
+    CTR_NET_OBJECT_TX,
+    CTR_NET_OBJECT_CULLED,
+    CTR_NET_OBJECT_DEFERRED,
+    CTR_TEX_HIT,
+    CTR_TEX_MISS,
+    CTR_TEX_SHARED,
+    CTR_TEX_EVICT,
+    CTR_TEX_UPLOAD_BYTES,
+    CTR_GFX_FLUSH,
+    CTR_GFX_DRAW,
+    CTR_GFX_MERGED,
+    CTR_GFX_VBO_BYTES,
+    CTR_COL_REBUILT,
+    CTR_COL_REUSED,
+    CTR_LUA_ALLOC_B,
+    CTR_LUA_HEAP_KB,
+    CTR_AUDIO_UNDERRUN,
+    CTR_DJUI_GLYPHS,
+    CTR_DJUI_DL_SAVED,
+    CTR_DYNOS_TEX_STALL,
+    CTR_DYNOS_TEX_STALL_US,
+    CTR_DYNOS_TEX_PENDING,
+    // counters from here on keep their value until they are set again
+    CTR_AREA_LOAD_US,
+    CTR_AREA_SURFACES,
+    CTR_MAX,
+    // MUST BE KEPT IN SYNC WITH sDebugCounterNames
+};
+
+#define CTR_PERSISTENT_START CTR_AREA_LOAD_US
+
 void debug_context_begin(enum DebugContext ctx);
 void debug_context_end(enum DebugContext ctx);
 void debug_context_reset(void);
 bool debug_context_within(enum DebugContext ctx);
 void debug_context_set_time(enum DebugContext ctx, f64 time);
-f64 debug_context_get_time(enum DebugContext ctx);
\ No newline at end of file
+f64 debug_context_get_time(enum DebugContext ctx);
+
+void debug_counter_set(enum DebugCounter ctr, s64 value);
+void debug_counter_add(enum DebugCounter ctr, s64 value);
+s64 debug_counter_get(enum DebugCounter ctr);
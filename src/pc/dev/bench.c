@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "bench.h"
+#include "pc/network/network.h"
+#include "pc/djui/djui_chat_message.h"
+#include "pc/debuglog.h"
+#include "data/dynos_cmap.cpp.h"
+#include "engine/surface_collision.h"
+#include "pc/lua/smlua_utils.h"
+#include "audio/synthesis.h"
+
+#ifdef DEVELOPMENT
+
+struct DevBench {
+    const char* name;
+    const char* description;
+    void (*run)(void);
+};
+
+static struct DevBench sDevBenches[] = {
+    { "collision",    "Replay recent collision queries through lists and packed cells", surface_collision_bench },
+    { "hmap",         "Look up and walk hmap keys in the old and new backends",         hmap_bench },
+    { "packet_codec", "Replay captured packets through each packet codec",             packet_codec_bench },
+    { "players",      "Scan fake lobbies of up to MAX_PLAYERS players",                network_player_bench },
+    { "raycast",      "Cast random rays through the collision grid and surface BVH",    surface_raycast_bench },
+    { "synthesis",    "Mix the playing notes serially and in parallel, then compare",  synthesis_bench },
+    { "sync_objects", "Walk and look up sync objects in the old and new layouts",       sync_object_bench },
+    { "vec",          "Run mod vector math with table and native vectors",              smlua_vec_bench },
+};
+
+#define DEV_BENCH_COUNT (sizeof(sDevBenches) / sizeof(sDevBenches[0]))
+
+void dev_bench_report(const char* fmt, ...) {
+    char message[256] = { 0 };
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(message, 256, fmt, args);
+    va_end(args);
+
+    LOG_INFO("%s", message);
+    djui_chat_message_create(message);
+}
+
+bool dev_bench_run(const char* name) {
+    for (u32 i = 0; i < DEV_BENCH_COUNT; i++) {
+        if (strcmp(sDevBenches[i].name, name) != 0) { continue; }
+        dev_bench_report("Running benchmark: %s", name);
+        sDevBenches[i].run();
+        return true;
+    }
+    return false;
+}
+
+void dev_bench_list(void) {
+    for (u32 i = 0; i < DEV_BENCH_COUNT; i++) {
+        dev_bench_report("%s - %s", sDevBenches[i].name, sDevBenches[i].description);
+    }
+}
+
+#endif
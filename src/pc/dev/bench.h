@@ -0,0 +1,8 @@
+#pragma once
+#include <stdbool.h>
+
+#ifdef DEVELOPMENT
+bool dev_bench_run(const char* name);
+void dev_bench_list(void);
+void dev_bench_report(const char* fmt, ...);
+#endif
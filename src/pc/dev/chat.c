@@ -10,6 +10,7 @@
 #include "pc/lua/utils/smlua_level_utils.h"
 #include "level_table.h"
 #include "game/save_file.h"
+#include "bench.h"
 
 #ifdef DEVELOPMENT
 
@@ -184,6 +185,20 @@ bool exec_dev_chat_command(char* command) {
         return true;
     }
 
+    if (strcmp("/bench", command) == 0) {
+        dev_bench_list();
+        return true;
+    }
+
+    if (str_starts_with("/bench ", command)) {
+        if (!dev_bench_run(&command[7])) {
+            char message[256];
+            snprintf(message, 256, "Unknown benchmark: %s", &command[7]);
+            djui_chat_message_create(message);
+        }
+        return true;
+    }
+
     return false;
 }
 
@@ -191,5 +206,6 @@ void dev_display_chat_commands(void) {
     djui_chat_message_create("/warp [LEVEL] [AREA] [ACT] - Level can be either a numeric value or a shorthand name");
     djui_chat_message_create("/lua [LUA] - Execute Lua code from a string");
     djui_chat_message_create("/luaf [FILENAME] - Execute Lua code from a file");
+    djui_chat_message_create("/bench [NAME] - Run a benchmark, or list them when no name is given");
 }
 #endif
\ No newline at end of file
@@ -18,10 +18,41 @@ static char* sDebugContextNames[] = {
     "LEVEL",
     "HOOK",
     "LIGHTING",
+    "LUA GC",
     "OTHER",
     "MAX",
 };
 
+static char* sDebugCounterNames[] = {
+    "PLR RAW B/S",
+    "PLR TX B/S",
+    "OBJ TX",
+    "OBJ CULLED",
+    "OBJ DEFERRED",
+    "TEX HIT",
+    "TEX MISS",
+    "TEX SHARED",
+    "TEX EVICT",
+    "TEX UPLOAD B",
+    "GFX FLUSH",
+    "GFX DRAW",
+    "GFX MERGED",
+    "GFX VBO B",
+    "COL REBUILT",
+    "COL REUSED",
+    "LUA ALLOC B",
+    "LUA HEAP KB",
+    "AUDIO UNDERRUN",
+    "DJUI GLYPHS",
+    "DJUI DL SAVED",
+    "DYN TEX STALL",
+    "DYN TEX STALL US",
+    "DYN TEX PENDING",
+    "AREA LOAD US",
+    "AREA SURFACES",
+    "MAX",
+};
+
 #endif
 
 struct DjuiCtxEntry {
@@ -32,6 +63,7 @@ struct DjuiCtxEntry {
 struct DjuiCtxDisplay {
     struct DjuiCtxEntry topEntry;
     struct DjuiCtxEntry entries[CTX_MAX];
+    struct DjuiCtxEntry counters[CTR_MAX];
     struct DjuiBase base;
 };
 
@@ -74,6 +106,18 @@ void djui_ctx_display_update(void) {
         snprintf(timing, 32, "%05d", counterMs);
         djui_text_set_text(entry->timing, timing);
     }
+
+    // Draw the non-timing counters.
+    for (s32 i = 0; i < CTR_MAX; i++) {
+        struct DjuiCtxEntry *entry = &sCtxDisplay->counters[i];
+
+        const char *name = sDebugCounterNames[i];
+        djui_text_set_text(entry->name, name);
+
+        char value[32];
+        snprintf(value, 32, "%lld", (long long)debug_counter_get(i));
+        djui_text_set_text(entry->timing, value);
+    }
 #endif
 }
 
@@ -113,7 +157,7 @@ void djui_ctx_display_create(void) {
     struct DjuiCtxDisplay *ctxDisplay = calloc(1, sizeof(struct DjuiCtxDisplay));
     struct DjuiBase *base = &ctxDisplay->base;
     djui_base_init(NULL, base, NULL, djui_ctx_display_on_destroy);
-    djui_base_set_size(base, 220.0f, 39.0f + ((CTX_MAX - 2) * 26.0f));
+    djui_base_set_size(base, 220.0f, 39.0f + ((CTX_MAX - 2) * 26.0f) + (CTR_MAX * 22.0f));
     djui_base_set_color(base, 0, 0, 0, 240);
     djui_base_set_border_color(base, 0, 0, 0, 200);
     djui_base_set_border_width(base, 4);
@@ -130,6 +174,11 @@ void djui_ctx_display_create(void) {
             djui_ctx_display_initialize_entry(base, &ctxDisplay->entries[i], offset);
             offset += 22.0;
         }
+
+        for (s32 i = 0; i < CTR_MAX; i++) {
+            djui_ctx_display_initialize_entry(base, &ctxDisplay->counters[i], offset);
+            offset += 22.0;
+        }
     }
 
     sCtxDisplay = ctxDisplay;
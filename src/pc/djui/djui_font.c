@@ -3,13 +3,29 @@
 #include "djui_hud_utils.h"
 #include "game/segment2.h"
 
+static void djui_font_set_glyph(struct DjuiFontGlyph* glyph, const Texture* texture, u32 w, u32 h, u32 tileX, u32 tileY, u32 tileW, u32 tileH) {
+    glyph->texture = texture;
+    glyph->textureWidth = w;
+    glyph->textureHeight = h;
+    glyph->tileX = tileX;
+    glyph->tileY = tileY;
+    glyph->tileW = tileW;
+    glyph->tileH = tileH;
+}
+
+static void djui_font_render_glyph(bool (*get_glyph)(char*, struct DjuiFontGlyph*), char* c) {
+    struct DjuiFontGlyph glyph;
+    if (!get_glyph(c, &glyph)) { return; }
+    djui_gfx_render_texture_tile(glyph.texture, glyph.textureWidth, glyph.textureHeight, 32, glyph.tileX, glyph.tileY, glyph.tileW, glyph.tileH, false, true);
+}
+
   ///////////////////////////////////
  // font 0 (built-in normal font) //
 ///////////////////////////////////
 
-static void djui_font_normal_render_char(char* c) {
+static bool djui_font_normal_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
 
@@ -18,13 +34,18 @@ static void djui_font_normal_render_char(char* c) {
         u32 tx = index % 64;
         u32 ty = index / 64;
         extern ALIGNED8 const Texture texture_font_jp[];
-        djui_gfx_render_texture_tile(texture_font_jp, 512, 1024, 32, tx * 8, ty * 16, 8, 16, false, true);
+        djui_font_set_glyph(glyph, texture_font_jp, 512, 1024, tx * 8, ty * 16, 8, 16);
     } else {
         u32 tx = index % 32;
         u32 ty = index / 32;
         extern ALIGNED8 const Texture texture_font_normal[];
-        djui_gfx_render_texture_tile(texture_font_normal, 256, 128, 32, tx * 8, ty * 16, 8, 16, false, true);
+        djui_font_set_glyph(glyph, texture_font_normal, 256, 128, tx * 8, ty * 16, 8, 16);
     }
+    return true;
+}
+
+static void djui_font_normal_render_char(char* c) {
+    djui_font_render_glyph(djui_font_normal_get_glyph, c);
 }
 
 static f32 djui_font_normal_char_width(char* c) {
@@ -43,15 +64,16 @@ static const struct DjuiFont sDjuiFontNormal = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_normal_render_char,
     .char_width           = djui_font_normal_char_width,
+    .get_glyph            = djui_font_normal_get_glyph,
 };
 
   ////////////////////////////////
  // font 1 (custom title font) //
 ////////////////////////////////
 
-static void djui_font_title_render_char(char* c) {
+static bool djui_font_title_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
     if ((u8)*c < '!' || (u8)*c > '~' + 1) {
@@ -64,7 +86,12 @@ static void djui_font_title_render_char(char* c) {
     u32 ty = index / 16;
 
     extern ALIGNED8 const Texture texture_font_title[];
-    djui_gfx_render_texture_tile(texture_font_title, 1024, 512, 32, tx * 64, ty * 64, 64, 64, false, true);
+    djui_font_set_glyph(glyph, texture_font_title, 1024, 512, tx * 64, ty * 64, 64, 64);
+    return true;
+}
+
+static void djui_font_title_render_char(char* c) {
+    djui_font_render_glyph(djui_font_title_get_glyph, c);
 }
 
 static f32 djui_font_title_char_width(char* text) {
@@ -85,6 +112,7 @@ static const struct DjuiFont sDjuiFontTitle = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_title_render_char,
     .char_width           = djui_font_title_char_width,
+    .get_glyph            = djui_font_title_get_glyph,
 };
 
   ///////////////////////
@@ -152,9 +180,9 @@ static const struct DjuiFont sDjuiFontHud = {
  // font 3 (DJ's aliased font) //
 ////////////////////////////////
 
-static void djui_font_aliased_render_char(char* c) {
+static bool djui_font_aliased_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
 
@@ -163,13 +191,18 @@ static void djui_font_aliased_render_char(char* c) {
         u32 tx = index % 64;
         u32 ty = index / 64;
         extern ALIGNED8 const Texture texture_font_jp_aliased[];
-        djui_gfx_render_texture_tile(texture_font_jp_aliased, 1024, 2048, 32, tx * 16, ty * 32, 16, 32, false, true);
+        djui_font_set_glyph(glyph, texture_font_jp_aliased, 1024, 2048, tx * 16, ty * 32, 16, 32);
     } else {
         u32 tx = index % 32;
         u32 ty = index / 32;
         extern ALIGNED8 const Texture texture_font_aliased[];
-        djui_gfx_render_texture_tile(texture_font_aliased, 512, 256, 32, tx * 16, ty * 32, 16, 32, false, true);
+        djui_font_set_glyph(glyph, texture_font_aliased, 512, 256, tx * 16, ty * 32, 16, 32);
     }
+    return true;
+}
+
+static void djui_font_aliased_render_char(char* c) {
+    djui_font_render_glyph(djui_font_aliased_get_glyph, c);
 }
 
 static f32 djui_font_aliased_char_width(char* c) {
@@ -188,15 +221,16 @@ static const struct DjuiFont sDjuiFontAliased = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_aliased_render_char,
     .char_width           = djui_font_aliased_char_width,
+    .get_glyph            = djui_font_aliased_get_glyph,
 };
 
   ////////////////////////////////////////
  // font 4/5 (custom hud font/recolor) //
 ////////////////////////////////////////
 
-static void djui_font_custom_hud_render_char(char* c) {
+static bool djui_font_custom_hud_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
 
@@ -204,12 +238,17 @@ static void djui_font_custom_hud_render_char(char* c) {
     u32 ty = index / 16;
 
     extern ALIGNED8 const Texture texture_font_hud[];
-    djui_gfx_render_texture_tile(texture_font_hud, 512, 512, 32, tx * 32, ty * 32, 32, 32, false, true);
+    djui_font_set_glyph(glyph, texture_font_hud, 512, 512, tx * 32, ty * 32, 32, 32);
+    return true;
 }
 
-static void djui_font_custom_hud_recolor_render_char(char* c) {
+static void djui_font_custom_hud_render_char(char* c) {
+    djui_font_render_glyph(djui_font_custom_hud_get_glyph, c);
+}
+
+static bool djui_font_custom_hud_recolor_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
 
@@ -217,7 +256,12 @@ static void djui_font_custom_hud_recolor_render_char(char* c) {
     u32 ty = index / 16;
 
     extern ALIGNED8 const Texture texture_font_hud_recolor[];
-    djui_gfx_render_texture_tile(texture_font_hud_recolor, 512, 512, 32, tx * 32, ty * 32, 32, 32, false, true);
+    djui_font_set_glyph(glyph, texture_font_hud_recolor, 512, 512, tx * 32, ty * 32, 32, 32);
+    return true;
+}
+
+static void djui_font_custom_hud_recolor_render_char(char* c) {
+    djui_font_render_glyph(djui_font_custom_hud_recolor_get_glyph, c);
 }
 
 static f32 djui_font_custom_hud_char_width(char* text) {
@@ -238,6 +282,7 @@ static const struct DjuiFont sDjuiFontCustomHud = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_custom_hud_render_char,
     .char_width           = djui_font_custom_hud_char_width,
+    .get_glyph            = djui_font_custom_hud_get_glyph,
 };
 
 static const struct DjuiFont sDjuiFontCustomHudRecolor = {
@@ -250,15 +295,16 @@ static const struct DjuiFont sDjuiFontCustomHudRecolor = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_custom_hud_recolor_render_char,
     .char_width           = djui_font_custom_hud_char_width,
+    .get_glyph            = djui_font_custom_hud_recolor_get_glyph,
 };
 
   ///////////////////////////
  // font 6 (special font) //
 ///////////////////////////
 
-static void djui_font_special_render_char(char* c) {
+static bool djui_font_special_get_glyph(char* c, struct DjuiFontGlyph* glyph) {
     // replace undisplayable characters
-    if (*c == ' ') { return; }
+    if (*c == ' ') { return false; }
 
     u32 index = djui_unicode_get_sprite_index(c);
     if (index & 0x010000) {
@@ -266,14 +312,18 @@ static void djui_font_special_render_char(char* c) {
         u32 tx = index % 64;
         u32 ty = index / 64;
         extern ALIGNED8 const Texture texture_font_jp[];
-        djui_gfx_render_texture_tile(texture_font_jp, 512, 1024, 32, tx * 8, ty * 16, 8, 16, false, true);
+        djui_font_set_glyph(glyph, texture_font_jp, 512, 1024, tx * 8, ty * 16, 8, 16);
     } else {
         u32 tx = index % 32;
         u32 ty = index / 32;
         extern ALIGNED8 const Texture texture_font_special[];
-        djui_gfx_render_texture_tile(texture_font_special, 256, 128, 32, tx * 8, ty * 16, 8, 16, false, true);
+        djui_font_set_glyph(glyph, texture_font_special, 256, 128, tx * 8, ty * 16, 8, 16);
     }
+    return true;
+}
 
+static void djui_font_special_render_char(char* c) {
+    djui_font_render_glyph(djui_font_special_get_glyph, c);
 }
 
 static f32 djui_font_special_char_width(char* c) {
@@ -292,6 +342,7 @@ static const struct DjuiFont sDjuiFontSpecial = {
     .textBeginDisplayList = NULL,
     .render_char          = djui_font_special_render_char,
     .char_width           = djui_font_special_char_width,
+    .get_glyph            = djui_font_special_get_glyph,
 };
 
   ///////////////
@@ -1,6 +1,16 @@
 #pragma once
 #include "djui.h"
 
+struct DjuiFontGlyph {
+    const Texture* texture;
+    u32 textureWidth;
+    u32 textureHeight;
+    u32 tileX;
+    u32 tileY;
+    u32 tileW;
+    u32 tileH;
+};
+
 struct DjuiFont {
     f32 charWidth;
     f32 charHeight;
@@ -12,6 +22,7 @@ struct DjuiFont {
     const Gfx* textBeginDisplayList;
     void (*render_char)(char*);
     f32 (*char_width)(char*);
+    bool (*get_glyph)(char*, struct DjuiFontGlyph*); // NULL when the font has no atlas
 };
 
 extern const struct DjuiFont* gDjuiFonts[];
@@ -163,6 +163,106 @@ void djui_gfx_render_texture_tile(const u8* texture, u32 w, u32 h, u32 bitSize,
 
 /////////////////////////////////////////////
 
+static u32 sTilesTextureW = 0;
+static u32 sTilesTextureH = 0;
+
+void djui_gfx_render_texture_tiles_begin(const u8* texture, u32 w, u32 h, u32 bitSize, bool filter) {
+    sTilesTextureW = w;
+    sTilesTextureH = h;
+
+    gSPClearGeometryMode(gDisplayListHead++, G_LIGHTING);
+    gDPSetCombineMode(gDisplayListHead++, G_CC_FADEA, G_CC_FADEA);
+    gDPSetRenderMode(gDisplayListHead++, G_RM_XLU_SURF, G_RM_XLU_SURF2);
+    gDPSetTextureFilter(gDisplayListHead++, filter ? G_TF_BILERP : G_TF_POINT);
+
+    gSPTexture(gDisplayListHead++, 0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_ON);
+
+    gDPSetTextureOverrideDjui(gDisplayListHead++, texture, djui_gfx_power_of_two(w), djui_gfx_power_of_two(h), bitSize);
+    gDPLoadTextureBlockWithoutTexture(gDisplayListHead++, NULL, G_IM_FMT_RGBA, G_IM_SIZ_16b, 64, 64, 0, G_TX_CLAMP, G_TX_CLAMP, 0, 0, 0, 0);
+
+    *(gDisplayListHead++) = (Gfx) gsSPExecuteDjui(G_TEXOVERRIDE_DJUI);
+}
+
+static void djui_gfx_tile_vertices(Vtx* vtx, const struct DjuiGfxTile* tile, f32 offsetX, f32 offsetY) {
+    f32 w = sTilesTextureW;
+    f32 h = sTilesTextureH;
+    f32 aspect = tile->tileH ? ((f32)tile->tileW / (f32)tile->tileH) : 1;
+    f32 x = tile->x;
+    f32 y = -tile->y;
+
+    // same quad as djui_gfx_render_texture_tile(), placed without a translation matrix
+    vtx[0] = (Vtx) {{{ x,          y - 1, 0 }, 0, { ( tile->tileX                * 2048.0f) / w + offsetX, ((tile->tileY + tile->tileH) * 2048.0f) / h + offsetY }, { 0xff, 0xff, 0xff, 0xff }}};
+    vtx[2] = (Vtx) {{{ x + aspect, y,     0 }, 0, { ((tile->tileX + tile->tileW) * 2048.0f) / w + offsetX, ( tile->tileY                * 2048.0f) / h + offsetY }, { 0xff, 0xff, 0xff, 0xff }}};
+    vtx[1] = (Vtx) {{{ x + aspect, y - 1, 0 }, 0, { ((tile->tileX + tile->tileW) * 2048.0f) / w + offsetX, ((tile->tileY + tile->tileH) * 2048.0f) / h + offsetY }, { 0xff, 0xff, 0xff, 0xff }}};
+    vtx[3] = (Vtx) {{{ x,          y,     0 }, 0, { ( tile->tileX                * 2048.0f) / w + offsetX, ( tile->tileY                * 2048.0f) / h + offsetY }, { 0xff, 0xff, 0xff, 0xff }}};
+}
+
+static void djui_gfx_tile_set_color(const struct DjuiGfxTile* tile) {
+    if (!tile->setColor) { return; }
+    gDPSetEnvColor(gDisplayListHead++, tile->color.r, tile->color.g, tile->color.b, tile->color.a);
+}
+
+static bool djui_gfx_tile_is_clipped(const struct DjuiGfxTile* tile) {
+    return (tile->clip[0] != 0) || (tile->clip[1] != 0) || (tile->clip[2] != 0) || (tile->clip[3] != 0);
+}
+
+void djui_gfx_render_texture_tiles(const struct DjuiGfxTile* tiles, u32 count, bool font) {
+    f32 offsetX = font ? -1024.0f / (f32)sTilesTextureW : 1;
+    f32 offsetY = font ? -1024.0f / (f32)sTilesTextureH : 1;
+
+    u32 start = 0;
+    while (start < count) {
+        // partially clipped tiles go through G_TEXCLIP_DJUI on their own, it only adjusts the first
+        // quad of a load, and clipping the uvs here before they're rounded would shift the texels
+        if (djui_gfx_tile_is_clipped(&tiles[start])) {
+            const struct DjuiGfxTile* tile = &tiles[start++];
+            Vtx* vtx = alloc_display_list(sizeof(Vtx) * 4);
+            if (!vtx) {
+                LOG_ERROR("Failed to allocate vertices");
+                return;
+            }
+            djui_gfx_tile_vertices(vtx, tile, offsetX, offsetY);
+
+            djui_gfx_tile_set_color(tile);
+            gDPSetTextureClippingDjui(gDisplayListHead++, tile->clip[0], tile->clip[1], tile->clip[2], tile->clip[3]);
+            gSPVertexNonGlobal(gDisplayListHead++, vtx, 4, 0);
+            *(gDisplayListHead++) = (Gfx) gsSPExecuteDjui(G_TEXCLIP_DJUI);
+            gSP2TrianglesDjui(gDisplayListHead++, 0, 1, 2, 0x0, 0, 2, 3, 0x0);
+            continue;
+        }
+
+        // the rsp only holds so many vertices, so load the unclipped tiles a few quads at a time
+        u32 n = 1;
+        while (start + n < count && n < DJUI_GFX_TILES_PER_LOAD && !djui_gfx_tile_is_clipped(&tiles[start + n])) {
+            n++;
+        }
+
+        Vtx* vtx = alloc_display_list(sizeof(Vtx) * 4 * n);
+        if (!vtx) {
+            LOG_ERROR("Failed to allocate vertices");
+            return;
+        }
+        for (u32 i = 0; i < n; i++) {
+            djui_gfx_tile_vertices(&vtx[i * 4], &tiles[start + i], offsetX, offsetY);
+        }
+
+        gSPVertexNonGlobal(gDisplayListHead++, vtx, n * 4, 0);
+        for (u32 i = 0; i < n; i++) {
+            u8 v = i * 4;
+            djui_gfx_tile_set_color(&tiles[start + i]);
+            gSP2TrianglesDjui(gDisplayListHead++, v, v + 1, v + 2, 0x0, v, v + 2, v + 3, 0x0);
+        }
+        start += n;
+    }
+}
+
+void djui_gfx_render_texture_tiles_end(void) {
+    gSPTexture(gDisplayListHead++, 0xFFFF, 0xFFFF, 0, G_TX_RENDERTILE, G_OFF);
+    gDPSetCombineMode(gDisplayListHead++, G_CC_SHADE, G_CC_SHADE);
+}
+
+/////////////////////////////////////////////
+
 void djui_gfx_position_translate(f32* x, f32* y) {
     u32 windowWidth, windowHeight;
     wm_api->get_dimensions(&windowWidth, &windowHeight);
@@ -185,7 +285,7 @@ void djui_gfx_size_translate(f32* size) {
     *size = *size * ((f32)SCREEN_HEIGHT / (f32)windowHeight) * djui_gfx_get_scale();
 }
 
-bool djui_gfx_add_clipping_specific(struct DjuiBase* base, f32 dX, f32 dY, f32 dW, f32 dH) {
+bool djui_gfx_get_clipping(struct DjuiBase* base, f32 dX, f32 dY, f32 dW, f32 dH, u8 clipped[4]) {
     struct DjuiBaseRect* clip = &base->clip;
 
     f32 clipX2 = clip->x + clip->width;
@@ -205,8 +305,21 @@ bool djui_gfx_add_clipping_specific(struct DjuiBase* base, f32 dX, f32 dY, f32 d
     f32 dClipX2 = fmax((dX - (clipX2 - dW)) / dW, 0);
     f32 dClipY2 = fmax((dY - (clipY2 - dH)) / dH, 0);
 
-    if ((dClipX1 != 0) || (dClipY1 != 0) || (dClipX2 != 0) || (dClipY2 != 0)) {
-        gDPSetTextureClippingDjui(gDisplayListHead++, (u8)(dClipX1 * 255), (u8)(dClipY1 * 255), (u8)(dClipX2 * 255), (u8)(dClipY2 * 255));
+    clipped[0] = (u8)(dClipX1 * 255);
+    clipped[1] = (u8)(dClipY1 * 255);
+    clipped[2] = (u8)(dClipX2 * 255);
+    clipped[3] = (u8)(dClipY2 * 255);
+    return false;
+}
+
+bool djui_gfx_add_clipping_specific(struct DjuiBase* base, f32 dX, f32 dY, f32 dW, f32 dH) {
+    u8 clipped[4];
+    if (djui_gfx_get_clipping(base, dX, dY, dW, dH, clipped)) {
+        return true;
+    }
+
+    if ((clipped[0] != 0) || (clipped[1] != 0) || (clipped[2] != 0) || (clipped[3] != 0)) {
+        gDPSetTextureClippingDjui(gDisplayListHead++, clipped[0], clipped[1], clipped[2], clipped[3]);
     }
 
     return false;
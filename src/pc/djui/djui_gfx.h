@@ -5,6 +5,22 @@
 #define DJUI_MTX_PUSH   1
 #define DJUI_MTX_NOPUSH 2
 
+// commands emitted by one djui_gfx_render_texture_tile() call
+#define DJUI_GFX_TILE_COMMANDS 18
+#define DJUI_GFX_TILES_PER_LOAD 16
+
+struct DjuiGfxTile {
+    f32 x;
+    f32 y;
+    u16 tileX;
+    u16 tileY;
+    u16 tileW;
+    u16 tileH;
+    u8 clip[4];
+    bool setColor; // switch the env color to color before drawing the tile
+    struct DjuiColor color;
+};
+
 extern const Gfx dl_djui_simple_rect[];
 extern const Gfx dl_djui_img_begin[];
 extern const Gfx dl_djui_img_end[];
@@ -17,9 +33,14 @@ f32 djui_gfx_get_scale(void);
 void djui_gfx_render_texture(const u8* texture, u32 w, u32 h, u32 bitSize, bool filter);
 void djui_gfx_render_texture_tile(const u8* texture, u32 w, u32 h, u32 bitSize, u32 tileX, u32 tileY, u32 tileW, u32 tileH, bool filter, bool font);
 
+void djui_gfx_render_texture_tiles_begin(const u8* texture, u32 w, u32 h, u32 bitSize, bool filter);
+void djui_gfx_render_texture_tiles(const struct DjuiGfxTile* tiles, u32 count, bool font);
+void djui_gfx_render_texture_tiles_end(void);
+
 void djui_gfx_position_translate(f32* x, f32* y);
 void djui_gfx_scale_translate(f32* width, f32* height);
 void djui_gfx_size_translate(f32* size);
 
+bool djui_gfx_get_clipping(struct DjuiBase* base, f32 dX, f32 dY, f32 dW, f32 dH, u8 clipped[4]);
 bool djui_gfx_add_clipping_specific(struct DjuiBase* base, f32 dX, f32 dY, f32 dW, f32 dH);
 bool djui_gfx_add_clipping(struct DjuiBase* base);
\ No newline at end of file
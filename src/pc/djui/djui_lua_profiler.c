@@ -4,8 +4,11 @@
 #include "pc/pc_main.h"
 #include "pc/mods/mod.h"
 #include "pc/mods/mods.h"
+#include "pc/lua/smlua_profiler.h"
 
 #define MAX_PROFILED_MODS 16
+#define MAX_PROFILED_BEHAVIORS 8
+#define GC_ROW_COUNT 3
 #define REFRESH_RATE 30
 
 struct DjuiPrfCounter {
@@ -23,11 +26,14 @@ struct DjuiPrfEntry {
 
 struct DjuiPrfDisplay {
     struct DjuiPrfEntry entries[MAX_PROFILED_MODS];
+    struct DjuiPrfEntry behaviors[MAX_PROFILED_BEHAVIORS];
+    struct DjuiPrfEntry gc[GC_ROW_COUNT];
     struct DjuiBase base;
 };
 
 static struct DjuiPrfDisplay *sPrfDisplay = NULL;
 static u8 sPrfDisplayCount = 0;
+static u8 sPrfBehaviorCount = 0;
 
 void lua_profiler_start_counter(UNUSED struct Mod *mod) {
     if (!configLuaProfiler || sPrfDisplay == NULL) { return; }
@@ -81,6 +87,102 @@ void djui_lua_profiler_initialize_entry(struct DjuiBase *base, struct DjuiPrfEnt
     entry->timing = timing;
 }
 
+static void djui_lua_profiler_set_name(struct DjuiText *text, const char *source, s32 length) {
+    char name[256];
+    memset(name, 0, 256);
+    memcpy(name, source, MIN(16, length));
+    for (s32 j = 0; j != 16; ++j) {
+        char c = name[j];
+        if (c >= 'a' && c <= 'z') c -= ('a' - 'A');
+        if ((c < '0' || c > '9') && (c < 'A' || c > 'Z')) c = ' ';
+        name[j] = c;
+    }
+    djui_text_set_text(text, name);
+}
+
+static void djui_lua_profiler_set_timing(struct DjuiText *text, f64 seconds) {
+    // The timing is in microseconds.
+    s32 counterMs = (s32)(seconds * 1000000.0);
+    char timing[32];
+    snprintf(timing, 32, "%05d", counterMs);
+    djui_text_set_text(text, timing);
+}
+
+/**
+ * Lists the hooked behaviors that took the most time below the mods.
+ */
+static void djui_lua_profiler_update_behaviors(void) {
+    static struct LuaBehaviorProfile sProfiles[MAX_PROFILED_BEHAVIORS] = { 0 };
+    static u32 sProfileCount = 0;
+
+    if (gGlobalTimer % REFRESH_RATE == 0) {
+        sProfileCount = smlua_pop_behavior_profiles(sProfiles, MAX_PROFILED_BEHAVIORS);
+    }
+
+    u32 modRows = MIN(MAX_PROFILED_MODS, gActiveMods.entryCount);
+    for (u32 i = 0; i < MAX(sPrfBehaviorCount, sProfileCount); i++) {
+        struct DjuiPrfEntry *entry = &sPrfDisplay->behaviors[i];
+        if (i >= sPrfBehaviorCount) {
+            djui_lua_profiler_initialize_entry(&sPrfDisplay->base, entry, 0);
+        }
+        if (i >= sProfileCount) {
+            djui_base_destroy(&entry->name->base);
+            djui_base_destroy(&entry->timing->base);
+            entry->name = NULL;
+            entry->timing = NULL;
+            continue;
+        }
+
+        // keep the rows under the mods, even when mods are added or removed
+        f64 offset = 4.0 + ((modRows + i) * 22.0);
+        djui_base_set_location(&entry->name->base, 0, -entry->name->fontScale / 3.0f + offset);
+        djui_base_set_location(&entry->timing->base, 0, -entry->timing->fontScale / 3.0f + offset);
+
+        const char *bhvName = sProfiles[i].bhvName ? sProfiles[i].bhvName : "";
+        djui_lua_profiler_set_name(entry->name, bhvName, strlen(bhvName));
+        djui_lua_profiler_set_timing(entry->timing, sProfiles[i].time / (f64) REFRESH_RATE);
+    }
+    sPrfBehaviorCount = sProfileCount;
+}
+
+/**
+ * Shows the Lua gc time, allocation rate and heap size at the bottom.
+ */
+static void djui_lua_profiler_update_gc(void) {
+    static const char *sGcNames[GC_ROW_COUNT] = { "GC US", "ALLOC KB", "HEAP KB" };
+    static f64 sGcSums[GC_ROW_COUNT] = { 0 };
+    static f64 sGcDisplay[GC_ROW_COUNT] = { 0 };
+
+    sGcSums[0] += gLuaGcStats.time * 1000000.0;
+    sGcSums[1] += gLuaGcStats.allocated / 1024.0;
+    sGcSums[2] += gLuaGcStats.heap / 1024.0;
+
+    if (gGlobalTimer % REFRESH_RATE == 0) {
+        for (s32 i = 0; i < GC_ROW_COUNT; i++) {
+            sGcDisplay[i] = sGcSums[i] / (f64) REFRESH_RATE;
+            sGcSums[i] = 0;
+        }
+    }
+
+    u32 rows = MIN(MAX_PROFILED_MODS, gActiveMods.entryCount) + sPrfBehaviorCount;
+    for (s32 i = 0; i < GC_ROW_COUNT; i++) {
+        struct DjuiPrfEntry *entry = &sPrfDisplay->gc[i];
+        f64 offset = 4.0 + ((rows + i) * 22.0);
+        if (entry->name == NULL) {
+            djui_lua_profiler_initialize_entry(&sPrfDisplay->base, entry, offset);
+        }
+        djui_base_set_location(&entry->name->base, 0, -entry->name->fontScale / 3.0f + offset);
+        djui_base_set_location(&entry->timing->base, 0, -entry->timing->fontScale / 3.0f + offset);
+
+        djui_lua_profiler_set_name(entry->name, sGcNames[i], strlen(sGcNames[i]));
+        char value[32];
+        snprintf(value, 32, "%05d", (s32)sGcDisplay[i]);
+        djui_text_set_text(entry->timing, value);
+    }
+
+    djui_base_set_size(&sPrfDisplay->base, 290.0f, MAX(MAX_PROFILED_MODS, rows + GC_ROW_COUNT) * 26.0f);
+}
+
 void djui_lua_profiler_update(void) {
     if (!configLuaProfiler || sPrfDisplay == NULL) { return; }
 
@@ -110,24 +212,13 @@ void djui_lua_profiler_update(void) {
             counter->sum = 0;
         }
 
-        char name[256];
-        memset(name, 0, 256);
         const char *modName = gActiveMods.entries[i]->relativePath;
-        memcpy(name, modName, MIN(16, strlen(modName) - (gActiveMods.entries[i]->isDirectory ? 0 : 4)));
-        for (s32 j = 0; j != 16; ++j) {
-            char c = name[j];
-            if (c >= 'a' && c <= 'z') c -= ('a' - 'A');
-            if ((c < '0' || c > '9') && (c < 'A' || c > 'Z')) c = ' ';
-            name[j] = c;
-        }
-        djui_text_set_text(entry->name, name);
-
-        // The timing is in microseconds.
-        s32 counterMs = (s32)(counter->display * 1000000.0);
-        char timing[32];
-        snprintf(timing, 32, "%05d", counterMs);
-        djui_text_set_text(entry->timing, timing);
+        djui_lua_profiler_set_name(entry->name, modName, strlen(modName) - (gActiveMods.entries[i]->isDirectory ? 0 : 4));
+        djui_lua_profiler_set_timing(entry->timing, counter->display);
     }
+
+    djui_lua_profiler_update_behaviors();
+    djui_lua_profiler_update_gc();
 }
 
 void djui_lua_profiler_render(void) {
@@ -153,6 +244,7 @@ void djui_lua_profiler_create(void) {
     djui_base_set_location(base, 0, 300.0f);
 
     sPrfDisplay = prfDisplay;
+    sPrfBehaviorCount = 0;
 }
 
 void djui_lua_profiler_destroy(void) {
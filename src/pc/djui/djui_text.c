@@ -3,6 +3,7 @@
 #include "djui_unicode.h"
 #include "djui_hud_utils.h"
 #include "game/segment2.h"
+#include "pc/debug_context.h"
 
 static u8 sSavedR = 0;
 static u8 sSavedG = 0;
@@ -28,6 +29,7 @@ void djui_text_set_text(struct DjuiText* text, const char* message) {
     u16 messageLen = strlen(message);
     text->message = calloc((messageLen + 1), sizeof(char));
     memcpy(text->message, message, sizeof(char) * (messageLen + 1));
+    text->layout.valid = false;
 }
 
 void djui_text_set_font(struct DjuiText* text, const struct DjuiFont* font) {
@@ -83,7 +85,116 @@ static void djui_text_render_single_char(struct DjuiText* text, char* c) {
     sTextRenderLastY = sTextRenderY;
 }
 
+  //////////////
+ // batching //
+//////////////
+
+#define DJUI_TEXT_BATCH_TILES 256
+
+static struct DjuiGfxTile sTextTiles[DJUI_TEXT_BATCH_TILES];
+static u32 sTextTileCount = 0;
+
+static bool sTextBatching = false;
+static const Texture* sTextBatchTexture = NULL;
+static s64 sTextBatchCommands = 0;
+static s64 sTextLegacyCommands = 0;
+static s64 sTextGlyphs = 0;
+
+static void djui_text_batch_flush(struct DjuiText* text) {
+    if (sTextTileCount == 0) { return; }
+    Gfx* start = gDisplayListHead;
+
+    djui_gfx_render_texture_tiles(sTextTiles, sTextTileCount, true);
+
+    // the last tile drawn may have been a shadow
+    if (text->dropShadow.a > 0) {
+        gDPSetEnvColor(gDisplayListHead++, sSavedR, sSavedG, sSavedB, sSavedA);
+    }
+
+    sTextBatchCommands += gDisplayListHead - start;
+    sTextGlyphs += sTextTileCount;
+    sTextTileCount = 0;
+}
+
+static void djui_text_batch_end(struct DjuiText* text) {
+    djui_text_batch_flush(text);
+    if (sTextBatchTexture == NULL) { return; }
+
+    Gfx* start = gDisplayListHead;
+    djui_gfx_render_texture_tiles_end();
+    sTextBatchCommands += gDisplayListHead - start;
+    sTextBatchTexture = NULL;
+}
+
+static void djui_text_batch_add(struct DjuiText* text, struct DjuiFontGlyph* glyph, const struct DjuiColor* color) {
+    struct DjuiBaseRect* comp = &text->base.comp;
+
+    f32 dX = comp->x + sTextRenderX * text->fontScale;
+    f32 dY = comp->y + sTextRenderY * text->fontScale;
+    f32 dW = text->font->charWidth  * text->fontScale;
+    f32 dH = text->font->charHeight * text->fontScale;
+
+    struct DjuiGfxTile* tile = &sTextTiles[sTextTileCount];
+    if (djui_gfx_get_clipping(&text->base, dX, dY, dW, dH, tile->clip)) {
+        return;
+    }
+
+    tile->x = sTextRenderX;
+    tile->y = sTextRenderY;
+    tile->tileX = glyph->tileX;
+    tile->tileY = glyph->tileY;
+    tile->tileW = glyph->tileW;
+    tile->tileH = glyph->tileH;
+    tile->setColor = (color != NULL);
+    if (color != NULL) { tile->color = *color; }
+    sTextTileCount++;
+
+    // what the glyph would have cost drawn on its own, with its matrix and clipping
+    sTextLegacyCommands += DJUI_GFX_TILE_COMMANDS + 1;
+    if (tile->clip[0] || tile->clip[1] || tile->clip[2] || tile->clip[3]) {
+        sTextLegacyCommands++;
+    }
+}
+
+static void djui_text_batch_char(struct DjuiText* text, char* c) {
+    struct DjuiFontGlyph glyph;
+    if (!text->font->get_glyph(c, &glyph)) { return; }
+
+    // every glyph in a batch has to come from the same atlas
+    if (glyph.texture != sTextBatchTexture) {
+        djui_text_batch_end(text);
+        Gfx* start = gDisplayListHead;
+        djui_gfx_render_texture_tiles_begin(glyph.texture, glyph.textureWidth, glyph.textureHeight, 32, false);
+        sTextBatchCommands += gDisplayListHead - start;
+        sTextBatchTexture = glyph.texture;
+    }
+
+    // room for the glyph and its shadow
+    if (sTextTileCount + 2 > DJUI_TEXT_BATCH_TILES) {
+        djui_text_batch_flush(text);
+    }
+
+    // the shadow goes right before its glyph, so it overlaps the previous glyph like it used to
+    if (text->dropShadow.a > 0) {
+        struct DjuiColor saved = { sSavedR, sSavedG, sSavedB, sSavedA };
+        sTextRenderX += 1.0f / text->fontScale;
+        sTextRenderY += 1.0f / text->fontScale;
+        djui_text_batch_add(text, &glyph, &text->dropShadow);
+        sTextRenderX -= 1.0f / text->fontScale;
+        sTextRenderY -= 1.0f / text->fontScale;
+        djui_text_batch_add(text, &glyph, &saved);
+        sTextLegacyCommands += 2;
+        return;
+    }
+    djui_text_batch_add(text, &glyph, NULL);
+}
+
 static void djui_text_render_char(struct DjuiText* text, char* c) {
+    if (sTextBatching) {
+        djui_text_batch_char(text, c);
+        return;
+    }
+
     if (text->dropShadow.a > 0) {
         // render drop shadow
         sTextRenderX += 1.0f / text->fontScale;
@@ -176,38 +287,56 @@ static void djui_text_read_line(struct DjuiText* text, char** message, f32* line
     *message = c;
 }
 
-int djui_text_count_lines(struct DjuiText* text, u16 maxLines) {
-    struct DjuiBaseRect* comp = &text->base.comp;
+static struct DjuiTextLayout* djui_text_get_layout(struct DjuiText* text, u16 maxLines) {
+    struct DjuiTextLayout* layout = &text->layout;
+    f32 maxLineWidth = text->base.comp.width / ((f32)text->fontScale);
+
+    // char widths depend on the font and theme, so those are part of the key too
+    if (layout->valid
+        && layout->maxLines == maxLines
+        && layout->maxLineWidth == maxLineWidth
+        && layout->font == text->font
+        && layout->theme == configExCoopTheme) {
+        return layout;
+    }
+
+    layout->lineCount = 0;
+    layout->maxLines = maxLines;
+    layout->maxLineWidth = maxLineWidth;
+    layout->font = text->font;
+    layout->theme = configExCoopTheme;
+    layout->valid = true;
+
     char* c = text->message;
-    f32 maxLineWidth = comp->width / ((f32)text->fontScale);
-    u16 lineCount = 0;
     while (*c != '\0') {
-        bool onLastLine = lineCount + 1 >= maxLines;
-        f32 lineWidth;
+        bool onLastLine = layout->lineCount + 1 >= maxLines;
+        if (layout->lineCount >= layout->lineCapacity) {
+            u16 capacity = layout->lineCapacity ? layout->lineCapacity * 2 : 4;
+            struct DjuiTextLine* lines = realloc(layout->lines, sizeof(struct DjuiTextLine) * capacity);
+            if (lines == NULL) { break; }
+            layout->lines = lines;
+            layout->lineCapacity = capacity;
+        }
+
+        struct DjuiTextLine* line = &layout->lines[layout->lineCount++];
         bool ellipses;
-        djui_text_read_line(text, &c, &lineWidth, maxLineWidth, onLastLine, &ellipses);
-        lineCount++;
+        line->start = c - text->message;
+        djui_text_read_line(text, &c, &line->width, maxLineWidth, onLastLine, &ellipses);
+        line->end = c - text->message;
         if (onLastLine) { break; }
     }
-    return lineCount;
+    return layout;
 }
 
-f32 djui_text_find_width(struct DjuiText* text, u16 maxLines) {
-    struct DjuiBaseRect* comp = &text->base.comp;
-    char* c = text->message;
-    f32 maxLineWidth = comp->width / ((f32)text->fontScale);
-    u16 lineCount = 0;
+int djui_text_count_lines(struct DjuiText* text, u16 maxLines) {
+    return djui_text_get_layout(text, maxLines)->lineCount;
+}
 
+f32 djui_text_find_width(struct DjuiText* text, u16 maxLines) {
+    struct DjuiTextLayout* layout = djui_text_get_layout(text, maxLines);
     f32 largestWidth = 0;
-
-    while (*c != '\0') {
-        bool onLastLine = lineCount + 1 >= maxLines;
-        f32 lineWidth;
-        bool ellipses;
-        djui_text_read_line(text, &c, &lineWidth, maxLineWidth, onLastLine, &ellipses);
-        largestWidth = fmax(largestWidth, lineWidth);
-        lineCount++;
-        if (onLastLine) { break; }
+    for (u16 i = 0; i < layout->lineCount; i++) {
+        largestWidth = fmax(largestWidth, layout->lines[i].width);
     }
     return largestWidth * text->fontScale;
 }
@@ -286,6 +415,8 @@ static void djui_text_render_line(struct DjuiText* text, char* c1, char* c2, f32
     // render the line
     for (char* c = c1; c < c2;) {
         if (*c == '\\') {
+            // queued glyphs still need the old color
+            if (sTextBatching) { djui_text_batch_flush(text); }
             c = djui_text_render_line_parse_escape(c, c2);
             continue;
         }
@@ -359,8 +490,8 @@ static bool djui_text_render(struct DjuiBase* base) {
 
     // count lines
     u16 maxLines = comp->height / ((f32)text->font->lineHeight * text->fontScale);
-    f32 maxLineWidth = comp->width / ((f32)text->fontScale);
-    u16 lineCount = djui_text_count_lines(text, maxLines);
+    struct DjuiTextLayout* layout = djui_text_get_layout(text, maxLines);
+    u16 lineCount = layout->lineCount;
 
     // do vertical alignment
     f32 vOffset = 0;
@@ -373,19 +504,21 @@ static bool djui_text_render(struct DjuiBase* base) {
     }
     djui_text_translate(0, vOffset);
 
-    // render lines
-    char* c1 = text->message;
-    char* c2 = c1;
-    f32 lineWidth;
-    u16 lineIndex = 0;
-    bool ellipses = false;
-    while (*c1 != '\0') {
-        bool onLastLine = lineIndex + 1 >= maxLines;
-        djui_text_read_line(text, &c2, &lineWidth, maxLineWidth, onLastLine, &ellipses);
-        djui_text_render_line(text, c1, c2, lineWidth, ellipses);
-        c1 = c2;
-        lineIndex++;
-        if (onLastLine) { break; }
+    // render lines, fonts with an atlas queue their glyphs into batches
+    sTextBatching = (text->font->get_glyph != NULL);
+    sTextBatchCommands = 0;
+    sTextLegacyCommands = 0;
+    sTextGlyphs = 0;
+    for (u16 i = 0; i < lineCount; i++) {
+        struct DjuiTextLine* line = &layout->lines[i];
+        djui_text_render_line(text, text->message + line->start, text->message + line->end, line->width, false);
+    }
+
+    if (sTextBatching) {
+        djui_text_batch_end(text);
+        sTextBatching = false;
+        CTR_ADD(CTR_DJUI_GLYPHS, sTextGlyphs);
+        CTR_ADD(CTR_DJUI_DL_SAVED, sTextLegacyCommands - sTextBatchCommands);
     }
 
     gSPPopMatrix(gDisplayListHead++, G_MTX_MODELVIEW);
@@ -395,6 +528,7 @@ static bool djui_text_render(struct DjuiBase* base) {
 
 static void djui_text_destroy(struct DjuiBase* base) {
     struct DjuiText* text = (struct DjuiText*)base;
+    free(text->layout.lines);
     free(text->message);
     free(text);
 }
@@ -1,6 +1,23 @@
 #pragma once
 #include "djui.h"
 
+struct DjuiTextLine {
+    u32 start;
+    u32 end;
+    f32 width;
+};
+
+struct DjuiTextLayout {
+    struct DjuiTextLine* lines;
+    u16 lineCount;
+    u16 lineCapacity;
+    u16 maxLines;
+    f32 maxLineWidth;
+    const struct DjuiFont* font;
+    u8 theme;
+    bool valid;
+};
+
 struct DjuiText {
     struct DjuiBase base;
     char* message;
@@ -9,6 +26,7 @@ struct DjuiText {
     struct DjuiColor dropShadow;
     enum DjuiHAlign textHAlign;
     enum DjuiVAlign textVAlign;
+    struct DjuiTextLayout layout;
 };
 
 void djui_text_set_text(struct DjuiText* text, const char* message);
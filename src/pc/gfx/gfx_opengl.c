@@ -43,6 +43,17 @@
 
 #define TEX_CACHE_STEP 512
 
+// vertices stream through a ring of segments, each fenced before it gets rewritten
+#define VBO_RING_SIZE (4 * 1024 * 1024)
+#define VBO_RING_SEGMENTS 4
+#define VBO_SEGMENT_SIZE (VBO_RING_SIZE / VBO_RING_SEGMENTS)
+
+#if !defined(USE_GLES) && defined(GL_MAP_PERSISTENT_BIT)
+# define VBO_PERSISTENT_SUPPORTED 1
+#else
+# define VBO_PERSISTENT_SUPPORTED 0
+#endif
+
 struct ShaderProgram {
     uint64_t hash;
     GLuint opengl_program_id;
@@ -69,6 +80,14 @@ static uint8_t shader_program_pool_index = 0;
 static GLuint opengl_vbo;
 static GLuint opengl_vao;
 
+static size_t vbo_pos = 0;
+static size_t vbo_segment = 0;
+static bool vbo_persistent = false;
+#if VBO_PERSISTENT_SUPPORTED
+static uint8_t *vbo_mapped = NULL;
+static GLsync vbo_fences[VBO_RING_SEGMENTS] = { 0 };
+#endif
+
 static int tex_cache_size = 0;
 static int num_textures = 0;
 static struct GLTexture *tex_cache = NULL;
@@ -665,10 +684,52 @@ static void gfx_opengl_set_use_alpha(bool use_alpha) {
     }
 }
 
+static void gfx_opengl_vbo_next_segment(void) {
+#if VBO_PERSISTENT_SUPPORTED
+    if (vbo_persistent) {
+        // the gpu may still be reading the segment we left, and the one we enter
+        vbo_fences[vbo_segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        vbo_segment = (vbo_segment + 1) % VBO_RING_SEGMENTS;
+        if (vbo_fences[vbo_segment]) {
+            glClientWaitSync(vbo_fences[vbo_segment], GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+            glDeleteSync(vbo_fences[vbo_segment]);
+            vbo_fences[vbo_segment] = NULL;
+        }
+        vbo_pos = vbo_segment * VBO_SEGMENT_SIZE;
+        return;
+    }
+#endif
+    vbo_segment = (vbo_segment + 1) % VBO_RING_SEGMENTS;
+    if (vbo_segment == 0) {
+        // orphan the storage so the driver never has to wait on in-flight draws
+        glBufferData(GL_ARRAY_BUFFER, VBO_RING_SIZE, NULL, GL_STREAM_DRAW);
+    }
+    vbo_pos = vbo_segment * VBO_SEGMENT_SIZE;
+}
+
 static void gfx_opengl_draw_triangles(float buf_vbo[], size_t buf_vbo_len, size_t buf_vbo_num_tris) {
     //printf("flushing %d tris\n", buf_vbo_num_tris);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * buf_vbo_len, buf_vbo, GL_STREAM_DRAW);
-    glDrawArrays(GL_TRIANGLES, 0, 3 * buf_vbo_num_tris);
+    size_t size = sizeof(float) * buf_vbo_len;
+    size_t stride = size / (3 * buf_vbo_num_tris);
+
+    // draws start on a whole vertex so the attribute pointers can stay at offset zero
+    size_t pos = (vbo_pos + stride - 1) / stride * stride;
+    if (pos + size > (vbo_segment + 1) * VBO_SEGMENT_SIZE) {
+        gfx_opengl_vbo_next_segment();
+        pos = (vbo_pos + stride - 1) / stride * stride;
+    }
+
+#if VBO_PERSISTENT_SUPPORTED
+    if (vbo_persistent) {
+        memcpy(vbo_mapped + pos, buf_vbo, size);
+    } else
+#endif
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, pos, size, buf_vbo);
+    }
+    vbo_pos = pos + size;
+
+    glDrawArrays(GL_TRIANGLES, pos / stride, 3 * buf_vbo_num_tris);
 }
 
 static inline bool gl_get_version(int *major, int *minor, bool *is_es) {
@@ -709,6 +770,25 @@ static void gfx_opengl_init(void) {
     
     glBindBuffer(GL_ARRAY_BUFFER, opengl_vbo);
 
+#if VBO_PERSISTENT_SUPPORTED
+    // map the vertex ring once when buffer storage is available
+    if (vmajor > 4 || (vmajor == 4 && vminor >= 4)) {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, VBO_RING_SIZE, NULL, flags);
+        vbo_mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, VBO_RING_SIZE, flags);
+        vbo_persistent = (vbo_mapped != NULL);
+        if (!vbo_persistent) {
+            // buffer storage is immutable, start over with a plain buffer
+            glDeleteBuffers(1, &opengl_vbo);
+            glGenBuffers(1, &opengl_vbo);
+            glBindBuffer(GL_ARRAY_BUFFER, opengl_vbo);
+        }
+    }
+#endif
+    if (!vbo_persistent) {
+        glBufferData(GL_ARRAY_BUFFER, VBO_RING_SIZE, NULL, GL_STREAM_DRAW);
+    }
+
     if (vmajor >= 3 && !is_es) {
         glGenVertexArrays(1, &opengl_vao);
         glBindVertexArray(opengl_vao);
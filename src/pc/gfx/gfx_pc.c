@@ -65,10 +65,10 @@
 #define MAX_VERTICES 64
 
 # define MAX_CACHED_TEXTURES 4096 // for preloading purposes
-# define HASH_SHIFT 0
 
 #define HASHMAP_LEN (MAX_CACHED_TEXTURES * 2)
 #define HASH_MASK (HASHMAP_LEN - 1)
+#define HASH_ADDR(_addr) ((size_t)(((uint64_t)(uintptr_t)(_addr) * 0x9E3779B97F4A7C15ULL) >> 32) & HASH_MASK)
 
 u8 gGfxPcResetTex1 = 0;
 
@@ -97,10 +97,21 @@ struct TextureHashmapNode {
     uint32_t texture_id;
     uint8_t cms, cmt;
     bool linear_filter;
+
+    // fields above are mirrored by DynOS, keep new ones below
+    struct TextureHashmapNode *lru_prev, *lru_next;
+    struct TextureHashmapNode *content_next;
+    struct TextureHashmapNode *owner; // set when this address shares another node's upload
+    uint64_t content_hash;
+    uint32_t alias_count;
+    bool content_hashed;
 };
 static struct {
     struct TextureHashmapNode *hashmap[HASHMAP_LEN];
+    struct TextureHashmapNode *content_hashmap[HASHMAP_LEN];
     struct TextureHashmapNode pool[MAX_CACHED_TEXTURES];
+    struct TextureHashmapNode *free_list;
+    struct TextureHashmapNode *lru_head, *lru_tail;
     uint32_t pool_pos;
 } gfx_texture_cache;
 
@@ -230,7 +241,10 @@ static unsigned long get_time(void) {
 }
 
 static void gfx_flush(void) {
+    CTR_ADD(CTR_GFX_FLUSH, 1);
     if (buf_vbo_len > 0) {
+        CTR_ADD(CTR_GFX_DRAW, 1);
+        CTR_ADD(CTR_GFX_VBO_BYTES, sizeof(float) * buf_vbo_len);
         gfx_rapi->draw_triangles(buf_vbo, buf_vbo_len, buf_vbo_num_tris);
         buf_vbo_len = 0;
         buf_vbo_num_tris = 0;
@@ -367,48 +381,196 @@ static struct ColorCombiner *gfx_lookup_or_create_color_combiner(struct CombineM
     return prev_combiner = comb;
 }
 
+static void gfx_texture_cache_lru_unlink(struct TextureHashmapNode *node) {
+    if (node->lru_prev) { node->lru_prev->lru_next = node->lru_next; } else { gfx_texture_cache.lru_head = node->lru_next; }
+    if (node->lru_next) { node->lru_next->lru_prev = node->lru_prev; } else { gfx_texture_cache.lru_tail = node->lru_prev; }
+    node->lru_prev = NULL;
+    node->lru_next = NULL;
+}
+
+static void gfx_texture_cache_lru_push(struct TextureHashmapNode *node) {
+    node->lru_prev = NULL;
+    node->lru_next = gfx_texture_cache.lru_head;
+    if (gfx_texture_cache.lru_head) { gfx_texture_cache.lru_head->lru_prev = node; } else { gfx_texture_cache.lru_tail = node; }
+    gfx_texture_cache.lru_head = node;
+}
+
+static void gfx_texture_cache_touch(struct TextureHashmapNode *node) {
+    if (gfx_texture_cache.lru_head == node) { return; }
+    gfx_texture_cache_lru_unlink(node);
+    gfx_texture_cache_lru_push(node);
+}
+
+static void gfx_texture_cache_unlink_chain(struct TextureHashmapNode **chain, struct TextureHashmapNode *node, bool content) {
+    while (*chain != NULL) {
+        if (*chain == node) {
+            *chain = content ? node->content_next : node->next;
+            return;
+        }
+        chain = content ? &(*chain)->content_next : &(*chain)->next;
+    }
+}
+
+static void gfx_texture_cache_evict(struct TextureHashmapNode *node) {
+    gfx_texture_cache_lru_unlink(node);
+    gfx_texture_cache_unlink_chain(&gfx_texture_cache.hashmap[HASH_ADDR(node->texture_addr)], node, false);
+    if (node->owner) {
+        node->owner->alias_count--;
+    } else if (node->content_hashed) {
+        gfx_texture_cache_unlink_chain(&gfx_texture_cache.content_hashmap[node->content_hash & HASH_MASK], node, true);
+    }
+    for (int i = 0; i < 2; i++) {
+        if (rendering_state.textures[i] == node) { rendering_state.textures[i] = NULL; }
+    }
+    CTR_ADD(CTR_TEX_EVICT, 1);
+}
+
+static struct TextureHashmapNode *gfx_texture_cache_alloc(void) {
+    struct TextureHashmapNode *node = NULL;
+    if (gfx_texture_cache.free_list != NULL) {
+        node = gfx_texture_cache.free_list;
+        gfx_texture_cache.free_list = node->next;
+    } else if (gfx_texture_cache.pool_pos < MAX_CACHED_TEXTURES) {
+        node = &gfx_texture_cache.pool[gfx_texture_cache.pool_pos++];
+        node->texture_id = gfx_rapi->new_texture();
+    } else {
+        // aliases are always older than their owner, so the tail is never shared
+        node = gfx_texture_cache.lru_tail;
+        while (node != NULL && node->alias_count > 0) { node = node->lru_prev; }
+        if (node == NULL) { return NULL; }
+        gfx_texture_cache_evict(node);
+    }
+
+    // the gpu texture stays with the pool slot and gets reused
+    uint32_t texture_id = node->texture_id;
+    memset(node, 0, sizeof(struct TextureHashmapNode));
+    node->texture_id = texture_id;
+    gfx_texture_cache_lru_push(node);
+    return node;
+}
+
 void gfx_texture_cache_clear(void) {
-    memset(&gfx_texture_cache, 0, sizeof(gfx_texture_cache));
+    while (gfx_texture_cache.lru_head != NULL) {
+        struct TextureHashmapNode *node = gfx_texture_cache.lru_head;
+        gfx_texture_cache_lru_unlink(node);
+        node->next = gfx_texture_cache.free_list;
+        gfx_texture_cache.free_list = node;
+    }
+    memset(gfx_texture_cache.hashmap, 0, sizeof(gfx_texture_cache.hashmap));
+    memset(gfx_texture_cache.content_hashmap, 0, sizeof(gfx_texture_cache.content_hashmap));
+    rendering_state.textures[0] = NULL;
+    rendering_state.textures[1] = NULL;
+}
+
+// finds a cached texture without uploading or binding anything, it still counts as a use for the LRU
+static struct TextureHashmapNode *gfx_texture_cache_peek(const void *orig_addr, uint8_t fmt, uint8_t siz) {
+    for (struct TextureHashmapNode *node = gfx_texture_cache.hashmap[HASH_ADDR(orig_addr)]; node != NULL; node = node->next) {
+        if (node->texture_addr == orig_addr && node->fmt == fmt && node->siz == siz) {
+            gfx_texture_cache_touch(node);
+            if (node->owner) {
+                node = node->owner;
+                gfx_texture_cache_touch(node);
+            }
+            return node;
+        }
+    }
+    return NULL;
 }
 
-static bool gfx_texture_cache_lookup(int tile, struct TextureHashmapNode **n, const uint8_t *orig_addr, uint32_t fmt, uint32_t siz) {
-    size_t hash = (uintptr_t)orig_addr;
-#define CMPADDR(x, y) x == y
+void gfx_texture_cache_invalidate(const void *orig_addr) {
+    struct TextureHashmapNode **node = &gfx_texture_cache.hashmap[HASH_ADDR(orig_addr)];
+    while (*node != NULL) {
+        struct TextureHashmapNode *found = *node;
+        if (found->texture_addr != orig_addr) {
+            node = &found->next;
+            continue;
+        }
+        *node = found->next;
+        found->texture_addr = NULL;
+        if (found->owner) {
+            found->owner->alias_count--;
+            gfx_texture_cache_lru_unlink(found);
+            found->next = gfx_texture_cache.free_list;
+            gfx_texture_cache.free_list = found;
+        }
+        // owners stay cached by content for their aliases
+    }
+}
 
-    hash = (hash >> HASH_SHIFT) & HASH_MASK;
+static uint64_t gfx_texture_content_hash(uint64_t hash, const uint8_t *data, size_t size) {
+    // FNV-1a
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    }
+    return hash;
+}
 
-    struct TextureHashmapNode **node = &gfx_texture_cache.hashmap[hash];
-    while (node != NULL && *node != NULL && *node - gfx_texture_cache.pool < (int)gfx_texture_cache.pool_pos) {
-        if (CMPADDR((*node)->texture_addr, orig_addr) && (*node)->fmt == fmt && (*node)->siz == siz) {
-            gfx_rapi->select_texture(tile, (*node)->texture_id);
-            *n = *node;
+bool gfx_texture_cache_lookup(int tile, struct TextureHashmapNode **n, const void *orig_addr, uint8_t fmt, uint8_t siz, const uint8_t *data, size_t size, uint32_t line_size) {
+    struct TextureHashmapNode **node = &gfx_texture_cache.hashmap[HASH_ADDR(orig_addr)];
+    while (*node != NULL) {
+        if ((*node)->texture_addr == orig_addr && (*node)->fmt == fmt && (*node)->siz == siz) {
+            struct TextureHashmapNode *found = *node;
+            gfx_texture_cache_touch(found);
+            if (found->owner) {
+                found = found->owner;
+                gfx_texture_cache_touch(found);
+            }
+            gfx_rapi->select_texture(tile, found->texture_id);
+            *n = found;
+            CTR_ADD(CTR_TEX_HIT, 1);
             return true;
         }
         node = &(*node)->next;
     }
-    if (gfx_texture_cache.pool_pos >= sizeof(gfx_texture_cache.pool) / sizeof(struct TextureHashmapNode)) {
-        // Pool is full. We just invalidate everything and start over.
-        gfx_texture_cache.pool_pos = 0;
-        node = &gfx_texture_cache.hashmap[hash];
-        // puts("Clearing texture cache");
-    }
-    if (!node) { return false; }
-    *node = &gfx_texture_cache.pool[gfx_texture_cache.pool_pos++];
-    if ((*node)->texture_addr == NULL) {
-        (*node)->texture_id = gfx_rapi->new_texture();
+
+    struct TextureHashmapNode *added = gfx_texture_cache_alloc();
+    if (added == NULL) {
+        *n = NULL;
+        return false;
+    }
+    added->texture_addr = orig_addr;
+    added->fmt = fmt;
+    added->siz = siz;
+    added->next = gfx_texture_cache.hashmap[HASH_ADDR(orig_addr)];
+    gfx_texture_cache.hashmap[HASH_ADDR(orig_addr)] = added;
+
+    // identical pixels loaded from another address can share that upload
+    if (configTextureContentHash && data != NULL) {
+        uint64_t hash = 0xCBF29CE484222325ULL;
+        uint8_t header[6] = { fmt, siz, line_size & 0xFF, (line_size >> 8) & 0xFF, (line_size >> 16) & 0xFF, (line_size >> 24) & 0xFF };
+        hash = gfx_texture_content_hash(hash, header, sizeof(header));
+        hash = gfx_texture_content_hash(hash, data, size);
+        if (fmt == G_IM_FMT_CI && rdp.palette != NULL) {
+            hash = gfx_texture_content_hash(hash, rdp.palette, (siz == G_IM_SIZ_4b) ? 16 * 2 : 256 * 2);
+        }
+
+        for (struct TextureHashmapNode *owner = gfx_texture_cache.content_hashmap[hash & HASH_MASK]; owner != NULL; owner = owner->content_next) {
+            if (owner->content_hash != hash || owner->fmt != fmt || owner->siz != siz) { continue; }
+            added->owner = owner;
+            owner->alias_count++;
+            gfx_texture_cache_touch(owner);
+            gfx_rapi->select_texture(tile, owner->texture_id);
+            *n = owner;
+            CTR_ADD(CTR_TEX_SHARED, 1);
+            return true;
+        }
+
+        added->content_hash = hash;
+        added->content_hashed = true;
+        added->content_next = gfx_texture_cache.content_hashmap[hash & HASH_MASK];
+        gfx_texture_cache.content_hashmap[hash & HASH_MASK] = added;
     }
-    gfx_rapi->select_texture(tile, (*node)->texture_id);
+
+    gfx_rapi->select_texture(tile, added->texture_id);
     gfx_rapi->set_sampler_parameters(tile, false, 0, 0);
-    (*node)->cms = 0;
-    (*node)->cmt = 0;
-    (*node)->linear_filter = false;
-    (*node)->next = NULL;
-    (*node)->texture_addr = orig_addr;
-    (*node)->fmt = fmt;
-    (*node)->siz = siz;
-    *n = *node;
+    *n = added;
+    CTR_ADD(CTR_TEX_MISS, 1);
     return false;
-    #undef CMPADDR
+}
+
+static void gfx_upload_texture(const uint8_t *rgba32_buf, uint32_t width, uint32_t height) {
+    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    CTR_ADD(CTR_TEX_UPLOAD_BYTES, width * height * 4);
 }
 
 static void import_texture_rgba32(int tile) {
@@ -416,7 +578,7 @@ static void import_texture_rgba32(int tile) {
     if (!rdp.loaded_texture[tile].addr) { return; }
     uint32_t width = rdp.texture_tile.line_size_bytes / 2;
     uint32_t height = (rdp.loaded_texture[tile].size_bytes / 2) / rdp.texture_tile.line_size_bytes;
-    gfx_rapi->upload_texture(rdp.loaded_texture[tile].addr, width, height);
+    gfx_upload_texture(rdp.loaded_texture[tile].addr, width, height);
 }
 
 static void import_texture_rgba16(int tile) {
@@ -440,7 +602,7 @@ static void import_texture_rgba16(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes / 2;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_ia4(int tile) {
@@ -466,7 +628,7 @@ static void import_texture_ia4(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes * 2;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_ia8(int tile) {
@@ -490,7 +652,7 @@ static void import_texture_ia8(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_ia16(int tile) {
@@ -514,7 +676,7 @@ static void import_texture_ia16(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes / 2;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_i4(int tile) {
@@ -535,7 +697,7 @@ static void import_texture_i4(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes * 2;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_i8(int tile) {
@@ -555,7 +717,7 @@ static void import_texture_i8(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_ci4(int tile) {
@@ -581,7 +743,7 @@ static void import_texture_ci4(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes * 2;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
 }
 
 static void import_texture_ci8(int tile) {
@@ -606,13 +768,25 @@ static void import_texture_ci8(int tile) {
     uint32_t width = rdp.texture_tile.line_size_bytes;
     uint32_t height = rdp.loaded_texture[tile].size_bytes / rdp.texture_tile.line_size_bytes;
 
-    gfx_rapi->upload_texture(rgba32_buf, width, height);
+    gfx_upload_texture(rgba32_buf, width, height);
+}
+
+// what import_texture would bind for this tile if it is already cached, DynOS overrides included
+static struct TextureHashmapNode *peek_texture(int tile) {
+    tile = tile % RDP_TILES;
+    if (!rdp.loaded_texture[tile].addr) { return NULL; }
+    extern s32 dynos_tex_resolve(const void **key, void *ptr);
+    const void *key = NULL;
+    if (dynos_tex_resolve(&key, (void *) rdp.loaded_texture[tile].addr)) {
+        return key ? gfx_texture_cache_peek(key, G_IM_FMT_RGBA, G_IM_SIZ_32b) : NULL;
+    }
+    return gfx_texture_cache_peek(rdp.loaded_texture[tile].addr, rdp.texture_tile.fmt, rdp.texture_tile.siz);
 }
 
 static void import_texture(int tile) {
     tile = tile % RDP_TILES;
-    extern s32 dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi, void **hashmap, void *pool, s32 *poolpos, s32 poolsize);
-    if (dynos_tex_import((void **) &rendering_state.textures[tile], (void *) rdp.loaded_texture[tile].addr, tile, gfx_rapi, (void **) gfx_texture_cache.hashmap, (void *) gfx_texture_cache.pool, (int *) &gfx_texture_cache.pool_pos, MAX_CACHED_TEXTURES)) { return; }
+    extern s32 dynos_tex_import(void **output, void *ptr, s32 tile, void *grapi);
+    if (dynos_tex_import((void **) &rendering_state.textures[tile], (void *) rdp.loaded_texture[tile].addr, tile, gfx_rapi)) { return; }
     uint8_t fmt = rdp.texture_tile.fmt;
     uint8_t siz = rdp.texture_tile.siz;
 
@@ -626,7 +800,7 @@ static void import_texture(int tile) {
         return;
     }
 
-    if (gfx_texture_cache_lookup(tile, &rendering_state.textures[tile], rdp.loaded_texture[tile].addr, fmt, siz)) {
+    if (gfx_texture_cache_lookup(tile, &rendering_state.textures[tile], rdp.loaded_texture[tile].addr, fmt, siz, rdp.loaded_texture[tile].addr, rdp.loaded_texture[tile].size_bytes, rdp.texture_tile.line_size_bytes)) {
         return;
     }
 
@@ -1048,8 +1222,14 @@ static void OPTIMIZE_O3 gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t
     for (int32_t i = 0; i < 2; i++) {
         if (used_textures[i]) {
             if (rdp.textures_changed[i]) {
-                gfx_flush();
-                import_texture(i);
+                // reloading the texture that is already bound doesn't need to split the batch
+                struct TextureHashmapNode *bound = rendering_state.textures[i];
+                if (bound != NULL && bound == peek_texture(i)) {
+                    CTR_ADD(CTR_GFX_MERGED, 1);
+                } else {
+                    gfx_flush();
+                    import_texture(i);
+                }
                 rdp.textures_changed[i] = false;
             }
             bool linear_filter = configFiltering && ((rdp.other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT);
@@ -1886,6 +2066,10 @@ void gfx_run(Gfx *commands) {
     }
     dropped_frame = false;
 
+    // texture overrides may have changed since the last frame, resolve every texture again
+    rendering_state.textures[0] = NULL;
+    rendering_state.textures[1] = NULL;
+
     //double t0 = gfx_wapi->get_time();
     gfx_rapi->start_frame();
     gfx_run_dl(commands);
@@ -32,6 +32,10 @@ void gfx_end_frame(void);
 void gfx_shutdown(void);
 void gfx_pc_precomp_shader(uint32_t rgb1, uint32_t alpha1, uint32_t rgb2, uint32_t alpha2, uint32_t flags);
 
+struct TextureHashmapNode;
+void gfx_texture_cache_invalidate(const void *orig_addr);
+bool gfx_texture_cache_lookup(int tile, struct TextureHashmapNode **n, const void *orig_addr, uint8_t fmt, uint8_t siz, const uint8_t *data, size_t size, uint32_t line_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -3,6 +3,7 @@
 #ifdef LOADING_SCREEN_SUPPORTED
 
 #include <assert.h>
+#include <stdarg.h>
 
 #include "djui/djui.h"
 #include "pc/djui/djui_unicode.h"
@@ -14,13 +15,14 @@
 
 extern ALIGNED8 u8 texture_coopdx_logo[];
 
-struct LoadingSegment gCurrLoadingSegment = { "", 0 };
+struct LoadingSegment gCurrLoadingSegment = { "", 0, "" };
 
 struct LoadingScreen {
     struct DjuiBase base;
     struct DjuiImage* splashImage;
     struct DjuiText* splashText;
     struct DjuiText* loadingDesc;
+    struct DjuiText* loadingStats;
     struct DjuiProgressBar *loadingBar;
 };
 
@@ -32,6 +34,17 @@ void loading_screen_set_segment_text(const char* text) {
     snprintf(gCurrLoadingSegment.str, 256, text);
 }
 
+void loading_screen_add_stat(const char* fmt, ...) {
+    char stat[128] = { 0 };
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(stat, 128, fmt, args);
+    va_end(args);
+
+    size_t length = strlen(gCurrLoadingSegment.stats);
+    snprintf(gCurrLoadingSegment.stats + length, 256 - length, "%s%s", length > 0 ? "\n" : "", stat);
+}
+
 void loading_screen_reset_progress_bar(void) {
     sLoading->loadingBar->smoothValue = 0;
 }
@@ -87,6 +100,10 @@ static bool loading_screen_on_render(struct DjuiBase* base) {
     djui_base_set_location(&sLoading->loadingBar->base, windowWidth / 4, loadingDescY2 + 64);
     djui_base_set_visible(&sLoading->loadingBar->base, gCurrLoadingSegment.percentage > 0 && strlen(gCurrLoadingSegment.str) > 0);
 
+    // timings of the steps that finished
+    djui_text_set_text(sLoading->loadingStats, gCurrLoadingSegment.stats);
+    djui_base_set_location(&sLoading->loadingStats->base, 0, loadingDescY2 + 128);
+
     djui_base_compute(base);
 
     MUTEX_UNLOCK(gLoadingThread);
@@ -146,6 +163,22 @@ static void init_loading_screen(void) {
         load->loadingDesc = text;
     }
 
+    {
+        // startup stats
+        struct DjuiText *text = djui_text_create(base, "");
+        djui_base_set_location_type(&text->base, DJUI_SVT_RELATIVE, DJUI_SVT_ABSOLUTE);
+        djui_base_set_location(&text->base, 0, 0);
+
+        djui_base_set_size_type(&text->base, DJUI_SVT_RELATIVE, DJUI_SVT_ABSOLUTE);
+        djui_base_set_size(&text->base, 1.0f, gDjuiFonts[0]->defaultFontScale * 4.0f);
+        djui_base_set_color(&text->base, 150, 150, 150, 255);
+        djui_text_set_alignment(text, DJUI_HALIGN_CENTER, DJUI_VALIGN_TOP);
+        djui_text_set_font(text, gDjuiFonts[0]);
+        djui_text_set_font_scale(text, gDjuiFonts[0]->defaultFontScale * 0.75f);
+
+        load->loadingStats = text;
+    }
+
     {
         // loading bar
         struct DjuiProgressBar *progressBar = djui_progress_bar_create(base, &gCurrLoadingSegment.percentage, 0.0f, 1.0f, false);
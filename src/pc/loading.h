@@ -13,6 +13,7 @@
 struct LoadingSegment {
     char str[256];
     f32 percentage;
+    char stats[256];
 };
 
 extern struct LoadingSegment gCurrLoadingSegment;
@@ -27,6 +28,7 @@ extern struct LoadingSegment gCurrLoadingSegment;
 extern struct ThreadHandle gLoadingThread;
 
 void loading_screen_set_segment_text(const char* text);
+void loading_screen_add_stat(const char* fmt, ...);
 void loading_screen_reset_progress_bar(void);
 void render_loading_screen(void);
 void loading_screen_reset(void);
@@ -8,8 +8,13 @@
 #include "pc/lua/utils/smlua_model_utils.h"
 #include "pc/lua/utils/smlua_level_utils.h"
 #include "pc/lua/utils/smlua_anim_utils.h"
+#include "pc/lua/utils/smlua_collision_utils.h"
 #include "pc/djui/djui.h"
 #include "pc/fs/fmem.h"
+#include "pc/configfile.h"
+#include "pc/debug_context.h"
+#include "pc/utils/misc.h"
+#include "engine/behavior_script.h"
 
 lua_State* gLuaState = NULL;
 u8 gLuaInitializingScript = 0;
@@ -17,6 +22,22 @@ u8 gSmLuaSuppressErrors = 0;
 struct Mod* gLuaLoadingMod = NULL;
 struct Mod* gLuaActiveMod = NULL;
 struct Mod* gLuaLastHookMod = NULL;
+struct LuaGcStats gLuaGcStats = { 0 };
+
+static lua_Alloc sLuaDefaultAlloc = NULL;
+static u64 sLuaFrameAllocated = 0;
+static u64 sLuaAllocatedSinceCycle = 0;
+static f64 sLuaFrameGcTime = 0;
+
+static void* smlua_alloc(void* ud, void* ptr, size_t osize, size_t nsize) {
+    // when ptr is NULL, osize is the type of the new object, not a size
+    if (nsize > 0 && (ptr == NULL || nsize > osize)) {
+        size_t grown = (ptr == NULL) ? nsize : (nsize - osize);
+        sLuaFrameAllocated += grown;
+        sLuaAllocatedSinceCycle += grown;
+    }
+    return sLuaDefaultAlloc(ud, ptr, osize, nsize);
+}
 
 void smlua_mod_error(void) {
     struct Mod* mod = gLuaActiveMod;
@@ -285,6 +306,14 @@ void smlua_init(void) {
     gLuaState = luaL_newstate();
     lua_State* L = gLuaState;
 
+    // count allocations for the gc telemetry
+    void* allocUd = NULL;
+    sLuaDefaultAlloc = lua_getallocf(L, &allocUd);
+    lua_setallocf(L, smlua_alloc, allocUd);
+    sLuaFrameAllocated = 0;
+    sLuaAllocatedSinceCycle = 0;
+    sLuaFrameGcTime = 0;
+
     // load libraries
     luaopen_base(L);
 #if defined(DEVELOPMENT)
@@ -308,6 +337,10 @@ void smlua_init(void) {
     extern char gSmluaConstants[];
     smlua_exec_str(gSmluaConstants);
 
+    // the player cap is a build option, don't trust the generated value
+    lua_pushinteger(L, MAX_PLAYERS);
+    lua_setglobal(L, "MAX_PLAYERS");
+
     smlua_cobject_init_globals();
     smlua_model_util_initialize();
 
@@ -344,18 +377,44 @@ void smlua_update(void) {
 
     smlua_call_event_hooks(HOOK_UPDATE);
 
-    // Collect our garbage after calling our hooks.
-    // If we don't, Lag can quickly build up from our mods.
-    // Truth is smlua generates so much garbage that the
-    // incremental collection fails to keep up after some time.
-    // So, for now, stop the GC from running during the hooks
-    // and perform a full GC at the end of the frame.
-    // EDIT: That builds up lag over time, so we need to keep
-    // doing incremental garbage collection.
-    // The real fix would be to make smlua produce less
-    // garbage.
-    // lua_gc(L, LUA_GCSTOP, 0);
-    // lua_gc(L, LUA_GCCOLLECT, 0);
+    // Stopping the GC during hooks and doing a full collect at the end of
+    // the frame built up lag over time, so the incremental GC stays on.
+    // smlua_gc_step() pays the GC debt ahead of time with frame time that
+    // would otherwise be spent sleeping, so fewer steps land inside hooks.
+    gLuaGcStats.time = sLuaFrameGcTime;
+    gLuaGcStats.allocated = sLuaFrameAllocated;
+    gLuaGcStats.heap = (u64)lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+    sLuaFrameGcTime = 0;
+    sLuaFrameAllocated = 0;
+
+    CTR_SET(CTR_LUA_ALLOC_B, gLuaGcStats.allocated);
+    CTR_SET(CTR_LUA_HEAP_KB, gLuaGcStats.heap / 1024);
+}
+
+void smlua_gc_step(f64 available) {
+    lua_State* L = gLuaState;
+    if (L == NULL) { return; }
+
+    // nothing to do until the next cycle has garbage to collect
+    if (sLuaAllocatedSinceCycle == 0) { return; }
+
+    f64 budget = MIN(available, configLuaGcBudget / 1000000.0 - sLuaFrameGcTime);
+    if (budget <= 0) { return; }
+
+    CTX_BEGIN(CTX_LUA_GC);
+    f64 start = clock_elapsed_f64();
+    f64 now = start;
+    do {
+        // a zero-sized step is the smallest unit of work, so the budget is checked often
+        if (lua_gc(L, LUA_GCSTEP, 0)) {
+            sLuaAllocatedSinceCycle = 0;
+            now = clock_elapsed_f64();
+            break;
+        }
+        now = clock_elapsed_f64();
+    } while (now - start < budget);
+    sLuaFrameGcTime += now - start;
+    CTX_END(CTX_LUA_GC);
 }
 
 void smlua_shutdown(void) {
@@ -364,14 +423,17 @@ void smlua_shutdown(void) {
     smlua_audio_utils_reset_all();
     audio_custom_shutdown();
     smlua_clear_hooks();
+    behavior_ext_cache_clear();
     smlua_model_util_clear();
     smlua_level_util_reset();
     smlua_anim_util_reset();
+    smlua_collision_util_reset();
     lua_State* L = gLuaState;
     if (L != NULL) {
         lua_close(L);
         gLuaState = NULL;
     }
+    memset(&gLuaGcStats, 0, sizeof(gLuaGcStats));
     gLuaLoadingMod = NULL;
     gLuaActiveMod = NULL;
     gLuaLastHookMod = NULL;
@@ -15,6 +15,7 @@
 #include "smlua_functions_autogen.h"
 #include "smlua_hooks.h"
 #include "smlua_sync_table.h"
+#include "smlua_profiler.h"
 
 #include "pc/debuglog.h"
 #include "pc/djui/djui_console.h"
@@ -49,6 +50,7 @@ void smlua_exec_str(const char* str);
 
 void smlua_init(void);
 void smlua_update(void);
+void smlua_gc_step(f64 available);
 void smlua_shutdown(void);
 
 #endif
@@ -8,6 +8,7 @@
 #include "game/scroll_targets.h"
 #include "game/rendering_graph_node.h"
 #include "audio/external.h"
+#include "engine/surface_load.h"
 #include "object_fields.h"
 #include "pc/djui/djui_hud_utils.h"
 #include "pc/lua/smlua.h"
@@ -369,6 +370,123 @@ struct LuaObjectField* smlua_get_custom_field(lua_State* L, u32 lot, int keyInde
     return &lof;
 }
 
+  //////////
+ // vecs //
+//////////
+
+static u8 smlua_vec_component_count(u16 lot) {
+    switch (lot) {
+        case LOT_VEC2F: return 2;
+        case LOT_VEC3F: return 3;
+        case LOT_VEC4F: return 4;
+        case LOT_VEC3S: return 3;
+        case LOT_VEC4S: return 4;
+        default:        return 0;
+    }
+}
+
+static s32 smlua_vec_component_index(lua_State* L, int index, u8 count) {
+    if (lua_type(L, index) != LUA_TSTRING) { return -1; }
+    const char *key = lua_tostring(L, index);
+    if (key[0] == '\0' || key[1] != '\0') { return -1; }
+    const char *components = "xyzw";
+    for (u8 i = 0; i < count; i++) {
+        if (key[0] == components[i]) { return i; }
+    }
+    return -1;
+}
+
+static f32 smlua_vec_get(const CObject *cobj, u8 i) {
+    if (cobj->lot == LOT_VEC3S || cobj->lot == LOT_VEC4S) {
+        return ((s16*)cobj->pointer)[i];
+    }
+    return ((f32*)cobj->pointer)[i];
+}
+
+static void smlua_vec_set(void *p, u16 lot, u8 i, f32 value) {
+    if (lot == LOT_VEC3S || lot == LOT_VEC4S) {
+        ((s16*)p)[i] = value;
+    } else {
+        ((f32*)p)[i] = value;
+    }
+}
+
+static const CObject *smlua_vec_operand(lua_State* L, int index) {
+    if (lua_type(L, index) != LUA_TUSERDATA) { return NULL; }
+    const CObject *cobj = luaL_testudata(L, index, "CObject");
+    if (cobj == NULL || cobj->freed || smlua_vec_component_count(cobj->lot) == 0) { return NULL; }
+    return cobj;
+}
+
+enum LuaVecOp { LUA_VEC_OP_ADD, LUA_VEC_OP_SUB, LUA_VEC_OP_MUL, LUA_VEC_OP_DIV };
+
+static int smlua_vec_arith(lua_State* L, enum LuaVecOp op) {
+    const CObject *a = smlua_vec_operand(L, 1);
+    const CObject *b = smlua_vec_operand(L, 2);
+    const CObject *vec = a ? a : b;
+    if (vec == NULL) {
+        LOG_LUA_LINE("Tried to do arithmetic on a cobject that is not a vector");
+        return 0;
+    }
+
+    // a vector and a number scale component-wise, two vectors must be the same type
+    f32 scalar = 0;
+    if (a == NULL || b == NULL) {
+        if (op == LUA_VEC_OP_ADD || op == LUA_VEC_OP_SUB || lua_type(L, a ? 2 : 1) != LUA_TNUMBER) {
+            LOG_LUA_LINE("Tried to do arithmetic on a vector and an incompatible value");
+            return 0;
+        }
+        scalar = lua_tonumber(L, a ? 2 : 1);
+    } else if (a->lot != b->lot) {
+        LOG_LUA_LINE("Tried to do arithmetic on vectors of different types");
+        return 0;
+    }
+
+    u8 count = smlua_vec_component_count(vec->lot);
+    f32 result[4];
+    for (u8 i = 0; i < count; i++) {
+        f32 x = a ? smlua_vec_get(a, i) : scalar;
+        f32 y = b ? smlua_vec_get(b, i) : scalar;
+        switch (op) {
+            case LUA_VEC_OP_ADD: result[i] = x + y; break;
+            case LUA_VEC_OP_SUB: result[i] = x - y; break;
+            case LUA_VEC_OP_MUL: result[i] = x * y; break;
+            case LUA_VEC_OP_DIV: result[i] = (y != 0) ? (x / y) : 0; break;
+        }
+    }
+
+    void *p = smlua_push_vec(L, vec->lot);
+    for (u8 i = 0; i < count; i++) {
+        smlua_vec_set(p, vec->lot, i, result[i]);
+    }
+    return 1;
+}
+
+static int smlua__add(lua_State* L) { return smlua_vec_arith(L, LUA_VEC_OP_ADD); }
+static int smlua__sub(lua_State* L) { return smlua_vec_arith(L, LUA_VEC_OP_SUB); }
+static int smlua__mul(lua_State* L) { return smlua_vec_arith(L, LUA_VEC_OP_MUL); }
+static int smlua__div(lua_State* L) { return smlua_vec_arith(L, LUA_VEC_OP_DIV); }
+
+static int smlua__unm(lua_State* L) {
+    const CObject *vec = smlua_vec_operand(L, 1);
+    if (vec == NULL) {
+        LOG_LUA_LINE("Tried to negate a cobject that is not a vector");
+        return 0;
+    }
+
+    u8 count = smlua_vec_component_count(vec->lot);
+    f32 result[4];
+    for (u8 i = 0; i < count; i++) {
+        result[i] = -smlua_vec_get(vec, i);
+    }
+
+    void *p = smlua_push_vec(L, vec->lot);
+    for (u8 i = 0; i < count; i++) {
+        smlua_vec_set(p, vec->lot, i, result[i]);
+    }
+    return 1;
+}
+
   /////////////////////
  // CObject get/set //
 /////////////////////
@@ -472,6 +590,22 @@ static bool smlua_set_field(lua_State* L, u8* p, struct LuaObjectField *data) {
     return false;
 }
 
+/**
+ * Surface fields the collision code keeps a copy of, writes to them have to be
+ * reported through mark_static_surfaces_modified.
+ */
+static bool smlua_is_surface_vertex_field(struct LuaObjectField* data) {
+    return data->valueOffset == offsetof(struct Surface, vertex1)
+        || data->valueOffset == offsetof(struct Surface, vertex2)
+        || data->valueOffset == offsetof(struct Surface, vertex3)
+        || data->valueOffset == offsetof(struct Surface, normal);
+}
+
+static bool smlua_is_surface_height_field(struct LuaObjectField* data) {
+    return data->valueOffset == offsetof(struct Surface, lowerY)
+        || data->valueOffset == offsetof(struct Surface, upperY);
+}
+
 static int smlua__get_field(lua_State* L) {
     LUA_STACK_CHECK_BEGIN_NUM(1);
 
@@ -484,6 +618,20 @@ static int smlua__get_field(lua_State* L) {
         return 0;
     }
 
+    // vector components skip the field lookup
+    u8 vecCount = smlua_vec_component_count(lot);
+    if (vecCount > 0) {
+        s32 component = smlua_vec_component_index(L, 2, vecCount);
+        if (component >= 0) {
+            if (lot == LOT_VEC3S || lot == LOT_VEC4S) {
+                lua_pushinteger(L, ((s16*)cobj->pointer)[component]);
+            } else {
+                lua_pushnumber(L, ((f32*)cobj->pointer)[component]);
+            }
+            return 1;
+        }
+    }
+
     if (lot == LOT_ARRAY) {
         struct LuaObjectField* data = cobj->info;
         if (!data) {
@@ -563,6 +711,12 @@ static int smlua__get_field(lua_State* L) {
             LOG_LUA_LINE("_get_field on unimplemented type '%d', key '%s'", data->valueType, key);
             return 0;
         }
+
+        // the vector remembers its surface so writes through it can be reported
+        if (cobj->lot == LOT_SURFACE && smlua_is_surface_vertex_field(data)) {
+            CObject *vec = lua_touserdata(L, -1);
+            if (vec != NULL) { vec->info = cobj->pointer; }
+        }
     } else {
         smlua_push_object(L, LOT_ARRAY, p, data);
         if (!gSmLuaConvertSuccess) {
@@ -587,6 +741,23 @@ static int smlua__set_field(lua_State* L) {
         return 0;
     }
 
+    // vector components skip the field lookup
+    u8 vecCount = smlua_vec_component_count(lot);
+    if (vecCount > 0) {
+        s32 component = smlua_vec_component_index(L, 2, vecCount);
+        if (component >= 0) {
+            if (lot == LOT_VEC3S || lot == LOT_VEC4S) {
+                s16 value = smlua_to_integer(L, 3);
+                if (gSmLuaConvertSuccess) { ((s16*)cobj->pointer)[component] = value; }
+            } else {
+                f32 value = smlua_to_number(L, 3);
+                if (gSmLuaConvertSuccess) { ((f32*)cobj->pointer)[component] = value; }
+            }
+            if (gSmLuaConvertSuccess && cobj->info != NULL) { mark_static_surfaces_modified(TRUE); }
+            return 1;
+        }
+    }
+
     if (lot == LOT_ARRAY) {
         struct LuaObjectField* data = cobj->info;
         if (!data) {
@@ -646,6 +817,9 @@ static int smlua__set_field(lua_State* L) {
         LOG_LUA_LINE("_set_field failed to retrieve value type '%d', key '%s'", data->valueType, key);
         return 0;
     }
+    if (cobj->lot == LOT_SURFACE && smlua_is_surface_height_field(data)) {
+        mark_static_surfaces_modified(FALSE);
+    }
 
     LUA_STACK_CHECK_END();
     return 1;
@@ -698,6 +872,11 @@ void smlua_cobject_init_globals(void) {
         { "__index",    smlua__get_field },
         { "__newindex", smlua__set_field },
         { "__eq",       smlua__eq },
+        { "__add",      smlua__add },
+        { "__sub",      smlua__sub },
+        { "__mul",      smlua__mul },
+        { "__div",      smlua__div },
+        { "__unm",      smlua__unm },
         { "__metatable", NULL },
         { NULL, NULL }
     };
@@ -4738,7 +4738,7 @@ char gSmluaConstants[] = ""
 "COOP_OBJ_FLAG_INITIALIZED=(1 << 3)\n"
 "SM64COOPDX_VERSION='v1.3'\n"
 "VERSION_TEXT='v'\n"
-"VERSION_NUMBER=40\n"
-"MINOR_VERSION_NUMBER=0\n"
+"VERSION_NUMBER=41\n"
+"MINOR_VERSION_NUMBER=2\n"
 "MAX_VERSION_LENGTH=128\n"
 ;
@@ -1046,6 +1046,42 @@ int smlua_func_cast_graph_node(lua_State* L) {
     return 1;
 }
 
+  //////////
+ // vecs //
+//////////
+
+int smlua_func_vec3f_new(lua_State* L) {
+    if (!smlua_functions_valid_param_range(L, 0, 3)) { return 0; }
+
+    int paramCount = lua_gettop(L);
+    Vec3f v = { 0, 0, 0 };
+    for (int i = 0; i < paramCount; i++) {
+        v[i] = smlua_to_number(L, i + 1);
+        if (!gSmLuaConvertSuccess) { LOG_LUA("vec3f_new: Failed to convert parameter %u", i + 1); return 0; }
+    }
+
+    f32 *dest = smlua_push_vec(L, LOT_VEC3F);
+    vec3f_copy(dest, v);
+
+    return 1;
+}
+
+int smlua_func_vec3s_new(lua_State* L) {
+    if (!smlua_functions_valid_param_range(L, 0, 3)) { return 0; }
+
+    int paramCount = lua_gettop(L);
+    Vec3s v = { 0, 0, 0 };
+    for (int i = 0; i < paramCount; i++) {
+        v[i] = smlua_to_integer(L, i + 1);
+        if (!gSmLuaConvertSuccess) { LOG_LUA("vec3s_new: Failed to convert parameter %u", i + 1); return 0; }
+    }
+
+    s16 *dest = smlua_push_vec(L, LOT_VEC3S);
+    vec3s_copy(dest, v);
+
+    return 1;
+}
+
   /////////////
  // strings //
 /////////////
@@ -1138,5 +1174,7 @@ void smlua_bind_functions(void) {
     smlua_bind_function(L, "collision_find_surface_on_ray", smlua_func_collision_find_surface_on_ray);
     smlua_bind_function(L, "cast_graph_node", smlua_func_cast_graph_node);
     smlua_bind_function(L, "get_uncolored_string", smlua_func_get_uncolored_string);
+    smlua_bind_function(L, "vec3f_new", smlua_func_vec3f_new);
+    smlua_bind_function(L, "vec3s_new", smlua_func_vec3s_new);
     smlua_bind_function(L, "gfx_set_command", smlua_func_gfx_set_command);
 }
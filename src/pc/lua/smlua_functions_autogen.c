@@ -59,28 +59,52 @@
 ///////////////
 
 static void smlua_get_vec2f(Vec2f dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_VEC2F);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Vec2f));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_number_field(index, "x");
     dest[1] = smlua_get_number_field(index, "y");
 }
 
 static void smlua_push_vec2f(Vec2f src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_VEC2F, src, sizeof(Vec2f))) {
+        return;
+    }
     smlua_push_number_field(index, "x", src[0]);
     smlua_push_number_field(index, "y", src[1]);
 }
 
 static void smlua_get_vec3f(Vec3f dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_VEC3F);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Vec3f));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_number_field(index, "x");
     dest[1] = smlua_get_number_field(index, "y");
     dest[2] = smlua_get_number_field(index, "z");
 }
 
 static void smlua_push_vec3f(Vec3f src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_VEC3F, src, sizeof(Vec3f))) {
+        return;
+    }
     smlua_push_number_field(index, "x", src[0]);
     smlua_push_number_field(index, "y", src[1]);
     smlua_push_number_field(index, "z", src[2]);
 }
 
 static void smlua_get_vec4f(Vec4f dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_VEC4F);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Vec4f));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_number_field(index, "x");
     dest[1] = smlua_get_number_field(index, "y");
     dest[2] = smlua_get_number_field(index, "z");
@@ -88,6 +112,9 @@ static void smlua_get_vec4f(Vec4f dest, int index) {
 }
 
 static void smlua_push_vec4f(Vec4f src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_VEC4F, src, sizeof(Vec4f))) {
+        return;
+    }
     smlua_push_number_field(index, "x", src[0]);
     smlua_push_number_field(index, "y", src[1]);
     smlua_push_number_field(index, "z", src[2]);
@@ -95,18 +122,33 @@ static void smlua_push_vec4f(Vec4f src, int index) {
 }
 
 static void smlua_get_vec3s(Vec3s dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_VEC3S);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Vec3s));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_integer_field(index, "x");
     dest[1] = smlua_get_integer_field(index, "y");
     dest[2] = smlua_get_integer_field(index, "z");
 }
 
 static void smlua_push_vec3s(Vec3s src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_VEC3S, src, sizeof(Vec3s))) {
+        return;
+    }
     smlua_push_integer_field(index, "x", src[0]);
     smlua_push_integer_field(index, "y", src[1]);
     smlua_push_integer_field(index, "z", src[2]);
 }
 
 static void smlua_get_vec4s(Vec4s dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_VEC4S);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Vec4s));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_integer_field(index, "x");
     dest[1] = smlua_get_integer_field(index, "y");
     dest[2] = smlua_get_integer_field(index, "z");
@@ -114,6 +156,9 @@ static void smlua_get_vec4s(Vec4s dest, int index) {
 }
 
 static void smlua_push_vec4s(Vec4s src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_VEC4S, src, sizeof(Vec4s))) {
+        return;
+    }
     smlua_push_integer_field(index, "x", src[0]);
     smlua_push_integer_field(index, "y", src[1]);
     smlua_push_integer_field(index, "z", src[2]);
@@ -121,6 +166,12 @@ static void smlua_push_vec4s(Vec4s src, int index) {
 }
 
 static void smlua_get_mat4(Mat4 dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_MAT4);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Mat4));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0][0] = smlua_get_number_field(index, "m00");
     dest[0][1] = smlua_get_number_field(index, "m01");
     dest[0][2] = smlua_get_number_field(index, "m02");
@@ -140,6 +191,9 @@ static void smlua_get_mat4(Mat4 dest, int index) {
 }
 
 static void smlua_push_mat4(Mat4 src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_MAT4, src, sizeof(Mat4))) {
+        return;
+    }
     smlua_push_number_field(index, "m00", src[0][0]);
     smlua_push_number_field(index, "m01", src[0][1]);
     smlua_push_number_field(index, "m02", src[0][2]);
@@ -175,12 +229,21 @@ static void smlua_push_mat4(Mat4 src, int index) {
 }
 
 static void smlua_get_color(Color dest, int index) {
+    void *src = smlua_to_vec(gLuaState, index, LOT_COLOR);
+    if (src != NULL) {
+        memcpy(dest, src, sizeof(Color));
+        gSmLuaConvertSuccess = true;
+        return;
+    }
     dest[0] = smlua_get_integer_field(index, "r");
     dest[1] = smlua_get_integer_field(index, "g");
     dest[2] = smlua_get_integer_field(index, "b");
 }
 
 static void smlua_push_color(Color src, int index) {
+    if (smlua_write_vec(gLuaState, index, LOT_COLOR, src, sizeof(Color))) {
+        return;
+    }
     smlua_push_integer_field(index, "r", src[0]);
     smlua_push_integer_field(index, "g", src[1]);
     smlua_push_integer_field(index, "b", src[2]);
@@ -28831,6 +28894,29 @@ int smlua_func_collision_find_ceil(lua_State* L) {
     return 1;
 }
 
+int smlua_func_collision_find_closest_surface(lua_State* L) {
+    if (L == NULL) { return 0; }
+
+    int top = lua_gettop(L);
+    if (top != 4) {
+        LOG_LUA_LINE("Improper param count for '%s': Expected %u, Received %u", "collision_find_closest_surface", 4, top);
+        return 0;
+    }
+
+    f32 x = smlua_to_number(L, 1);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 1, "collision_find_closest_surface"); return 0; }
+    f32 y = smlua_to_number(L, 2);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 2, "collision_find_closest_surface"); return 0; }
+    f32 z = smlua_to_number(L, 3);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 3, "collision_find_closest_surface"); return 0; }
+    f32 radius = smlua_to_number(L, 4);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 4, "collision_find_closest_surface"); return 0; }
+
+    smlua_push_object(L, LOT_SURFACE, collision_find_closest_surface(x, y, z, radius), NULL);
+
+    return 1;
+}
+
 int smlua_func_collision_find_floor(lua_State* L) {
     if (L == NULL) { return 0; }
 
@@ -28852,6 +28938,21 @@ int smlua_func_collision_find_floor(lua_State* L) {
     return 1;
 }
 
+int smlua_func_collision_get_bvh_enabled(UNUSED lua_State* L) {
+    if (L == NULL) { return 0; }
+
+    int top = lua_gettop(L);
+    if (top != 0) {
+        LOG_LUA_LINE("Improper param count for '%s': Expected %u, Received %u", "collision_get_bvh_enabled", 0, top);
+        return 0;
+    }
+
+
+    lua_pushboolean(L, collision_get_bvh_enabled());
+
+    return 1;
+}
+
 int smlua_func_collision_get_temp_wall_collision_data(UNUSED lua_State* L) {
     if (L == NULL) { return 0; }
 
@@ -28867,6 +28968,23 @@ int smlua_func_collision_get_temp_wall_collision_data(UNUSED lua_State* L) {
     return 1;
 }
 
+int smlua_func_collision_set_bvh_enabled(lua_State* L) {
+    if (L == NULL) { return 0; }
+
+    int top = lua_gettop(L);
+    if (top != 1) {
+        LOG_LUA_LINE("Improper param count for '%s': Expected %u, Received %u", "collision_set_bvh_enabled", 1, top);
+        return 0;
+    }
+
+    bool enabled = smlua_to_boolean(L, 1);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 1, "collision_set_bvh_enabled"); return 0; }
+
+    collision_set_bvh_enabled(enabled);
+
+    return 1;
+}
+
 int smlua_func_get_surface_from_wcd_index(lua_State* L) {
     if (L == NULL) { return 0; }
 
@@ -32896,6 +33014,35 @@ int smlua_func_find_ceil_height(lua_State* L) {
     return 1;
 }
 
+int smlua_func_find_closest_surface_in_sphere(lua_State* L) {
+    if (L == NULL) { return 0; }
+
+    int top = lua_gettop(L);
+    if (top != 3) {
+        LOG_LUA_LINE("Improper param count for '%s': Expected %u, Received %u", "find_closest_surface_in_sphere", 3, top);
+        return 0;
+    }
+
+
+    Vec3f pos;
+    smlua_get_vec3f(pos, 1);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 1, "find_closest_surface_in_sphere"); return 0; }
+    f32 radius = smlua_to_number(L, 2);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 2, "find_closest_surface_in_sphere"); return 0; }
+
+    Vec3f closestPos;
+    smlua_get_vec3f(closestPos, 3);
+    if (!gSmLuaConvertSuccess) { LOG_LUA("Failed to convert parameter %u for function '%s'", 3, "find_closest_surface_in_sphere"); return 0; }
+
+    smlua_push_object(L, LOT_SURFACE, find_closest_surface_in_sphere(pos, radius, closestPos), NULL);
+
+    smlua_push_vec3f(pos, 1);
+
+    smlua_push_vec3f(closestPos, 3);
+
+    return 1;
+}
+
 /*
 int smlua_func_find_floor(lua_State* L) {
     if (L == NULL) { return 0; }
@@ -34829,8 +34976,11 @@ void smlua_bind_functions_autogen(void) {
 
     // smlua_collision_utils.h
     smlua_bind_function(L, "collision_find_ceil", smlua_func_collision_find_ceil);
+    smlua_bind_function(L, "collision_find_closest_surface", smlua_func_collision_find_closest_surface);
     smlua_bind_function(L, "collision_find_floor", smlua_func_collision_find_floor);
+    smlua_bind_function(L, "collision_get_bvh_enabled", smlua_func_collision_get_bvh_enabled);
     smlua_bind_function(L, "collision_get_temp_wall_collision_data", smlua_func_collision_get_temp_wall_collision_data);
+    smlua_bind_function(L, "collision_set_bvh_enabled", smlua_func_collision_set_bvh_enabled);
     smlua_bind_function(L, "get_surface_from_wcd_index", smlua_func_get_surface_from_wcd_index);
     smlua_bind_function(L, "get_water_surface_pseudo_floor", smlua_func_get_water_surface_pseudo_floor);
     smlua_bind_function(L, "smlua_collision_util_find_surface_types", smlua_func_smlua_collision_util_find_surface_types);
@@ -35074,6 +35224,7 @@ void smlua_bind_functions_autogen(void) {
     // surface_collision.h
     //smlua_bind_function(L, "find_ceil", smlua_func_find_ceil); <--- UNIMPLEMENTED
     smlua_bind_function(L, "find_ceil_height", smlua_func_find_ceil_height);
+    smlua_bind_function(L, "find_closest_surface_in_sphere", smlua_func_find_closest_surface_in_sphere);
     //smlua_bind_function(L, "find_floor", smlua_func_find_floor); <--- UNIMPLEMENTED
     smlua_bind_function(L, "find_floor_height", smlua_func_find_floor_height);
     //smlua_bind_function(L, "find_floor_height_and_data", smlua_func_find_floor_height_and_data); <--- UNIMPLEMENTED
@@ -19,6 +19,7 @@
 #include "pc/djui/djui_panel.h"
 #include "pc/configfile.h"
 #include "pc/utils/misc.h"
+#include "data/dynos_cmap.cpp.h"
 
 #include "../mods/mods.h"
 #include "game/print.h"
@@ -37,6 +38,43 @@ struct LuaHookedEvent {
 
 static struct LuaHookedEvent sHookedEvents[HOOK_MAX] = { 0 };
 
+// one bit per event type with at least one subscriber, so unhooked events are skipped with a single test
+static u64 sHookedEventMask = 0;
+
+// registry references to the userdata of gMarioStates[i] and gNetworkPlayers[i], 0 until first pushed
+static int sMarioStateRefs[MAX_PLAYERS] = { 0 };
+static int sNetworkPlayerRefs[MAX_PLAYERS] = { 0 };
+
+static inline bool smlua_is_event_hooked(enum LuaHookedEventType hookType) {
+    return (sHookedEventMask >> hookType) & 1;
+}
+
+static void smlua_push_cached_object(lua_State* L, int* ref, u16 lot, void* p) {
+    if (*ref == 0) {
+        smlua_push_object(L, lot, p, NULL);
+        lua_pushvalue(L, -1);
+        *ref = luaL_ref(L, LUA_REGISTRYINDEX);
+        return;
+    }
+    lua_rawgeti(L, LUA_REGISTRYINDEX, *ref);
+}
+
+static void smlua_push_mario_state(lua_State* L, struct MarioState* m) {
+    if (m->playerIndex >= MAX_PLAYERS) {
+        lua_pushnil(L);
+        return;
+    }
+    smlua_push_cached_object(L, &sMarioStateRefs[m->playerIndex], LOT_MARIOSTATE, &gMarioStates[m->playerIndex]);
+}
+
+static void smlua_push_network_player(lua_State* L, struct NetworkPlayer* np) {
+    if (np->localIndex >= MAX_PLAYERS) {
+        lua_pushnil(L);
+        return;
+    }
+    smlua_push_cached_object(L, &sNetworkPlayerRefs[np->localIndex], LOT_NETWORKPLAYER, &gNetworkPlayers[np->localIndex]);
+}
+
 int smlua_call_hook(lua_State* L, int nargs, int nresults, int errfunc, struct Mod* activeMod) {
     if (!gGameInited) { return 0; } // Don't call hooks while the game is booting
 
@@ -87,13 +125,14 @@ int smlua_hook_event(lua_State* L) {
     hook->reference[hook->count] = ref;
     hook->mod[hook->count] = gLuaActiveMod;
     hook->count++;
+    sHookedEventMask |= (1ULL << hookType);
 
     return 1;
 }
 
 void smlua_call_event_hooks(enum LuaHookedEventType hookType) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -165,7 +204,7 @@ void smlua_call_event_on_hud_render_behind(void (*resetFunc)(void)) {
 
 void smlua_call_event_hooks_bool_param(enum LuaHookedEventType hookType, bool value) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -184,7 +223,7 @@ void smlua_call_event_hooks_bool_param(enum LuaHookedEventType hookType, bool va
 
 void smlua_call_event_hooks_bool_param_ret_bool(enum LuaHookedEventType hookType, bool value, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -211,17 +250,14 @@ void smlua_call_event_hooks_bool_param_ret_bool(enum LuaHookedEventType hookType
 
 void smlua_call_event_hooks_mario_param(enum LuaHookedEventType hookType, struct MarioState* m) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // call the callback
         if (0 != smlua_call_hook(L, 1, 0, 0, hook->mod[i])) {
@@ -233,7 +269,7 @@ void smlua_call_event_hooks_mario_param(enum LuaHookedEventType hookType, struct
 
 void smlua_call_event_hooks_mario_param_ret_bool(enum LuaHookedEventType hookType, struct MarioState* m, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -242,10 +278,7 @@ void smlua_call_event_hooks_mario_param_ret_bool(enum LuaHookedEventType hookTyp
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // call the callback
         if (0 != smlua_call_hook(L, 1, 1, 0, hook->mod[i])) {
@@ -263,23 +296,17 @@ void smlua_call_event_hooks_mario_param_ret_bool(enum LuaHookedEventType hookTyp
 
 void smlua_call_event_hooks_mario_params(enum LuaHookedEventType hookType, struct MarioState* m1, struct MarioState* m2, u32 interaction) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m1->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m1);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m2->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m2);
 
         // push interaction
         lua_pushinteger(L, interaction);
@@ -294,7 +321,7 @@ void smlua_call_event_hooks_mario_params(enum LuaHookedEventType hookType, struc
 
 void smlua_call_event_hooks_mario_params_ret_bool(enum LuaHookedEventType hookType, struct MarioState* m1, struct MarioState* m2, u32 interaction, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -303,16 +330,10 @@ void smlua_call_event_hooks_mario_params_ret_bool(enum LuaHookedEventType hookTy
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m1->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m1);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m2->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m2);
 
         // push interaction
         lua_pushinteger(L, interaction);
@@ -333,17 +354,14 @@ void smlua_call_event_hooks_mario_params_ret_bool(enum LuaHookedEventType hookTy
 
 void smlua_call_event_hooks_interact_params(enum LuaHookedEventType hookType, struct MarioState* m, struct Object* obj, u32 interactType, bool interactValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push object
         smlua_push_object(L, LOT_OBJECT, obj, NULL);
@@ -364,7 +382,7 @@ void smlua_call_event_hooks_interact_params(enum LuaHookedEventType hookType, st
 
 void smlua_call_event_hooks_interact_params_ret_bool(enum LuaHookedEventType hookType, struct MarioState* m, struct Object* obj, u32 interactType, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -373,10 +391,7 @@ void smlua_call_event_hooks_interact_params_ret_bool(enum LuaHookedEventType hoo
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push object
         smlua_push_object(L, LOT_OBJECT, obj, NULL);
@@ -400,17 +415,14 @@ void smlua_call_event_hooks_interact_params_ret_bool(enum LuaHookedEventType hoo
 
 void smlua_call_event_hooks_interact_params_no_ret(enum LuaHookedEventType hookType, struct MarioState* m, struct Object* obj, u32 interactType) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push object
         smlua_push_object(L, LOT_OBJECT, obj, NULL);
@@ -428,7 +440,7 @@ void smlua_call_event_hooks_interact_params_no_ret(enum LuaHookedEventType hookT
 
 void smlua_call_event_hooks_object_param(enum LuaHookedEventType hookType, struct Object* obj) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -447,7 +459,7 @@ void smlua_call_event_hooks_object_param(enum LuaHookedEventType hookType, struc
 
 void smlua_call_event_hooks_object_model_param(enum LuaHookedEventType hookType, struct Object* obj, s32 modelID) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -467,7 +479,7 @@ void smlua_call_event_hooks_object_model_param(enum LuaHookedEventType hookType,
 
 bool smlua_call_event_hooks_ret_int(enum LuaHookedEventType hookType, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return false; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -495,6 +507,7 @@ void smlua_call_event_hooks_ret_bool(enum LuaHookedEventType hookType, bool* ret
     lua_State* L = gLuaState;
     if (L == NULL) { return; }
     *returnValue = true;
+    if (!smlua_is_event_hooked(hookType)) { return; }
 
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
@@ -519,17 +532,14 @@ void smlua_call_event_hooks_ret_bool(enum LuaHookedEventType hookType, bool* ret
 
 void smlua_call_event_hooks_network_player_param(enum LuaHookedEventType hookType, struct NetworkPlayer* np) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gNetworkPlayers");
-        lua_pushinteger(L, np->localIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_network_player(L, np);
 
         // call the callback
         if (0 != smlua_call_hook(L, 1, 0, 0, hook->mod[i])) {
@@ -543,6 +553,7 @@ void smlua_call_event_hooks_set_camera_mode_params(enum LuaHookedEventType hookT
     lua_State* L = gLuaState;
     if (L == NULL) { return; }
     *returnValue = true;
+    if (!smlua_is_event_hooked(hookType)) { return; }
 
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
@@ -574,6 +585,7 @@ void smlua_call_event_hooks_int_params_ret_bool(enum LuaHookedEventType hookType
     lua_State* L = gLuaState;
     if (L == NULL) { return; }
     *returnValue = true;
+    if (!smlua_is_event_hooked(hookType)) { return; }
 
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
@@ -601,7 +613,7 @@ void smlua_call_event_hooks_int_params_ret_bool(enum LuaHookedEventType hookType
 
 void smlua_call_event_hooks_int_params_ret_int(enum LuaHookedEventType hookType, s32 param, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -631,7 +643,7 @@ void smlua_call_event_hooks_int_params_ret_int(enum LuaHookedEventType hookType,
 
 void smlua_call_event_hooks_int_params_ret_string(enum LuaHookedEventType hookType, s32 param, char** returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -661,7 +673,7 @@ void smlua_call_event_hooks_int_params_ret_string(enum LuaHookedEventType hookTy
 
 void smlua_call_event_hooks_value_param(enum LuaHookedEventType hookType, int modIndex, int valueIndex) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         if (hook->mod[i]->index != modIndex) { continue; }
@@ -681,7 +693,7 @@ void smlua_call_event_hooks_value_param(enum LuaHookedEventType hookType, int mo
 
 void smlua_call_event_hooks_on_play_sound(enum LuaHookedEventType hookType, s32 soundBits, f32* pos, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -727,7 +739,7 @@ void smlua_call_event_hooks_on_play_sound(enum LuaHookedEventType hookType, s32
 
 void smlua_call_event_hooks_on_seq_load(enum LuaHookedEventType hookType, u32 player, u32 seqId, s32 loadAsync, s16* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -757,7 +769,7 @@ void smlua_call_event_hooks_on_seq_load(enum LuaHookedEventType hookType, u32 pl
 void smlua_call_event_hooks_use_act_select(enum LuaHookedEventType hookType, int value, bool* foundHook, bool* returnValue) {
     lua_State* L = gLuaState;
     *foundHook = false;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -785,7 +797,7 @@ void smlua_call_event_hooks_use_act_select(enum LuaHookedEventType hookType, int
 
 void smlua_call_event_hooks_on_chat_message(enum LuaHookedEventType hookType, struct MarioState* m, const char* message, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -794,10 +806,7 @@ void smlua_call_event_hooks_on_chat_message(enum LuaHookedEventType hookType, st
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push the string
         lua_pushstring(L, message);
@@ -818,7 +827,7 @@ void smlua_call_event_hooks_on_chat_message(enum LuaHookedEventType hookType, st
 
 bool smlua_call_event_hooks_mario_character_sound_param_ret_int(enum LuaHookedEventType hookType, struct MarioState* m, enum CharacterSound characterSound, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return false; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -827,10 +836,7 @@ bool smlua_call_event_hooks_mario_character_sound_param_ret_int(enum LuaHookedEv
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push character sound
         lua_pushinteger(L, characterSound);
@@ -855,7 +861,7 @@ bool smlua_call_event_hooks_mario_character_sound_param_ret_int(enum LuaHookedEv
 
 void smlua_call_event_hooks_mario_action_params_ret_int(enum LuaHookedEventType hookType, struct MarioState *m, u32 action, u32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -864,10 +870,7 @@ void smlua_call_event_hooks_mario_action_params_ret_int(enum LuaHookedEventType
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push action
         lua_pushinteger(L, action);
@@ -888,7 +891,7 @@ void smlua_call_event_hooks_mario_action_params_ret_int(enum LuaHookedEventType
 
 void smlua_call_event_hooks_mario_param_and_int_ret_bool(enum LuaHookedEventType hookType, struct MarioState* m, s32 param, bool* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -897,10 +900,7 @@ void smlua_call_event_hooks_mario_param_and_int_ret_bool(enum LuaHookedEventType
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push param
         lua_pushinteger(L, param);
@@ -921,7 +921,7 @@ void smlua_call_event_hooks_mario_param_and_int_ret_bool(enum LuaHookedEventType
 
 bool smlua_call_event_hooks_mario_param_and_int_ret_int(enum LuaHookedEventType hookType, struct MarioState* m, s32 param, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return false; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -930,10 +930,7 @@ bool smlua_call_event_hooks_mario_param_and_int_ret_int(enum LuaHookedEventType
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push param
         lua_pushinteger(L, param);
@@ -957,7 +954,7 @@ bool smlua_call_event_hooks_mario_param_and_int_ret_int(enum LuaHookedEventType
 
 bool smlua_call_event_hooks_mario_param_ret_float(enum LuaHookedEventType hookType, struct MarioState* m, f32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return false; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -966,10 +963,7 @@ bool smlua_call_event_hooks_mario_param_ret_float(enum LuaHookedEventType hookTy
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // call the callback
         if (0 != smlua_call_hook(L, 1, 1, 0, hook->mod[i])) {
@@ -991,7 +985,7 @@ bool smlua_call_event_hooks_mario_param_ret_float(enum LuaHookedEventType hookTy
 
 bool smlua_call_event_hooks_mario_param_and_int_and_int_ret_int(enum LuaHookedEventType hookType, struct MarioState* m, s32 param, u32 args, s32* returnValue) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return false; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         s32 prevTop = lua_gettop(L);
@@ -1000,10 +994,7 @@ bool smlua_call_event_hooks_mario_param_and_int_and_int_ret_int(enum LuaHookedEv
         lua_rawgeti(L, LUA_REGISTRYINDEX, hook->reference[i]);
 
         // push mario state
-        lua_getglobal(L, "gMarioStates");
-        lua_pushinteger(L, m->playerIndex);
-        lua_gettable(L, -2);
-        lua_remove(L, -2);
+        smlua_push_mario_state(L, m);
 
         // push param
         lua_pushinteger(L, param);
@@ -1030,7 +1021,7 @@ bool smlua_call_event_hooks_mario_param_and_int_and_int_ret_int(enum LuaHookedEv
 
 void smlua_call_event_hooks_graph_node_object_and_int_param(enum LuaHookedEventType hookType, struct GraphNodeObject* node, s32 param) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -1052,7 +1043,7 @@ void smlua_call_event_hooks_graph_node_object_and_int_param(enum LuaHookedEventT
 
 void smlua_call_event_hooks_graph_node_and_int_param(enum LuaHookedEventType hookType, struct GraphNode* node, s16 matIndex) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -1076,6 +1067,7 @@ const char *smlua_call_event_hooks_int_ret_bool_and_string(enum LuaHookedEventTy
     lua_State* L = gLuaState;
     if (L == NULL) { return NULL; }
     *returnValue = true;
+    if (!smlua_is_event_hooked(hookType)) { return NULL; }
     const char *retString = NULL;
 
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
@@ -1110,7 +1102,7 @@ const char *smlua_call_event_hooks_int_ret_bool_and_string(enum LuaHookedEventTy
 
 void smlua_call_event_hooks_string_param(enum LuaHookedEventType hookType, const char* string) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return; }
+    if (L == NULL || !smlua_is_event_hooked(hookType)) { return; }
     struct LuaHookedEvent* hook = &sHookedEvents[hookType];
     for (int i = 0; i < hook->count; i++) {
         // push the callback onto the stack
@@ -1242,10 +1234,7 @@ bool smlua_call_action_hook(enum LuaActionHookType hookType, struct MarioState*
             lua_rawgeti(L, LUA_REGISTRYINDEX, hook->actionHookRefs[hookType]);
 
             // push mario state
-            lua_getglobal(L, "gMarioStates");
-            lua_pushinteger(L, m->playerIndex);
-            lua_gettable(L, -2);
-            lua_remove(L, -2);
+            smlua_push_mario_state(L, m);
 
             // call the callback
             if (0 != smlua_call_hook(L, 1, 1, 0, hook->mod)) {
@@ -1295,6 +1284,7 @@ struct LuaHookedBehavior {
     bool replace;
     bool luaBehavior;
     struct Mod* mod;
+    f64 profilerTime;
 };
 
 #define MAX_HOOKED_BEHAVIORS 1024
@@ -1302,6 +1292,20 @@ struct LuaHookedBehavior {
 static struct LuaHookedBehavior sHookedBehaviors[MAX_HOOKED_BEHAVIORS] = { 0 };
 static int sHookedBehaviorsCount = 0;
 
+// Behavior script -> first LuaHookedBehavior using it, so objects don't scan every hook
+static void* sHookedBehaviorMap = NULL;
+
+static void smlua_map_hooked_behavior(struct LuaHookedBehavior* hooked) {
+    if (sHookedBehaviorMap == NULL) {
+        sHookedBehaviorMap = hmap_create(true);
+    }
+
+    int64_t key = (int64_t)(uintptr_t)hooked->behavior;
+    if (hmap_get(sHookedBehaviorMap, key) == NULL) {
+        hmap_put(sHookedBehaviorMap, key, hooked);
+    }
+}
+
 enum BehaviorId smlua_get_original_behavior_id(const BehaviorScript* behavior) {
     enum BehaviorId id = get_id_from_behavior(behavior);
     for (int i = 0; i < sHookedBehaviorsCount; i++) {
@@ -1381,6 +1385,8 @@ int smlua_hook_custom_bhv(BehaviorScript *bhvScript, const char *bhvName) {
     hooked->replace = true;
     hooked->luaBehavior = false;
     hooked->mod = gLuaActiveMod;
+    hooked->profilerTime = 0;
+    smlua_map_hooked_behavior(hooked);
 
     sHookedBehaviorsCount++;
 
@@ -1522,6 +1528,8 @@ int smlua_hook_behavior(lua_State* L) {
     hooked->replace = replaceBehavior;
     hooked->luaBehavior = true;
     hooked->mod = gLuaActiveMod;
+    hooked->profilerTime = 0;
+    smlua_map_hooked_behavior(hooked);
 
     sHookedBehaviorsCount++;
 
@@ -1539,55 +1547,80 @@ int smlua_hook_behavior(lua_State* L) {
 
 bool smlua_call_behavior_hook(const BehaviorScript** behavior, struct Object* object, bool before) {
     lua_State* L = gLuaState;
-    if (L == NULL) { return false; }
-    for (int i = 0; i < sHookedBehaviorsCount; i++) {
-        struct LuaHookedBehavior* hooked = &sHookedBehaviors[i];
+    if (L == NULL || sHookedBehaviorMap == NULL) { return false; }
 
-        // find behavior
-        if (object->behavior != hooked->behavior) {
-            continue;
-        }
+    // find behavior
+    struct LuaHookedBehavior* hooked = hmap_get(sHookedBehaviorMap, (int64_t)(uintptr_t)object->behavior);
+    if (hooked == NULL) {
+        return false;
+    }
 
-        // Figure out whether to run before or after
-        if (before && !hooked->replace) {
-            return false;
-        }
-        if (!before && hooked->replace) {
-            return false;
-        }
+    // Figure out whether to run before or after
+    if (before && !hooked->replace) {
+        return false;
+    }
+    if (!before && hooked->replace) {
+        return false;
+    }
 
-        // This behavior doesn't call it's LUA functions in this manner. It actually uses the normal behavior
-        // system.
-        if (!hooked->luaBehavior) {
-            return false;
-        }
+    // This behavior doesn't call it's LUA functions in this manner. It actually uses the normal behavior
+    // system.
+    if (!hooked->luaBehavior) {
+        return false;
+    }
 
-        // retrieve and remember first run
-        bool firstRun = (object->curBhvCommand == hooked->originalBehavior) || (object->curBhvCommand == hooked->behavior);
-        if (firstRun && hooked->replace) { *behavior = &hooked->behavior[1]; }
+    // retrieve and remember first run
+    bool firstRun = (object->curBhvCommand == hooked->originalBehavior) || (object->curBhvCommand == hooked->behavior);
+    if (firstRun && hooked->replace) { *behavior = &hooked->behavior[1]; }
 
-        // get function and null check it
-        int reference = firstRun ? hooked->initReference : hooked->loopReference;
-        if (reference == 0) {
-            return true;
-        }
+    // get function and null check it
+    int reference = firstRun ? hooked->initReference : hooked->loopReference;
+    if (reference == 0) {
+        return true;
+    }
 
-        // push the callback onto the stack
-        lua_rawgeti(L, LUA_REGISTRYINDEX, reference);
+    // push the callback onto the stack
+    lua_rawgeti(L, LUA_REGISTRYINDEX, reference);
 
-        // push object
-        smlua_push_object(L, LOT_OBJECT, object, NULL);
+    // push object
+    smlua_push_object(L, LOT_OBJECT, object, NULL);
 
-        // call the callback
-        if (0 != smlua_call_hook(L, 1, 0, 0, hooked->mod)) {
-            LOG_LUA("Failed to call the behavior callback: %u", hooked->behaviorId);
-            return true;
-        }
+    // call the callback
+    f64 start = configLuaProfiler ? clock_elapsed_f64() : 0;
+    int rc = smlua_call_hook(L, 1, 0, 0, hooked->mod);
+    if (configLuaProfiler) { hooked->profilerTime += clock_elapsed_f64() - start; }
 
-        return hooked->replace;
+    if (0 != rc) {
+        LOG_LUA("Failed to call the behavior callback: %u", hooked->behaviorId);
+        return true;
     }
 
-    return false;
+    return hooked->replace;
+}
+
+u32 smlua_pop_behavior_profiles(struct LuaBehaviorProfile* profiles, u32 maxProfiles) {
+    u32 count = 0;
+
+    for (int i = 0; i < sHookedBehaviorsCount; i++) {
+        struct LuaHookedBehavior* hooked = &sHookedBehaviors[i];
+        f64 time = hooked->profilerTime;
+        hooked->profilerTime = 0;
+        if (time <= 0) { continue; }
+
+        // insert into the list, slowest first
+        u32 j = MIN(count, maxProfiles);
+        for (; j > 0 && profiles[j - 1].time < time; j--) {
+            if (j < maxProfiles) { profiles[j] = profiles[j - 1]; }
+        }
+        if (j < maxProfiles) {
+            profiles[j].bhvName = hooked->bhvName;
+            profiles[j].mod = hooked->mod;
+            profiles[j].time = time;
+            count = MIN(count + 1, maxProfiles);
+        }
+    }
+
+    return count;
 }
 
 
@@ -2350,6 +2383,9 @@ void smlua_clear_hooks(void) {
         }
         hooked->count = 0;
     }
+    sHookedEventMask = 0;
+    memset(sMarioStateRefs, 0, sizeof(sMarioStateRefs));
+    memset(sNetworkPlayerRefs, 0, sizeof(sNetworkPlayerRefs));
 
     for (int i = 0; i < sHookedMarioActionsCount; i++) {
         struct LuaHookedMarioAction* hooked = &sHookedMarioActions[i];
@@ -2412,8 +2448,12 @@ void smlua_clear_hooks(void) {
         hooked->replace = false;
         hooked->luaBehavior = false;
         hooked->mod = NULL;
+        hooked->profilerTime = 0;
     }
     sHookedBehaviorsCount = 0;
+    if (sHookedBehaviorMap != NULL) {
+        hmap_clear(sHookedBehaviorMap);
+    }
     memset(gLuaMarioActionIndex, 0, sizeof(gLuaMarioActionIndex));
 }
 
@@ -5,6 +5,7 @@
 #include "include/behavior_table.h"
 
 #include "smlua.h"
+#include "smlua_profiler.h"
 #include "pc/mods/mod.h"
 
 // forward declare
@@ -0,0 +1,25 @@
+#ifndef SMLUA_PROFILER_H
+#define SMLUA_PROFILER_H
+
+#include "types.h"
+
+struct Mod;
+
+struct LuaGcStats {
+    f64 time;      // seconds spent in scheduled gc steps last frame
+    u64 allocated; // bytes allocated by Lua last frame
+    u64 heap;      // bytes in use by Lua
+};
+
+extern struct LuaGcStats gLuaGcStats;
+
+struct LuaBehaviorProfile {
+    const char* bhvName;
+    struct Mod* mod;
+    f64 time;
+};
+
+// Fills `profiles` with the hooked behaviors that took the most time since the last call, slowest first
+u32 smlua_pop_behavior_profiles(struct LuaBehaviorProfile* profiles, u32 maxProfiles);
+
+#endif
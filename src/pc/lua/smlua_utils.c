@@ -1,6 +1,7 @@
 #include "smlua.h"
 #include "pc/mods/mods.h"
 #include "audio/external.h"
+#include "engine/surface_load.h"
 
 u8 gSmLuaConvertSuccess = false;
 
@@ -419,6 +420,61 @@ CPointer *smlua_push_pointer(lua_State* L, u16 lvt, void* p, void *extraInfo) {
     return cpointer;
 }
 
+static size_t smlua_vec_size(u16 lot) {
+    switch (lot) {
+        case LOT_VEC2F: return sizeof(Vec2f);
+        case LOT_VEC3F: return sizeof(Vec3f);
+        case LOT_VEC4F: return sizeof(Vec4f);
+        case LOT_VEC3S: return sizeof(Vec3s);
+        case LOT_VEC4S: return sizeof(Vec4s);
+        case LOT_MAT4:  return sizeof(Mat4);
+        case LOT_COLOR: return sizeof(Color);
+        default:        return 0;
+    }
+}
+
+void* smlua_push_vec(lua_State* L, u16 lot) {
+    size_t size = smlua_vec_size(lot);
+    if (size == 0) {
+        lua_pushnil(L);
+        return NULL;
+    }
+
+    // The components live right after the CObject, so the userdata owns its storage
+    // and is collected like any other value. It is not added to the object pool.
+    CObject *cobject = lua_newuserdata(L, sizeof(CObject) + size);
+    void *storage = (u8*)cobject + sizeof(CObject);
+    memset(storage, 0, size);
+    cobject->pointer = storage;
+    cobject->lot = lot;
+    cobject->freed = false;
+    cobject->info = NULL;
+    lua_rawgeti(L, LUA_REGISTRYINDEX, gSmLuaCObjectMetatable);
+    lua_setmetatable(L, -2);
+
+    return storage;
+}
+
+void* smlua_to_vec(lua_State* L, int index, u16 lot) {
+    if (lua_type(L, index) != LUA_TUSERDATA) { return NULL; }
+    CObject *cobject = luaL_testudata(L, index, "CObject");
+    if (cobject == NULL || cobject->lot != lot || cobject->freed) { return NULL; }
+    return cobject->pointer;
+}
+
+bool smlua_write_vec(lua_State* L, int index, u16 lot, const void* src, size_t size) {
+    if (lua_type(L, index) != LUA_TUSERDATA) { return false; }
+    CObject *cobject = luaL_testudata(L, index, "CObject");
+    if (cobject == NULL || cobject->lot != lot || cobject->freed) { return false; }
+    if (memcmp(cobject->pointer, src, size) != 0) {
+        memcpy(cobject->pointer, src, size);
+
+        // vectors taken from a surface's vertices carry the surface, see smlua__get_field
+        if (cobject->info != NULL) { mark_static_surfaces_modified(TRUE); }
+    }
+    return true;
+}
+
 void smlua_push_integer_field(int index, const char* name, lua_Integer val) {
     lua_pushinteger(gLuaState, val);
     lua_setfield(gLuaState, index, name);
@@ -794,3 +850,80 @@ void smlua_free(void *ptr) {
     }
     free(ptr);
 }
+
+#ifdef DEVELOPMENT
+
+  ///////////
+ // bench //
+///////////
+
+#include "pc/dev/bench.h"
+#include "pc/utils/misc.h"
+
+#define VEC_BENCH_ITERATIONS 100000
+
+// The same mod-style math loop, once with table vectors and once with native ones.
+static const char* sVecBenchTables =
+    "local a, b, out = { x = 1, y = 2, z = 3 }, { x = 0, y = 0, z = 0 }, { x = 0, y = 0, z = 0 }\n"
+    "for i = 1, %u do\n"
+    "    local vel = { x = i, y = 1, z = -i }\n"
+    "    vec3f_dif(out, vel, a)\n"
+    "    vec3f_cross(b, out, a)\n"
+    "    vec3f_normalize(b)\n"
+    "    a.x = a.x + b.x * 0.5\n"
+    "end\n";
+
+static const char* sVecBenchNative =
+    "local a, b, out = vec3f_new(1, 2, 3), vec3f_new(), vec3f_new()\n"
+    "for i = 1, %u do\n"
+    "    local vel = vec3f_new(i, 1, -i)\n"
+    "    vec3f_dif(out, vel, a)\n"
+    "    vec3f_cross(b, out, a)\n"
+    "    vec3f_normalize(b)\n"
+    "    a.x = a.x + b.x * 0.5\n"
+    "end\n";
+
+static bool smlua_vec_bench_one(const char* source, f64* seconds, f64* kilobytes) {
+    lua_State* L = gLuaState;
+    char chunk[512];
+    snprintf(chunk, 512, source, VEC_BENCH_ITERATIONS);
+    if (luaL_loadstring(L, chunk) != LUA_OK) {
+        lua_pop(L, 1);
+        return false;
+    }
+
+    // keep the collector out of the measurement so the allocation total is exact
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    lua_gc(L, LUA_GCSTOP, 0);
+    f64 before = lua_gc(L, LUA_GCCOUNT, 0) + lua_gc(L, LUA_GCCOUNTB, 0) / 1024.0;
+    f64 start = clock_elapsed_f64();
+    int rc = lua_pcall(L, 0, 0, 0);
+    *seconds = clock_elapsed_f64() - start;
+    *kilobytes = lua_gc(L, LUA_GCCOUNT, 0) + lua_gc(L, LUA_GCCOUNTB, 0) / 1024.0 - before;
+    lua_gc(L, LUA_GCRESTART, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    if (rc != LUA_OK) {
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+void smlua_vec_bench(void) {
+    if (gLuaState == NULL) {
+        dev_bench_report("Lua is not running");
+        return;
+    }
+
+    f64 tableTime, tableKb, nativeTime, nativeKb;
+    if (!smlua_vec_bench_one(sVecBenchTables, &tableTime, &tableKb) || !smlua_vec_bench_one(sVecBenchNative, &nativeTime, &nativeKb)) {
+        dev_bench_report("Failed to run the vector benchmark chunks");
+        return;
+    }
+
+    dev_bench_report("%u iterations: tables %.2fms %.0fKB, native %.2fms %.0fKB",
+        VEC_BENCH_ITERATIONS, tableTime * 1000.0, tableKb, nativeTime * 1000.0, nativeKb);
+}
+
+#endif
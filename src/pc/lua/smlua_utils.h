@@ -1,6 +1,10 @@
 #ifndef SMLUA_UTILS_H
 #define SMLUA_UTILS_H
 
+#include <lua.h>
+#include "types.h"
+#include "smlua_cobject.h"
+
 extern u8 gSmLuaConvertSuccess;
 typedef int LuaFunction;
 struct Packet;
@@ -30,6 +34,9 @@ bool packet_read_lnt(struct Packet* p, struct LSTNetworkType* lnt);
 
 CObject *smlua_push_object(lua_State* L, u16 lot, void* p, void *extraInfo);
 CPointer *smlua_push_pointer(lua_State* L, u16 lvt, void* p, void *extraInfo);
+void* smlua_push_vec(lua_State* L, u16 lot);
+void* smlua_to_vec(lua_State* L, int index, u16 lot);
+bool smlua_write_vec(lua_State* L, int index, u16 lot, const void* src, size_t size);
 void smlua_push_integer_field(int index, const char* name, lua_Integer val);
 void smlua_push_number_field(int index, const char* name, lua_Number val);
 void smlua_push_string_field(int index, const char* name, const char* val);
@@ -56,4 +63,8 @@ void smlua_dump_globals(void);
 void smlua_dump_table(int index);
 void smlua_free(void *ptr);
 
+#ifdef DEVELOPMENT
+void smlua_vec_bench(void);
+#endif
+
 #endif
\ No newline at end of file
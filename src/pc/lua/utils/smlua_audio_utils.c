@@ -6,6 +6,7 @@
 
 #include "types.h"
 #include "seq_ids.h"
+#include "audio/data.h"
 #include "audio/external.h"
 #include "game/camera.h"
 #include "engine/math_util.h"
@@ -51,12 +52,17 @@ static void smlua_audio_utils_reset(struct AudioOverride* override) {
 }
 
 void smlua_audio_utils_reset_all(void) {
+    // the audio thread reads the heap and the override buffers while it synthesizes,
+    // let it finish what was queued before the reset and keep it out until we're done
+    audio_command_flush();
+    MUTEX_LOCK(gAudioThread);
     audio_init();
     for (s32 i = 0; i < MAX_AUDIO_OVERRIDE; i++) {
 #ifdef VERSION_EU
         if (sAudioOverrides[i].enabled) {
             if (i >= SEQ_EVENT_CUTSCENE_LAKITU) {
                 sBackgroundMusicDefaultVolume[i] = 75;
+                MUTEX_UNLOCK(gAudioThread);
                 return;
             }
             sBackgroundMusicDefaultVolume[i] = sBackgroundMusicDefaultVolumeDefault[i];
@@ -66,6 +72,7 @@ void smlua_audio_utils_reset_all(void) {
 #endif
         smlua_audio_utils_reset(&sAudioOverrides[i]);
     }
+    MUTEX_UNLOCK(gAudioThread);
 }
 
 bool smlua_audio_utils_override(u8 sequenceId, s32* bankId, void** seqData) {
@@ -137,12 +144,15 @@ void smlua_audio_utils_replace_sequence(u8 sequenceId, u8 bankId, u8 defaultVolu
         normalize_path(relPath);
         if (str_ends_with(relPath, m64path)) {
             struct AudioOverride* override = &sAudioOverrides[sequenceId];
+            if (override->enabled) { audio_command_flush(); }
+            MUTEX_LOCK(gAudioThread);
             if (override->enabled) { audio_init(); }
             smlua_audio_utils_reset(override);
             LOG_INFO("Loading audio: %s", file->cachedPath);
             override->filename = strdup(file->cachedPath);
             override->enabled = true;
             override->bank = bankId;
+            MUTEX_UNLOCK(gAudioThread);
 #ifdef VERSION_EU
             //sBackgroundMusicDefaultVolume[sequenceId] = defaultVolume;
 #else
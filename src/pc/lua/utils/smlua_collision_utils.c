@@ -179,6 +179,20 @@ struct Surface* collision_find_ceil(f32 x, f32 y, f32 z) {
     return surface;
 }
 
+struct Surface* collision_find_closest_surface(f32 x, f32 y, f32 z, f32 radius) {
+    Vec3f pos = { x, y, z };
+    Vec3f closestPos;
+    return find_closest_surface_in_sphere(pos, radius, closestPos);
+}
+
+bool collision_get_bvh_enabled(void) {
+    return gSurfaceBVHEnabled;
+}
+
+void collision_set_bvh_enabled(bool enabled) {
+    gSurfaceBVHEnabled = enabled;
+}
+
 struct Surface* get_water_surface_pseudo_floor(void) {
     return &gWaterSurfacePseudoFloor;
 }
@@ -237,3 +251,7 @@ void smlua_collision_util_find_surface_types(Collision* data) {
     // Couldn't find anything
     lua_pushnil(L);
 }
+
+void smlua_collision_util_reset(void) {
+    gSurfaceBVHEnabled = TRUE;
+}
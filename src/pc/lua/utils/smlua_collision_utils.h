@@ -121,6 +121,15 @@ struct Surface* collision_find_floor(f32 x, f32 y, f32 z);
 /* |description|Finds a potential ceiling at the given `x`, `y`, and `z` values|descriptionEnd| */
 struct Surface* collision_find_ceil(f32 x, f32 y, f32 z);
 
+/* |description|Finds the surface closest to the given `x`, `y`, and `z` values within `radius`|descriptionEnd| */
+struct Surface* collision_find_closest_surface(f32 x, f32 y, f32 z, f32 radius);
+
+/* |description|Gets whether raycasts and sphere queries use the level's surface BVH|descriptionEnd| */
+bool collision_get_bvh_enabled(void);
+
+/* |description|Sets whether raycasts and sphere queries use the level's surface BVH instead of walking the collision grid|descriptionEnd| */
+void collision_set_bvh_enabled(bool enabled);
+
 struct Surface* get_water_surface_pseudo_floor(void);
 
 /* |description|Gets the `Collision` with `name`|descriptionEnd| */
@@ -141,4 +150,6 @@ Collision *smlua_collision_util_get_level_collision(u32 level, u16 area);
 /* |description|Gets a table of the surface types from `data`|descriptionEnd| */
 void smlua_collision_util_find_surface_types(Collision* data);
 
+void smlua_collision_util_reset(void);
+
 #endif
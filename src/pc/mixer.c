@@ -1,5 +1,6 @@
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ultra64.h>
 #include "macros.h"
@@ -27,7 +28,7 @@
 #define ROUND_UP_16(v) (((v) + 15) & ~15)
 #define ROUND_UP_8(v) (((v) + 7) & ~7)
 
-static struct {
+struct MixerDmem {
     uint16_t in;
     uint16_t out;
     uint16_t nbytes;
@@ -51,7 +52,21 @@ static struct {
         int16_t as_s16[2512 / sizeof(int16_t)];
         uint8_t as_u8[2512];
     } buf;
-} rspa;
+};
+
+static struct MixerDmem rspa;
+
+struct MixerDmem *mixer_dmem_create(void) {
+    return calloc(1, sizeof(struct MixerDmem));
+}
+
+void mixer_dmem_copy(struct MixerDmem *dst, struct MixerDmem *src) {
+    memcpy(dst ? dst : &rspa, src ? src : &rspa, sizeof(struct MixerDmem));
+}
+
+// The commands the synthesis workers run are built on the dmem passed in, then
+// wrapped once for the shared one and once for a worker's
+#define MIXER_INLINE inline __attribute__((always_inline))
 
 static int16_t resample_table[64][4] = {
     {0x0c39, 0x66ad, 0x0d46, 0xffdf}, {0x0b39, 0x6696, 0x0e5f, 0xffd8},
@@ -106,24 +121,26 @@ static inline int32_t clamp32(int64_t v) {
     return (int32_t)v;
 }
 
-void aClearBufferImpl(uint16_t addr, int nbytes) {
+#define rspa (*dmem)
+
+static MIXER_INLINE void aClearBufferOn(struct MixerDmem *dmem, uint16_t addr, int nbytes) {
     nbytes = ROUND_UP_16(nbytes);
     memset(rspa.buf.as_u8 + addr, 0, nbytes);
 }
 
-void aLoadBufferImpl(const void *source_addr) {
+static MIXER_INLINE void aLoadBufferOn(struct MixerDmem *dmem, const void *source_addr) {
     memcpy(rspa.buf.as_u8 + rspa.in, source_addr, ROUND_UP_8(rspa.nbytes));
 }
 
-void aSaveBufferImpl(int16_t *dest_addr) {
+static MIXER_INLINE void aSaveBufferOn(struct MixerDmem *dmem, int16_t *dest_addr) {
     memcpy(dest_addr, rspa.buf.as_s16 + rspa.out / sizeof(int16_t), ROUND_UP_8(rspa.nbytes));
 }
 
-void aLoadADPCMImpl(int num_entries_times_16, const int16_t *book_source_addr) {
+static MIXER_INLINE void aLoadADPCMOn(struct MixerDmem *dmem, int num_entries_times_16, const int16_t *book_source_addr) {
     memcpy(rspa.adpcm_table, book_source_addr, num_entries_times_16);
 }
 
-void aSetBufferImpl(uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) {
+static MIXER_INLINE void aSetBufferOn(struct MixerDmem *dmem, uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) {
     if (flags & A_AUX) {
         rspa.dry_right = in;
         rspa.wet_left = out;
@@ -135,6 +152,8 @@ void aSetBufferImpl(uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) {
     }
 }
 
+#undef rspa
+
 void aSetVolumeImpl(uint8_t flags, int16_t v, int16_t t, int16_t r) {
     if (flags & A_AUX) {
         rspa.vol_dry = v;
@@ -198,16 +217,18 @@ void aInterleaveImpl(uint16_t left, uint16_t right) {
     }
 }
 
-void aDMEMMoveImpl(uint16_t in_addr, uint16_t out_addr, int nbytes) {
+#define rspa (*dmem)
+
+static MIXER_INLINE void aDMEMMoveOn(struct MixerDmem *dmem, uint16_t in_addr, uint16_t out_addr, int nbytes) {
     nbytes = ROUND_UP_16(nbytes);
     memmove(rspa.buf.as_u8 + out_addr, rspa.buf.as_u8 + in_addr, nbytes);
 }
 
-void aSetLoopImpl(ADPCM_STATE *adpcm_loop_state) {
+static MIXER_INLINE void aSetLoopOn(struct MixerDmem *dmem, ADPCM_STATE *adpcm_loop_state) {
     rspa.adpcm_loop_state = adpcm_loop_state;
 }
 
-void OPTIMIZE_O3 aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
+static MIXER_INLINE void OPTIMIZE_O3 aADPCMdecOn(struct MixerDmem *dmem, uint8_t flags, ADPCM_STATE state) {
 #if HAS_SSE41
     const __m128i tblrev = _mm_setr_epi8(12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1, -1, -1);
     const __m128i pos0 = _mm_set_epi8(3, -1, 3, -1, 2, -1, 2, -1, 1, -1, 1, -1, 0, -1, 0, -1);
@@ -375,7 +396,7 @@ void OPTIMIZE_O3 aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) {
     memcpy(state, out - 16, 16 * sizeof(int16_t));
 }
 
-void OPTIMIZE_O3 aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
+static MIXER_INLINE void OPTIMIZE_O3 aResampleOn(struct MixerDmem *dmem, uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) {
     int16_t tmp[16];
     int16_t *in_initial = rspa.buf.as_s16 + rspa.in / sizeof(int16_t);
     int16_t *in = in_initial;
@@ -527,6 +548,7 @@ void OPTIMIZE_O3 aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE sta
     memcpy(state + 8, in, 8 * sizeof(int16_t));
 }
 
+#undef rspa
 
 void OPTIMIZE_O3 aEnvMixerImpl(uint8_t flags, ENVMIX_STATE state) {
     int16_t *in = rspa.buf.as_s16 + rspa.in / sizeof(int16_t);
@@ -870,3 +892,23 @@ void aMixImpl(int16_t gain, uint16_t in_addr, uint16_t out_addr) {
         nbytes -= 16 * sizeof(int16_t);
     }
 }
+
+// the mixing thread runs on the shared dmem, the synthesis workers pass their own
+void aClearBufferImpl(uint16_t addr, int nbytes) { aClearBufferOn(&rspa, addr, nbytes); }
+void aClearBufferDmem(struct MixerDmem *dmem, uint16_t addr, int nbytes) { aClearBufferOn(dmem, addr, nbytes); }
+void aLoadBufferImpl(const void *source_addr) { aLoadBufferOn(&rspa, source_addr); }
+void aLoadBufferDmem(struct MixerDmem *dmem, const void *source_addr) { aLoadBufferOn(dmem, source_addr); }
+void aSaveBufferImpl(int16_t *dest_addr) { aSaveBufferOn(&rspa, dest_addr); }
+void aSaveBufferDmem(struct MixerDmem *dmem, int16_t *dest_addr) { aSaveBufferOn(dmem, dest_addr); }
+void aLoadADPCMImpl(int num_entries_times_16, const int16_t *book_source_addr) { aLoadADPCMOn(&rspa, num_entries_times_16, book_source_addr); }
+void aLoadADPCMDmem(struct MixerDmem *dmem, int num_entries_times_16, const int16_t *book_source_addr) { aLoadADPCMOn(dmem, num_entries_times_16, book_source_addr); }
+void aSetBufferImpl(uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) { aSetBufferOn(&rspa, flags, in, out, nbytes); }
+void aSetBufferDmem(struct MixerDmem *dmem, uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes) { aSetBufferOn(dmem, flags, in, out, nbytes); }
+void aDMEMMoveImpl(uint16_t in_addr, uint16_t out_addr, int nbytes) { aDMEMMoveOn(&rspa, in_addr, out_addr, nbytes); }
+void aDMEMMoveDmem(struct MixerDmem *dmem, uint16_t in_addr, uint16_t out_addr, int nbytes) { aDMEMMoveOn(dmem, in_addr, out_addr, nbytes); }
+void aSetLoopImpl(ADPCM_STATE *adpcm_loop_state) { aSetLoopOn(&rspa, adpcm_loop_state); }
+void aSetLoopDmem(struct MixerDmem *dmem, ADPCM_STATE *adpcm_loop_state) { aSetLoopOn(dmem, adpcm_loop_state); }
+void OPTIMIZE_O3 aADPCMdecImpl(uint8_t flags, ADPCM_STATE state) { aADPCMdecOn(&rspa, flags, state); }
+void OPTIMIZE_O3 aADPCMdecDmem(struct MixerDmem *dmem, uint8_t flags, ADPCM_STATE state) { aADPCMdecOn(dmem, flags, state); }
+void OPTIMIZE_O3 aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) { aResampleOn(&rspa, flags, pitch, state); }
+void OPTIMIZE_O3 aResampleDmem(struct MixerDmem *dmem, uint8_t flags, uint16_t pitch, RESAMPLE_STATE state) { aResampleOn(dmem, flags, pitch, state); }
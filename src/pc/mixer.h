@@ -34,19 +34,39 @@ void aResampleImpl(uint8_t flags, uint16_t pitch, RESAMPLE_STATE state);
 void aEnvMixerImpl(uint8_t flags, ENVMIX_STATE state);
 void aMixImpl(int16_t gain, uint16_t in_addr, uint16_t out_addr);
 
+// Private dmem for mixing on another thread, NULL refers to the shared one
+struct MixerDmem;
+struct MixerDmem *mixer_dmem_create(void);
+void mixer_dmem_copy(struct MixerDmem *dst, struct MixerDmem *src);
+
+void aClearBufferDmem(struct MixerDmem *dmem, uint16_t addr, int nbytes);
+void aLoadBufferDmem(struct MixerDmem *dmem, const void *source_addr);
+void aSaveBufferDmem(struct MixerDmem *dmem, int16_t *dest_addr);
+void aLoadADPCMDmem(struct MixerDmem *dmem, int num_entries_times_16, const int16_t *book_source_addr);
+void aSetBufferDmem(struct MixerDmem *dmem, uint8_t flags, uint16_t in, uint16_t out, uint16_t nbytes);
+void aDMEMMoveDmem(struct MixerDmem *dmem, uint16_t in_addr, uint16_t out_addr, int nbytes);
+void aSetLoopDmem(struct MixerDmem *dmem, ADPCM_STATE *adpcm_loop_state);
+void aADPCMdecDmem(struct MixerDmem *dmem, uint8_t flags, ADPCM_STATE state);
+void aResampleDmem(struct MixerDmem *dmem, uint8_t flags, uint16_t pitch, RESAMPLE_STATE state);
+
+// The dmem the commands with a Dmem variant run on. Code that can run on a
+// worker redefines it, NULL is resolved at compile time to the shared one.
+#define MIXER_DMEM NULL
+#define MIXER_CMD(cmd, ...) ((MIXER_DMEM) == NULL ? cmd##Impl(__VA_ARGS__) : cmd##Dmem((MIXER_DMEM), __VA_ARGS__))
+
 #define aSegment(pkt, s, b) do { } while(0)
-#define aClearBuffer(pkt, d, c) aClearBufferImpl(d, c)
-#define aLoadBuffer(pkt, s) aLoadBufferImpl(s)
-#define aSaveBuffer(pkt, s) aSaveBufferImpl(s)
-#define aLoadADPCM(pkt, c, d) aLoadADPCMImpl(c, d)
-#define aSetBuffer(pkt, f, i, o, c) aSetBufferImpl(f, i, o, c)
+#define aClearBuffer(pkt, d, c) MIXER_CMD(aClearBuffer, d, c)
+#define aLoadBuffer(pkt, s) MIXER_CMD(aLoadBuffer, s)
+#define aSaveBuffer(pkt, s) MIXER_CMD(aSaveBuffer, s)
+#define aLoadADPCM(pkt, c, d) MIXER_CMD(aLoadADPCM, c, d)
+#define aSetBuffer(pkt, f, i, o, c) MIXER_CMD(aSetBuffer, f, i, o, c)
 #define aSetVolume(pkt, f, v, t, r) aSetVolumeImpl(f, v, t, r)
 #define aSetVolume32(pkt, f, v, tr) aSetVolume(pkt, f, v, (int16_t)((tr) >> 16), (int16_t)(tr))
 #define aInterleave(pkt, l, r) aInterleaveImpl(l, r)
-#define aDMEMMove(pkt, i, o, c) aDMEMMoveImpl(i, o, c)
-#define aSetLoop(pkt, a) aSetLoopImpl(a)
-#define aADPCMdec(pkt, f, s) aADPCMdecImpl(f, s)
-#define aResample(pkt, f, p, s) aResampleImpl(f, p, s)
+#define aDMEMMove(pkt, i, o, c) MIXER_CMD(aDMEMMove, i, o, c)
+#define aSetLoop(pkt, a) MIXER_CMD(aSetLoop, a)
+#define aADPCMdec(pkt, f, s) MIXER_CMD(aADPCMdec, f, s)
+#define aResample(pkt, f, p, s) MIXER_CMD(aResample, f, p, s)
 #define aEnvMixer(pkt, f, s) aEnvMixerImpl(f, s)
 #define aMix(pkt, f, g, i, o) aMixImpl(g, i, o)
 
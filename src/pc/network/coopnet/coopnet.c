@@ -212,12 +212,12 @@ void ns_coopnet_update(void) {
             if (sReconnecting) {
                 LOG_INFO("Update lobby");
                 coopnet_populate_description();
-                coopnet_lobby_update(sLocalLobbyId, GAME_NAME, get_version(), configPlayerName, mode, sCoopNetDescription);
+                coopnet_lobby_update(sLocalLobbyId, GAME_NAME, get_version_online(), configPlayerName, mode, sCoopNetDescription);
             } else {
                 LOG_INFO("Create lobby");
                 snprintf(gCoopNetPassword, 64, "%s", configPassword);
                 coopnet_populate_description();
-                coopnet_lobby_create(GAME_NAME, get_version(), configPlayerName, mode, (uint16_t)configAmountOfPlayers, gCoopNetPassword, sCoopNetDescription);
+                coopnet_lobby_create(GAME_NAME, get_version_online(), configPlayerName, mode, (uint16_t)configAmountOfPlayers, gCoopNetPassword, sCoopNetDescription);
             }
         } else if (sNetworkType == NT_CLIENT) {
             LOG_INFO("Join lobby");
@@ -309,6 +309,7 @@ struct NetworkSystem gNetworkSystemCoopNet = {
     .dup_addr         = ns_coopnet_dup_addr,
     .match_addr       = ns_coopnet_match_addr,
     .update           = ns_coopnet_update,
+    .flush            = NULL,
     .send             = ns_coopnet_network_send,
     .get_lobby_id     = ns_coopnet_get_lobby_id,
     .get_lobby_secret = ns_coopnet_get_lobby_secret,
@@ -0,0 +1,128 @@
+#include "types.h"
+#include "network.h"
+#include "interest_grid.h"
+#include "object_fields.h"
+#include "engine/extended_bounds.h"
+#include "game/level_update.h"
+#include "game/obj_behaviors.h"
+#include "pc/configfile.h"
+#include "pc/debug_context.h"
+#include "pc/utils/misc.h"
+
+// coarse XZ grid of where every remote player in the local area is
+#define INTEREST_CELL_SIZE 2048
+#define INTEREST_CELLS (2 * LEVEL_BOUNDARY_MAX / INTEREST_CELL_SIZE)
+
+static NetworkPlayerMask sCells[INTEREST_CELLS][INTEREST_CELLS] = { 0 };
+static s16 sPeerCell[MAX_PLAYERS][2] = { 0 };
+static NetworkPlayerMask sPeersInGrid = 0;
+static s32 sPeerBudget[MAX_PLAYERS] = { 0 };
+
+static s16 interest_grid_cell(f32 coord) {
+    s32 cell = (s32)((coord + LEVEL_BOUNDARY_MAX) / INTEREST_CELL_SIZE);
+    if (cell < 0) { return 0; }
+    if (cell >= INTEREST_CELLS) { return INTEREST_CELLS - 1; }
+    return cell;
+}
+
+void interest_grid_update(void) {
+    // only clear the cells that were used last tick
+    NetworkPlayerMask mask = sPeersInGrid;
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
+        sCells[sPeerCell[i][0]][sPeerCell[i][1]] = 0;
+    }
+    sPeersInGrid = 0;
+
+    mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
+        sPeerBudget[i] = configNetworkObjectBudget;
+
+        struct MarioState* m = &gMarioStates[i];
+        if (m->marioObj == NULL || !is_player_in_local_area(m)) { continue; }
+
+        s16 cx = interest_grid_cell(m->marioObj->header.gfx.pos[0]);
+        s16 cz = interest_grid_cell(m->marioObj->header.gfx.pos[2]);
+        sPeerCell[i][0] = cx;
+        sPeerCell[i][1] = cz;
+        sCells[cx][cz] |= NETWORK_PLAYER_BIT(i);
+        sPeersInGrid |= NETWORK_PLAYER_BIT(i);
+    }
+}
+
+NetworkPlayerMask interest_grid_nearby(struct SyncObject* so, NetworkPlayerMask candidates) {
+    struct Object* o = so->o;
+    candidates &= sPeersInGrid;
+    if (o == NULL || candidates == 0) { return 0; }
+
+    // gather every peer in the cells the sync distance reaches
+    bool infinite = (so->maxSyncDistance == SYNC_DISTANCE_INFINITE);
+    f32 radius = so->maxSyncDistance;
+    NetworkPlayerMask inCells = candidates;
+    if (!infinite) {
+        s16 minX = interest_grid_cell(o->oPosX - radius);
+        s16 maxX = interest_grid_cell(o->oPosX + radius);
+        s16 minZ = interest_grid_cell(o->oPosZ - radius);
+        s16 maxZ = interest_grid_cell(o->oPosZ + radius);
+        inCells = 0;
+        for (s16 x = minX; x <= maxX; x++) {
+            for (s16 z = minZ; z <= maxZ; z++) {
+                inCells |= sCells[x][z];
+            }
+        }
+    }
+
+    // then do the exact check on what's left
+    NetworkPlayerMask nearby = 0;
+    NetworkPlayerMask mask = candidates & inCells;
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
+        if (!infinite && player_distance(&gMarioStates[i], o) > radius) {
+            CTR_ADD(CTR_NET_OBJECT_CULLED, 1);
+            continue;
+        }
+        if (configNetworkObjectBudget > 0 && sPeerBudget[i] <= 0) {
+            CTR_ADD(CTR_NET_OBJECT_DEFERRED, 1);
+            continue;
+        }
+        nearby |= NETWORK_PLAYER_BIT(i);
+    }
+
+    CTR_ADD(CTR_NET_OBJECT_CULLED, __builtin_popcountll(candidates & ~inCells));
+    return nearby;
+}
+
+NetworkPlayerMask interest_grid_due(struct SyncObject* so, NetworkPlayerMask nearby) {
+    struct Object* o = so->o;
+    if (o == NULL) { return 0; }
+
+    NetworkPlayerMask due = 0;
+    NetworkPlayerMask mask = nearby;
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
+
+        // calculate the update rate from this peer's point of view
+        f32 updateRate = player_distance(&gMarioStates[i], o) / 1000.0f;
+        if (gMarioStates[0].heldObj == o) { updateRate = 0.33f; }
+
+        // set max and min update rate
+        if (so->maxUpdateRate > 0 && updateRate < so->maxUpdateRate) { updateRate = so->maxUpdateRate; }
+        if (updateRate < so->minUpdateRate) { updateRate = so->minUpdateRate; }
+
+        f32 timeSinceUpdate = (clock_elapsed() - so->peerClockSinceUpdate[i]);
+        if (timeSinceUpdate < updateRate) { continue; }
+
+        due |= NETWORK_PLAYER_BIT(i);
+    }
+    return due;
+}
+
+void interest_grid_charge(struct SyncObject* so, NetworkPlayerMask mask, u16 bytes) {
+    CTR_ADD(CTR_NET_OBJECT_TX, __builtin_popcountll(mask));
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
+        so->peerClockSinceUpdate[i] = clock_elapsed();
+        sPeerBudget[i] -= bytes;
+    }
+}
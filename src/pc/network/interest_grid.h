@@ -0,0 +1,13 @@
+#ifndef INTEREST_GRID_H
+#define INTEREST_GRID_H
+
+#include "network_player.h"
+
+struct SyncObject;
+
+void interest_grid_update(void);
+NetworkPlayerMask interest_grid_nearby(struct SyncObject* so, NetworkPlayerMask candidates);
+NetworkPlayerMask interest_grid_due(struct SyncObject* so, NetworkPlayerMask nearby);
+void interest_grid_charge(struct SyncObject* so, NetworkPlayerMask mask, u16 bytes);
+
+#endif
@@ -2,6 +2,7 @@
 #include "coopnet/coopnet.h"
 #include <stdio.h>
 #include "network.h"
+#include "interest_grid.h"
 #include "object_fields.h"
 #include "game/level_update.h"
 #include "object_constants.h"
@@ -213,6 +214,28 @@ void network_on_loaded_area(void) {
     }
 }
 
+static bool network_rate_limited(u8 localIndex) {
+    static s32 sPacketsPerSecond[MAX_PLAYERS] = { 0 };
+    static f32 sPacketsPerSecondTime[MAX_PLAYERS] = { 0 };
+    if (localIndex >= MAX_PLAYERS) { return false; }
+
+    s32 maxPacketsPerSecond = (gNetworkType == NT_SERVER) ? (MAX_PACKETS_PER_SECOND_PER_PLAYER * (u16)network_player_connected_count()) : MAX_PACKETS_PER_SECOND_PER_PLAYER;
+    f32 currentTime = clock_elapsed();
+    if ((currentTime - sPacketsPerSecondTime[localIndex]) > 0) {
+        if (sPacketsPerSecond[localIndex] > maxPacketsPerSecond) {
+            LOG_ERROR("Too many packets sent to localIndex %d! Attempted %d. Connected count %d.", localIndex, sPacketsPerSecond[localIndex], network_player_connected_count());
+        }
+        sPacketsPerSecondTime[localIndex] = currentTime;
+        sPacketsPerSecond[localIndex] = 1;
+    } else {
+        sPacketsPerSecond[localIndex]++;
+        if (sPacketsPerSecond[localIndex] > maxPacketsPerSecond) {
+            return true;
+        }
+    }
+    return false;
+}
+
 static void network_remember_debug_packet(u8 id, bool sent) {
     if (id == PACKET_ACK) { return; }
     if (id == PACKET_KEEP_ALIVE) { return; }
@@ -316,23 +339,7 @@ void network_send_to(u8 localIndex, struct Packet* p) {
     SOFT_ASSERT(p->dataLength < PACKET_LENGTH);
 
     // rate limit packets
-    bool tooManyPackets = false;
-    s32 maxPacketsPerSecond = (gNetworkType == NT_SERVER) ? (MAX_PACKETS_PER_SECOND_PER_PLAYER * (u16)network_player_connected_count()) : MAX_PACKETS_PER_SECOND_PER_PLAYER;
-    static s32 sPacketsPerSecond[MAX_PLAYERS] = { 0 };
-    static f32 sPacketsPerSecondTime[MAX_PLAYERS] = { 0 };
-    f32 currentTime = clock_elapsed();
-    if ((currentTime - sPacketsPerSecondTime[localIndex]) > 0) {
-        if (sPacketsPerSecond[localIndex] > maxPacketsPerSecond) {
-            LOG_ERROR("Too many packets sent to localIndex %d! Attempted %d. Connected count %d.", localIndex, sPacketsPerSecond[localIndex], network_player_connected_count());
-        }
-        sPacketsPerSecondTime[localIndex] = currentTime;
-        sPacketsPerSecond[localIndex] = 1;
-    } else {
-        sPacketsPerSecond[localIndex]++;
-        if (sPacketsPerSecond[localIndex] > maxPacketsPerSecond) {
-            tooManyPackets = true;
-        }
-    }
+    bool tooManyPackets = network_rate_limited(localIndex);
 
     // send
     if (!tooManyPackets) {
@@ -358,7 +365,60 @@ void network_send_to(u8 localIndex, struct Packet* p) {
     }
 }
 
+static void network_send_fanout(struct Packet* p, u8* recipients, u8 recipientCount) {
+    // every recipient gets the exact same bytes, so serialize, hash and compress once.
+    // receivers only use the destination to route packets through the server,
+    // which never happens for a packet the server itself fans out
+    if (gNetworkType == NT_NONE) { LOG_ERROR("network type error none!"); return; }
+    if (p->error) { LOG_ERROR("packet error!"); return; }
+    if (gNetworkSystem == NULL) { LOG_ERROR("no network system attached"); return; }
+
+    packet_set_flags(p);
+    packet_set_destination(p, PACKET_DESTINATION_BROADCAST);
+
+    // set ordered data (MUST BE IMMEDITAELY BEFORE network_remember_reliable())
+    if (p->orderedGroupId != 0 && !p->sent) {
+        packet_set_ordered_data(p);
+    }
+
+    u32 hash = packet_hash(p);
+    memcpy(&p->buffer[p->dataLength], &hash, sizeof(u32));
+    SOFT_ASSERT(p->dataLength < PACKET_LENGTH);
+
+    u8* buffer = NULL;
+    u32 len = 0;
+    packet_compress(p, &buffer, &len);
+    if (!buffer || len == 0) {
+        LOG_ERROR("Failed to compress!");
+        return;
+    }
+
+    for (u8 i = 0; i < recipientCount; i++) {
+        u8 localIndex = recipients[i];
+
+        // remember reliable packets per peer
+        p->localIndex = localIndex;
+        p->sent = false;
+        network_remember_reliable(p);
+
+        if (!network_rate_limited(localIndex)) {
+            int rc = gNetworkSystem->send(localIndex, p->addr, buffer, len);
+            if (rc == SOCKET_ERROR) { LOG_ERROR("send error %d", rc); continue; }
+        }
+
+        gNetworkPlayers[localIndex].lastSent = clock_elapsed();
+    }
+    p->sent = true;
+
+    network_remember_debug_packet(p->packetType, true);
+}
+
 void network_send(struct Packet* p) {
+    network_send_mask(p, gNetworkPlayersConnected);
+}
+
+// clients that relay through the server leave the filtering up to it
+void network_send_mask(struct Packet* p, NetworkPlayerMask mask) {
     if (p == NULL) {
         LOG_ERROR("no data to send");
         return;
@@ -383,9 +443,12 @@ void network_send(struct Packet* p) {
         }
     }
 
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
+    u8 recipients[MAX_PLAYERS] = { 0 };
+    u8 recipientCount = 0;
+    mask &= gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         struct NetworkPlayer* np = &gNetworkPlayers[i];
-        if (!np->connected) { continue; }
 
         // don't send a packet to a player that can't receive it
         if (p->levelAreaMustMatch) {
@@ -399,9 +462,18 @@ void network_send(struct Packet* p) {
             if (p->levelNum  != np->currLevelNum)  { continue; }
         }
 
-        p->localIndex = i;
+        recipients[recipientCount++] = i;
+    }
+
+    if (recipientCount > 1 && !p->keepSendingAfterDisconnect) {
+        network_send_fanout(p, recipients, recipientCount);
+        return;
+    }
+
+    for (u8 i = 0; i < recipientCount; i++) {
+        p->localIndex = recipients[i];
         p->sent = false;
-        network_send_to(i, p);
+        network_send_to(recipients[i], p);
     }
 }
 
@@ -579,6 +651,7 @@ void network_update(void) {
     // send out update packets
     if (gNetworkType != NT_NONE) {
         network_player_update();
+        interest_grid_update();
         if (sCurrPlayMode == PLAY_MODE_NORMAL || sCurrPlayMode == PLAY_MODE_PAUSED) {
             network_update_player();
             network_update_objects();
@@ -598,6 +671,9 @@ void network_update(void) {
 
     sync_objects_update();
 
+    // send out everything queued up this frame
+    network_flush();
+
     // update level/area request timers
     /*struct NetworkPlayer* np = gNetworkPlayerLocal;
     if (np != NULL && !np->currLevelSyncValid) {
@@ -631,6 +707,11 @@ void network_update(void) {
     }
 }
 
+void network_flush(void) {
+    if (gNetworkSystem == NULL || gNetworkSystem->flush == NULL) { return; }
+    gNetworkSystem->flush();
+}
+
 static inline void color_set(Color color, u8 r, u8 g, u8 b) {
     color[0] = r;
     color[1] = g;
@@ -49,6 +49,7 @@ struct NetworkSystem {
     void* (*dup_addr)(u8 localIndex);
     bool (*match_addr)(void* addr1, void* addr2);
     void (*update)(void);
+    void (*flush)(void);
     int  (*send)(u8 localIndex, void* addr, u8* data, u16 dataLength);
     void (*get_lobby_id)(char* destination, u32 destLength);
     void (*get_lobby_secret)(char* destination, u32 destLength);
@@ -120,6 +121,7 @@ void network_on_loaded_area(void);
 bool network_allow_unknown_local_index(enum PacketType packetType);
 void network_send_to(u8 localIndex, struct Packet* p);
 void network_send(struct Packet* p);
+void network_send_mask(struct Packet* p, NetworkPlayerMask mask);
 void network_receive(u8 localIndex, void* addr, u8* data, u16 dataLength);
 void* network_duplicate_address(u8 localIndex);
 void network_reset_reconnect_and_rehost(void);
@@ -127,6 +129,7 @@ void network_reconnect_begin(void);
 bool network_is_reconnecting(void);
 void network_rehost_begin(void);
 void network_update(void);
+void network_flush(void);
 void network_shutdown(bool sendLeaving, bool exiting, bool popup, bool reconnecting);
 
 #endif
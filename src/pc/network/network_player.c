@@ -19,6 +19,8 @@
 #include "pc/djui/djui_unicode.h"
 
 struct NetworkPlayer gNetworkPlayers[MAX_PLAYERS] = { 0 };
+NetworkPlayerMask gNetworkPlayersConnected = 0;
+static u8 sLocalIndexFromGlobal[MAX_PLAYERS] = { 0 };
 struct NetworkPlayer *gNetworkPlayerLocal = NULL;
 struct NetworkPlayer *gNetworkPlayerServer = NULL;
 static char sDefaultPlayerName[] = "Player";
@@ -64,18 +66,11 @@ void network_player_update_model(u8 localIndex) {
 }
 
 bool network_player_any_connected(void) {
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        if (gNetworkPlayers[i].connected) { return true; }
-    }
-    return false;
+    return (gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0)) != 0;
 }
 
 u8 network_player_connected_count(void) {
-    u8 count = 0;
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        if (gNetworkPlayers[i].connected) { count++; }
-    }
-    return count;
+    return (u8)__builtin_popcountll(gNetworkPlayersConnected);
 }
 
 void network_player_set_description(struct NetworkPlayer *np, const char *description, u8 r, u8 g, u8 b, u8 a) {
@@ -104,18 +99,16 @@ void network_player_set_override_location(struct NetworkPlayer *np, const char *
 }
 
 struct NetworkPlayer *network_player_from_global_index(u8 globalIndex) {
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        if (!gNetworkPlayers[i].connected) { continue; }
-        if (gNetworkPlayers[i].globalIndex == globalIndex) {
-            return &gNetworkPlayers[i];
-        }
-    }
-    return NULL;
+    if (globalIndex >= MAX_PLAYERS) { return NULL; }
+    struct NetworkPlayer* np = &gNetworkPlayers[sLocalIndexFromGlobal[globalIndex]];
+    if (!np->connected || np->globalIndex != globalIndex) { return NULL; }
+    return np;
 }
 
 struct NetworkPlayer *get_network_player_from_level(s16 courseNum, s16 actNum, s16 levelNum) {
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer *np = &gNetworkPlayers[i];
+    NetworkPlayerMask mask = gNetworkPlayersConnected;
+    while (mask) {
+        struct NetworkPlayer *np = &gNetworkPlayers[network_player_mask_pop(&mask)];
         if (!np->connected)                 { continue; }
         if (!np->currLevelSyncValid)        { continue; }
         if (np->currCourseNum != courseNum) { continue; }
@@ -127,8 +120,9 @@ struct NetworkPlayer *get_network_player_from_level(s16 courseNum, s16 actNum, s
 }
 
 struct NetworkPlayer *get_network_player_from_area(s16 courseNum, s16 actNum, s16 levelNum, s16 areaIndex) {
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer *np = &gNetworkPlayers[i];
+    NetworkPlayerMask mask = gNetworkPlayersConnected;
+    while (mask) {
+        struct NetworkPlayer *np = &gNetworkPlayers[network_player_mask_pop(&mask)];
         if (!np->connected)                 { continue; }
         if (!np->currLevelSyncValid)        { continue; }
         if (!np->currAreaSyncValid)         { continue; }
@@ -144,8 +138,9 @@ struct NetworkPlayer *get_network_player_from_area(s16 courseNum, s16 actNum, s1
 struct NetworkPlayer *get_network_player_smallest_global(void) {
     struct NetworkPlayer* lNp = gNetworkPlayerLocal;
     struct NetworkPlayer* smallest = gNetworkPlayerLocal;
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer *np = &gNetworkPlayers[i];
+    NetworkPlayerMask mask = gNetworkPlayersConnected;
+    while (mask) {
+        struct NetworkPlayer *np = &gNetworkPlayers[network_player_mask_pop(&mask)];
         if (!np->connected)                          { continue; }
         if (!np->currLevelSyncValid)                 { continue; }
         if (!np->currAreaSyncValid)                  { continue; }
@@ -193,19 +188,17 @@ bool network_player_is_override_palette_same(struct NetworkPlayer *np) {
 void network_player_update(void) {
     lag_compensation_store();
 
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer *np = &gNetworkPlayers[i];
-        if (!np->connected && i > 0) { continue; }
-
-        network_player_update_model(i);
+    NetworkPlayerMask mask = network_player_present_mask();
+    while (mask) {
+        network_player_update_model(network_player_mask_pop(&mask));
     }
 
     if (!network_player_any_connected()) { return; }
 
 
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer *np = &gNetworkPlayers[i];
-        if (!np->connected && i > 0) { continue; }
+    mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        struct NetworkPlayer *np = &gNetworkPlayers[network_player_mask_pop(&mask)];
         float elapsed = (clock_elapsed() - np->lastPingSent);
         if (elapsed > NETWORK_PLAYER_PING_TIMEOUT) {
             network_send_ping(np);
@@ -214,9 +207,10 @@ void network_player_update(void) {
     }
 
     if (gNetworkType == NT_SERVER) {
-        for (s32 i = 1; i < MAX_PLAYERS; i++) {
+        mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+        while (mask) {
+            u8 i = network_player_mask_pop(&mask);
             struct NetworkPlayer *np = &gNetworkPlayers[i];
-            if (!np->connected && i > 0) { continue; }
 
             float elapsed = (clock_elapsed() - np->lastReceived);
 #ifdef DEVELOPMENT
@@ -304,6 +298,8 @@ u8 network_player_connected(enum NetworkPlayerType type, u8 globalIndex, u8 mode
     np->type = type;
     np->localIndex = localIndex;
     np->globalIndex = globalIndex;
+    gNetworkPlayersConnected |= NETWORK_PLAYER_BIT(localIndex);
+    if (globalIndex < MAX_PLAYERS) { sLocalIndexFromGlobal[globalIndex] = localIndex; }
     np->ping = 50;
     if ((type != NPT_LOCAL) && (gNetworkType == NT_SERVER || type == NPT_SERVER)) { gNetworkSystem->save_id(localIndex, 0); }
     network_player_set_description(np, NULL, 0, 0, 0, 0);
@@ -335,11 +331,14 @@ u8 network_player_connected(enum NetworkPlayerType type, u8 globalIndex, u8 mode
     if (localIndex != 0) {
         for (struct SyncObject* so = sync_object_get_first(); so != NULL; so = sync_object_get_next()) {
             so->rxEventId[localIndex] = 0;
+            so->peerClockSinceUpdate[localIndex] = 0;
         }
     }
 
     for (s32 j = 0; j < MAX_RX_SEQ_IDS; j++) { np->rxSeqIds[j] = 0; np->rxPacketHash[j] = 0; }
 
+    network_player_snapshots_clear(localIndex);
+
     // set up network player pointers
     if (type == NPT_LOCAL) {
         gNetworkPlayerLocal = np;
@@ -382,12 +381,12 @@ u8 network_player_disconnected(u8 globalIndex) {
         return UNKNOWN_GLOBAL_INDEX;
     }
 
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        struct NetworkPlayer* np = &gNetworkPlayers[i];
-        if (!np->connected) { continue; }
-        if (np->globalIndex != globalIndex) { continue; }
+    struct NetworkPlayer* np = network_player_from_global_index(globalIndex);
+    if (np != NULL && np->localIndex != 0) {
+        u8 i = np->localIndex;
         if (gNetworkType == NT_SERVER) { network_send_leaving(np->globalIndex); }
         np->connected = false;
+        gNetworkPlayersConnected &= ~NETWORK_PLAYER_BIT(i);
         np->currCourseNum      = -1;
         np->currActNum         = -1;
         np->currLevelNum       = -1;
@@ -407,6 +406,7 @@ u8 network_player_disconnected(u8 globalIndex) {
         construct_player_popup(np, DLANG(NOTIF, DISCONNECTED), NULL);
 
         packet_ordered_clear(globalIndex);
+        network_player_snapshots_clear(i);
 
         smlua_call_event_hooks_mario_param(HOOK_ON_PLAYER_DISCONNECTED, &gMarioStates[i]);
 
@@ -512,7 +512,131 @@ void network_player_shutdown(bool popup) {
         networkPlayer->connected = false;
         gNetworkSystem->clear_id(i);
     }
+    gNetworkPlayersConnected = 0;
+    memset(sLocalIndexFromGlobal, 0, sizeof(sLocalIndexFromGlobal));
+    network_player_snapshots_clear_all();
 
     if (popup) { djui_popup_create(DLANG(NOTIF, SERVER_CLOSED), 1); }
     LOG_INFO("cleared all network players");
 }
+
+#ifdef DEVELOPMENT
+
+  ///////////
+ // bench //
+///////////
+
+#include "game/obj_behaviors.h"
+#include "pc/dev/bench.h"
+
+#define PLAYER_BENCH_OBJECTS 256
+#define PLAYER_BENCH_ITERATIONS 200
+#define PLAYER_BENCH_AREA_SIZE 8000.0f
+
+static struct NetworkPlayer sBenchSavedPlayers[MAX_PLAYERS] = { 0 };
+static struct MarioState sBenchSavedMarioStates[MAX_PLAYERS] = { 0 };
+static struct Object sBenchPlayerObjs[MAX_PLAYERS] = { 0 };
+static struct Object sBenchObjs[PLAYER_BENCH_OBJECTS] = { 0 };
+static u32 sBenchSeed = 0;
+
+static f32 network_player_bench_coord(void) {
+    // keep the game's rng untouched
+    sBenchSeed = sBenchSeed * 1103515245 + 12345;
+    return ((sBenchSeed >> 16) / 65535.0f - 0.5f) * PLAYER_BENCH_AREA_SIZE;
+}
+
+static void network_player_bench_place(struct Object* o) {
+    memset(o, 0, sizeof(struct Object));
+    o->oPosX = network_player_bench_coord();
+    o->oPosY = network_player_bench_coord();
+    o->oPosZ = network_player_bench_coord();
+    o->header.gfx.pos[0] = o->oPosX;
+    o->header.gfx.pos[1] = o->oPosY;
+    o->header.gfx.pos[2] = o->oPosZ;
+}
+
+static void network_player_bench_one(u8 playerCount) {
+    sBenchSeed = playerCount;
+
+    // fake a lobby where everyone is in the same area
+    gNetworkPlayersConnected = 0;
+    for (u8 i = 0; i < MAX_PLAYERS; i++) {
+        struct NetworkPlayer* np = &gNetworkPlayers[i];
+        memset(np, 0, sizeof(struct NetworkPlayer));
+        memset(&gMarioStates[i], 0, sizeof(struct MarioState));
+        gMarioStates[i].playerIndex = i;
+        if (i >= playerCount) { continue; }
+
+        np->connected = true;
+        np->type = (i == 0) ? NPT_LOCAL : NPT_CLIENT;
+        np->localIndex = i;
+        np->globalIndex = i;
+        np->currLevelNum = gLevelValues.entryLevel;
+        np->currAreaIndex = 1;
+        sLocalIndexFromGlobal[i] = i;
+        gNetworkPlayersConnected |= NETWORK_PLAYER_BIT(i);
+
+        network_player_bench_place(&sBenchPlayerObjs[i]);
+        gMarioStates[i].marioObj = &sBenchPlayerObjs[i];
+        gMarioStates[i].visibleToEnemies = true;
+    }
+
+    for (u32 i = 0; i < PLAYER_BENCH_OBJECTS; i++) {
+        network_player_bench_place(&sBenchObjs[i]);
+    }
+
+    u32 hits = 0;
+    f64 start = clock_elapsed_f64();
+    for (u32 iter = 0; iter < PLAYER_BENCH_ITERATIONS; iter++) {
+        for (u32 i = 0; i < PLAYER_BENCH_OBJECTS; i++) {
+            struct Object* o = &sBenchObjs[i];
+            if (nearest_mario_state_to_object(o) != NULL) { hits++; }
+            if (nearest_possible_mario_state_to_object(o) != NULL) { hits++; }
+        }
+    }
+    f64 mid = clock_elapsed_f64();
+    for (u32 iter = 0; iter < PLAYER_BENCH_ITERATIONS; iter++) {
+        for (u32 i = 0; i < MAX_PLAYERS; i++) {
+            if (network_player_from_global_index(i) != NULL) { hits++; }
+        }
+    }
+    f64 end = clock_elapsed_f64();
+
+    dev_bench_report("%u players: object scan %.3fus, global lookup %.3fus (%u hits)",
+        playerCount,
+        (mid - start) * 1000000.0 / (PLAYER_BENCH_ITERATIONS * PLAYER_BENCH_OBJECTS),
+        (end - mid) * 1000000.0 / (PLAYER_BENCH_ITERATIONS * MAX_PLAYERS),
+        hits);
+}
+
+void network_player_bench(void) {
+    if (gNetworkType != NT_NONE) {
+        dev_bench_report("Disconnect before running this benchmark");
+        return;
+    }
+
+    // swap the real players out for the fake ones
+    struct NetworkPlayer* savedLocal = gNetworkPlayerLocal;
+    struct NetworkPlayer* savedServer = gNetworkPlayerServer;
+    NetworkPlayerMask savedConnected = gNetworkPlayersConnected;
+    u8 savedLocalIndexFromGlobal[MAX_PLAYERS];
+    memcpy(savedLocalIndexFromGlobal, sLocalIndexFromGlobal, sizeof(sLocalIndexFromGlobal));
+    memcpy(sBenchSavedPlayers, gNetworkPlayers, sizeof(sBenchSavedPlayers));
+    memcpy(sBenchSavedMarioStates, gMarioStates, sizeof(sBenchSavedMarioStates));
+    gNetworkPlayerLocal = &gNetworkPlayers[0];
+    gNetworkPlayerServer = NULL;
+
+    for (u32 playerCount = 1; playerCount < MAX_PLAYERS; playerCount *= 2) {
+        network_player_bench_one(playerCount);
+    }
+    network_player_bench_one(MAX_PLAYERS);
+
+    gNetworkPlayerLocal = savedLocal;
+    gNetworkPlayerServer = savedServer;
+    gNetworkPlayersConnected = savedConnected;
+    memcpy(sLocalIndexFromGlobal, savedLocalIndexFromGlobal, sizeof(sLocalIndexFromGlobal));
+    memcpy(gNetworkPlayers, sBenchSavedPlayers, sizeof(sBenchSavedPlayers));
+    memcpy(gMarioStates, sBenchSavedMarioStates, sizeof(sBenchSavedMarioStates));
+}
+
+#endif
@@ -14,6 +14,12 @@
 #define USE_REAL_PALETTE_VAR 0xFF
 #define MAX_DESCRIPTION_STRING 20
 
+#if MAX_PLAYERS > 64
+#error "MAX_PLAYERS can not be larger than 64"
+#endif
+
+#define NETWORK_PLAYER_BIT(_localIndex) ((NetworkPlayerMask)1 << (_localIndex))
+
 enum NetworkPlayerType {
     NPT_UNKNOWN,
     NPT_LOCAL,
@@ -71,6 +77,19 @@ struct NetworkPlayer {
 extern struct NetworkPlayer gNetworkPlayers[];
 extern struct NetworkPlayer* gNetworkPlayerLocal;
 extern struct NetworkPlayer* gNetworkPlayerServer;
+extern NetworkPlayerMask gNetworkPlayersConnected;
+
+// pops the lowest local index out of the mask
+static inline u8 network_player_mask_pop(NetworkPlayerMask* mask) {
+    u8 localIndex = (u8)__builtin_ctzll(*mask);
+    *mask &= *mask - 1;
+    return localIndex;
+}
+
+// every local index that can have an active player, the local player always does
+static inline NetworkPlayerMask network_player_present_mask(void) {
+    return gNetworkPlayersConnected | NETWORK_PLAYER_BIT(0);
+}
 
 bool network_player_name_valid(char* buffer);
 
@@ -101,4 +120,8 @@ void construct_player_popup(struct NetworkPlayer* np, char* msg, const char* lev
 void network_player_update_course_level(struct NetworkPlayer* np, s16 courseNum, s16 actNum, s16 levelNum, s16 areaIndex);
 void network_player_shutdown(bool popup);
 
+#ifdef DEVELOPMENT
+void network_player_bench(void);
+#endif
+
 #endif
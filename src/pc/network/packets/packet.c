@@ -1,47 +1,8 @@
 #include <stdio.h>
-#include <zlib.h>
 #include "../network.h"
 #include "pc/network/ban_list.h"
 #include "pc/debuglog.h"
 
-static u32 sCompBufferLen = 0;
-static Bytef* sCompBuffer = NULL;
-
-static void increase_comp_buffer(u32 compressedLen) {
-    if (compressedLen <= sCompBufferLen && sCompBuffer) { return; }
-
-    if (sCompBuffer != NULL) { free(sCompBuffer); }
-
-    sCompBufferLen = compressedLen;
-    sCompBuffer = (Bytef*)malloc(sCompBufferLen);
-}
-
-void packet_compress(struct Packet* p, u8** compBuffer, u32* compSize) {
-    uLong sourceSize = p->dataLength + sizeof(u32);
-    uLongf compressedLen = compressBound(sourceSize);
-    increase_comp_buffer(PACKET_LENGTH);
-
-    if (sCompBuffer && compress2((Bytef*)sCompBuffer, &compressedLen, (Bytef*)p->buffer, sourceSize, Z_BEST_COMPRESSION) == Z_OK) {
-        *compBuffer = sCompBuffer;
-        *compSize = compressedLen;
-    } else {
-        *compBuffer = NULL;
-        *compSize = 0;
-    }
-}
-
-bool packet_decompress(struct Packet* p, u8* compBuffer, u32 compSize) {
-    increase_comp_buffer(PACKET_LENGTH);
-    if (!sCompBuffer) { return false; }
-    uLong decompSize = PACKET_LENGTH;
-    if (uncompress((Bytef*)p->buffer, &decompSize, (Bytef*)compBuffer, compSize) == Z_OK) {
-        p->dataLength = decompSize - sizeof(u32);
-        return true;
-    } else {
-        return false;
-    }
-}
-
 void packet_process(struct Packet* p) {
     if (gNetworkType == NT_NONE) { return; }
     if (p->levelAreaMustMatch) {
@@ -78,6 +39,7 @@ void packet_process(struct Packet* p) {
     switch (p->packetType) {
         case PACKET_ACK:                     network_receive_ack(p);                     break;
         case PACKET_PLAYER:                  network_receive_player(p);                  break;
+        case PACKET_PLAYER_ACK:              network_receive_player_ack(p);              break;
         case PACKET_OBJECT:                  network_receive_object(p);                  break;
         case PACKET_SPAWN_OBJECTS:           network_receive_spawn_objects(p);           break;
         case PACKET_SPAWN_STAR:              network_receive_spawn_star(p);              break;
@@ -201,7 +163,9 @@ void packet_receive(struct Packet* p) {
     }
 
     // parse the packet without processing the rest
+    u16 payloadCursor = 0;
     if (packet_initial_read(p)) {
+        payloadCursor = p->cursor;
         if (gNetworkType == NT_SERVER && p->destGlobalId != PACKET_DESTINATION_BROADCAST && p->destGlobalId != 0 && packetType != PACKET_ACK && packetType != PACKET_MOD_LIST_REQUEST) {
             // this packet is meant for someone else
             struct Packet p2 = { 0 };
@@ -220,9 +184,19 @@ void packet_receive(struct Packet* p) {
 
     // broadcast packet
     if (p->requestBroadcast) {
-        if (gNetworkType == NT_SERVER && gNetworkSystem->requireServerBroadcast) {
-            for (s32 i = 1; i < MAX_PLAYERS; i++) {
-                if (!gNetworkPlayers[i].connected) { continue; }
+        if (gNetworkType == NT_SERVER && gNetworkSystem->requireServerBroadcast && packetType == PACKET_PLAYER) {
+            // player packets are delta encoded per link
+            p->cursor = payloadCursor;
+            if (payloadCursor != 0) { network_relay_player(p); }
+        } else if (gNetworkType == NT_SERVER && gNetworkSystem->requireServerBroadcast) {
+            // object updates only go to the peers near the object
+            NetworkPlayerMask mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+            if (packetType == PACKET_OBJECT && payloadCursor != 0) {
+                p->cursor = payloadCursor;
+                mask &= network_object_relay_mask(p);
+            }
+            while (mask) {
+                u8 i = network_player_mask_pop(&mask);
                 if (i == p->localIndex) { continue; }
                 struct Packet p2 = { 0 };
                 packet_duplicate(p, &p2);
@@ -77,6 +77,8 @@ enum PacketType {
     PACKET_COMMAND,
     PACKET_MODERATOR,
 
+    PACKET_PLAYER_ACK,
+
     ///
     PACKET_CUSTOM = 255,
 };
@@ -113,6 +115,12 @@ struct Packet {
     u8 buffer[PACKET_LENGTH];
 };
 
+enum PacketCompression {
+    PACKET_COMPRESSION_BEST,
+    PACKET_COMPRESSION_FAST,
+    PACKET_COMPRESSION_MAX,
+};
+
 enum KickReasonType {
     EKT_CLOSE_CONNECTION,
     EKT_FULL_PARTY,
@@ -152,12 +160,17 @@ struct LSTNetworkType {
 extern u8 gAllowOrderedPacketClear;
 
 // packet.c
-void packet_compress(struct Packet* p, u8** compBuffer, u32* compSize);
-bool packet_decompress(struct Packet* p, u8* compBuffer, u32 compSize);
 void packet_process(struct Packet* p);
 void packet_receive(struct Packet* packet);
 bool packet_spoofed(struct Packet* p, u8 globalIndex);
 
+// packet_codec.c
+void packet_compress(struct Packet* p, u8** compBuffer, u32* compSize);
+bool packet_decompress(struct Packet* p, u8* compBuffer, u32 compSize);
+#ifdef DEVELOPMENT
+void packet_codec_bench(void);
+#endif
+
 // packet_read_write.c
 void packet_init(struct Packet* packet, enum PacketType packetType, bool reliable, enum PacketLevelMatchType levelAreaMustMatch);
 void packet_duplicate(struct Packet* srcPacket, struct Packet* dstPacket);
@@ -188,13 +201,19 @@ void packet_ordered_clear(u8 globalIndex);
 void packet_ordered_update(void);
 
 // packet_player.c
+void network_player_snapshots_clear(u8 localIndex);
+void network_player_snapshots_clear_all(void);
+void network_player_get_bandwidth(u8 localIndex, u32* rawBytesPerSecond, u32* sentBytesPerSecond);
 void network_update_player(void);
 void network_receive_player(struct Packet* p);
+void network_relay_player(struct Packet* p);
+void network_receive_player_ack(struct Packet* p);
 
 // packet_object.c
 void network_send_object(struct Object* o);
 void network_send_object_reliability(struct Object* o, bool reliable);
 void network_receive_object(struct Packet* p);
+NetworkPlayerMask network_object_relay_mask(struct Packet* p);
 void network_update_objects(void);
 
 // packet_spawn_object.c
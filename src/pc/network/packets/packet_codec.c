@@ -0,0 +1,246 @@
+#include <stdio.h>
+#include <zlib.h>
+#include "../network.h"
+#include "pc/configfile.h"
+#include "pc/debuglog.h"
+#include "pc/utils/misc.h"
+#ifdef DEVELOPMENT
+#include "pc/dev/bench.h"
+#endif
+
+// Every compressed packet starts with a single codec byte so the receiver
+// knows how to decode it regardless of the sender's settings.
+#define PACKET_CODEC_HEADER_SIZE 1
+#define PACKET_CODEC_BUFFER_LENGTH (PACKET_CODEC_HEADER_SIZE + PACKET_LENGTH + 64)
+
+enum PacketCodecType {
+    PACKET_CODEC_RAW,
+    PACKET_CODEC_DEFLATE,
+    PACKET_CODEC_MAX,
+};
+
+struct PacketCompressor {
+    char* name;
+    enum PacketCodecType codec;
+    s32 level;
+    z_stream stream;
+    bool initialized;
+};
+
+static struct PacketCompressor sPacketCompressors[PACKET_COMPRESSION_MAX] = {
+    [PACKET_COMPRESSION_BEST] = { .name = "deflate-9", .codec = PACKET_CODEC_DEFLATE, .level = Z_BEST_COMPRESSION },
+    [PACKET_COMPRESSION_FAST] = { .name = "deflate-1", .codec = PACKET_CODEC_DEFLATE, .level = Z_BEST_SPEED       },
+};
+
+static u8 sCompBuffer[PACKET_CODEC_BUFFER_LENGTH] = { 0 };
+static z_stream sInflateStream = { 0 };
+static bool sInflateInitialized = false;
+
+  /////////////
+ // deflate //
+/////////////
+
+static bool packet_deflate(struct PacketCompressor* compressor, u8* src, u32 srcSize, u8* dst, u32* dstSize) {
+    z_stream* stream = &compressor->stream;
+    if (!compressor->initialized) {
+        memset(stream, 0, sizeof(z_stream));
+        if (deflateInit(stream, compressor->level) != Z_OK) { return false; }
+        compressor->initialized = true;
+    } else if (deflateReset(stream) != Z_OK) {
+        return false;
+    }
+
+    stream->next_in = src;
+    stream->avail_in = srcSize;
+    stream->next_out = dst;
+    stream->avail_out = *dstSize;
+    if (deflate(stream, Z_FINISH) != Z_STREAM_END) { return false; }
+
+    *dstSize = stream->total_out;
+    return true;
+}
+
+static bool packet_inflate(u8* src, u32 srcSize, u8* dst, u32* dstSize) {
+    z_stream* stream = &sInflateStream;
+    if (!sInflateInitialized) {
+        memset(stream, 0, sizeof(z_stream));
+        if (inflateInit(stream) != Z_OK) { return false; }
+        sInflateInitialized = true;
+    } else if (inflateReset(stream) != Z_OK) {
+        return false;
+    }
+
+    stream->next_in = src;
+    stream->avail_in = srcSize;
+    stream->next_out = dst;
+    stream->avail_out = *dstSize;
+
+    if (inflate(stream, Z_FINISH) != Z_STREAM_END) { return false; }
+
+    *dstSize = stream->total_out;
+    return true;
+}
+
+  /////////////
+ // packets //
+/////////////
+
+#ifdef DEVELOPMENT
+static void packet_capture(u8* data, u32 length);
+#endif
+
+static bool packet_compress_with(struct PacketCompressor* compressor, u8* src, u32 srcSize, u8* dst, u32* dstSize) {
+    // small packets aren't worth the cpu time, send them as-is
+    if (compressor != NULL && srcSize >= configNetworkCompressionThreshold) {
+        u32 compressedLen = *dstSize - PACKET_CODEC_HEADER_SIZE;
+        if (packet_deflate(compressor, src, srcSize, dst + PACKET_CODEC_HEADER_SIZE, &compressedLen) && compressedLen < srcSize) {
+            dst[0] = compressor->codec;
+            *dstSize = compressedLen + PACKET_CODEC_HEADER_SIZE;
+            return true;
+        }
+    }
+
+    if (srcSize + PACKET_CODEC_HEADER_SIZE > *dstSize) { return false; }
+    dst[0] = PACKET_CODEC_RAW;
+    memcpy(dst + PACKET_CODEC_HEADER_SIZE, src, srcSize);
+    *dstSize = srcSize + PACKET_CODEC_HEADER_SIZE;
+    return true;
+}
+
+static bool packet_decompress_into(u8* src, u32 srcSize, u8* dst, u32* dstSize) {
+    if (srcSize <= PACKET_CODEC_HEADER_SIZE) { return false; }
+
+    u8* payload = src + PACKET_CODEC_HEADER_SIZE;
+    u32 payloadSize = srcSize - PACKET_CODEC_HEADER_SIZE;
+
+    switch (src[0]) {
+        case PACKET_CODEC_RAW:
+            if (payloadSize > *dstSize) { return false; }
+            memcpy(dst, payload, payloadSize);
+            *dstSize = payloadSize;
+            return true;
+        case PACKET_CODEC_DEFLATE:
+            return packet_inflate(payload, payloadSize, dst, dstSize);
+        default:
+            LOG_ERROR("unknown packet codec: %u", src[0]);
+            return false;
+    }
+}
+
+void packet_compress(struct Packet* p, u8** compBuffer, u32* compSize) {
+    u32 sourceSize = p->dataLength + sizeof(u32);
+    u32 compressedLen = PACKET_CODEC_BUFFER_LENGTH;
+
+#ifdef DEVELOPMENT
+    packet_capture(p->buffer, sourceSize);
+#endif
+
+    struct PacketCompressor* compressor = (configNetworkCompression < PACKET_COMPRESSION_MAX)
+                                        ? &sPacketCompressors[configNetworkCompression]
+                                        : NULL;
+
+    if (packet_compress_with(compressor, p->buffer, sourceSize, sCompBuffer, &compressedLen)) {
+        *compBuffer = sCompBuffer;
+        *compSize = compressedLen;
+    } else {
+        *compBuffer = NULL;
+        *compSize = 0;
+    }
+}
+
+bool packet_decompress(struct Packet* p, u8* compBuffer, u32 compSize) {
+    u32 decompSize = PACKET_LENGTH;
+    if (!packet_decompress_into(compBuffer, compSize, p->buffer, &decompSize)) { return false; }
+    if (decompSize < sizeof(u32)) { return false; }
+    p->dataLength = decompSize - sizeof(u32);
+    return true;
+}
+
+  ///////////
+ // bench //
+///////////
+
+#ifdef DEVELOPMENT
+
+#define PACKET_CAPTURE_MAX 256
+#define PACKET_BENCH_ITERATIONS 20
+
+struct PacketCapture {
+    u8* data;
+    u32 length;
+};
+
+static struct PacketCapture sPacketCaptures[PACKET_CAPTURE_MAX] = { 0 };
+static u32 sPacketCaptureIndex = 0;
+static u32 sPacketCaptureCount = 0;
+
+static void packet_capture(u8* data, u32 length) {
+    struct PacketCapture* capture = &sPacketCaptures[sPacketCaptureIndex];
+    capture->data = realloc(capture->data, length);
+    if (capture->data == NULL) { capture->length = 0; return; }
+    memcpy(capture->data, data, length);
+    capture->length = length;
+
+    sPacketCaptureIndex = (sPacketCaptureIndex + 1) % PACKET_CAPTURE_MAX;
+    if (sPacketCaptureCount < PACKET_CAPTURE_MAX) { sPacketCaptureCount++; }
+}
+
+static void packet_codec_bench_one(struct PacketCompressor* compressor, const char* name) {
+    static u8 sBenchComp[PACKET_CODEC_BUFFER_LENGTH];
+    static u8 sBenchDecomp[PACKET_LENGTH];
+
+    u64 inBytes = 0;
+    u64 outBytes = 0;
+    u32 packets = 0;
+    f64 compressTime = 0;
+    f64 decompressTime = 0;
+
+    for (u32 iter = 0; iter < PACKET_BENCH_ITERATIONS; iter++) {
+        for (u32 i = 0; i < sPacketCaptureCount; i++) {
+            struct PacketCapture* capture = &sPacketCaptures[i];
+            if (capture->data == NULL || capture->length == 0) { continue; }
+
+            u32 compSize = PACKET_CODEC_BUFFER_LENGTH;
+            f64 start = clock_elapsed_f64();
+            if (!packet_compress_with(compressor, capture->data, capture->length, sBenchComp, &compSize)) { continue; }
+            f64 mid = clock_elapsed_f64();
+
+            u32 decompSize = PACKET_LENGTH;
+            bool ok = packet_decompress_into(sBenchComp, compSize, sBenchDecomp, &decompSize);
+            f64 end = clock_elapsed_f64();
+
+            if (!ok || decompSize != capture->length || memcmp(sBenchDecomp, capture->data, decompSize)) {
+                dev_bench_report("%s: round trip mismatch!", name);
+                return;
+            }
+
+            compressTime += mid - start;
+            decompressTime += end - mid;
+            inBytes += capture->length;
+            outBytes += compSize;
+            packets++;
+        }
+    }
+
+    if (packets == 0) { return; }
+    dev_bench_report("%s: ratio %.3f, compress %.2fus, decompress %.2fus per packet",
+        name,
+        (f64)outBytes / (f64)inBytes,
+        compressTime * 1000000.0 / packets,
+        decompressTime * 1000000.0 / packets);
+}
+
+void packet_codec_bench(void) {
+    if (sPacketCaptureCount == 0) {
+        dev_bench_report("No packets captured yet, join or host a game first");
+        return;
+    }
+
+    dev_bench_report("Replaying %u captured packets, threshold %u bytes", sPacketCaptureCount, configNetworkCompressionThreshold);
+    packet_codec_bench_one(NULL, "raw");
+    for (s32 i = 0; i < PACKET_COMPRESSION_MAX; i++) {
+        packet_codec_bench_one(&sPacketCompressors[i], sPacketCompressors[i].name);
+    }
+}
+
+#endif
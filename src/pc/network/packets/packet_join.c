@@ -45,7 +45,7 @@ void network_send_join_request(void) {
     struct Packet p = { 0 };
     packet_init(&p, PACKET_JOIN_REQUEST, true, PLMT_NONE);
     char version[MAX_VERSION_LENGTH] = { 0 };
-    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version());
+    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version_online());
     packet_write(&p, &version, sizeof(u8) * MAX_VERSION_LENGTH);
 
     packet_write(&p, &configPlayerModel,   sizeof(u8));
@@ -107,8 +107,9 @@ void network_send_join(struct Packet* joinRequestPacket) {
     }
 
     char version[MAX_VERSION_LENGTH] = { 0 };
-    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version());
+    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version_online());
     LOG_INFO("sending version: %s", version);
+    u8 buildMaxPlayers = MAX_PLAYERS;
 
     struct Packet p = { 0 };
     packet_init(&p, PACKET_JOIN, true, PLMT_NONE);
@@ -124,6 +125,7 @@ void network_send_join(struct Packet* joinRequestPacket) {
     packet_write(&p, &gServerSettings.headlessServer, sizeof(u8));
     packet_write(&p, &gServerSettings.nametags, sizeof(u8));
     packet_write(&p, &gServerSettings.maxPlayers, sizeof(u8));
+    packet_write(&p, &buildMaxPlayers, sizeof(u8));
     packet_write(&p, &gServerSettings.pauseAnywhere, sizeof(u8));
     packet_write(&p, &gServerSettings.pvpType, sizeof(u8));
     packet_write(&p, eeprom, sizeof(u8) * 512);
@@ -143,11 +145,12 @@ void network_receive_join(struct Packet* p) {
     gOverrideEeprom = eeprom;
 
     char version[MAX_VERSION_LENGTH] = { 0 };
-    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version());
+    snprintf(version, MAX_VERSION_LENGTH, "%s", get_version_online());
     LOG_INFO("client has version: %s", version);
 
     char remoteVersion[MAX_VERSION_LENGTH] = { 0 };
     u8 myGlobalIndex = UNKNOWN_GLOBAL_INDEX;
+    u8 remoteMaxPlayers = 0;
 
     if (gNetworkPlayerLocal != NULL && gNetworkPlayerLocal->connected) {
         LOG_ERROR("Received join packet, but already in-game!");
@@ -177,10 +180,21 @@ void network_receive_join(struct Packet* p) {
     packet_read(p, &gServerSettings.headlessServer, sizeof(u8));
     packet_read(p, &gServerSettings.nametags, sizeof(u8));
     packet_read(p, &gServerSettings.maxPlayers, sizeof(u8));
+    packet_read(p, &remoteMaxPlayers, sizeof(u8));
     packet_read(p, &gServerSettings.pauseAnywhere, sizeof(u8));
     packet_read(p, &gServerSettings.pvpType, sizeof(u8));
     packet_read(p, eeprom, sizeof(u8) * 512);
 
+    // player bitmasks and sync table sequences are sized by the build's player cap, so both sides have to agree on it
+    if (remoteMaxPlayers != MAX_PLAYERS) {
+        network_shutdown(true, false, false, false);
+        LOG_ERROR("player cap mismatch");
+        char mismatchMessage[256] = { 0 };
+        snprintf(mismatchMessage, 256, "\\#ffa0a0\\Error:\\#dcdcdc\\ This lobby was built for up to \\#a0a0ff\\%d\\#dcdcdc\\ players, but this build is for \\#a0a0ff\\%d\\#dcdcdc\\.\n", remoteMaxPlayers, MAX_PLAYERS);
+        djui_panel_join_message_error(mismatchMessage);
+        return;
+    }
+
     network_player_connected(NPT_SERVER, 0, 0, &DEFAULT_MARIO_PALETTE, "Player", "0");
     network_player_connected(NPT_LOCAL, myGlobalIndex, configPlayerModel, &configPlayerPalette, configPlayerName, get_local_discord_id());
     djui_chat_box_create();
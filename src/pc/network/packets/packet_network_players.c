@@ -7,40 +7,50 @@
 #include "pc/configfile.h"
 #include "pc/network/moderator_list.h"
 
+#define NETWORK_PLAYERS_PER_PACKET 16
+
 static void network_send_to_network_players(u8 sendToLocalIndex) {
     SOFT_ASSERT(gNetworkType == NT_SERVER);
     SOFT_ASSERT(sendToLocalIndex != 0);
 
-    u8 connectedCount = network_player_connected_count();
+    // the list is split up so that large lobbies still fit within PACKET_LENGTH
+    NetworkPlayerMask mask = gNetworkPlayersConnected;
+    while (mask) {
+        u8 indices[NETWORK_PLAYERS_PER_PACKET] = { 0 };
+        u8 connectedCount = 0;
+        while (mask && connectedCount < NETWORK_PLAYERS_PER_PACKET) {
+            indices[connectedCount++] = network_player_mask_pop(&mask);
+        }
 
-    struct Packet p = { 0 };
-    packet_init(&p, PACKET_NETWORK_PLAYERS, true, PLMT_NONE);
-    packet_write(&p, &connectedCount, sizeof(u8));
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        if (!gNetworkPlayers[i].connected) { continue; }
-        u8 npType = gNetworkPlayers[i].type;
-        if (npType == NPT_LOCAL) { npType = NPT_SERVER; }
-        else if (i == sendToLocalIndex) { npType = NPT_LOCAL; }
-        s64 networkId = gNetworkSystem->get_id(i);
-        packet_write(&p, &npType,                                sizeof(u8));
-        packet_write(&p, &gNetworkPlayers[i].globalIndex,        sizeof(u8));
-        packet_write(&p, &gNetworkPlayers[i].currLevelAreaSeqId, sizeof(u16));
-        packet_write(&p, &gNetworkPlayers[i].currCourseNum,      sizeof(s16));
-        packet_write(&p, &gNetworkPlayers[i].currActNum,         sizeof(s16));
-        packet_write(&p, &gNetworkPlayers[i].currLevelNum,       sizeof(s16));
-        packet_write(&p, &gNetworkPlayers[i].currAreaIndex,      sizeof(s16));
-        packet_write(&p, &gNetworkPlayers[i].currLevelSyncValid, sizeof(u8));
-        packet_write(&p, &gNetworkPlayers[i].currAreaSyncValid,  sizeof(u8));
-        packet_write(&p, &networkId,                             sizeof(s64));
-        packet_write(&p, &gNetworkPlayers[i].modelIndex,         sizeof(u8));
-        packet_write(&p, &gNetworkPlayers[i].palette,            sizeof(struct PlayerPalette));
-        packet_write(&p, &gNetworkPlayers[i].name,               sizeof(u8) * MAX_CONFIG_STRING);
-        packet_write(&p, &gNetworkPlayers[i].discordId,          sizeof(u8) * 64);
-        LOG_INFO("send network player [%d == %d]", gNetworkPlayers[i].globalIndex, npType);
-    }
+        struct Packet p = { 0 };
+        packet_init(&p, PACKET_NETWORK_PLAYERS, true, PLMT_NONE);
+        packet_write(&p, &connectedCount, sizeof(u8));
+        for (u8 j = 0; j < connectedCount; j++) {
+            u8 i = indices[j];
+            u8 npType = gNetworkPlayers[i].type;
+            if (npType == NPT_LOCAL) { npType = NPT_SERVER; }
+            else if (i == sendToLocalIndex) { npType = NPT_LOCAL; }
+            s64 networkId = gNetworkSystem->get_id(i);
+            packet_write(&p, &npType,                                sizeof(u8));
+            packet_write(&p, &gNetworkPlayers[i].globalIndex,        sizeof(u8));
+            packet_write(&p, &gNetworkPlayers[i].currLevelAreaSeqId, sizeof(u16));
+            packet_write(&p, &gNetworkPlayers[i].currCourseNum,      sizeof(s16));
+            packet_write(&p, &gNetworkPlayers[i].currActNum,         sizeof(s16));
+            packet_write(&p, &gNetworkPlayers[i].currLevelNum,       sizeof(s16));
+            packet_write(&p, &gNetworkPlayers[i].currAreaIndex,      sizeof(s16));
+            packet_write(&p, &gNetworkPlayers[i].currLevelSyncValid, sizeof(u8));
+            packet_write(&p, &gNetworkPlayers[i].currAreaSyncValid,  sizeof(u8));
+            packet_write(&p, &networkId,                             sizeof(s64));
+            packet_write(&p, &gNetworkPlayers[i].modelIndex,         sizeof(u8));
+            packet_write(&p, &gNetworkPlayers[i].palette,            sizeof(struct PlayerPalette));
+            packet_write(&p, &gNetworkPlayers[i].name,               sizeof(u8) * MAX_CONFIG_STRING);
+            packet_write(&p, &gNetworkPlayers[i].discordId,          sizeof(u8) * 64);
+            LOG_INFO("send network player [%d == %d]", gNetworkPlayers[i].globalIndex, npType);
+        }
 
-    network_send_to(sendToLocalIndex, &p);
-    LOG_INFO("sent list of %d network players to %d", connectedCount, sendToLocalIndex);
+        network_send_to(sendToLocalIndex, &p);
+        LOG_INFO("sent list of %d network players to %d", connectedCount, sendToLocalIndex);
+    }
 }
 
 void network_send_network_players_request(void) {
@@ -69,8 +79,9 @@ void network_receive_network_players_request(struct Packet* p) {
 void network_send_network_players(u8 exceptLocalIndex) {
     SOFT_ASSERT(gNetworkType == NT_SERVER);
     LOG_INFO("sending list of network players to all");
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        if (!gNetworkPlayers[i].connected) { continue; }
+    NetworkPlayerMask mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        u8 i = network_player_mask_pop(&mask);
         if (i == exceptLocalIndex) { continue; }
         network_send_to_network_players(i);
     }
@@ -13,6 +13,7 @@
 #include "pc/lua/smlua_hooks.h"
 #include "pc/debuglog.h"
 #include "pc/utils/misc.h"
+#include "pc/network/interest_grid.h"
 
 struct DelayedPacketObject {
     struct Packet p;
@@ -268,7 +269,9 @@ static void packet_read_object_only_death(struct Packet* p, struct Object* o) {
 
 // ----- main send/receive ----- //
 
-void network_send_object(struct Object* o) {
+static void network_send_object_to(struct Object* o, bool reliable, NetworkPlayerMask mask);
+
+static void network_send_object_masked(struct Object* o, NetworkPlayerMask mask) {
     if (gNetworkType == NT_NONE || gNetworkPlayerLocal == NULL) { return; }
 
     // sanity check SyncObject
@@ -293,11 +296,20 @@ void network_send_object(struct Object* o) {
         return;
     }
 
+    // events always go out to everyone
     bool reliable = (o->activeFlags == ACTIVE_FLAG_DEACTIVATED || so->maxSyncDistance == SYNC_DISTANCE_ONLY_EVENTS);
-    network_send_object_reliability(o, reliable);
+    network_send_object_to(o, reliable, reliable ? gNetworkPlayersConnected : mask);
+}
+
+void network_send_object(struct Object* o) {
+    network_send_object_masked(o, gNetworkPlayersConnected);
 }
 
 void network_send_object_reliability(struct Object* o, bool reliable) {
+    network_send_object_to(o, reliable, gNetworkPlayersConnected);
+}
+
+static void network_send_object_to(struct Object* o, bool reliable, NetworkPlayerMask mask) {
     // don't send sync objects while area sync is invalid
     if (gNetworkPlayerLocal == NULL || !gNetworkPlayerLocal->currAreaSyncValid) {
         return;
@@ -358,7 +370,8 @@ void network_send_object_reliability(struct Object* o, bool reliable) {
     }
 
     // send the packet out
-    network_send(&p);
+    network_send_mask(&p, mask);
+    if (!reliable) { interest_grid_charge(so, mask & ~NETWORK_PLAYER_BIT(0), p.dataLength); }
 
     // trigger on_sent_post callback
     if (so->on_sent_post != NULL) {
@@ -450,6 +463,33 @@ void network_receive_object(struct Packet* p) {
 
 }
 
+NetworkPlayerMask network_object_relay_mask(struct Packet* p) {
+    if (p->reliable || !p->levelAreaMustMatch) { return gNetworkPlayersConnected; }
+
+    // the server only knows where everyone is when it's in the same area
+    extern s16 gCurrCourseNum, gCurrActStarNum, gCurrLevelNum, gCurrAreaIndex;
+    if (gNetworkPlayerLocal == NULL || !gNetworkPlayerLocal->currAreaSyncValid) { return gNetworkPlayersConnected; }
+    if (p->courseNum != gCurrCourseNum || p->actNum != gCurrActStarNum || p->levelNum != gCurrLevelNum || p->areaIndex != gCurrAreaIndex) {
+        return gNetworkPlayersConnected;
+    }
+
+    // peek at the sync id
+    u16 cursor = p->cursor;
+    u8 fromGlobalIndex = 0;
+    u32 syncId = 0;
+    packet_read(p, &fromGlobalIndex, sizeof(u8));
+    packet_read(p, &syncId, sizeof(u32));
+    p->cursor = cursor;
+
+    struct SyncObject* so = sync_object_get(syncId);
+    if (so == NULL || so->o == NULL || so->o->oSyncID != syncId) { return gNetworkPlayersConnected; }
+
+    // the sender already throttled the rate, only filter on distance and budget
+    NetworkPlayerMask mask = interest_grid_nearby(so, gNetworkPlayersConnected);
+    interest_grid_charge(so, mask, p->dataLength);
+    return mask;
+}
+
 void network_update_objects(void) {
     if (gNetworkAreaLoaded && delayedPacketObjectHead != NULL) {
         network_delayed_packet_object_execute();
@@ -488,24 +528,15 @@ void network_update_objects(void) {
             continue;
         }
 
-        // calculate the update rate
-        float dist = player_distance(&gMarioStates[0], so->o);
-        if (so->maxSyncDistance != SYNC_DISTANCE_INFINITE && dist > so->maxSyncDistance) { continue; }
-        float updateRate = dist / 1000.0f;
-        if (gMarioStates[0].heldObj == so->o) { updateRate = 0.33f; }
-
-        // set max and min update rate
-        if (so->maxUpdateRate > 0 && updateRate < so->maxUpdateRate) { updateRate = so->maxUpdateRate; }
-        if (updateRate < so->minUpdateRate) { updateRate = so->minUpdateRate; }
-
-        // see if we should update
-        float timeSinceUpdate = (clock_elapsed() - so->clockSinceUpdate);
-        if (timeSinceUpdate < updateRate) { continue; }
+        // figure out which peers are near enough, and which of them are due an update
+        NetworkPlayerMask nearby = interest_grid_nearby(so, gNetworkPlayersConnected);
+        NetworkPlayerMask due = interest_grid_due(so, nearby);
+        if (due == 0) { continue; }
 
         // update!
         bool inCredits = (gCurrActStarNum == 99);
         if (network_player_any_connected() && !inCredits) {
-            network_send_object(so->o);
+            network_send_object_masked(so->o, due);
         }
     }
 
@@ -16,6 +16,8 @@
 #include "pc/djui/djui.h"
 #include "pc/djui/djui_language.h"
 #include "pc/debuglog.h"
+#include "pc/debug_context.h"
+#include "pc/utils/misc.h"
 
 #pragma pack(1)
 struct PacketPlayerData {
@@ -80,6 +82,43 @@ struct PacketPlayerData {
 };
 #pragma pack()
 
+// Player packets are delta encoded per link against the last snapshot the
+// receiving peer acknowledged. Snapshot id 0 means "no baseline" (full).
+#define PLAYER_SNAPSHOT_HISTORY 32
+#define PLAYER_SNAPSHOT_NONE 0
+#define PLAYER_SNAPSHOT_WORDS ((sizeof(struct PacketPlayerData) + sizeof(u32) - 1) / sizeof(u32))
+#define PLAYER_SNAPSHOT_MASK_BYTES ((PLAYER_SNAPSHOT_WORDS + 7) / 8)
+#define PLAYER_ACK_INTERVAL 3
+
+struct PlayerSnapshot {
+    u16 id;
+    u32 words[PLAYER_SNAPSHOT_WORDS];
+};
+
+struct PlayerSnapshotsTx {
+    u16 nextId;
+    u16 ackedId[MAX_PLAYERS];
+    struct PlayerSnapshot history[PLAYER_SNAPSHOT_HISTORY];
+};
+
+struct PlayerSnapshotsRx {
+    u8 ackLocalIndex;
+    u16 pendingAckId;
+    struct PlayerSnapshot history[PLAYER_SNAPSHOT_HISTORY];
+};
+
+struct PlayerBandwidth {
+    u32 rawBytes;
+    u32 sentBytes;
+    u32 rawBytesPerSecond;
+    u32 sentBytesPerSecond;
+};
+
+static struct PlayerSnapshotsTx sSnapshotsTx[MAX_PLAYERS] = { 0 };
+static struct PlayerSnapshotsRx sSnapshotsRx[MAX_PLAYERS] = { 0 };
+static struct PlayerBandwidth sBandwidth[MAX_PLAYERS] = { 0 };
+static f32 sBandwidthTime = 0;
+
 static void read_packet_data(struct PacketPlayerData* data, struct MarioState* m) {
     u32 heldSyncID     = (m->heldObj != NULL)            ? m->heldObj->oSyncID            : 0;
     u32 heldBySyncID   = (m->heldByObj != NULL)          ? m->heldByObj->oSyncID          : 0;
@@ -218,6 +257,241 @@ static void write_packet_data(struct PacketPlayerData* data, struct MarioState*
     m->dialogId = data->dialogId;
 }
 
+  ///////////////
+ // snapshots //
+///////////////
+
+void network_player_snapshots_clear(u8 localIndex) {
+    if (localIndex >= MAX_PLAYERS) { return; }
+    memset(&sSnapshotsTx[localIndex], 0, sizeof(struct PlayerSnapshotsTx));
+    memset(&sSnapshotsRx[localIndex], 0, sizeof(struct PlayerSnapshotsRx));
+    memset(&sBandwidth[localIndex], 0, sizeof(struct PlayerBandwidth));
+    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+        sSnapshotsTx[i].ackedId[localIndex] = PLAYER_SNAPSHOT_NONE;
+    }
+}
+
+void network_player_snapshots_clear_all(void) {
+    memset(sSnapshotsTx, 0, sizeof(sSnapshotsTx));
+    memset(sSnapshotsRx, 0, sizeof(sSnapshotsRx));
+    memset(sBandwidth, 0, sizeof(sBandwidth));
+}
+
+void network_player_get_bandwidth(u8 localIndex, u32* rawBytesPerSecond, u32* sentBytesPerSecond) {
+    if (localIndex >= MAX_PLAYERS) {
+        *rawBytesPerSecond = 0;
+        *sentBytesPerSecond = 0;
+        return;
+    }
+    *rawBytesPerSecond = sBandwidth[localIndex].rawBytesPerSecond;
+    *sentBytesPerSecond = sBandwidth[localIndex].sentBytesPerSecond;
+}
+
+static void snapshot_push(u8 subjectLocalIndex, struct PacketPlayerData* data) {
+    struct PlayerSnapshotsTx* tx = &sSnapshotsTx[subjectLocalIndex];
+    if (++tx->nextId == PLAYER_SNAPSHOT_NONE) { tx->nextId++; }
+
+    struct PlayerSnapshot* snapshot = &tx->history[tx->nextId % PLAYER_SNAPSHOT_HISTORY];
+    snapshot->id = tx->nextId;
+    memset(snapshot->words, 0, sizeof(snapshot->words));
+    memcpy(snapshot->words, data, sizeof(struct PacketPlayerData));
+}
+
+static void snapshot_write(struct Packet* p, u8 subjectLocalIndex, u8 toLocalIndex) {
+    struct PlayerSnapshotsTx* tx = &sSnapshotsTx[subjectLocalIndex];
+    struct PlayerSnapshot* current = &tx->history[tx->nextId % PLAYER_SNAPSHOT_HISTORY];
+    u16 startLength = p->dataLength;
+
+    // only delta against a baseline the peer acknowledged that we still remember
+    u16 baselineId = tx->ackedId[toLocalIndex];
+    struct PlayerSnapshot* baseline = &tx->history[baselineId % PLAYER_SNAPSHOT_HISTORY];
+    if (baselineId == PLAYER_SNAPSHOT_NONE || baseline->id != baselineId || baselineId == current->id) {
+        baselineId = PLAYER_SNAPSHOT_NONE;
+    }
+
+    packet_write(p, &current->id, sizeof(u16));
+    packet_write(p, &baselineId, sizeof(u16));
+
+    if (baselineId == PLAYER_SNAPSHOT_NONE) {
+        // full resync
+        packet_write(p, current->words, sizeof(struct PacketPlayerData));
+    } else {
+        // changed words only
+        u8 mask[PLAYER_SNAPSHOT_MASK_BYTES] = { 0 };
+        for (u32 i = 0; i < PLAYER_SNAPSHOT_WORDS; i++) {
+            if (current->words[i] != baseline->words[i]) {
+                mask[i / 8] |= (1 << (i % 8));
+            }
+        }
+        packet_write(p, mask, PLAYER_SNAPSHOT_MASK_BYTES);
+        for (u32 i = 0; i < PLAYER_SNAPSHOT_WORDS; i++) {
+            if (mask[i / 8] & (1 << (i % 8))) {
+                packet_write(p, &current->words[i], sizeof(u32));
+            }
+        }
+    }
+
+    if (toLocalIndex < MAX_PLAYERS) {
+        sBandwidth[toLocalIndex].rawBytes  += sizeof(struct PacketPlayerData);
+        sBandwidth[toLocalIndex].sentBytes += p->dataLength - startLength;
+    }
+}
+
+static bool snapshot_read(struct Packet* p, u8 subjectLocalIndex, struct PacketPlayerData* data) {
+    struct PlayerSnapshotsRx* rx = &sSnapshotsRx[subjectLocalIndex];
+
+    u16 id = PLAYER_SNAPSHOT_NONE;
+    u16 baselineId = PLAYER_SNAPSHOT_NONE;
+    packet_read(p, &id, sizeof(u16));
+    packet_read(p, &baselineId, sizeof(u16));
+    if (p->error || id == PLAYER_SNAPSHOT_NONE) { return false; }
+
+    struct PlayerSnapshot snapshot = { .id = id };
+    if (baselineId == PLAYER_SNAPSHOT_NONE) {
+        packet_read(p, snapshot.words, sizeof(struct PacketPlayerData));
+    } else {
+        // we no longer have the baseline, wait for a full resync
+        struct PlayerSnapshot* baseline = &rx->history[baselineId % PLAYER_SNAPSHOT_HISTORY];
+        if (baseline->id != baselineId) { return false; }
+        memcpy(snapshot.words, baseline->words, sizeof(snapshot.words));
+
+        u8 mask[PLAYER_SNAPSHOT_MASK_BYTES] = { 0 };
+        packet_read(p, mask, PLAYER_SNAPSHOT_MASK_BYTES);
+        for (u32 i = 0; i < PLAYER_SNAPSHOT_WORDS; i++) {
+            if (mask[i / 8] & (1 << (i % 8))) {
+                packet_read(p, &snapshot.words[i], sizeof(u32));
+            }
+        }
+    }
+    if (p->error) { return false; }
+
+    rx->history[id % PLAYER_SNAPSHOT_HISTORY] = snapshot;
+    rx->pendingAckId = id;
+    rx->ackLocalIndex = p->localIndex;
+
+    memcpy(data, snapshot.words, sizeof(struct PacketPlayerData));
+    return true;
+}
+
+static void snapshot_send(u8 subjectLocalIndex, struct Packet* header, u8 exceptLocalIndex) {
+    u8 globalIndex = gNetworkPlayers[subjectLocalIndex].globalIndex;
+
+    if (gNetworkType != NT_SERVER) {
+        header->requestBroadcast = TRUE;
+        if (gNetworkSystem != NULL && gNetworkSystem->requireServerBroadcast && gNetworkPlayerServer != NULL) {
+            u8 serverLocalIndex = gNetworkPlayerServer->localIndex;
+            struct Packet p = { 0 };
+            packet_duplicate(header, &p);
+            packet_write(&p, &globalIndex, sizeof(u8));
+            snapshot_write(&p, subjectLocalIndex, serverLocalIndex);
+            p.localIndex = serverLocalIndex;
+            network_send_to(serverLocalIndex, &p);
+            return;
+        }
+    }
+
+    for (s32 i = 1; i < MAX_PLAYERS; i++) {
+        struct NetworkPlayer* np = &gNetworkPlayers[i];
+        if (!np->connected) { continue; }
+        if (i == exceptLocalIndex || i == subjectLocalIndex) { continue; }
+
+        // don't send a packet to a player that can't receive it
+        if (header->courseNum != np->currCourseNum) { continue; }
+        if (header->actNum    != np->currActNum)    { continue; }
+        if (header->levelNum  != np->currLevelNum)  { continue; }
+        if (header->areaIndex != np->currAreaIndex) { continue; }
+
+        struct Packet p = { 0 };
+        packet_duplicate(header, &p);
+        packet_write(&p, &globalIndex, sizeof(u8));
+        snapshot_write(&p, subjectLocalIndex, i);
+        p.localIndex = i;
+        network_send_to(i, &p);
+    }
+}
+
+static void network_update_player_acks(void) {
+    static u8 sTicksSinceAck = 0;
+    if (++sTicksSinceAck < PLAYER_ACK_INTERVAL) { return; }
+    sTicksSinceAck = 0;
+
+    // batch acknowledgements per link
+    for (s32 link = 1; link < MAX_PLAYERS; link++) {
+        if (!gNetworkPlayers[link].connected) { continue; }
+
+        struct Packet p = { 0 };
+        packet_init(&p, PACKET_PLAYER_ACK, false, PLMT_NONE);
+        u8 count = 0;
+        u16 countCursor = p.dataLength;
+        packet_write(&p, &count, sizeof(u8));
+
+        for (s32 i = 1; i < MAX_PLAYERS; i++) {
+            struct PlayerSnapshotsRx* rx = &sSnapshotsRx[i];
+            if (rx->pendingAckId == PLAYER_SNAPSHOT_NONE || rx->ackLocalIndex != link) { continue; }
+            if (!gNetworkPlayers[i].connected) { continue; }
+            packet_write(&p, &gNetworkPlayers[i].globalIndex, sizeof(u8));
+            packet_write(&p, &rx->pendingAckId, sizeof(u16));
+            rx->pendingAckId = PLAYER_SNAPSHOT_NONE;
+            count++;
+        }
+
+        if (count == 0) { continue; }
+        p.buffer[countCursor] = count;
+        network_send_to(link, &p);
+    }
+}
+
+void network_receive_player_ack(struct Packet* p) {
+    if (p->localIndex == 0 || p->localIndex >= MAX_PLAYERS) { return; }
+
+    u8 count = 0;
+    packet_read(p, &count, sizeof(u8));
+    for (u8 i = 0; i < count; i++) {
+        u8 globalIndex = 0;
+        u16 id = PLAYER_SNAPSHOT_NONE;
+        packet_read(p, &globalIndex, sizeof(u8));
+        packet_read(p, &id, sizeof(u16));
+        if (p->error) { return; }
+
+        struct NetworkPlayer* np = network_player_from_global_index(globalIndex);
+        if (np == NULL || np->localIndex >= MAX_PLAYERS) { continue; }
+
+        // acks can arrive out of order, only move forward
+        u16* ackedId = &sSnapshotsTx[np->localIndex].ackedId[p->localIndex];
+        if (*ackedId == PLAYER_SNAPSHOT_NONE || (s16)(id - *ackedId) > 0) {
+            *ackedId = id;
+        }
+    }
+}
+
+static void network_update_player_bandwidth(void) {
+    f32 currentTime = clock_elapsed();
+    if ((currentTime - sBandwidthTime) >= 1.0f) {
+        f32 elapsed = currentTime - sBandwidthTime;
+        for (s32 i = 0; i < MAX_PLAYERS; i++) {
+            struct PlayerBandwidth* bw = &sBandwidth[i];
+            bw->rawBytesPerSecond  = (sBandwidthTime > 0) ? (u32)(bw->rawBytes / elapsed)  : 0;
+            bw->sentBytesPerSecond = (sBandwidthTime > 0) ? (u32)(bw->sentBytes / elapsed) : 0;
+            bw->rawBytes = 0;
+            bw->sentBytes = 0;
+        }
+        sBandwidthTime = currentTime;
+    }
+
+    s64 rawBytesPerSecond = 0;
+    s64 sentBytesPerSecond = 0;
+    for (s32 i = 0; i < MAX_PLAYERS; i++) {
+        rawBytesPerSecond  += sBandwidth[i].rawBytesPerSecond;
+        sentBytesPerSecond += sBandwidth[i].sentBytesPerSecond;
+    }
+    CTR_SET(CTR_NET_PLAYER_RAW_BPS, rawBytesPerSecond);
+    CTR_SET(CTR_NET_PLAYER_TX_BPS, sentBytesPerSecond);
+}
+
+  /////////////
+ // packets //
+/////////////
+
 void network_send_player(u8 localIndex) {
     if (gMarioStates[localIndex].marioObj == NULL) { return; }
     if (gDjuiInMainMenu) { return; }
@@ -225,12 +499,31 @@ void network_send_player(u8 localIndex) {
 
     struct PacketPlayerData data = { 0 };
     read_packet_data(&data, &gMarioStates[localIndex]);
+    snapshot_push(localIndex, &data);
+
+    struct Packet header = { 0 };
+    packet_init(&header, PACKET_PLAYER, false, PLMT_AREA);
+    snapshot_send(localIndex, &header, UNKNOWN_LOCAL_INDEX);
+}
+
+void network_relay_player(struct Packet* p) {
+    // player packets are delta encoded per link, so they must be re-encoded for each peer
+    u16 headerLength = p->cursor;
+
+    u8 globalIndex = 0;
+    packet_read(p, &globalIndex, sizeof(u8));
+    struct NetworkPlayer* np = network_player_from_global_index(globalIndex);
+    if (np == NULL || np->localIndex == UNKNOWN_LOCAL_INDEX || np->localIndex == 0 || !np->connected) { return; }
 
-    struct Packet p = { 0 };
-    packet_init(&p, PACKET_PLAYER, false, PLMT_AREA);
-    packet_write(&p, &gNetworkPlayers[localIndex].globalIndex, sizeof(u8));
-    packet_write(&p, &data, sizeof(struct PacketPlayerData));
-    network_send(&p);
+    struct PacketPlayerData data = { 0 };
+    if (!snapshot_read(p, np->localIndex, &data)) { return; }
+    snapshot_push(np->localIndex, &data);
+
+    struct Packet header = { 0 };
+    packet_duplicate(p, &header);
+    header.dataLength = headerLength;
+    header.cursor = headerLength;
+    snapshot_send(np->localIndex, &header, p->localIndex);
 }
 
 void network_receive_player(struct Packet* p) {
@@ -242,10 +535,14 @@ void network_receive_player(struct Packet* p) {
     // prevent receiving a packet about our player
     if (gNetworkPlayerLocal && globalIndex == gNetworkPlayerLocal->globalIndex) { return; }
 
+    // load mario information from packet
+    struct PacketPlayerData data = { 0 };
+    if (!snapshot_read(p, np->localIndex, &data)) { return; }
+
     struct MarioState* m = &gMarioStates[np->localIndex];
     if (m == NULL || m->marioObj == NULL) { return; }
 
-    if (gNetworkType == NT_SERVER && *((u32*)(p->buffer + p->cursor + offsetof(struct PacketPlayerData, action))) == ACT_DEBUG_FREE_MOVE) {
+    if (gNetworkType == NT_SERVER && data.action == ACT_DEBUG_FREE_MOVE) {
 #ifdef DEVELOPMENT
         if (m->action != ACT_DEBUG_FREE_MOVE) {
             construct_player_popup(np, DLANG(NOTIF, DEBUG_FLY), NULL);
@@ -271,10 +568,6 @@ void network_receive_player(struct Packet* p) {
     u16 playerIndex  = np->localIndex;
     u32 oldBehParams = m->marioObj->oBehParams;
 
-    // load mario information from packet
-    struct PacketPlayerData data = { 0 };
-    packet_read(p, &data, sizeof(struct PacketPlayerData));
-
     // check to see if we should just drop this packet
     if (oldData.action == ACT_JUMBO_STAR_CUTSCENE && data.action == ACT_JUMBO_STAR_CUTSCENE) {
         return;
@@ -416,7 +709,10 @@ void network_receive_player(struct Packet* p) {
 }
 
 void network_update_player(void) {
+    network_update_player_bandwidth();
     if (!network_player_any_connected()) { return; }
+    network_update_player_acks();
+
     struct MarioState* m = &gMarioStates[0];
 
     u8 localIsHeadless = (&gNetworkPlayers[0] == gNetworkPlayerServer && gServerSettings.headlessServer);
@@ -81,15 +81,23 @@ void network_receive_ack(struct Packet* p) {
     u16 seqId = 0;
     packet_read(p, &seqId, sizeof(u16));
 
-    // find in list and remove
+    // find in list and remove, broadcasts share a seqId so prefer the node for this peer
+    struct PacketLinkedList* match = NULL;
     struct PacketLinkedList* node = head;
     while (node != NULL) {
         if (node->p.seqId == seqId) {
-            remove_node_from_list(node);
-            break;
+            if (node->p.localIndex == p->localIndex) {
+                match = node;
+                break;
+            }
+            bool unknownPeer = (node->p.localIndex == 0 || p->localIndex == 0 || p->localIndex == UNKNOWN_LOCAL_INDEX);
+            if (match == NULL && unknownPeer) { match = node; }
         }
         node = node->next;
     }
+    if (match != NULL) {
+        remove_node_from_list(match);
+    }
 }
 
 void network_remember_reliable(struct Packet* p) {
@@ -4,8 +4,21 @@
 #include "pc/debuglog.h"
 #include "pc/djui/djui.h"
 
+#define SOCKET_ADDR_TABLE_SIZE 128 // must be a power of two larger than MAX_PLAYERS
+#define SOCKET_DATAGRAM_LENGTH (PACKET_LENGTH + 1)
+
 static SOCKET sCurSocket = INVALID_SOCKET;
 static struct sockaddr_in6 sAddr[MAX_PLAYERS] = { 0 };
+static u8 sAddrTable[SOCKET_ADDR_TABLE_SIZE] = { 0 };
+
+#ifdef SOCKET_BATCHED_IO
+static struct SocketDatagram sSendQueue[SOCKET_BATCH_MAX] = { 0 };
+static u8 sSendQueueData[SOCKET_BATCH_MAX][SOCKET_DATAGRAM_LENGTH] = { 0 };
+static u32 sSendQueueCount = 0;
+
+static struct SocketDatagram sReceiveBatch[SOCKET_BATCH_MAX] = { 0 };
+static u8 sReceiveBatchData[SOCKET_BATCH_MAX][SOCKET_DATAGRAM_LENGTH] = { 0 };
+#endif
 struct addrinfo hints;
 struct addrinfo *result, *i;
 
@@ -97,6 +110,45 @@ static int socket_bind(SOCKET socket, unsigned int port) {
     return rc;
 }
 
+  ////////////////
+ // addr table //
+////////////////
+
+static u32 socket_addr_hash(struct sockaddr_in6* addr) {
+    // FNV-1a over the port and address, the only parts that vary between peers
+    u32 hash = 2166136261u;
+    u8* port = (u8*)&addr->sin6_port;
+    for (u32 i = 0; i < sizeof(addr->sin6_port); i++) { hash = (hash ^ port[i]) * 16777619u; }
+    u8* ip = (u8*)&addr->sin6_addr;
+    for (u32 i = 0; i < sizeof(addr->sin6_addr); i++) { hash = (hash ^ ip[i]) * 16777619u; }
+    return hash;
+}
+
+static void socket_addr_table_rebuild(void) {
+    static const struct sockaddr_in6 sEmptyAddr = { 0 };
+    memset(sAddrTable, 0, sizeof(sAddrTable));
+    for (u8 i = 1; i < MAX_PLAYERS; i++) {
+        if (!memcmp(&sAddr[i], &sEmptyAddr, sizeof(struct sockaddr_in6))) { continue; }
+        u32 slot = socket_addr_hash(&sAddr[i]) & (SOCKET_ADDR_TABLE_SIZE - 1);
+        while (sAddrTable[slot] != 0) { slot = (slot + 1) & (SOCKET_ADDR_TABLE_SIZE - 1); }
+        sAddrTable[slot] = i;
+    }
+}
+
+static u8 socket_addr_lookup(struct sockaddr_in6* addr) {
+    u32 slot = socket_addr_hash(addr) & (SOCKET_ADDR_TABLE_SIZE - 1);
+    while (sAddrTable[slot] != 0) {
+        u8 localIndex = sAddrTable[slot];
+        if (!memcmp(addr, &sAddr[localIndex], sizeof(struct sockaddr_in6))) { return localIndex; }
+        slot = (slot + 1) & (SOCKET_ADDR_TABLE_SIZE - 1);
+    }
+    return UNKNOWN_LOCAL_INDEX;
+}
+
+  ////////////
+ // socket //
+////////////
+
 static int socket_send(SOCKET socket, struct sockaddr_in6* addr, u8* buffer, u16 bufferLength) {
     int addrSize = sizeof(struct sockaddr_in6);
     int rc = sendto(socket, (char*)buffer, bufferLength, 0, (struct sockaddr*)addr, addrSize);
@@ -109,18 +161,13 @@ static int socket_send(SOCKET socket, struct sockaddr_in6* addr, u8* buffer, u16
     return rc;
 }
 
+#ifndef SOCKET_BATCHED_IO
 static int socket_receive(SOCKET socket, struct sockaddr_in6* rxAddr, u8* buffer, u16 bufferLength, u16* receiveLength, u8* localIndex) {
     *receiveLength = 0;
 
     RX_ADDR_SIZE_TYPE rxAddrSize = sizeof(struct sockaddr_in6);
     int rc = recvfrom(socket, (char*)buffer, bufferLength, 0, (struct sockaddr*)rxAddr, &rxAddrSize);
-
-    for (int i = 1; i < MAX_PLAYERS; i++) {
-        if (memcmp(rxAddr, &sAddr[i], sizeof(struct sockaddr_in6)) == 0) {
-            *localIndex = i;
-            break;
-        }
-    }
+    *localIndex = socket_addr_lookup(rxAddr);
 
     if (rc == SOCKET_ERROR) {
         int error = SOCKET_LAST_ERROR;
@@ -133,6 +180,7 @@ static int socket_receive(SOCKET socket, struct sockaddr_in6* rxAddr, u8* buffer
     *receiveLength = rc;
     return NO_ERROR;
 }
+#endif
 
 static bool ns_socket_initialize(enum NetworkType networkType, UNUSED bool reconnecting) {
     // sanity check port
@@ -209,6 +257,7 @@ static void ns_socket_save_id(u8 localId, UNUSED s64 networkId) {
     SOFT_ASSERT(localId > 0);
     SOFT_ASSERT(localId < MAX_PLAYERS);
     sAddr[localId] = sAddr[0];
+    socket_addr_table_rebuild();
     LOG_INFO("saved addr for id %d", localId);
 }
 
@@ -216,6 +265,7 @@ static void ns_socket_clear_id(u8 localId) {
     if (localId == 0) { return; }
     SOFT_ASSERT(localId < MAX_PLAYERS);
     memset(&sAddr[localId], 0, sizeof(struct sockaddr_in6));
+    socket_addr_table_rebuild();
     LOG_INFO("cleared addr for id %d", localId);
 }
 
@@ -229,8 +279,40 @@ static bool ns_socket_match_addr(void* addr1, void* addr2) {
     return !memcmp(addr1, addr2, sizeof(struct sockaddr_in6));
 }
 
+#ifdef SOCKET_BATCHED_IO
+static void ns_socket_flush(void) {
+    if (sSendQueueCount == 0) { return; }
+    if (sCurSocket != INVALID_SOCKET) {
+        socket_send_batch(sCurSocket, sSendQueue, sSendQueueCount);
+    }
+    sSendQueueCount = 0;
+}
+#endif
+
 static void ns_socket_update(void) {
     if (gNetworkType == NT_NONE) { return; }
+#ifdef SOCKET_BATCHED_IO
+    // drain every pending datagram, one syscall per batch
+    do {
+        for (u32 i = 0; i < SOCKET_BATCH_MAX; i++) {
+            sReceiveBatch[i].data = sReceiveBatchData[i];
+        }
+        int count = socket_receive_batch(sCurSocket, sReceiveBatch, SOCKET_BATCH_MAX, SOCKET_DATAGRAM_LENGTH);
+        if (count <= 0) { break; }
+
+        for (int i = 0; i < count; i++) {
+            struct SocketDatagram* datagram = &sReceiveBatch[i];
+            if (datagram->length >= PACKET_LENGTH) {
+                LOG_ERROR("dropping oversized datagram: %u", datagram->length);
+                continue;
+            }
+            sAddr[0] = datagram->addr;
+            network_receive(socket_addr_lookup(&datagram->addr), &sAddr[0], datagram->data, datagram->length);
+        }
+
+        if (count < SOCKET_BATCH_MAX) { break; }
+    } while (sCurSocket != INVALID_SOCKET);
+#else
     do {
         // receive packet
         u8 data[PACKET_LENGTH + 1];
@@ -241,6 +323,7 @@ static void ns_socket_update(void) {
         if (rc != NO_ERROR) { break; }
         network_receive(localIndex, &sAddr[0], data, dataLength);
     } while (true);
+#endif
 }
 
 static int ns_socket_send(u8 localIndex, void* address, u8* data, u16 dataLength) {
@@ -252,6 +335,20 @@ static int ns_socket_send(u8 localIndex, void* address, u8* data, u16 dataLength
     struct sockaddr_in6* userAddr = &sAddr[localIndex];
     if (localIndex == 0 && address != NULL) { userAddr = (struct sockaddr_in6*)address; }
 
+#ifdef SOCKET_BATCHED_IO
+    // queue it up, the whole frame gets flushed with a single sendmmsg
+    if (dataLength <= SOCKET_DATAGRAM_LENGTH) {
+        if (sSendQueueCount >= SOCKET_BATCH_MAX) { ns_socket_flush(); }
+        struct SocketDatagram* datagram = &sSendQueue[sSendQueueCount];
+        datagram->addr = *userAddr;
+        datagram->data = sSendQueueData[sSendQueueCount];
+        datagram->length = dataLength;
+        memcpy(datagram->data, data, dataLength);
+        sSendQueueCount++;
+        return NO_ERROR;
+    }
+#endif
+
     int rc = socket_send(sCurSocket, userAddr, data, dataLength);
     if (rc) {
         LOG_ERROR("    localIndex: %d, packetType: %d, dataLength: %d", localIndex, data[0], dataLength);
@@ -268,11 +365,15 @@ static void ns_socket_get_lobby_secret(char* destination, u32 destLength) {
 }
 
 static void ns_socket_shutdown(UNUSED bool reconnecting) {
+#ifdef SOCKET_BATCHED_IO
+    ns_socket_flush();
+#endif
     socket_shutdown(sCurSocket);
     sCurSocket = INVALID_SOCKET;
     for (u16 i = 0; i < MAX_PLAYERS; i++) {
         memset(&sAddr[i], 0, sizeof(struct sockaddr_in6));
     }
+    socket_addr_table_rebuild();
     LOG_INFO("shutdown");
 }
 
@@ -285,6 +386,11 @@ struct NetworkSystem gNetworkSystemSocket = {
     .dup_addr         = ns_socket_dup_addr,
     .match_addr       = ns_socket_match_addr,
     .update           = ns_socket_update,
+#ifdef SOCKET_BATCHED_IO
+    .flush            = ns_socket_flush,
+#else
+    .flush            = NULL,
+#endif
     .send             = ns_socket_send,
     .get_lobby_id     = ns_socket_get_lobby_id,
     .get_lobby_secret = ns_socket_get_lobby_secret,
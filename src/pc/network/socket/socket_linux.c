@@ -1,4 +1,7 @@
 #ifndef WINSOCK
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
 #include "socket_linux.h"
 #include "../network.h"
 #include "pc/debuglog.h"
@@ -38,4 +41,73 @@ void socket_shutdown(SOCKET socket) {
     }
 }
 
+#ifdef SOCKET_BATCHED_IO
+int socket_send_batch(SOCKET socket, struct SocketDatagram* datagrams, u32 count) {
+    struct mmsghdr msgs[SOCKET_BATCH_MAX];
+    struct iovec iovecs[SOCKET_BATCH_MAX];
+    if (count > SOCKET_BATCH_MAX) { count = SOCKET_BATCH_MAX; }
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (u32 i = 0; i < count; i++) {
+        iovecs[i].iov_base = datagrams[i].data;
+        iovecs[i].iov_len = datagrams[i].length;
+        msgs[i].msg_hdr.msg_name = &datagrams[i].addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    u32 sent = 0;
+    while (sent < count) {
+        int rc = sendmmsg(socket, &msgs[sent], count - sent, 0);
+        if (rc > 0) {
+            sent += rc;
+            continue;
+        }
+
+        // drop the rest of the batch just like a would-block sendto()
+        int error = SOCKET_LAST_ERROR;
+        if (error == SOCKET_EWOULDBLOCK) { return NO_ERROR; }
+
+        // skip the datagram that failed and keep going
+        LOG_ERROR("sendmmsg failed with error: %d", error);
+        sent++;
+    }
+
+    return NO_ERROR;
+}
+
+int socket_receive_batch(SOCKET socket, struct SocketDatagram* datagrams, u32 count, u16 bufferLength) {
+    struct mmsghdr msgs[SOCKET_BATCH_MAX];
+    struct iovec iovecs[SOCKET_BATCH_MAX];
+    if (count > SOCKET_BATCH_MAX) { count = SOCKET_BATCH_MAX; }
+
+    memset(msgs, 0, sizeof(struct mmsghdr) * count);
+    for (u32 i = 0; i < count; i++) {
+        memset(&datagrams[i].addr, 0, sizeof(struct sockaddr_in6));
+        iovecs[i].iov_base = datagrams[i].data;
+        iovecs[i].iov_len = bufferLength;
+        msgs[i].msg_hdr.msg_name = &datagrams[i].addr;
+        msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in6);
+        msgs[i].msg_hdr.msg_iov = &iovecs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int rc = recvmmsg(socket, msgs, count, MSG_DONTWAIT, NULL);
+    if (rc == SOCKET_ERROR) {
+        int error = SOCKET_LAST_ERROR;
+        if (error != SOCKET_EWOULDBLOCK && error != SOCKET_ECONNRESET) {
+            LOG_ERROR("recvmmsg failed with error %d", error);
+        }
+        return SOCKET_ERROR;
+    }
+
+    for (int i = 0; i < rc; i++) {
+        datagrams[i].length = msgs[i].msg_len;
+    }
+
+    return rc;
+}
+#endif
+
 #endif
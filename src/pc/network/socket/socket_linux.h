@@ -20,4 +20,21 @@
 #define SOCKET_ECONNRESET ECONNRESET
 #define RX_ADDR_SIZE_TYPE unsigned int
 
+#ifdef __linux__
+#include <PR/ultratypes.h>
+
+// sendmmsg/recvmmsg let us move a whole frame's datagrams in a single syscall
+#define SOCKET_BATCHED_IO
+#define SOCKET_BATCH_MAX 64
+
+struct SocketDatagram {
+    struct sockaddr_in6 addr;
+    u8* data;
+    u16 length;
+};
+
+int socket_send_batch(SOCKET socket, struct SocketDatagram* datagrams, u32 count);
+int socket_receive_batch(SOCKET socket, struct SocketDatagram* datagrams, u32 count, u16 bufferLength);
+#endif
+
 #endif
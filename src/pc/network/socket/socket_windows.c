@@ -38,7 +38,7 @@ SOCKET socket_initialize(void) {
     // on windows, the send buffer for the socket needs to be increased
     // for the many players case to avoid WSAEWOULDBLOCK on send
     // not actually sure this is the "proper" way to fix it
-    int bufsiz = 128 * 1024; // 128kb, default is apparently 8kb or 16kb
+    int bufsiz = 8 * 1024 * MAX_PLAYERS; // 128kb at 16 players, default is apparently 8kb or 16kb
     rc = setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (const char *)&bufsiz, sizeof(bufsiz));
     if (rc != NO_ERROR) {
         LOG_ERROR("setsockopt(SO_SNDBUF) failed with error: %d", rc);
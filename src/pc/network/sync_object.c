@@ -10,71 +10,117 @@
 #include "game/object_helpers.h"
 #include "pc/debuglog.h"
 #include "pc/utils/misc.h"
-#include "data/dynos_cmap.cpp.h"
 #include "pc/debug_context.h"
 
-static void* sSoMap = NULL;
+// every valid sync id indexes straight into the slot table
+#define SYNC_ID_MAX ((MAX_PLAYERS + 1) * SYNC_ID_BLOCK_SIZE)
+#define SYNC_SLOT_EMPTY 0xFFFFFFFF
+#define SYNC_DENSE_INITIAL_CAPACITY 256
 
-#define FORGET_TIMEOUT 10
+struct SyncObjectSlot {
+    u32 dense;
+    u32 generation;
+};
 
-struct SyncObjectForgetEntry {
-    struct SyncObject* so;
-    s32 forgetTimer;
-    struct SyncObjectForgetEntry* next;
+struct SyncObjectTable {
+    struct SyncObjectSlot slots[SYNC_ID_MAX];
+    struct SyncObject** dense;
+    u32 count;
+    u32 capacity;
 };
-struct SyncObjectForgetEntry* sForgetList = NULL;
+
+static struct SyncObjectTable sSoTableLive = { 0 };
+static struct SyncObjectTable* sSoTable = &sSoTableLive;
+static u32 sSoIterator = 0;
+
+// forgotten objects stay mapped until the next update, then wait on the wheel until they are freed
+#define FORGET_TIMEOUT 10
+#define FORGET_WHEEL_SIZE (FORGET_TIMEOUT + 1)
+
+static struct SyncObject* sForgetPending = NULL;
+static struct SyncObject* sForgetWheel[FORGET_WHEEL_SIZE] = { 0 };
+static u32 sForgetWheelPos = 0;
 
 static u32 sNextSyncId = SYNC_ID_BLOCK_SIZE / 2;
 static bool sFreeingAll = false;
 
-  ////////////
- // system //
-////////////
+  ///////////
+ // table //
+///////////
 
-void sync_objects_init_system(void) {
-    sSoMap = hmap_create(true);
+static void sync_object_table_init(struct SyncObjectTable* table) {
+    for (u32 i = 0; i < SYNC_ID_MAX; i++) {
+        table->slots[i].dense = SYNC_SLOT_EMPTY;
+    }
+    table->capacity = SYNC_DENSE_INITIAL_CAPACITY;
+    table->dense = malloc(sizeof(struct SyncObject*) * table->capacity);
+    table->count = 0;
 }
 
-static bool sync_objects_forget_list_contains(struct SyncObject* so) {
-    struct SyncObjectForgetEntry* entry = sForgetList;
-    while (entry) {
-        struct SyncObjectForgetEntry* next = entry->next;
-        if (entry->so == so) {
-            return true;
+static void sync_object_table_put(struct SyncObjectTable* table, u32 syncId, struct SyncObject* so) {
+    struct SyncObjectSlot* slot = &table->slots[syncId];
+    if (slot->dense != SYNC_SLOT_EMPTY) {
+        table->dense[slot->dense] = so;
+    } else {
+        if (table->count >= table->capacity) {
+            table->capacity *= 2;
+            table->dense = realloc(table->dense, sizeof(struct SyncObject*) * table->capacity);
         }
-        entry = next;
+        slot->dense = table->count++;
+        table->dense[slot->dense] = so;
     }
-    return false;
+    so->generation = ++slot->generation;
 }
 
-void sync_objects_update(void) {
-    struct SyncObjectForgetEntry* prev = NULL;
-    struct SyncObjectForgetEntry* entry = sForgetList;
-    while (entry) {
-        struct SyncObjectForgetEntry* next = entry->next;
-        if (entry->forgetTimer == FORGET_TIMEOUT) {
-            struct SyncObject* currentSo = sync_object_get(entry->so->id);
-            if (currentSo == entry->so) {
-                hmap_del(sSoMap, entry->so->id);
-            }
-        }
+static void sync_object_table_del(struct SyncObjectTable* table, struct SyncObject* so) {
+    struct SyncObjectSlot* slot = &table->slots[so->id];
+    if (slot->dense == SYNC_SLOT_EMPTY || slot->generation != so->generation) { return; }
 
-        if (entry->forgetTimer-- <= 0) {
-            if (prev) {
-                prev->next = next;
-            } else {
-                sForgetList = next;
-            }
-            //LOG_INFO("Freeing sync object %u : %s\n", entry->so->id, get_behavior_name_from_id(get_id_from_behavior(entry->so->behavior)));
-            free(entry->so);
-            free(entry);
+    // swap the last object into the hole to keep the table dense
+    struct SyncObject* last = table->dense[--table->count];
+    table->dense[slot->dense] = last;
+    table->slots[last->id].dense = slot->dense;
+    slot->dense = SYNC_SLOT_EMPTY;
+}
 
-        } else {
-            prev = entry;
-        }
+static void sync_object_table_clear(struct SyncObjectTable* table) {
+    for (u32 i = 0; i < table->count; i++) {
+        table->slots[table->dense[i]->id].dense = SYNC_SLOT_EMPTY;
+    }
+    table->count = 0;
+}
+
+  ////////////
+ // system //
+////////////
 
-        entry = next;
+void sync_objects_init_system(void) {
+    sync_object_table_init(&sSoTableLive);
+}
+
+void sync_objects_update(void) {
+    // unmap everything forgotten since the last update
+    struct SyncObject* so = sForgetPending;
+    sForgetPending = NULL;
+    while (so) {
+        struct SyncObject* next = so->forgetNext;
+        sync_object_table_del(sSoTable, so);
+        u32 bucket = (sForgetWheelPos + FORGET_TIMEOUT) % FORGET_WHEEL_SIZE;
+        so->forgetNext = sForgetWheel[bucket];
+        sForgetWheel[bucket] = so;
+        so = next;
     }
+
+    // free whatever has waited on the wheel for FORGET_TIMEOUT updates
+    so = sForgetWheel[sForgetWheelPos];
+    sForgetWheel[sForgetWheelPos] = NULL;
+    while (so) {
+        struct SyncObject* next = so->forgetNext;
+        //LOG_INFO("Freeing sync object %u : %s\n", so->id, get_behavior_name_from_id(get_id_from_behavior(so->behavior)));
+        free(so);
+        so = next;
+    }
+    sForgetWheelPos = (sForgetWheelPos + 1) % FORGET_WHEEL_SIZE;
 }
 
 void sync_objects_clear(void) {
@@ -84,7 +130,7 @@ void sync_objects_clear(void) {
     for (struct SyncObject* so = sync_object_get_first(); so != NULL; so = sync_object_get_next()) {
         sync_object_forget(so->id);
     }
-    hmap_clear(sSoMap);
+    sync_object_table_clear(sSoTable);
 }
 
 void sync_object_forget(u32 syncId) {
@@ -115,21 +161,9 @@ void sync_object_forget(u32 syncId) {
 
     so->forgetting = true;
 
-    // add it to a list to free later
-    s32 forgetCount = 1;
-    struct SyncObjectForgetEntry* newEntry = calloc(1, sizeof(struct SyncObjectForgetEntry));
-    newEntry->so = so;
-    newEntry->forgetTimer = FORGET_TIMEOUT;
-    if (sForgetList == NULL) {
-        sForgetList = newEntry;
-    } else {
-        struct SyncObjectForgetEntry* entry = sForgetList;
-        while (entry->next != NULL) {
-            entry = entry->next;
-            forgetCount++;
-        }
-        entry->next = newEntry;
-    }
+    // unmap it on the next update, free it later
+    so->forgetNext = sForgetPending;
+    sForgetPending = so;
     //LOG_INFO("Scheduling sync object to free %u : %s\n", so->id, get_behavior_name_from_id(get_id_from_behavior(so->behavior)));
 
 }
@@ -178,6 +212,7 @@ struct SyncObject* sync_object_init(struct Object *o, float maxSyncDistance) {
     so->behavior = (BehaviorScript*)o->behavior;
     for (s32 i = 0; i < MAX_PLAYERS; i++) {
         so->rxEventId[i] = 0;
+        so->peerClockSinceUpdate[i] = 0;
     }
     so->txEventId = 0;
     so->fullObjectSync = false;
@@ -247,16 +282,19 @@ void sync_object_init_field_with_size(struct Object *o, void* field, u8 size) {
 /////////////
 
 struct SyncObject* sync_object_get(u32 syncId) {
-    if (syncId == 0) { return NULL; }
-    return hmap_get(sSoMap, syncId);
+    if (syncId == 0 || syncId >= SYNC_ID_MAX) { return NULL; }
+    u32 dense = sSoTable->slots[syncId].dense;
+    return (dense == SYNC_SLOT_EMPTY) ? NULL : sSoTable->dense[dense];
 }
 
 struct SyncObject* sync_object_get_first(void) {
-    return hmap_begin(sSoMap);
+    sSoIterator = 0;
+    return (sSoTable->count > 0) ? sSoTable->dense[0] : NULL;
 }
 
 struct SyncObject* sync_object_get_next(void) {
-    return hmap_next(sSoMap);
+    if (++sSoIterator >= sSoTable->count) { return NULL; }
+    return sSoTable->dense[sSoIterator];
 }
 
 struct Object* sync_object_get_object(u32 syncId) {
@@ -310,16 +348,17 @@ void sync_object_override_object(u32 syncId, struct Object* o) {
  // utils //
 ///////////
 
-// todo: move this to somewhere more general
-float player_distance(struct MarioState* marioState, struct Object* o) {
+static f32 player_distance_squared(struct MarioState* marioState, struct Object* o) {
     if (marioState->marioObj == NULL) { return 0; }
     f32 mx = marioState->marioObj->header.gfx.pos[0] - o->oPosX;
     f32 my = marioState->marioObj->header.gfx.pos[1] - o->oPosY;
     f32 mz = marioState->marioObj->header.gfx.pos[2] - o->oPosZ;
-    mx *= mx;
-    my *= my;
-    mz *= mz;
-    return sqrt(mx + my + mz);
+    return mx * mx + my * my + mz * mz;
+}
+
+// todo: move this to somewhere more general
+float player_distance(struct MarioState* marioState, struct Object* o) {
+    return sqrt(player_distance_squared(marioState, o));
 }
 
 bool sync_object_should_own(u32 syncId) {
@@ -345,16 +384,20 @@ bool sync_object_should_own(u32 syncId) {
     if (gMarioStates[0].heldByObj == so->o) { return true; }
 
     // don't own other held objects
-    for (s32 i = 1; i < MAX_PLAYERS; i++) {
-        if (gMarioStates[i].heldByObj == so->o) { return false; }
+    NetworkPlayerMask mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        if (gMarioStates[network_player_mask_pop(&mask)].heldByObj == so->o) { return false; }
     }
 
     if (so->o->oHeldState == HELD_HELD && so->o->heldByPlayerIndex == 0) { return true; }
 
     // check distance
-    for (s32 i = 0; i < MAX_PLAYERS; i++) {
-        if (i != 0 && !is_player_in_local_area(&gMarioStates[i])) { continue; }
-        if (player_distance(&gMarioStates[0], so->o) > player_distance(&gMarioStates[i], so->o)) { return false; }
+    f32 localDistance = player_distance_squared(&gMarioStates[0], so->o);
+    mask = gNetworkPlayersConnected & ~NETWORK_PLAYER_BIT(0);
+    while (mask) {
+        struct MarioState* m = &gMarioStates[network_player_mask_pop(&mask)];
+        if (!is_player_in_local_area(m)) { continue; }
+        if (localDistance > player_distance_squared(m, so->o)) { return false; }
     }
 
     if (so->o->oHeldState == HELD_HELD && so->o->heldByPlayerIndex != 0) { return false; }
@@ -407,6 +450,12 @@ bool sync_object_set_id(struct Object* o) {
         }
     }
 
+    if (syncId >= SYNC_ID_MAX) {
+        o->oSyncID = 0;
+        LOG_ERROR("sync id %u is out of range for object w/behavior %d (set_sync_id)", syncId, get_id_from_behavior(o->behavior));
+        return false;
+    }
+
     if (syncId == 0 || !ctx) {
         o->oSyncID = 0;
         LOG_ERROR("failed to set sync id for object w/behavior %d (set_sync_id) %u", get_id_from_behavior(o->behavior), gNetworkAreaLoaded);
@@ -418,8 +467,8 @@ bool sync_object_set_id(struct Object* o) {
     if (!so) {
         so = calloc(1, sizeof(struct SyncObject));
         so->extendedModelId = 0xFFFF;
-        hmap_put(sSoMap, syncId, so);
-        //LOG_INFO("Allocated sync object @ %u, size %ld", syncId, (long int)hmap_len(sSoMap));
+        sync_object_table_put(sSoTable, syncId, so);
+        //LOG_INFO("Allocated sync object @ %u, size %u", syncId, sSoTable->count);
     } else if (so->o != o) {
         LOG_INFO("Already exists...");
     }
@@ -441,3 +490,83 @@ bool sync_object_set_id(struct Object* o) {
 
     return true;
 }
+
+#ifdef DEVELOPMENT
+
+  ///////////
+ // bench //
+///////////
+
+#include "data/dynos_cmap.cpp.h"
+#include "pc/dev/bench.h"
+
+#define SYNC_OBJECT_BENCH_MAX_OBJECTS 2048
+#define SYNC_OBJECT_BENCH_ITERATIONS 200
+
+static void sync_object_bench_one(u32 objectCount) {
+    struct SyncObject* objects = calloc(objectCount, sizeof(struct SyncObject));
+    struct SyncObjectTable* table = calloc(1, sizeof(struct SyncObjectTable));
+    void* map = hmap_create(true);
+    sync_object_table_init(table);
+
+    // scatter the ids over every player's block like a busy lobby would
+    u32 seed = objectCount;
+    for (u32 i = 0; i < objectCount; i++) {
+        u32 id = 0;
+        while (id == 0 || table->slots[id].dense != SYNC_SLOT_EMPTY) {
+            seed = seed * 1103515245 + 12345;
+            id = 1 + (seed >> 8) % (SYNC_ID_MAX - 1);
+        }
+        objects[i].id = id;
+        objects[i].o = (struct Object*)(uintptr_t)id;
+        sync_object_table_put(table, id, &objects[i]);
+        hmap_put(map, id, &objects[i]);
+    }
+
+    struct SyncObjectTable* savedTable = sSoTable;
+    u32 savedIterator = sSoIterator;
+    sSoTable = table;
+
+    uintptr_t sum = 0;
+    f64 start = clock_elapsed_f64();
+    for (u32 iter = 0; iter < SYNC_OBJECT_BENCH_ITERATIONS; iter++) {
+        for (struct SyncObject* so = hmap_begin(map); so != NULL; so = hmap_next(map)) {
+            sum += (uintptr_t)so->o;
+        }
+        for (u32 i = 0; i < objectCount; i++) {
+            sum += (uintptr_t)hmap_get(map, objects[i].id);
+        }
+    }
+    f64 mid = clock_elapsed_f64();
+    for (u32 iter = 0; iter < SYNC_OBJECT_BENCH_ITERATIONS; iter++) {
+        for (struct SyncObject* so = sync_object_get_first(); so != NULL; so = sync_object_get_next()) {
+            sum += (uintptr_t)so->o;
+        }
+        for (u32 i = 0; i < objectCount; i++) {
+            sum += (uintptr_t)sync_object_get(objects[i].id);
+        }
+    }
+    f64 end = clock_elapsed_f64();
+
+    sSoTable = savedTable;
+    sSoIterator = savedIterator;
+
+    dev_bench_report("%u objects: hmap %.3fus, dense %.3fus per walk + lookups (%x)",
+        objectCount,
+        (mid - start) * 1000000.0 / SYNC_OBJECT_BENCH_ITERATIONS,
+        (end - mid) * 1000000.0 / SYNC_OBJECT_BENCH_ITERATIONS,
+        (u32)(sum & 0xFF));
+
+    hmap_destroy(map);
+    free(table->dense);
+    free(table);
+    free(objects);
+}
+
+void sync_object_bench(void) {
+    for (u32 objectCount = 128; objectCount <= SYNC_OBJECT_BENCH_MAX_OBJECTS; objectCount *= 4) {
+        sync_object_bench_one(objectCount);
+    }
+}
+
+#endif
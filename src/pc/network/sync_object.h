@@ -15,6 +15,7 @@ struct SyncObject {
     void* behavior;
     u16 txEventId;
     u16 rxEventId[MAX_PLAYERS];
+    f32 peerClockSinceUpdate[MAX_PLAYERS];
     u16 randomSeed;
     u32 extraFieldCount;
     bool fullObjectSync;
@@ -37,6 +38,8 @@ struct SyncObject {
     struct Packet lastReliablePacket;
     u8 forgetting;
     u8 ctx;
+    u32 generation;
+    struct SyncObject* forgetNext;
 };
 
 
@@ -78,4 +81,8 @@ float player_distance(struct MarioState* marioState, struct Object* o);
 bool sync_object_should_own(u32 syncId);
 bool sync_object_set_id(struct Object* o);
 
+#ifdef DEVELOPMENT
+void sync_object_bench(void);
+#endif
+
 #endif
\ No newline at end of file
@@ -14,6 +14,16 @@ const char* get_version(void) {
     return sVersionString;
 }
 
+// the internal version changes whenever the network protocol does, so it is part of what peers and lobbies compare
+const char* get_version_online(void) {
+    if (MINOR_VERSION_NUMBER > 0) {
+        snprintf(sOnlineVersionString, MAX_VERSION_LENGTH, "%s (%s%d.%d)", get_version(), VERSION_TEXT, VERSION_NUMBER, MINOR_VERSION_NUMBER);
+    } else {
+        snprintf(sOnlineVersionString, MAX_VERSION_LENGTH, "%s (%s%d)", get_version(), VERSION_TEXT, VERSION_NUMBER);
+    }
+    return sOnlineVersionString;
+}
+
 #ifdef COMPILE_TIME
 const char* get_version_with_build_date(void) {
 #if defined(VERSION_US)
@@ -5,8 +5,8 @@
 
 // internal version
 #define VERSION_TEXT "v"
-#define VERSION_NUMBER 40
-#define MINOR_VERSION_NUMBER 0
+#define VERSION_NUMBER 41
+#define MINOR_VERSION_NUMBER 2
 
 #if defined(VERSION_JP)
 #define VERSION_REGION "JP"
@@ -32,6 +32,7 @@
 #define MAX_VERSION_LENGTH 128
 
 const char* get_version(void);
+const char* get_version_online(void);
 #ifdef COMPILE_TIME
 const char* get_version_with_build_date(void);
 #endif
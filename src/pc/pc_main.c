@@ -12,6 +12,7 @@
 #include "game/memory.h"
 #include "audio/data.h"
 #include "audio/external.h"
+#include "audio/synthesis.h"
 
 #include "network/network.h"
 #include "lua/smlua.h"
@@ -230,12 +231,22 @@ void produce_interpolation_frames_and_delay(void) {
         f64 elapsedTime = now - loopStartTime;
         expectedTime += (targetTime - curTime) / (f64) numFramesToDraw;
         f64 delay = (expectedTime - elapsedTime) * 1000.0;
+        if (delay > 0.0) {
+            // spend the time we would sleep on Lua garbage collection first
+            smlua_gc_step(delay / 1000.0);
+            delay = (expectedTime - (clock_elapsed_f64() - loopStartTime)) * 1000.0;
+        }
         if (delay > 0.0) {
             WAPI.delay((u32)delay);
         }
         numFramesToDraw--;
     } while ((curTime = clock_elapsed_f64()) < targetTime && numFramesToDraw > 0);
 
+    // an uncapped framerate never sleeps, so give the gc its budget once per game frame
+    if (!is30Fps && configUncappedFramerate) {
+        smlua_gc_step(configLuaGcBudget / 1000000.0);
+    }
+
     // compute and update the frame rate every second
     if ((curTime = clock_elapsed_f64()) >= sFpsTimeLast + 1.0) {
         compute_fps(curTime);
@@ -255,24 +266,56 @@ void produce_interpolation_frames_and_delay(void) {
 // It also may help static analysis and bug catching.
 static s16 sAudioBuffer[SAMPLES_HIGH * 2 * 2] = { 0 };
 
-inline static void buffer_audio(void) {
+// Computed on the game thread, applied by whichever thread buffers the audio.
+// Each entry is read and written atomically since the two threads don't share a lock for it.
+static f32 sSeqPlayerVolumes[SEQ_PLAYER_SFX + 1] = { 0 };
+
+static bool sAudioPlayed = false;
+static u32 sAudioUnderruns = 0;
+static bool sAudioThreadExit = false;
+
+static void set_seq_player_volume_target(s32 player, f32 volume) {
+    __atomic_store(&sSeqPlayerVolumes[player], &volume, __ATOMIC_RELAXED);
+}
+
+static f32 get_seq_player_volume_target(s32 player) {
+    f32 volume;
+    __atomic_load(&sSeqPlayerVolumes[player], &volume, __ATOMIC_RELAXED);
+    return volume;
+}
+
+static void update_audio_volumes(void) {
     bool shouldMute = configMuteFocusLoss && !WAPI.has_focus();
     const f32 masterMod = (f32)configMasterVolume / 127.0f * (f32)gLuaVolumeMaster / 127.0f;
-    set_sequence_player_volume(SEQ_PLAYER_LEVEL, shouldMute ? 0 : (f32)configMusicVolume / 127.0f * (f32)gLuaVolumeLevel / 127.0f * masterMod);
-    set_sequence_player_volume(SEQ_PLAYER_SFX,   shouldMute ? 0 : (f32)configSfxVolume / 127.0f * (f32)gLuaVolumeSfx / 127.0f * masterMod);
-    set_sequence_player_volume(SEQ_PLAYER_ENV,   shouldMute ? 0 : (f32)configEnvVolume / 127.0f * (f32)gLuaVolumeEnv / 127.0f * masterMod);
+    set_seq_player_volume_target(SEQ_PLAYER_LEVEL, shouldMute ? 0 : (f32)configMusicVolume / 127.0f * (f32)gLuaVolumeLevel / 127.0f * masterMod);
+    set_seq_player_volume_target(SEQ_PLAYER_SFX,   shouldMute ? 0 : (f32)configSfxVolume / 127.0f * (f32)gLuaVolumeSfx / 127.0f * masterMod);
+    set_seq_player_volume_target(SEQ_PLAYER_ENV,   shouldMute ? 0 : (f32)configEnvVolume / 127.0f * (f32)gLuaVolumeEnv / 127.0f * masterMod);
+}
+
+inline static void buffer_audio(void) {
+    set_sequence_player_volume(SEQ_PLAYER_LEVEL, get_seq_player_volume_target(SEQ_PLAYER_LEVEL));
+    set_sequence_player_volume(SEQ_PLAYER_SFX,   get_seq_player_volume_target(SEQ_PLAYER_SFX));
+    set_sequence_player_volume(SEQ_PLAYER_ENV,   get_seq_player_volume_target(SEQ_PLAYER_ENV));
 
     int samplesLeft = audio_api->buffered();
-    u32 numAudioSamples = samplesLeft < audio_api->get_desired_buffered() ? SAMPLES_HIGH : SAMPLES_LOW;
+    int desiredSamples = audio_api->get_desired_buffered();
+
+    // the device played through everything we queued, so there was a gap
+    if (sAudioPlayed && samplesLeft == 0 && desiredSamples > 0) {
+        __atomic_add_fetch(&sAudioUnderruns, 1, __ATOMIC_RELAXED);
+    }
+
+    u32 numAudioSamples = samplesLeft < desiredSamples ? SAMPLES_HIGH : SAMPLES_LOW;
     for (s32 i = 0; i < 2; i++) {
         create_next_audio_buffer(sAudioBuffer + i * (numAudioSamples * 2), numAudioSamples);
     }
     audio_api->play((u8 *)sAudioBuffer, 2 * numAudioSamples * 4);
+    sAudioPlayed = true;
 }
 
 void *audio_thread(UNUSED void *arg) {
     // As long as we have an audio api and that we're threaded, Loop.
-    while (audio_api) {
+    while (audio_api && !__atomic_load_n(&sAudioThreadExit, __ATOMIC_ACQUIRE)) {
         f64 curTime = clock_elapsed_f64();
 
         // Buffer the audio.
@@ -306,10 +349,15 @@ void produce_one_frame(void) {
 
     CTX_EXTENT(CTX_SMLUA, smlua_update);
 
+    CTX_EXTENT(CTX_NETWORK, network_flush);
+
+    update_audio_volumes();
+
     // If we aren't threaded
     if (gAudioThread.state == INVALID) {
         CTX_EXTENT(CTX_AUDIO, buffer_audio);
     }
+    CTR_SET(CTR_AUDIO_UNDERRUN, __atomic_load_n(&sAudioUnderruns, __ATOMIC_RELAXED));
 
     CTX_EXTENT(CTX_RENDER, produce_interpolation_frames_and_delay);
 }
@@ -348,6 +396,11 @@ void produce_one_dummy_frame(void (*callback)(), u8 clearColorR, u8 clearColorG,
 
 void audio_shutdown(void) {
     audio_custom_shutdown();
+    if (gAudioThread.state == RUNNING) {
+        __atomic_store_n(&sAudioThreadExit, true, __ATOMIC_RELEASE);
+        join_thread(&gAudioThread);
+    }
+    synthesis_shutdown();
     if (audio_api) {
         if (audio_api->shutdown) audio_api->shutdown();
         audio_api = NULL;
@@ -365,6 +418,7 @@ void game_deinit(void) {
     smlua_audio_custom_deinit();
     mods_shutdown();
     djui_shutdown();
+    dynos_tex_decode_shutdown();
     gfx_shutdown();
     gGameInited = false;
 }
@@ -376,6 +430,8 @@ void game_exit(void) {
 }
 
 void* main_game_init(UNUSED void* dummy) {
+    f64 startTime = clock_elapsed_f64();
+
     // load language
     if (!djui_language_init(configLanguage)) { snprintf(configLanguage, MAX_CONFIG_STRING, "%s", ""); }
 
@@ -404,6 +460,10 @@ void* main_game_init(UNUSED void* dummy) {
     network_player_init();
     mumble_init();
 
+    f64 startupMs = (clock_elapsed_f64() - startTime) * 1000.0;
+    LOG_INFO("game initialized in %.0f ms", startupMs);
+    LOADING_SCREEN_MUTEX(loading_screen_add_stat("Startup: %.0f ms", startupMs));
+
     gGameInited = true;
 }
 
@@ -495,7 +555,11 @@ int main(int argc, char *argv[]) {
     if (!audio_api) audio_api = &audio_null;
 
     // Initialize the audio thread if possible.
-    // init_thread_handle(&gAudioThread, audio_thread, NULL, NULL, 0);
+    // Its lock is recursive, the audio code takes it again from functions called with it held.
+    if (!gCLIOpts.headless && (init_recursive_mutex(&gAudioThread) != 0 || init_thread(&gAudioThread, audio_thread, NULL, NULL, 0) != 0)) {
+        LOG_ERROR("Failed to start the audio thread, buffering audio on the game thread instead");
+        gAudioThread.state = INVALID;
+    }
 
 #ifdef LOADING_SCREEN_SUPPORTED
     loading_screen_reset();
@@ -1,10 +1,34 @@
 #include <PR/ultratypes.h>
+#include <stdio.h>
 #include "rom_assets.h"
 #include "pc/debuglog.h"
+#include "pc/fs/fs.h"
+#include "pc/loading.h"
+#include "pc/thread.h"
+#include "pc/network/version.h"
+#include "pc/utils/miniz/miniz.h"
 #include "rom_checker.h"
 #include "apparition.inc.c"
 #include "utils/misc.h"
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// decoding threads, the loading thread included
+#define ROM_ASSETS_THREADS 4
+
+// decoded assets are kept in the user folder so later launches skip decompression
+#define ROM_ASSETS_CACHE_FILENAME "rom_assets.cache"
+#define ROM_ASSETS_CACHE_MAGIC 0x52414331
+#define ROM_ASSETS_CACHE_VERSION 2
+#define ROM_ASSETS_ROM_HEADER_SIZE 0x40
+
 #define ROM_ASSET_LOAD_DATA(bits) for (u##bits *data = asset->ptr; asset->cursor < asset->segmentedSize; data++) { *data = READ##bits(asset); }
 
 struct RomAsset {
@@ -15,21 +39,41 @@ struct RomAsset {
     u32 segmentedAddress;
     u32 segmentedSize;
     u32 cursor;
+    const u8* segment;
+    u32 segmentSize;
     struct RomAsset* next;
 };
 
-static FILE* sRomFile = NULL;
+struct RomAssetsCacheHeader {
+    u32 magic;
+    u32 version;
+    u32 assetCount;
+    u32 assetsCrc;
+    u32 romHeaderCrc;
+    u32 vtxSize;
+    u32 payloadCrc;
+    u32 pad;
+    char build[MAX_VERSION_LENGTH];
+    u64 payloadSize;
+};
+
 static struct RomAsset* sRomAssets = NULL;
 
-static u32 sCurrentPhysicalAddress = 0;
-static u32 sCurrentPhysicalSize = 0;
-static u8* sCurrentSegmentMemory = NULL;
-static u32 sCurrentSegmentSize = 0;
+// the rom is mapped read-only, or read into memory when mapping isn't possible
+static const u8* sRom = NULL;
+static size_t sRomSize = 0;
+static bool sRomMapped = false;
+
+// queued assets sorted by segment, each worker takes one run of a segment at a time
+static struct RomAsset** sSortedAssets = NULL;
+static u32 sSortedAssetCount = 0;
+static u32 sNextSortedAsset = 0;
+static pthread_mutex_t sSortedAssetMutex = PTHREAD_MUTEX_INITIALIZER;
 
 static s32 READ32(struct RomAsset* asset) {
     s64 index = (asset->segmentedAddress + asset->cursor);
-    if (index < 0 || index >= sCurrentSegmentSize) { return 0; }
-    u8* ptr = &sCurrentSegmentMemory[index];
+    if (index < 0 || index >= asset->segmentSize) { return 0; }
+    const u8* ptr = &asset->segment[index];
     s32 value = BSWAP32(*((s32*)ptr));
     asset->cursor += sizeof(s32);
     return value;
@@ -37,8 +81,8 @@ static s32 READ32(struct RomAsset* asset) {
 
 static s16 READ16(struct RomAsset* asset) {
     s64 index = (asset->segmentedAddress + asset->cursor);
-    if (index < 0 || index >= sCurrentSegmentSize) { return 0; }
-    u8* ptr = &sCurrentSegmentMemory[index];
+    if (index < 0 || index >= asset->segmentSize) { return 0; }
+    const u8* ptr = &asset->segment[index];
     s16 value = BSWAP16(*((s16*)ptr));
     asset->cursor += sizeof(s16);
     return value;
@@ -46,47 +90,13 @@ static s16 READ16(struct RomAsset* asset) {
 
 static s8 READ8(struct RomAsset* asset) {
     s64 index = (asset->segmentedAddress + asset->cursor);
-    if (index < 0 || index >= sCurrentSegmentSize) { return 0; }
-    u8* ptr = &sCurrentSegmentMemory[index];
+    if (index < 0 || index >= asset->segmentSize) { return 0; }
+    const u8* ptr = &asset->segment[index];
     s8 value = *ptr;
     asset->cursor += sizeof(s8);
     return value;
 }
 
-static bool rom_asset_load_segment(u32 physicalAddress, u32 physicalSize) {
-    if (physicalAddress == sCurrentPhysicalAddress && physicalSize == sCurrentPhysicalSize) {
-        return true;
-    }
-
-    sCurrentPhysicalAddress = physicalAddress;
-    sCurrentPhysicalSize = physicalSize;
-
-    if (sCurrentSegmentMemory) {
-        free(sCurrentSegmentMemory);
-    }
-
-    sCurrentSegmentMemory = malloc(physicalSize);
-    sCurrentSegmentSize = physicalSize;
-    if (!sCurrentSegmentMemory) {
-        LOG_ERROR("Could not allocate segment memory!");
-        sCurrentSegmentMemory = NULL;
-        return false;
-    }
-
-    fseek(sRomFile, physicalAddress, SEEK_SET);
-    fread(sCurrentSegmentMemory, sizeof(u8), physicalSize, sRomFile);
-
-    u8* decompressed = rom_assets_decompress((u32*)sCurrentSegmentMemory, &sCurrentSegmentSize);
-    if (decompressed != NULL) {
-        free(sCurrentSegmentMemory);
-        sCurrentSegmentMemory = decompressed;
-        if (!sCurrentSegmentMemory) {
-            LOG_ERROR("Could not decompress segment memory!");
-        }
-    }
-    return (sCurrentSegmentMemory != NULL);
-}
-
 // Some Vtx arrays have been manually modified to use white opaque vertex colors
 // so they can be shaded by Lua and not stand out as being unlit
 static inline bool rom_asset_override_vertex_colors(void* ptr) {
@@ -149,10 +159,8 @@ static void rom_asset_load_vtx(struct RomAsset* asset) {
     }
 }
 
-static void rom_asset_load(struct RomAsset* asset) {
-    if (!rom_asset_load_segment(asset->physicalAddress, asset->physicalSize)) {
-        return;
-    }
+// Applied after loading or restoring from the cache, so the cache never holds them
+static void rom_asset_apply_overrides(struct RomAsset* asset) {
     if (asset->physicalAddress == 0x00396340 && asset->assetType == ROM_ASSET_TEXTURE && clock_is_date(4, 1)) {
         switch (asset->segmentedAddress) {
             case 0x00008000: memcpy(asset->ptr, apparition_texture_1, asset->segmentedSize); return;
@@ -161,6 +169,22 @@ static void rom_asset_load(struct RomAsset* asset) {
             case 0x00009800: memcpy(asset->ptr, apparition_texture_4, asset->segmentedSize); return;
         }
     }
+}
+
+// How many bytes an asset fills at its destination
+static size_t rom_asset_memory_size(struct RomAsset* asset) {
+    switch (asset->assetType) {
+        case ROM_ASSET_VTX:       return ((asset->segmentedSize + 15) / 16) * sizeof(Vtx);
+        case ROM_ASSET_COLLISION:
+        case ROM_ASSET_ANIM:      return ((asset->segmentedSize + 1) / 2) * sizeof(u16);
+        default:                  return asset->segmentedSize;
+    }
+}
+
+static void rom_asset_load(struct RomAsset* asset, const u8* segment, u32 segmentSize) {
+    asset->segment = segment;
+    asset->segmentSize = segmentSize;
+    asset->cursor = 0;
     switch (asset->assetType) {
         case ROM_ASSET_VTX:       rom_asset_load_vtx(asset); break;
         case ROM_ASSET_TEXTURE:   ROM_ASSET_LOAD_DATA(8);    break;
@@ -174,27 +198,291 @@ static void rom_asset_load(struct RomAsset* asset) {
     }
 }
 
+  /////////
+ // rom //
+/////////
+
+static bool rom_assets_map_rom(void) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(gRomFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        HANDLE mapping = GetFileSizeEx(file, &size) ? CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL) : NULL;
+        if (mapping != NULL) {
+            sRom = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            sRomSize = size.QuadPart;
+            CloseHandle(mapping);
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = open(gRomFilename, O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {
+                sRom = map;
+                sRomSize = st.st_size;
+            }
+        }
+        close(fd);
+    }
+#endif
+    if (sRom != NULL) {
+        sRomMapped = true;
+        return true;
+    }
+
+    // fall back to reading the whole thing
+    FILE* fp = fopen(gRomFilename, "rb");
+    if (fp == NULL) { return false; }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    u8* rom = (size > 0) ? malloc(size) : NULL;
+    if (rom != NULL && fread(rom, 1, size, fp) == (size_t)size) {
+        sRom = rom;
+        sRomSize = size;
+    } else {
+        free(rom);
+    }
+    fclose(fp);
+    return (sRom != NULL);
+}
+
+static void rom_assets_unmap_rom(void) {
+    if (sRom == NULL) { return; }
+    if (sRomMapped) {
+#ifdef _WIN32
+        UnmapViewOfFile(sRom);
+#else
+        munmap((void*)sRom, sRomSize);
+#endif
+    } else {
+        free((void*)sRom);
+    }
+    sRom = NULL;
+    sRomSize = 0;
+    sRomMapped = false;
+}
+
+static int rom_assets_compare_segments(const void* a, const void* b) {
+    const struct RomAsset* assetA = *(const struct RomAsset**)a;
+    const struct RomAsset* assetB = *(const struct RomAsset**)b;
+    if (assetA->physicalAddress != assetB->physicalAddress) {
+        return (assetA->physicalAddress < assetB->physicalAddress) ? -1 : 1;
+    }
+    if (assetA->physicalSize != assetB->physicalSize) {
+        return (assetA->physicalSize < assetB->physicalSize) ? -1 : 1;
+    }
+    return 0;
+}
+
+static void rom_assets_job(UNUSED void* arg, UNUSED s32 worker) {
+    while (true) {
+        // claim every asset that shares the next segment
+        pthread_mutex_lock(&sSortedAssetMutex);
+        u32 start = sNextSortedAsset;
+        u32 end = start;
+        while (end < sSortedAssetCount && (end == start || rom_assets_compare_segments(&sSortedAssets[start], &sSortedAssets[end]) == 0)) {
+            end++;
+        }
+        sNextSortedAsset = end;
+        pthread_mutex_unlock(&sSortedAssetMutex);
+        if (start >= end) { break; }
+
+        struct RomAsset* first = sSortedAssets[start];
+        if ((u64)first->physicalAddress + first->physicalSize > sRomSize) {
+            LOG_ERROR("Asset segment %08X is outside of the rom!", first->physicalAddress);
+            continue;
+        }
+
+        const u8* segment = sRom + first->physicalAddress;
+        u32 segmentSize = first->physicalSize;
+        u8* decompressed = rom_assets_decompress((u32*)segment, &segmentSize);
+        if (decompressed != NULL) { segment = decompressed; }
+
+        for (u32 i = start; i < end; i++) {
+            rom_asset_load(sSortedAssets[i], segment, segmentSize);
+        }
+        free(decompressed);
+    }
+}
+
+static bool rom_assets_decode(u32 assetCount) {
+    if (!rom_assets_map_rom()) {
+        LOG_ERROR("Could not open rom '%s'!", gRomFilename);
+        return false;
+    }
+
+    sSortedAssets = malloc(sizeof(struct RomAsset*) * assetCount);
+    if (sSortedAssets == NULL) {
+        rom_assets_unmap_rom();
+        return false;
+    }
+    sSortedAssetCount = 0;
+    sNextSortedAsset = 0;
+    for (struct RomAsset* asset = sRomAssets; asset != NULL; asset = asset->next) {
+        sSortedAssets[sSortedAssetCount++] = asset;
+    }
+    qsort(sSortedAssets, sSortedAssetCount, sizeof(struct RomAsset*), rom_assets_compare_segments);
+
+    s32 threads = ROM_ASSETS_THREADS;
+#ifdef _SC_NPROCESSORS_ONLN
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 0) { threads = MIN(cores, ROM_ASSETS_THREADS); }
+#endif
+
+    // the loading thread helps out, this also covers every segment if no worker could start
+    struct ThreadPool pool;
+    init_thread_pool(&pool, threads - 1);
+    run_thread_pool(&pool, rom_assets_job, NULL);
+    shutdown_thread_pool(&pool);
+
+    free(sSortedAssets);
+    sSortedAssets = NULL;
+    sSortedAssetCount = 0;
+    rom_assets_unmap_rom();
+    return true;
+}
+
+  ///////////
+ // cache //
+///////////
+
+static void rom_assets_cache_header(struct RomAssetsCacheHeader* header, u32 assetCount) {
+    memset(header, 0, sizeof(struct RomAssetsCacheHeader));
+    header->magic = ROM_ASSETS_CACHE_MAGIC;
+    header->version = ROM_ASSETS_CACHE_VERSION;
+    header->assetCount = assetCount;
+    header->vtxSize = sizeof(Vtx);
+
+    // a new build may decode differently, even from the same rom
+#ifdef COMPILE_TIME
+    snprintf(header->build, sizeof(header->build), "%s", get_version_with_build_date());
+#else
+    snprintf(header->build, sizeof(header->build), "%s", get_version());
+#endif
+
+    // the asset table changes with the build, the rom header identifies the rom
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, NULL, 0);
+    for (struct RomAsset* asset = sRomAssets; asset != NULL; asset = asset->next) {
+        u32 entry[5] = { asset->assetType, asset->physicalAddress, asset->physicalSize, asset->segmentedAddress, asset->segmentedSize };
+        crc = mz_crc32(crc, (const u8*)entry, sizeof(entry));
+        header->payloadSize += rom_asset_memory_size(asset);
+    }
+    header->assetsCrc = crc;
+
+    u8 romHeader[ROM_ASSETS_ROM_HEADER_SIZE] = { 0 };
+    FILE* fp = fopen(gRomFilename, "rb");
+    if (fp != NULL) {
+        fread(romHeader, 1, ROM_ASSETS_ROM_HEADER_SIZE, fp);
+        fclose(fp);
+    }
+    header->romHeaderCrc = mz_crc32(MZ_CRC32_INIT, romHeader, ROM_ASSETS_ROM_HEADER_SIZE);
+}
+
+static bool rom_assets_cache_read(struct RomAssetsCacheHeader* expected) {
+    const char* filename = fs_get_write_path(ROM_ASSETS_CACHE_FILENAME);
+    FILE* fp = fopen(filename, "rb");
+    if (fp == NULL) { return false; }
+
+    struct RomAssetsCacheHeader header = { 0 };
+    if (fread(&header, sizeof(header), 1, fp) != 1) {
+        fclose(fp);
+        return false;
+    }
+
+    // compare everything but the payload crc, which is checked once it's read
+    expected->payloadCrc = header.payloadCrc;
+    if (memcmp(&header, expected, sizeof(header)) != 0) {
+        LOG_INFO("Rom asset cache is stale");
+        fclose(fp);
+        return false;
+    }
+
+    // read straight into place, a bad cache just gets decoded over
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, NULL, 0);
+    for (struct RomAsset* asset = sRomAssets; asset != NULL; asset = asset->next) {
+        size_t size = rom_asset_memory_size(asset);
+        if (fread(asset->ptr, 1, size, fp) != size) {
+            fclose(fp);
+            return false;
+        }
+        crc = mz_crc32(crc, asset->ptr, size);
+    }
+    fclose(fp);
+
+    if (crc != header.payloadCrc) {
+        LOG_ERROR("Rom asset cache is corrupt");
+        return false;
+    }
+    return true;
+}
+
+static void rom_assets_cache_write(struct RomAssetsCacheHeader* header) {
+    const char* filename = fs_get_write_path(ROM_ASSETS_CACHE_FILENAME);
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL) {
+        LOG_ERROR("Failed to open rom asset cache: %s", filename);
+        return;
+    }
+
+    mz_ulong crc = mz_crc32(MZ_CRC32_INIT, NULL, 0);
+    for (struct RomAsset* asset = sRomAssets; asset != NULL; asset = asset->next) {
+        crc = mz_crc32(crc, asset->ptr, rom_asset_memory_size(asset));
+    }
+    header->payloadCrc = crc;
+
+    bool ok = (fwrite(header, sizeof(struct RomAssetsCacheHeader), 1, fp) == 1);
+    for (struct RomAsset* asset = sRomAssets; ok && asset != NULL; asset = asset->next) {
+        size_t size = rom_asset_memory_size(asset);
+        ok = (fwrite(asset->ptr, 1, size, fp) == size);
+    }
+    fclose(fp);
+
+    // never leave a partial cache behind
+    if (!ok) {
+        LOG_ERROR("Failed to write rom asset cache: %s", filename);
+        remove(filename);
+    }
+}
+
+  //////////
+ // load //
+//////////
+
 void rom_assets_load(void) {
     LOG_INFO("loading asset");
 
     assert(fs_sys_file_exists(gRomFilename)); // Should never be false
 
-    sRomFile = fopen(gRomFilename, "rb");
+    f64 start = clock_elapsed_f64();
+    u32 assetCount = 0;
+    for (struct RomAsset* asset = sRomAssets; asset != NULL; asset = asset->next) {
+        assetCount++;
+    }
+
+    struct RomAssetsCacheHeader header;
+    rom_assets_cache_header(&header, assetCount);
+
+    bool cached = rom_assets_cache_read(&header);
+    if (!cached && rom_assets_decode(assetCount)) {
+        rom_assets_cache_write(&header);
+    }
 
     while (sRomAssets) {
-        rom_asset_load(sRomAssets);
+        rom_asset_apply_overrides(sRomAssets);
 
         struct RomAsset* next = sRomAssets->next;
         free(sRomAssets);
         sRomAssets = next;
     }
 
-    if (sCurrentSegmentMemory) {
-        free(sCurrentSegmentMemory);
-        sCurrentSegmentMemory = NULL;
-    }
-
-    fclose(sRomFile);
+    f64 elapsed = (clock_elapsed_f64() - start) * 1000.0;
+    LOG_INFO("loaded %u rom assets in %.1f ms (%s)", assetCount, elapsed, cached ? "cached" : "decoded");
+    LOADING_SCREEN_MUTEX(loading_screen_add_stat("ROM assets: %.0f ms (%s)", elapsed, cached ? "cached" : "decoded"));
 }
 
 void rom_assets_queue(void* ptr, enum RomAssetType assetType, u32 physicalAddress, u32 physicalSize, u32 segmentedAddress, u32 segmentedSize) {
@@ -91,8 +91,7 @@ int stop_thread(struct ThreadHandle *handle) {
     return pthread_cancel(handle->thread);
 }
 
-// Optimally just call init_thread_handle instead.
-int init_mutex(struct ThreadHandle *handle) {
+static int init_mutex_of_type(struct ThreadHandle *handle, int type) {
     assert(handle != NULL);
 
     pthread_mutexattr_t mtattr;
@@ -100,7 +99,7 @@ int init_mutex(struct ThreadHandle *handle) {
     int err = pthread_mutexattr_init(&mtattr);
     assert(err == 0);
 
-    err = pthread_mutexattr_settype(&mtattr, PTHREAD_MUTEX_ERRORCHECK);
+    err = pthread_mutexattr_settype(&mtattr, type);
     assert(err == 0);
 
     int ret = pthread_mutex_init(&handle->mutex, &mtattr);
@@ -111,6 +110,16 @@ int init_mutex(struct ThreadHandle *handle) {
     return ret;
 }
 
+// Optimally just call init_thread_handle instead.
+int init_mutex(struct ThreadHandle *handle) {
+    return init_mutex_of_type(handle, PTHREAD_MUTEX_ERRORCHECK);
+}
+
+// For handles whose lock is taken again by code that already holds it.
+int init_recursive_mutex(struct ThreadHandle *handle) {
+    return init_mutex_of_type(handle, PTHREAD_MUTEX_RECURSIVE);
+}
+
 int destroy_mutex(struct ThreadHandle *handle) {
     assert(handle != NULL);
 
@@ -133,4 +142,105 @@ int unlock_mutex(struct ThreadHandle *handle) {
     assert(handle != NULL);
 
     return pthread_mutex_unlock(&handle->mutex);
-}
\ No newline at end of file
+}
+
+static void *thread_pool_worker(void *arg) {
+    struct ThreadPoolWorker *worker = arg;
+    struct ThreadPool *pool = worker->pool;
+    u32 generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (true) {
+        while (pool->generation == generation && !pool->exit) {
+            pthread_cond_wait(&pool->wake, &pool->mutex);
+        }
+        if (pool->exit) { break; }
+        generation = pool->generation;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool->job(pool->arg, worker->index);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->busy == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+// Starts up to count workers, returns how many are running.
+int init_thread_pool(struct ThreadPool *pool, s32 count) {
+    assert(pool != NULL);
+
+    memset((void *)pool, 0, sizeof(struct ThreadPool));
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    if (count > THREAD_POOL_MAX_WORKERS) { count = THREAD_POOL_MAX_WORKERS; }
+    for (s32 i = 0; i < count; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i + 1;
+        if (init_thread(&pool->threads[i], thread_pool_worker, &pool->workers[i], NULL, 0) != 0) {
+            pool->threads[i].state = INVALID;
+            break;
+        }
+        pool->count++;
+    }
+
+    if (pool->count == 0) {
+        pthread_cond_destroy(&pool->done);
+        pthread_cond_destroy(&pool->wake);
+        pthread_mutex_destroy(&pool->mutex);
+    }
+
+    return pool->count;
+}
+
+// Runs job once on every worker and once on the calling thread as worker 0,
+// and returns once all of them have finished.
+void run_thread_pool(struct ThreadPool *pool, ThreadPoolJob job, void *arg) {
+    assert(pool != NULL);
+    if (pool->count == 0) {
+        job(arg, 0);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->job = job;
+    pool->arg = arg;
+    pool->busy = pool->count;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    job(arg, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->busy > 0) {
+        pthread_cond_wait(&pool->done, &pool->mutex);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+// Wakes and joins every worker. The pool can be initialized again afterwards.
+void shutdown_thread_pool(struct ThreadPool *pool) {
+    assert(pool != NULL);
+    if (pool->count == 0) { return; }
+
+    pthread_mutex_lock(&pool->mutex);
+    pool->exit = true;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (s32 i = 0; i < pool->count; i++) {
+        join_thread(&pool->threads[i]);
+    }
+
+    pthread_cond_destroy(&pool->done);
+    pthread_cond_destroy(&pool->wake);
+    pthread_mutex_destroy(&pool->mutex);
+    pool->count = 0;
+}
@@ -23,6 +23,30 @@ struct ThreadHandle {
     enum ThreadState state;
 };
 
+#define THREAD_POOL_MAX_WORKERS 8
+
+typedef void (*ThreadPoolJob)(void *arg, s32 worker);
+
+struct ThreadPoolWorker {
+    struct ThreadPool *pool;
+    s32 index;
+};
+
+// A fixed set of workers that sleep until run_thread_pool hands them a job.
+struct ThreadPool {
+    struct ThreadHandle threads[THREAD_POOL_MAX_WORKERS];
+    struct ThreadPoolWorker workers[THREAD_POOL_MAX_WORKERS];
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    ThreadPoolJob job;
+    void *arg;
+    u32 generation;
+    s32 busy;
+    s32 count;
+    bool exit;
+};
+
 // Functions
 //// Thread Handle
 int init_thread_handle(struct ThreadHandle *handle, void *(*entry)(void *), void *arg, void *sp, size_t sp_size);
@@ -37,9 +61,15 @@ int stop_thread(struct ThreadHandle *handle);
 
 //// Mutex
 int init_mutex(struct ThreadHandle *handle);
+int init_recursive_mutex(struct ThreadHandle *handle);
 int destroy_mutex(struct ThreadHandle *handle);
 int lock_mutex(struct ThreadHandle *handle);
 int trylock_mutex(struct ThreadHandle *handle);
 int unlock_mutex(struct ThreadHandle *handle);
 
+//// Thread Pool
+int init_thread_pool(struct ThreadPool *pool, s32 count);
+void run_thread_pool(struct ThreadPool *pool, ThreadPoolJob job, void *arg);
+void shutdown_thread_pool(struct ThreadPool *pool);
+
 #endif // THREADING_H